@@ -0,0 +1,39 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "CPUDispatch.h"
+#include "CPUInstructionSet.h"
+
+#include <atomic>
+#include <immintrin.h>
+
+namespace
+{
+	std::atomic_bool UseOptimized{ true };
+
+	bool IsAVX2Supported() noexcept
+	{
+		// Besides the CPU supporting the instructions, the OS should
+		// save and restore the YMM registers on context switches
+		return (CPUInstructionSet::AVX2() && CPUInstructionSet::AVX() && CPUInstructionSet::OSXSAVE() &&
+				(_xgetbv(0) & 0x6) == 0x6);
+	}
+}
+
+int QGCryptoGetUseOptimized()
+{
+	return UseOptimized.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+void QGCryptoSetUseOptimized(int use)
+{
+	UseOptimized.store(use != 0, std::memory_order_relaxed);
+}
+
+int QGCryptoUseAVX2()
+{
+	static const bool supported = IsAVX2Supported();
+
+	return (supported && QGCryptoGetUseOptimized()) ? 1 : 0;
+}
\ No newline at end of file
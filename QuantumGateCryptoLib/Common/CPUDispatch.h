@@ -0,0 +1,18 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+// Selects between the reference implementations of the post-quantum algorithms
+// and their optimized variants. The optimized variants produce exactly the same
+// output as the reference implementations and are used by default when the CPU
+// supports them.
+#ifdef __cplusplus
+extern "C" {
+#endif
+	int QGCryptoGetUseOptimized();
+	void QGCryptoSetUseOptimized(int use);
+	int QGCryptoUseAVX2();
+#ifdef __cplusplus
+}
+#endif
\ No newline at end of file
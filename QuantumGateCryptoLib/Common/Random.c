@@ -4,6 +4,8 @@
 #include "Random.h"
 
 #include <assert.h>
+#include <string.h>
+#include <openssl/evp.h>
 
 #include "..\targetver.h"
 
@@ -16,7 +18,153 @@
 
 #define STATUS_SUCCESS ((NTSTATUS)0x00000000L)
 
+// Random bytes are generated per thread with a fast-key-erasure generator
+// on top of AES-256 in CTR mode: every refill of the buffer produces a new
+// key followed by a buffer full of output after which the old key is gone,
+// and bytes that get handed out are erased from the buffer. The key gets
+// mixed with fresh bytes from the OS source after a number of bytes was
+// produced, after an interval and after the RNG gets reseeded.
+#define QGRNG_KEY_SIZE 32
+#define QGRNG_BUFFER_SIZE (QGRNG_KEY_SIZE + 4096)
+#define QGRNG_RESEED_BYTES (1024 * 1024)
+#define QGRNG_RESEED_INTERVAL 10000 // Milliseconds
+
+typedef struct
+{
+	unsigned char Key[QGRNG_KEY_SIZE];
+	unsigned char Buffer[QGRNG_BUFFER_SIZE];
+	unsigned long Available; // Unused bytes at the end of the buffer
+	unsigned long long BytesSinceReseed;
+	ULONGLONG LastReseedTicks;
+	LONG Generation;
+	int Seeded;
+	EVP_CIPHER_CTX* CipherContext; // Kept so that it doesn't get allocated for every refill
+} QGRngState;
+
 static BCRYPT_ALG_HANDLE BCryptAlgorithm = NULL;
+static DWORD RngStateFlsIndex = FLS_OUT_OF_INDEXES;
+static volatile LONG RngGeneration = 0;
+
+static int GetOSRandomBytes(unsigned char* buffer, unsigned long buffer_len)
+{
+	// Should already have been initialized with QGCryptoInitRng()
+	assert(BCryptAlgorithm != NULL);
+
+	if (BCryptGenRandom(BCryptAlgorithm, buffer, buffer_len, 0) == STATUS_SUCCESS)
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+static void WINAPI FreeRngState(void* data)
+{
+	// Gets called on thread exit and when the FLS index is freed
+	if (data != NULL)
+	{
+		QGRngState* state = (QGRngState*)data;
+		if (state->CipherContext != NULL) EVP_CIPHER_CTX_free(state->CipherContext);
+
+		SecureZeroMemory(data, sizeof(QGRngState));
+		HeapFree(GetProcessHeap(), 0, data);
+	}
+}
+
+static QGRngState* GetRngState()
+{
+	if (RngStateFlsIndex == FLS_OUT_OF_INDEXES) return NULL;
+
+	QGRngState* state = (QGRngState*)FlsGetValue(RngStateFlsIndex);
+	if (state == NULL)
+	{
+		state = (QGRngState*)HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(QGRngState));
+		if (state != NULL)
+		{
+			if (!FlsSetValue(RngStateFlsIndex, state))
+			{
+				HeapFree(GetProcessHeap(), 0, state);
+				state = NULL;
+			}
+		}
+	}
+
+	return state;
+}
+
+static int NeedsReseed(const QGRngState* state)
+{
+	return (!state->Seeded ||
+			state->Generation != RngGeneration ||
+			state->BytesSinceReseed >= QGRNG_RESEED_BYTES ||
+			GetTickCount64() - state->LastReseedTicks >= QGRNG_RESEED_INTERVAL);
+}
+
+static int Reseed(QGRngState* state)
+{
+	unsigned char seed[QGRNG_KEY_SIZE];
+	if (GetOSRandomBytes(seed, sizeof(seed)) != 1) return 0;
+
+	// Mixing rather than replacing the key keeps whatever
+	// entropy it already has in case the OS source is weak
+	for (int i = 0; i < QGRNG_KEY_SIZE; ++i)
+	{
+		state->Key[i] ^= seed[i];
+	}
+
+	SecureZeroMemory(seed, sizeof(seed));
+
+	// Output generated with the previous key is discarded
+	SecureZeroMemory(state->Buffer, sizeof(state->Buffer));
+	state->Available = 0;
+
+	state->BytesSinceReseed = 0;
+	state->LastReseedTicks = GetTickCount64();
+	state->Generation = RngGeneration;
+	state->Seeded = 1;
+
+	return 1;
+}
+
+static int Refill(QGRngState* state)
+{
+	// Every key only gets used once, so the nonce can stay fixed
+	const unsigned char nonce[16] = { 0 };
+
+	const EVP_CIPHER* cipher = NULL;
+
+	if (state->CipherContext == NULL)
+	{
+		state->CipherContext = EVP_CIPHER_CTX_new();
+		if (state->CipherContext == NULL) return 0;
+
+		// Only needed the first time; after that the context
+		// keeps the cipher and only the key gets replaced
+		cipher = EVP_aes_256_ctr();
+	}
+
+	// Encrypting zeroes in place leaves the keystream in the buffer
+	memset(state->Buffer, 0, sizeof(state->Buffer));
+
+	int outl = 0;
+	int ok = EVP_EncryptInit_ex(state->CipherContext, cipher, NULL, state->Key, nonce);
+	if (ok == 1) ok = EVP_EncryptUpdate(state->CipherContext, state->Buffer, &outl,
+										state->Buffer, (int)sizeof(state->Buffer));
+	if (ok != 1)
+	{
+		// Start over with a new context next time
+		EVP_CIPHER_CTX_free(state->CipherContext);
+		state->CipherContext = NULL;
+		return 0;
+	}
+
+	// The first bytes of the output become the next key
+	memcpy(state->Key, state->Buffer, QGRNG_KEY_SIZE);
+	SecureZeroMemory(state->Buffer, QGRNG_KEY_SIZE);
+	state->Available = QGRNG_BUFFER_SIZE - QGRNG_KEY_SIZE;
+
+	return 1;
+}
 
 int QGCryptoInitRng()
 {
@@ -25,7 +173,15 @@ int QGCryptoInitRng()
 	if (BCryptOpenAlgorithmProvider(&BCryptAlgorithm, BCRYPT_RNG_ALGORITHM, NULL, 0) == STATUS_SUCCESS &&
 		BCryptAlgorithm != NULL)
 	{
-		return 1;
+		RngStateFlsIndex = FlsAlloc(FreeRngState);
+		if (RngStateFlsIndex != FLS_OUT_OF_INDEXES)
+		{
+			QGCryptoReseedRng();
+			return 1;
+		}
+
+		BCryptCloseAlgorithmProvider(BCryptAlgorithm, 0);
+		BCryptAlgorithm = NULL;
 	}
 
 	return 0;
@@ -35,6 +191,13 @@ void QGCryptoDeinitRng()
 {
 	assert(BCryptAlgorithm != NULL);
 
+	if (RngStateFlsIndex != FLS_OUT_OF_INDEXES)
+	{
+		// Erases and frees the state of all threads
+		FlsFree(RngStateFlsIndex);
+		RngStateFlsIndex = FLS_OUT_OF_INDEXES;
+	}
+
 	if (BCryptAlgorithm != NULL)
 	{
 		BCryptCloseAlgorithmProvider(BCryptAlgorithm, 0);
@@ -42,19 +205,49 @@ void QGCryptoDeinitRng()
 	}
 }
 
+void QGCryptoReseedRng()
+{
+	// Threads reseed on their next request
+	InterlockedIncrement(&RngGeneration);
+}
+
 int QGCryptoGetRandomBytes(unsigned char* buffer, unsigned long buffer_len)
 {
 	assert(buffer != NULL);
 
-	// Should already have been initialized with QGCryptoInitRng()
-	assert(BCryptAlgorithm != NULL);
+	QGRngState* state = GetRngState();
+	if (state == NULL)
+	{
+		return GetOSRandomBytes(buffer, buffer_len);
+	}
 
-	if (BCryptGenRandom(BCryptAlgorithm, buffer, buffer_len, 0) == STATUS_SUCCESS)
+	if (NeedsReseed(state) && !Reseed(state))
 	{
-		return 1;
+		return 0;
 	}
 
-	return 0;
+	while (buffer_len > 0)
+	{
+		if (state->Available == 0 && !Refill(state))
+		{
+			// AES not available (e.g. after OpenSSL cleanup);
+			// get the remaining bytes from the OS source
+			return GetOSRandomBytes(buffer, buffer_len);
+		}
+
+		const unsigned long len = (buffer_len < state->Available) ? buffer_len : state->Available;
+		unsigned char* bytes = state->Buffer + (QGRNG_BUFFER_SIZE - state->Available);
+
+		memcpy(buffer, bytes, len);
+		SecureZeroMemory(bytes, len);
+
+		state->Available -= len;
+		state->BytesSinceReseed += len;
+		buffer += len;
+		buffer_len -= len;
+	}
+
+	return 1;
 }
 
 void randombytes(unsigned char* buffer, unsigned long buffer_len)
@@ -8,6 +8,7 @@ extern "C" {
 #endif
 	int QGCryptoInitRng();
 	void QGCryptoDeinitRng();
+	void QGCryptoReseedRng();
 	int QGCryptoGetRandomBytes(unsigned char* buffer, unsigned long buffer_len);
 #ifdef __cplusplus
 }
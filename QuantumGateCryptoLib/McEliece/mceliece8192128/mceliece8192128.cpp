@@ -3,32 +3,40 @@
 
 #include "pch.h"
 #include "mceliece8192128.h"
+#include "..\..\Common\CPUDispatch.h"
 #include "ref\operations.h"
 #include "vec\operations.h"
 
+// The vec implementation is portable 64-bit C that produces the same output as the
+// ref implementation; the ref implementation only gets used when optimizations are
+// switched off (see QGCryptoSetUseOptimized)
+
 int crypto_kem_mceliece8192128_enc(unsigned char* c, unsigned char* key, const unsigned char* pk)
 {
-#ifdef MCELIECE_USE_VEC
-	return crypto_kem_mceliece8192128_vec_enc(c, key, pk);
-#else
+	if (QGCryptoGetUseOptimized())
+	{
+		return crypto_kem_mceliece8192128_vec_enc(c, key, pk);
+	}
+
 	return crypto_kem_mceliece8192128_ref_enc(c, key, pk);
-#endif
 }
 
 int crypto_kem_mceliece8192128_dec(unsigned char* key, const unsigned char* c, const unsigned char* sk)
 {
-#ifdef MCELIECE_USE_VEC
-	return crypto_kem_mceliece8192128_vec_dec(key, c, sk);
-#else
+	if (QGCryptoGetUseOptimized())
+	{
+		return crypto_kem_mceliece8192128_vec_dec(key, c, sk);
+	}
+
 	return crypto_kem_mceliece8192128_ref_dec(key, c, sk);
-#endif
 }
 
 int crypto_kem_mceliece8192128_keypair(unsigned char* pk, unsigned char* sk)
 {
-#ifdef MCELIECE_USE_VEC
-	return crypto_kem_mceliece8192128_vec_keypair(pk, sk);
-#else
+	if (QGCryptoGetUseOptimized())
+	{
+		return crypto_kem_mceliece8192128_vec_keypair(pk, sk);
+	}
+
 	return crypto_kem_mceliece8192128_ref_keypair(pk, sk);
-#endif
 }
@@ -3,8 +3,6 @@
 
 #pragma once
 
-#define MCELIECE_USE_VEC
-
 #define crypto_kem_mceliece8192128_PUBLICKEYBYTES 1357824
 #define crypto_kem_mceliece8192128_SECRETKEYBYTES 14080
 #define crypto_kem_mceliece8192128_CIPHERTEXTBYTES 240
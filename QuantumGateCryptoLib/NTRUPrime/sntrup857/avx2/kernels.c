@@ -0,0 +1,306 @@
+#include <string.h>
+#include <immintrin.h>
+
+#include "..\ref\params.h"
+#include "..\ref\int8.h"
+#include "..\ref\int16.h"
+#include "..\ref\int32.h"
+#include "kernels.h"
+
+#pragma warning (disable: 4146)
+
+/*
+All vector loops run over the polynomials padded with zeros up to
+PADDED coefficients; the padding stays zero throughout so that results
+don't depend on it. Coefficients are always fully reduced to the same
+representatives as in the reference implementation (-1,0,1 for R3 and
+-q12...q12 for Rq) so that outputs are bit-identical.
+*/
+
+#define PADDED 864
+#define q12 ((q-1)/2)
+
+/* ----- masks (as in ..\ref\kem.c) */
+
+static int int16_nonzero_mask(int16 x)
+{
+  uint16_t u = x;
+  uint32_t v = u;
+  v = -v;
+  v >>= 31;
+  return -v;
+}
+
+static int int16_negative_mask(int16 x)
+{
+  uint16_t u = x;
+  u >>= 15;
+  return -(int) u;
+}
+
+/* ----- scalar arithmetic mod q */
+
+static int16 Fq_freeze(int32 x)
+{
+  return int32_mod_uint14(x+q12,q)-q12;
+}
+
+static int16 Fq_recip(int16 a1)
+{
+  int i = 1;
+  int16 ai = a1;
+
+  while (i < q-2) {
+    ai = Fq_freeze(a1*(int32)ai);
+    i += 1;
+  }
+  return ai;
+}
+
+/* ----- vector arithmetic */
+
+/* x mod 3 in -1,0,1 for int16 lanes with |x| <= 2^13 */
+/* round(x/3) equals the rounded product with 10923/2^15 in that range */
+static __m256i F3_freeze_epi16(__m256i x)
+{
+  const __m256i n = _mm256_mulhrs_epi16(x,_mm256_set1_epi16(10923));
+  return _mm256_sub_epi16(x,_mm256_mullo_epi16(n,_mm256_set1_epi16(3)));
+}
+
+/* x mod 3 in -1,0,1 for int8 lanes with |x| <= 2 */
+static __m256i F3_freeze_epi8(__m256i x)
+{
+  const __m256i three = _mm256_set1_epi8(3);
+  x = _mm256_sub_epi8(x,_mm256_and_si256(_mm256_cmpgt_epi8(x,_mm256_set1_epi8(1)),three));
+  return _mm256_add_epi8(x,_mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(-1),x),three));
+}
+
+/* x mod q in -q12...q12 for int32 lanes with |x| < 2^24 */
+/* x converts exactly to float, so the rounded quotient is off by at most one */
+static __m256i Fq_freeze_epi32(__m256i x)
+{
+  const __m256i qv = _mm256_set1_epi32(q);
+  const __m256 n = _mm256_round_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(x),_mm256_set1_ps(1.0f/q)),
+                                   _MM_FROUND_TO_NEAREST_INT|_MM_FROUND_NO_EXC);
+  __m256i r = _mm256_sub_epi32(x,_mm256_mullo_epi32(_mm256_cvtps_epi32(n),qv));
+  r = _mm256_sub_epi32(r,_mm256_and_si256(_mm256_cmpgt_epi32(r,_mm256_set1_epi32(q12)),qv));
+  return _mm256_add_epi32(r,_mm256_and_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(-q12),r),qv));
+}
+
+/* packs two vectors of 8 int32 lanes in -q12...q12 into 16 int16 lanes in order */
+static __m256i pack_epi32(__m256i lo,__m256i hi)
+{
+  return _mm256_permute4x64_epi64(_mm256_packs_epi32(lo,hi),0xd8);
+}
+
+/* ----- R3 */
+
+void sntrup857_avx2_R3_mult(int8_t *h,const int8_t *f,const int8_t *g)
+{
+  int16 g16[PADDED],fg[2*PADDED],out[PADDED];
+  int i,j;
+
+  memset(g16,0,sizeof g16);
+  memset(fg,0,sizeof fg);
+  for (i = 0;i < p;++i) g16[i] = g[i];
+
+  /* products are -1,0,1 so the sums can't overflow */
+  for (j = 0;j < p;++j) {
+    const __m256i fj = _mm256_set1_epi16(f[j]);
+    for (i = 0;i < PADDED;i += 16) {
+      const __m256i gi = _mm256_loadu_si256((const __m256i *) &g16[i]);
+      __m256i acc = _mm256_loadu_si256((const __m256i *) &fg[i+j]);
+      acc = _mm256_add_epi16(acc,_mm256_sign_epi16(fj,gi));
+      _mm256_storeu_si256((__m256i *) &fg[i+j],acc);
+    }
+  }
+
+  /* x^p = x+1 */
+  for (i = 0;i < PADDED;i += 16) {
+    __m256i x = _mm256_loadu_si256((const __m256i *) &fg[i]);
+    x = _mm256_add_epi16(x,_mm256_loadu_si256((const __m256i *) &fg[i+p]));
+    x = _mm256_add_epi16(x,_mm256_loadu_si256((const __m256i *) &fg[i+p-1]));
+    if (i == 0) x = _mm256_sub_epi16(x,_mm256_setr_epi16(fg[p-1],0,0,0,0,0,0,0,0,0,0,0,0,0,0,0));
+    _mm256_storeu_si256((__m256i *) &out[i],F3_freeze_epi16(x));
+  }
+
+  for (i = 0;i < p;++i) h[i] = (int8) out[i];
+}
+
+int sntrup857_avx2_R3_recip(int8_t *out,const int8_t *in)
+{
+  int8 f[PADDED],g[PADDED],v[PADDED],r[PADDED];
+  int i,loop,delta;
+  int sign,swap;
+
+  memset(f,0,sizeof f);
+  memset(g,0,sizeof g);
+  memset(v,0,sizeof v);
+  memset(r,0,sizeof r);
+  r[0] = 1;
+  f[0] = 1; f[p-1] = f[p] = -1;
+  for (i = 0;i < p;++i) g[p-1-i] = in[i];
+
+  delta = 1;
+
+  for (loop = 0;loop < 2*p-1;++loop) {
+    memmove(v+1,v,p);
+    v[0] = 0;
+
+    sign = -g[0]*f[0];
+    swap = int16_negative_mask(-delta) & int16_nonzero_mask(g[0]);
+    delta ^= swap&(delta^-delta);
+    delta += 1;
+
+    {
+      const __m256i swapv = _mm256_set1_epi8((char) swap);
+      const __m256i signv = _mm256_set1_epi8((char) sign);
+
+      for (i = 0;i < PADDED;i += 32) {
+        __m256i fi = _mm256_loadu_si256((const __m256i *) &f[i]);
+        __m256i gi = _mm256_loadu_si256((const __m256i *) &g[i]);
+        __m256i vi = _mm256_loadu_si256((const __m256i *) &v[i]);
+        __m256i ri = _mm256_loadu_si256((const __m256i *) &r[i]);
+        __m256i t;
+
+        t = _mm256_and_si256(swapv,_mm256_xor_si256(fi,gi)); fi = _mm256_xor_si256(fi,t); gi = _mm256_xor_si256(gi,t);
+        t = _mm256_and_si256(swapv,_mm256_xor_si256(vi,ri)); vi = _mm256_xor_si256(vi,t); ri = _mm256_xor_si256(ri,t);
+
+        /* sign is -1,0,1 */
+        gi = F3_freeze_epi8(_mm256_add_epi8(gi,_mm256_sign_epi8(fi,signv)));
+        ri = F3_freeze_epi8(_mm256_add_epi8(ri,_mm256_sign_epi8(vi,signv)));
+
+        _mm256_storeu_si256((__m256i *) &f[i],fi);
+        _mm256_storeu_si256((__m256i *) &g[i],gi);
+        _mm256_storeu_si256((__m256i *) &v[i],vi);
+        _mm256_storeu_si256((__m256i *) &r[i],ri);
+      }
+    }
+
+    memmove(g,g+1,p);
+    g[p] = 0;
+  }
+
+  sign = f[0];
+  for (i = 0;i < p;++i) out[i] = sign*v[p-1-i];
+
+  return int16_nonzero_mask(delta);
+}
+
+/* ----- Rq */
+
+void sntrup857_avx2_Rq_mult_small(int16_t *h,const int16_t *f,const int8_t *g)
+{
+  int32 g32[PADDED],fg[2*PADDED];
+  int16 out[PADDED];
+  int i,j;
+
+  memset(g32,0,sizeof g32);
+  memset(fg,0,sizeof fg);
+  for (i = 0;i < p;++i) g32[i] = g[i];
+
+  /* |sums| <= p*q12 < 2^22 */
+  for (j = 0;j < p;++j) {
+    const __m256i fj = _mm256_set1_epi32(f[j]);
+    for (i = 0;i < PADDED;i += 8) {
+      const __m256i gi = _mm256_loadu_si256((const __m256i *) &g32[i]);
+      __m256i acc = _mm256_loadu_si256((const __m256i *) &fg[i+j]);
+      acc = _mm256_add_epi32(acc,_mm256_sign_epi32(fj,gi));
+      _mm256_storeu_si256((__m256i *) &fg[i+j],acc);
+    }
+  }
+
+  /* x^p = x+1 */
+  for (i = 0;i < PADDED;i += 16) {
+    __m256i lo = _mm256_loadu_si256((const __m256i *) &fg[i]);
+    __m256i hi = _mm256_loadu_si256((const __m256i *) &fg[i+8]);
+    lo = _mm256_add_epi32(lo,_mm256_loadu_si256((const __m256i *) &fg[i+p]));
+    hi = _mm256_add_epi32(hi,_mm256_loadu_si256((const __m256i *) &fg[i+8+p]));
+    lo = _mm256_add_epi32(lo,_mm256_loadu_si256((const __m256i *) &fg[i+p-1]));
+    hi = _mm256_add_epi32(hi,_mm256_loadu_si256((const __m256i *) &fg[i+8+p-1]));
+    if (i == 0) lo = _mm256_sub_epi32(lo,_mm256_setr_epi32(fg[p-1],0,0,0,0,0,0,0));
+    _mm256_storeu_si256((__m256i *) &out[i],pack_epi32(Fq_freeze_epi32(lo),Fq_freeze_epi32(hi)));
+  }
+
+  memcpy(h,out,p*sizeof(int16));
+}
+
+/* g = f0*g-g0*f for 16 coefficients starting at i */
+static void Rq_eliminate(int16 *g,const int16 *f,__m256i f0,__m256i g0,int i)
+{
+  const __m128i *gp = (const __m128i *) &g[i];
+  const __m128i *fp = (const __m128i *) &f[i];
+  __m256i lo,hi;
+
+  lo = _mm256_sub_epi32(_mm256_mullo_epi32(f0,_mm256_cvtepi16_epi32(_mm_loadu_si128(gp))),
+                        _mm256_mullo_epi32(g0,_mm256_cvtepi16_epi32(_mm_loadu_si128(fp))));
+  hi = _mm256_sub_epi32(_mm256_mullo_epi32(f0,_mm256_cvtepi16_epi32(_mm_loadu_si128(gp+1))),
+                        _mm256_mullo_epi32(g0,_mm256_cvtepi16_epi32(_mm_loadu_si128(fp+1))));
+  _mm256_storeu_si256((__m256i *) &g[i],pack_epi32(Fq_freeze_epi32(lo),Fq_freeze_epi32(hi)));
+}
+
+int sntrup857_avx2_Rq_recip3(int16_t *out,const int8_t *in)
+{
+  int16 f[PADDED],g[PADDED],v[PADDED],r[PADDED];
+  int i,loop,delta;
+  int swap;
+  int16 scale;
+
+  memset(f,0,sizeof f);
+  memset(g,0,sizeof g);
+  memset(v,0,sizeof v);
+  memset(r,0,sizeof r);
+  r[0] = Fq_recip(3);
+  f[0] = 1; f[p-1] = f[p] = -1;
+  for (i = 0;i < p;++i) g[p-1-i] = in[i];
+
+  delta = 1;
+
+  for (loop = 0;loop < 2*p-1;++loop) {
+    memmove(v+1,v,p*sizeof(int16));
+    v[0] = 0;
+
+    swap = int16_negative_mask(-delta) & int16_nonzero_mask(g[0]);
+    delta ^= swap&(delta^-delta);
+    delta += 1;
+
+    {
+      const __m256i swapv = _mm256_set1_epi16((short) swap);
+
+      for (i = 0;i < PADDED;i += 16) {
+        __m256i fi = _mm256_loadu_si256((const __m256i *) &f[i]);
+        __m256i gi = _mm256_loadu_si256((const __m256i *) &g[i]);
+        __m256i vi = _mm256_loadu_si256((const __m256i *) &v[i]);
+        __m256i ri = _mm256_loadu_si256((const __m256i *) &r[i]);
+        __m256i t;
+
+        t = _mm256_and_si256(swapv,_mm256_xor_si256(fi,gi)); fi = _mm256_xor_si256(fi,t); gi = _mm256_xor_si256(gi,t);
+        t = _mm256_and_si256(swapv,_mm256_xor_si256(vi,ri)); vi = _mm256_xor_si256(vi,t); ri = _mm256_xor_si256(ri,t);
+
+        _mm256_storeu_si256((__m256i *) &f[i],fi);
+        _mm256_storeu_si256((__m256i *) &g[i],gi);
+        _mm256_storeu_si256((__m256i *) &v[i],vi);
+        _mm256_storeu_si256((__m256i *) &r[i],ri);
+      }
+    }
+
+    {
+      /* |f0*g-g0*f| <= 2*q12*q12 < 2^24 */
+      const __m256i f0 = _mm256_set1_epi32(f[0]);
+      const __m256i g0 = _mm256_set1_epi32(g[0]);
+
+      for (i = 0;i < PADDED;i += 16) {
+        Rq_eliminate(g,f,f0,g0,i);
+        Rq_eliminate(r,v,f0,g0,i);
+      }
+    }
+
+    memmove(g,g+1,p*sizeof(int16));
+    g[p] = 0;
+  }
+
+  scale = Fq_recip(f[0]);
+  for (i = 0;i < p;++i) out[i] = Fq_freeze(scale*(int32)v[p-1-i]);
+
+  return int16_nonzero_mask(delta);
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef AVX2_KERNELS_H
+#define AVX2_KERNELS_H
+
+#include <stdint.h>
+
+/*
+AVX2 variants of the polynomial arithmetic in ..\ref\kem.c; these
+produce exactly the same output as the reference functions and may
+only be called when the CPU supports AVX2 (see QGCryptoUseAVX2)
+*/
+
+extern void sntrup857_avx2_R3_mult(int8_t *h,const int8_t *f,const int8_t *g);
+extern int sntrup857_avx2_R3_recip(int8_t *out,const int8_t *in);
+extern void sntrup857_avx2_Rq_mult_small(int16_t *h,const int16_t *f,const int8_t *g);
+extern int sntrup857_avx2_Rq_recip3(int16_t *out,const int8_t *in);
+
+#endif
\ No newline at end of file
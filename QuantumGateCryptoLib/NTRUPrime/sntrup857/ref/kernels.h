@@ -0,0 +1,18 @@
+#ifndef REF_KERNELS_H
+#define REF_KERNELS_H
+
+#include <stdint.h>
+
+/*
+Entry points to the polynomial arithmetic in kem.c so that the kernels
+in ..\avx2 can be checked against it; like the rest of kem.c these use
+the AVX2 kernels when QGCryptoUseAVX2 returns nonzero, so call
+QGCryptoSetUseOptimized(0) first to get the reference output
+*/
+
+extern void sntrup857_ref_R3_mult(int8_t *h,const int8_t *f,const int8_t *g);
+extern int sntrup857_ref_R3_recip(int8_t *out,const int8_t *in);
+extern void sntrup857_ref_Rq_mult_small(int16_t *h,const int16_t *f,const int8_t *g);
+extern int sntrup857_ref_Rq_recip3(int16_t *out,const int8_t *in);
+
+#endif
\ No newline at end of file
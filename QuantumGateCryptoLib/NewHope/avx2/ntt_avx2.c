@@ -0,0 +1,114 @@
+#include <immintrin.h>
+
+#include "ntt_avx2.h"
+#include "..\ref\params.h"
+#include "..\ref\reduce.h"
+
+/*
+ * All arithmetic is done on 8 coefficients at a time in 32-bit lanes,
+ * which wrap around modulo 2^32 exactly like the uint32_t arithmetic
+ * in the reference implementation.
+ */
+
+static __m256i load_epu16(const uint16_t* in)
+{
+  return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)in));
+}
+
+/* Lanes must be in {0,...,2^16-1} */
+static void store_epu16(uint16_t* out, __m256i x)
+{
+  x = _mm256_permute4x64_epi64(_mm256_packus_epi32(x, x), 0x08);
+  _mm_storeu_si128((__m128i *)out, _mm256_castsi256_si128(x));
+}
+
+static __m256i montgomery_reduce_avx2(__m256i a)
+{
+  __m256i u;
+
+  u = _mm256_mullo_epi32(a, _mm256_set1_epi32(12287)); /* qinv */
+  u = _mm256_and_si256(u, _mm256_set1_epi32((1<<18)-1));
+  u = _mm256_mullo_epi32(u, _mm256_set1_epi32(NEWHOPE_Q));
+  a = _mm256_add_epi32(a, u);
+  return _mm256_srli_epi32(a, 18);
+}
+
+/* x % NEWHOPE_Q for x in {0,...,2^17-1}; floor(x*21843/2^28) is either
+ * floor(x/NEWHOPE_Q) or one less in that range */
+static __m256i mod_q_avx2(__m256i x)
+{
+  const __m256i q = _mm256_set1_epi32(NEWHOPE_Q);
+  const __m256i t = _mm256_srli_epi32(_mm256_mullo_epi32(x, _mm256_set1_epi32(21843)), 28);
+  x = _mm256_sub_epi32(x, _mm256_mullo_epi32(t, q));
+  return _mm256_sub_epi32(x, _mm256_and_si256(_mm256_cmpgt_epi32(x, _mm256_set1_epi32(NEWHOPE_Q-1)), q));
+}
+
+void mul_coefficients_avx2(uint16_t* poly, const uint16_t* factors)
+{
+  unsigned int i;
+
+  for(i = 0; i < NEWHOPE_N; i += 8)
+    store_epu16(poly + i, montgomery_reduce_avx2(_mm256_mullo_epi32(load_epu16(poly + i), load_epu16(factors + i))));
+}
+
+void poly_mul_pointwise_avx2(uint16_t* r, const uint16_t* a, const uint16_t* b)
+{
+  unsigned int i;
+  __m256i t;
+
+  for(i = 0; i < NEWHOPE_N; i += 8)
+  {
+    t = montgomery_reduce_avx2(_mm256_mullo_epi32(_mm256_set1_epi32(3186), load_epu16(b + i))); /* t is now in Montgomery domain */
+    store_epu16(r + i, montgomery_reduce_avx2(_mm256_mullo_epi32(load_epu16(a + i), t)));      /* r is back in normal domain */
+  }
+}
+
+void ntt_avx2(uint16_t* a, const uint16_t* omega)
+{
+  const __m256i q3 = _mm256_set1_epi32(3*NEWHOPE_Q);
+  const __m256i mask = _mm256_set1_epi32(0xFFFF);
+  int level, start, j, jTwiddle, distance, even;
+  uint16_t temp, W;
+  __m256i x, y, w;
+
+  for(level = 0; (1<<level) < NEWHOPE_N; level++)
+  {
+    distance = (1<<level);
+    even = ((level & 1) == 0);
+
+    if(distance < 8)
+    {
+      // Butterflies within 8 coefficients; same as the reference implementation
+      for(start = 0; start < distance; start++)
+      {
+        jTwiddle = 0;
+        for(j = start; j < NEWHOPE_N-1; j += 2*distance)
+        {
+          W = omega[jTwiddle++];
+          temp = a[j];
+          if(even) a[j] = (temp + a[j + distance]); // Omit reduction (be lazy)
+          else a[j] = (temp + a[j + distance]) % NEWHOPE_Q;
+          a[j + distance] = montgomery_reduce((W * ((uint32_t)temp + 3*NEWHOPE_Q - a[j + distance])));
+        }
+      }
+    }
+    else
+    {
+      // 8 consecutive butterflies share the same twiddle factor
+      jTwiddle = 0;
+      for(j = 0; j < NEWHOPE_N-1; j += 2*distance)
+      {
+        w = _mm256_set1_epi32(omega[jTwiddle++]);
+        for(start = 0; start < distance; start += 8)
+        {
+          x = load_epu16(a + j + start);
+          y = load_epu16(a + j + start + distance);
+          if(even) store_epu16(a + j + start, _mm256_and_si256(_mm256_add_epi32(x, y), mask));
+          else store_epu16(a + j + start, mod_q_avx2(_mm256_add_epi32(x, y)));
+          store_epu16(a + j + start + distance,
+                      montgomery_reduce_avx2(_mm256_mullo_epi32(w, _mm256_sub_epi32(_mm256_add_epi32(x, q3), y))));
+        }
+      }
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef NTT_AVX2_H
+#define NTT_AVX2_H
+
+#include <stdint.h>
+
+/*
+ * AVX2 variants of the NTT and the coefficient-wise multiplications in
+ * ../ref; these produce exactly the same output as the reference functions
+ * and may only be called when the CPU supports AVX2 (see QGCryptoUseAVX2)
+ */
+
+void ntt_avx2(uint16_t* poly, const uint16_t* omegas);
+void mul_coefficients_avx2(uint16_t* poly, const uint16_t* factors);
+void poly_mul_pointwise_avx2(uint16_t* r, const uint16_t* a, const uint16_t* b);
+
+#endif
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "ntt.h"
 #include "params.h"
 #include "reduce.h"
+#include "..\avx2\ntt_avx2.h"
+#include "..\..\Common\CPUDispatch.h"
 
 #if (NEWHOPE_N == 512)
 /************************************************************
@@ -112,6 +114,12 @@ void mul_coefficients(uint16_t* poly, const uint16_t* factors)
 {
     unsigned int i;
 
+    if (QGCryptoUseAVX2())
+    {
+      mul_coefficients_avx2(poly, factors);
+      return;
+    }
+
     for(i = 0; i < NEWHOPE_N; i++)
       poly[i] = montgomery_reduce((poly[i] * factors[i]));
 }
@@ -134,6 +142,11 @@ void ntt(uint16_t * a, const uint16_t* omega)
   int i, start, j, jTwiddle, distance;
   uint16_t temp, W;
 
+  if (QGCryptoUseAVX2())
+  {
+    ntt_avx2(a, omega);
+    return;
+  }
 
   for(i=0;i<9;i+=2)
   {
@@ -186,6 +199,11 @@ ntt(uint16_t * a, const uint16_t* omega)
   int i, start, j, jTwiddle, distance;
   uint16_t temp, W;
 
+  if (QGCryptoUseAVX2())
+  {
+    ntt_avx2(a, omega);
+    return;
+  }
 
   for(i=0;i<10;i+=2)
   {
@@ -2,6 +2,8 @@
 #include "ntt.h"
 #include "reduce.h"
 #include "fips202.h"
+#include "..\avx2\ntt_avx2.h"
+#include "..\..\Common\CPUDispatch.h"
 
 /*************************************************
 * Name:        coeff_freeze
@@ -331,6 +333,13 @@ void poly_mul_pointwise(poly *r, const poly *a, const poly *b)
 {
   int i;
   uint16_t t;
+
+  if (QGCryptoUseAVX2())
+  {
+    poly_mul_pointwise_avx2(r->coeffs, a->coeffs, b->coeffs);
+    return;
+  }
+
   for(i=0;i<NEWHOPE_N;i++)
   {
     t            = montgomery_reduce(3186*b->coeffs[i]); /* t is now in Montgomery domain */
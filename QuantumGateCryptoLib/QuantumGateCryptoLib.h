@@ -3,13 +3,16 @@
 
 #pragma once
 
+#include "Common\CPUDispatch.h"
 #include "Common\Random.h"
 #include "McEliece\mceliece8192128\mceliece8192128.h"
 #include "NTRUPrime\sntrup857\ref\crypto_kem_sntrup857.h"
 #include "NewHope\ref\ccakem.h"
 
 // The siphash function is defined in the siphash.c reference
-// implementation file included in the SipHash folder
+// implementation file included in the SipHash folder; the _opt
+// variants in siphash_opt.c produce exactly the same output and
+// halfsiphash_multi computes num independent hashes at once
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,6 +20,12 @@ extern "C" {
 					uint8_t* out, const size_t outlen);
 	int siphash(const uint8_t* in, const size_t inlen, const uint8_t* k,
 				uint8_t* out, const size_t outlen);
+	int halfsiphash_opt(const uint8_t* in, const size_t inlen, const uint8_t* k,
+						uint8_t* out, const size_t outlen);
+	int siphash_opt(const uint8_t* in, const size_t inlen, const uint8_t* k,
+					uint8_t* out, const size_t outlen);
+	int halfsiphash_multi(const uint8_t* const* in, const size_t* inlen, const uint8_t* const* k,
+						  uint8_t* const* out, const size_t outlen, const size_t num);
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
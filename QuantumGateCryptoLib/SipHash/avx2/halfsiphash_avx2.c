@@ -0,0 +1,127 @@
+#include <immintrin.h>
+#include <string.h>
+
+#include "halfsiphash_avx2.h"
+
+#define LANES HALFSIPHASH_AVX2_LANES
+
+static inline __m256i rotl(const __m256i x, const int b)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(x, b), _mm256_srli_epi32(x, 32 - b));
+}
+
+#define SIPROUND                                                  \
+  do {                                                            \
+    v0 = _mm256_add_epi32(v0, v1); v1 = rotl(v1, 5);              \
+    v1 = _mm256_xor_si256(v1, v0); v0 = rotl(v0, 16);             \
+    v2 = _mm256_add_epi32(v2, v3); v3 = rotl(v3, 8);              \
+    v3 = _mm256_xor_si256(v3, v2);                                \
+    v0 = _mm256_add_epi32(v0, v3); v3 = rotl(v3, 7);              \
+    v3 = _mm256_xor_si256(v3, v0);                                \
+    v2 = _mm256_add_epi32(v2, v1); v1 = rotl(v1, 13);             \
+    v1 = _mm256_xor_si256(v1, v2); v2 = rotl(v2, 16);             \
+  } while (0)
+
+static inline uint32_t load32(const uint8_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+void halfsiphash_avx2_x8(const uint8_t *const *in, const size_t *inlen,
+                         const uint8_t *const *k, uint8_t *const *out,
+                         const size_t outlen)
+{
+  uint32_t k0[LANES], k1[LANES], last[LANES], words[LANES], active[LANES], res[2][LANES];
+  size_t nblocks[LANES], minblocks = SIZE_MAX, maxblocks = 0, i, j;
+  __m256i v0, v1, v2, v3, m, t0, t1, t2, t3, mask;
+
+  for (i = 0; i < LANES; i++)
+  {
+    k0[i] = load32(k[i]);
+    k1[i] = load32(k[i] + 4);
+
+    /* Final word: the remaining bytes with the length in the top byte */
+    nblocks[i] = inlen[i] / 4;
+    last[i] = 0;
+    memcpy(&last[i], in[i] + (nblocks[i] * 4), inlen[i] & 3);
+    last[i] |= ((uint32_t)inlen[i]) << 24;
+
+    if (nblocks[i] < minblocks) minblocks = nblocks[i];
+    if (nblocks[i] > maxblocks) maxblocks = nblocks[i];
+  }
+
+  v0 = _mm256_loadu_si256((const __m256i *)k0);
+  v1 = _mm256_loadu_si256((const __m256i *)k1);
+  v2 = _mm256_xor_si256(v0, _mm256_set1_epi32(0x6c796765));
+  v3 = _mm256_xor_si256(v1, _mm256_set1_epi32(0x74656462));
+
+  if (outlen == 8) v1 = _mm256_xor_si256(v1, _mm256_set1_epi32(0xee));
+
+  /* Blocks that all inputs have */
+  for (j = 0; j < minblocks; j++)
+  {
+    for (i = 0; i < LANES; i++) words[i] = load32(in[i] + (j * 4));
+
+    m = _mm256_loadu_si256((const __m256i *)words);
+    v3 = _mm256_xor_si256(v3, m);
+    SIPROUND;
+    SIPROUND;
+    v0 = _mm256_xor_si256(v0, m);
+  }
+
+  /* Remaining blocks and final words; lanes whose input
+   * was already done keep their state */
+  for (j = minblocks; j <= maxblocks; j++)
+  {
+    for (i = 0; i < LANES; i++)
+    {
+      if (j < nblocks[i]) words[i] = load32(in[i] + (j * 4));
+      else if (j == nblocks[i]) words[i] = last[i];
+      else words[i] = 0;
+
+      active[i] = (j <= nblocks[i]) ? 0xFFFFFFFF : 0;
+    }
+
+    m = _mm256_loadu_si256((const __m256i *)words);
+    mask = _mm256_loadu_si256((const __m256i *)active);
+
+    t0 = v0; t1 = v1; t2 = v2; t3 = v3;
+
+    v3 = _mm256_xor_si256(v3, m);
+    SIPROUND;
+    SIPROUND;
+    v0 = _mm256_xor_si256(v0, m);
+
+    v0 = _mm256_blendv_epi8(t0, v0, mask);
+    v1 = _mm256_blendv_epi8(t1, v1, mask);
+    v2 = _mm256_blendv_epi8(t2, v2, mask);
+    v3 = _mm256_blendv_epi8(t3, v3, mask);
+  }
+
+  v2 = _mm256_xor_si256(v2, _mm256_set1_epi32((outlen == 8) ? 0xee : 0xff));
+  SIPROUND;
+  SIPROUND;
+  SIPROUND;
+  SIPROUND;
+
+  _mm256_storeu_si256((__m256i *)res[0], _mm256_xor_si256(v1, v3));
+
+  if (outlen == 8)
+  {
+    v1 = _mm256_xor_si256(v1, _mm256_set1_epi32(0xdd));
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+
+    _mm256_storeu_si256((__m256i *)res[1], _mm256_xor_si256(v1, v3));
+  }
+
+  for (i = 0; i < LANES; i++)
+  {
+    memcpy(out[i], &res[0][i], sizeof(uint32_t));
+    if (outlen == 8) memcpy(out[i] + 4, &res[1][i], sizeof(uint32_t));
+  }
+}
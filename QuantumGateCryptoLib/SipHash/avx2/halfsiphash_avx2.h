@@ -0,0 +1,20 @@
+#ifndef HALFSIPHASH_AVX2_H
+#define HALFSIPHASH_AVX2_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HALFSIPHASH_AVX2_LANES 8
+
+/*
+ * Computes HalfSipHash-2-4 for 8 independent inputs at once, each with its
+ * own key and length, in the 32-bit lanes of AVX2 registers; produces exactly
+ * the same output as ../halfsiphash.c and may only be called when the CPU
+ * supports AVX2 (see QGCryptoUseAVX2)
+ */
+
+void halfsiphash_avx2_x8(const uint8_t *const *in, const size_t *inlen,
+                         const uint8_t *const *k, uint8_t *const *out,
+                         const size_t outlen);
+
+#endif
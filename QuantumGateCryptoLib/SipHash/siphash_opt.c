@@ -0,0 +1,174 @@
+/*
+ * Word-at-a-time variants of the SipHash-2-4 and HalfSipHash-2-4 reference
+ * implementations in siphash.c and halfsiphash.c. They produce exactly the
+ * same output; input words and the final partial word are loaded with a
+ * single memcpy instead of byte by byte, and the rounds are unrolled.
+ *
+ * Only little-endian targets are supported, so loads need no byte swapping.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "avx2\halfsiphash_avx2.h"
+#include "..\Common\CPUDispatch.h"
+
+#define ROTL64(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+#define ROTL32(x, b) (uint32_t)(((x) << (b)) | ((x) >> (32 - (b))))
+
+#define SIPROUND64                                                             \
+    do {                                                                       \
+        v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32);          \
+        v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2;                               \
+        v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0;                               \
+        v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32);          \
+    } while (0)
+
+#define SIPROUND32                                                             \
+    do {                                                                       \
+        v0 += v1; v1 = ROTL32(v1, 5); v1 ^= v0; v0 = ROTL32(v0, 16);           \
+        v2 += v3; v3 = ROTL32(v3, 8); v3 ^= v2;                                \
+        v0 += v3; v3 = ROTL32(v3, 7); v3 ^= v0;                                \
+        v2 += v1; v1 = ROTL32(v1, 13); v1 ^= v2; v2 = ROTL32(v2, 16);          \
+    } while (0)
+
+static inline uint64_t load64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t load32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+int siphash_opt(const uint8_t *in, const size_t inlen, const uint8_t *k,
+                uint8_t *out, const size_t outlen) {
+
+    const uint64_t k0 = load64(k);
+    const uint64_t k1 = load64(k + 8);
+    uint64_t v0 = UINT64_C(0x736f6d6570736575) ^ k0;
+    uint64_t v1 = UINT64_C(0x646f72616e646f6d) ^ k1;
+    uint64_t v2 = UINT64_C(0x6c7967656e657261) ^ k0;
+    uint64_t v3 = UINT64_C(0x7465646279746573) ^ k1;
+    const uint8_t *end = in + inlen - (inlen & 7);
+    uint64_t m, b = ((uint64_t)inlen) << 56;
+
+    if (outlen == 16)
+        v1 ^= 0xee;
+
+    for (; in != end; in += 8) {
+        m = load64(in);
+        v3 ^= m;
+        SIPROUND64;
+        SIPROUND64;
+        v0 ^= m;
+    }
+
+    m = 0;
+    memcpy(&m, in, inlen & 7);
+    b |= m;
+
+    v3 ^= b;
+    SIPROUND64;
+    SIPROUND64;
+    v0 ^= b;
+
+    v2 ^= (outlen == 16) ? 0xee : 0xff;
+    SIPROUND64;
+    SIPROUND64;
+    SIPROUND64;
+    SIPROUND64;
+
+    b = v0 ^ v1 ^ v2 ^ v3;
+    memcpy(out, &b, sizeof(b));
+
+    if (outlen == 8)
+        return 0;
+
+    v1 ^= 0xdd;
+    SIPROUND64;
+    SIPROUND64;
+    SIPROUND64;
+    SIPROUND64;
+
+    b = v0 ^ v1 ^ v2 ^ v3;
+    memcpy(out + 8, &b, sizeof(b));
+
+    return 0;
+}
+
+int halfsiphash_opt(const uint8_t *in, const size_t inlen, const uint8_t *k,
+                    uint8_t *out, const size_t outlen) {
+
+    const uint32_t k0 = load32(k);
+    const uint32_t k1 = load32(k + 4);
+    uint32_t v0 = k0;
+    uint32_t v1 = k1;
+    uint32_t v2 = UINT32_C(0x6c796765) ^ k0;
+    uint32_t v3 = UINT32_C(0x74656462) ^ k1;
+    const uint8_t *end = in + inlen - (inlen & 3);
+    uint32_t m, b = ((uint32_t)inlen) << 24;
+
+    if (outlen == 8)
+        v1 ^= 0xee;
+
+    for (; in != end; in += 4) {
+        m = load32(in);
+        v3 ^= m;
+        SIPROUND32;
+        SIPROUND32;
+        v0 ^= m;
+    }
+
+    m = 0;
+    memcpy(&m, in, inlen & 3);
+    b |= m;
+
+    v3 ^= b;
+    SIPROUND32;
+    SIPROUND32;
+    v0 ^= b;
+
+    v2 ^= (outlen == 8) ? 0xee : 0xff;
+    SIPROUND32;
+    SIPROUND32;
+    SIPROUND32;
+    SIPROUND32;
+
+    b = v1 ^ v3;
+    memcpy(out, &b, sizeof(b));
+
+    if (outlen == 4)
+        return 0;
+
+    v1 ^= 0xdd;
+    SIPROUND32;
+    SIPROUND32;
+    SIPROUND32;
+    SIPROUND32;
+
+    b = v1 ^ v3;
+    memcpy(out + 4, &b, sizeof(b));
+
+    return 0;
+}
+
+int halfsiphash_multi(const uint8_t *const *in, const size_t *inlen,
+                      const uint8_t *const *k, uint8_t *const *out,
+                      const size_t outlen, const size_t num) {
+
+    size_t i = 0;
+
+    if (QGCryptoUseAVX2()) {
+        for (; i + HALFSIPHASH_AVX2_LANES <= num; i += HALFSIPHASH_AVX2_LANES)
+            halfsiphash_avx2_x8(in + i, inlen + i, k + i, out + i, outlen);
+    }
+
+    for (; i < num; ++i)
+        halfsiphash_opt(in[i], inlen[i], k[i], out[i], outlen);
+
+    return 0;
+}
@@ -85,6 +85,8 @@ namespace QuantumGate::API::Access
 									   const IPFilterType type) noexcept;
 		Result<IPFilterID> AddIPFilter(const IPAddress& ip, const IPAddress& mask,
 									   const IPFilterType type) noexcept;
+		Result<Vector<IPFilterID>> AddIPFilters(const Vector<String>& ip_cidrs,
+												const IPFilterType type) noexcept;
 
 		Result<> RemoveIPFilter(const IPFilterID filterid, const IPFilterType type) noexcept;
 		void RemoveAllIPFilters() noexcept;
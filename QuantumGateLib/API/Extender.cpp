@@ -81,6 +81,12 @@ namespace QuantumGate::API
 		return m_Extender->SendMessageTo(peer, std::move(buffer), params, std::move(callback));
 	}
 
+	Result<Size> Extender::SendMessageToPeers(const Vector<PeerLUID>& pluids, Buffer&& buffer,
+											  const SendParameters& params) const noexcept
+	{
+		return m_Extender->SendMessageToPeers(pluids, std::move(buffer), params);
+	}
+
 	Size Extender::GetMaximumMessageDataSize() noexcept
 	{
 		return QuantumGate::Implementation::Core::Extender::Extender::GetMaximumMessageDataSize();
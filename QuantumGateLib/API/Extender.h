@@ -38,7 +38,7 @@ namespace QuantumGate::API
 		public:
 			enum class Type : UInt16
 			{
-				Unknown, Connected, Suspended, Resumed, Disconnected, Message
+				Unknown, Connected, Suspended, Resumed, Disconnected, Message, SendBufferAvailable
 			};
 
 			struct Result
@@ -118,6 +118,9 @@ namespace QuantumGate::API
 		Result<> SendMessageTo(Peer& peer, Buffer&& buffer,
 							   const SendParameters& params, SendCallback&& callback = nullptr) const noexcept;
 
+		Result<Size> SendMessageToPeers(const Vector<PeerLUID>& pluids, Buffer&& buffer,
+										const SendParameters& params) const noexcept;
+
 		[[nodiscard]] static Size GetMaximumMessageDataSize() noexcept;
 
 		Result<Peer> GetPeer(const PeerLUID pluid) const noexcept;
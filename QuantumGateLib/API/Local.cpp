@@ -311,6 +311,16 @@ namespace QuantumGate::API
 		return m_Local->GetSecurityParameters();
 	}
 
+	Result<Vector<KeyGenerationStatistics>> Local::GetKeyGenerationStatistics() const noexcept
+	{
+		return m_Local->GetKeyGenerationStatistics();
+	}
+
+	Result<Vector<ExtenderThreadPoolStatistics>> Local::GetExtenderThreadPoolStatistics() const noexcept
+	{
+		return m_Local->GetExtenderThreadPoolStatistics();
+	}
+
 	void Local::FreeUnusedMemory() noexcept
 	{
 		return m_Local->FreeUnusedMemory();
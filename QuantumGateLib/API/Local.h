@@ -157,6 +157,9 @@ namespace QuantumGate::API
 		[[nodiscard]] SecurityLevel GetSecurityLevel() const noexcept;
 		[[nodiscard]] SecurityParameters GetSecurityParameters() const noexcept;
 
+		Result<Vector<KeyGenerationStatistics>> GetKeyGenerationStatistics() const noexcept;
+		Result<Vector<ExtenderThreadPoolStatistics>> GetExtenderThreadPoolStatistics() const noexcept;
+
 		void FreeUnusedMemory() noexcept;
 
 	private:
@@ -65,9 +65,9 @@ namespace QuantumGate::Implementation
 
 			UInt64 hash{ 0 };
 
-			siphash(reinterpret_cast<const uint8_t*>(buffer.GetBytes()), buffer.GetSize(),
-					reinterpret_cast<const uint8_t*>(key.GetBytes()),
-					reinterpret_cast<uint8_t*>(&hash), 8);
+			siphash_opt(reinterpret_cast<const uint8_t*>(buffer.GetBytes()), buffer.GetSize(),
+						reinterpret_cast<const uint8_t*>(key.GetBytes()),
+						reinterpret_cast<uint8_t*>(&hash), 8);
 
 			return hash;
 		}
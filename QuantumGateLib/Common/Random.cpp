@@ -14,28 +14,40 @@ namespace QuantumGate::Implementation
 {
 	Buffer Random::GetPseudoRandomBytes(const Size count)
 	{
-		if (count == 0) return Buffer();
-
-		GetRngEngine().CheckSeed64(count);
+		Buffer bytes;
+		AppendPseudoRandomBytes(bytes, count);
+		return bytes;
+	}
 
-		// How many 64bit integers do we need for the number of requested bytes?
-		const auto num = static_cast<Size>(std::ceil(static_cast<double>(count) /
-													 static_cast<double>(sizeof(UInt64))));
+	void Random::GetPseudoRandomBytes(Byte* buffer, const Size count) noexcept
+	{
+		if (count == 0) return;
 
-		assert(count <= (num * sizeof(UInt64)));
+		auto& rngen = GetRngEngine();
+		rngen.CheckSeedBulk(count);
 
-		Buffer bytes(num * sizeof(UInt64));
-		auto uint64_ptr = reinterpret_cast<UInt64*>(bytes.GetBytes());
+		// Whole steps get written directly into the buffer
+		const auto num = count / BulkRng::StepSize;
+		for (Size x = 0; x < num; ++x)
+		{
+			rngen.RngBulk.Step(buffer + (x * BulkRng::StepSize));
+		}
 
-		// Generate random 64bit integers
-		std::generate(uint64_ptr, uint64_ptr + num,
-					  [&]() -> UInt64
+		if (const auto rem = count % BulkRng::StepSize; rem > 0)
 		{
-			return (GetRngEngine().Rng64)();
-		});
+			std::array<Byte, BulkRng::StepSize> bytes;
+			rngen.RngBulk.Step(bytes.data());
+			std::memcpy(buffer + (num * BulkRng::StepSize), bytes.data(), rem);
+		}
+	}
+
+	void Random::AppendPseudoRandomBytes(Buffer& buffer, const Size count)
+	{
+		if (count == 0) return;
 
-		bytes.Resize(count);
+		const auto offset = buffer.GetSize();
+		buffer.Resize(offset + count);
 
-		return bytes;
+		GetPseudoRandomBytes(buffer.GetBytes() + offset, count);
 	}
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <random>
+#include <bit>
 
 // If NO_PCG_RANDOM is defined during compile time then PCG won't be used;
 // instead the Mersenne Twister engine from std will be used (see further below)
@@ -24,6 +25,65 @@ namespace QuantumGate::Implementation
 		using Rng64Alg = std::mt19937_64;
 #endif
 
+		// Generator for filling buffers with pseudo-random bytes (padding and noise);
+		// runs four interleaved xoshiro256** streams that don't depend on each other so
+		// that the compiler can vectorize them, and produces 32 bytes per step
+		struct BulkRng final
+		{
+			static constexpr Size NumLanes{ 4 };
+			static constexpr Size StepSize{ NumLanes * sizeof(UInt64) };
+
+			alignas(32) std::array<UInt64, NumLanes> S0{ 0 };
+			alignas(32) std::array<UInt64, NumLanes> S1{ 0 };
+			alignas(32) std::array<UInt64, NumLanes> S2{ 0 };
+			alignas(32) std::array<UInt64, NumLanes> S3{ 0 };
+
+			BulkRng(std::random_device& device) noexcept { Seed(device); }
+
+			void Seed(std::random_device& device) noexcept
+			{
+				// Expand the seed with SplitMix64 so that
+				// no lane ends up with an all zero state
+				UInt64 x = (static_cast<UInt64>(device()) << 32) | static_cast<UInt64>(device());
+				const auto next = [&]() noexcept
+				{
+					x += 0x9e3779b97f4a7c15ull;
+					auto z = x;
+					z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+					z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+					return z ^ (z >> 31);
+				};
+
+				for (Size l = 0; l < NumLanes; ++l)
+				{
+					S0[l] = next();
+					S1[l] = next();
+					S2[l] = next();
+					S3[l] = next();
+				}
+			}
+
+			ForceInline void Step(Byte* out) noexcept
+			{
+				alignas(32) std::array<UInt64, NumLanes> result;
+
+				for (Size l = 0; l < NumLanes; ++l)
+				{
+					result[l] = std::rotl(S1[l] * 5, 7) * 9;
+
+					const auto t = S1[l] << 17;
+					S2[l] ^= S0[l];
+					S3[l] ^= S1[l];
+					S1[l] ^= S2[l];
+					S0[l] ^= S3[l];
+					S2[l] ^= t;
+					S3[l] = std::rotl(S3[l], 45);
+				}
+
+				std::memcpy(out, result.data(), StepSize);
+			}
+		};
+
 		struct RngEngine final
 		{
 			std::random_device Device;
@@ -31,6 +91,8 @@ namespace QuantumGate::Implementation
 			UInt64 Rng32Count{ 0 };
 			Rng64Alg Rng64{ Device() };
 			UInt64 Rng64Count{ 0 };
+			BulkRng RngBulk{ Device };
+			UInt64 RngBulkCount{ 0 };
 			static constexpr UInt64 RngEngineReseedLimit{ 2'147'483'648 }; // 2^31
 
 			ForceInline void CheckSeed32(const UInt64 num = 1) noexcept
@@ -70,6 +132,25 @@ namespace QuantumGate::Implementation
 					Rng64Count = 0;
 				}
 			}
+
+			ForceInline void CheckSeedBulk(const UInt64 num) noexcept
+			{
+				if (std::numeric_limits<UInt64>::max() - num >= RngBulkCount)
+				{
+					RngBulkCount += num;
+
+					if (RngBulkCount > RngEngineReseedLimit)
+					{
+						RngBulk.Seed(Device);
+						RngBulkCount = 0;
+					}
+				}
+				else
+				{
+					RngBulk.Seed(Device);
+					RngBulkCount = 0;
+				}
+			}
 		};
 
 		Random() noexcept = default;
@@ -92,6 +173,8 @@ namespace QuantumGate::Implementation
 		}
 
 		static Buffer GetPseudoRandomBytes(const Size count);
+		static void GetPseudoRandomBytes(Byte* buffer, const Size count) noexcept;
+		static void AppendPseudoRandomBytes(Buffer& buffer, const Size count);
 
 	private:
 		ForceInline static RngEngine& GetRngEngine() noexcept
@@ -103,4 +103,136 @@ namespace QuantumGate::Implementation
 	private:
 		SizeType m_CurrentSize{ MinSize };
 	};
+
+	template<typename T, bool NoExcept = true>
+	class DynamicRateLimit final
+	{
+		static_assert(std::is_arithmetic_v<T>, "T should be an arithmetic type.");
+
+	public:
+		using SizeType = T;
+
+		constexpr DynamicRateLimit() noexcept = default;
+
+		template<typename U> requires std::is_arithmetic_v<U>
+		constexpr DynamicRateLimit(const U max_size) noexcept(NoExcept)
+		{
+			SetMaximum(max_size);
+		}
+
+		constexpr DynamicRateLimit(const DynamicRateLimit&) noexcept = default;
+		constexpr DynamicRateLimit(DynamicRateLimit&&) noexcept = default;
+		~DynamicRateLimit() = default;
+		constexpr DynamicRateLimit& operator=(const DynamicRateLimit&) noexcept = default;
+		constexpr DynamicRateLimit& operator=(DynamicRateLimit&&) noexcept = default;
+
+		template<typename U> requires std::is_arithmetic_v<U>
+		constexpr inline void SetMaximum(U max_size) noexcept(NoExcept)
+		{
+			if constexpr (NoExcept)
+			{
+				assert(max_size >= MinSize);
+
+				if (max_size < MinSize) max_size = MinSize;
+			}
+			else
+			{
+				if (max_size < MinSize)
+				{
+					throw std::invalid_argument("Maximum size should be greater than or equal to minimum size.");
+					return;
+				}
+			}
+
+			if constexpr (std::is_integral_v<U> && std::is_integral_v<T>)
+			{
+				// Don't let the value get truncated by the conversion below
+				if (std::cmp_greater(max_size, std::numeric_limits<T>::max()))
+				{
+					if constexpr (NoExcept)
+					{
+						m_MaxSize = std::numeric_limits<T>::max();
+						return;
+					}
+					else
+					{
+						throw std::invalid_argument("Maximum size is out of range.");
+						return;
+					}
+				}
+			}
+
+			// Note that the maximum may be set lower than the current size;
+			// in that case nothing can be added until enough has been subtracted
+			m_MaxSize = static_cast<SizeType>(max_size);
+		}
+
+		template<typename U> requires std::is_arithmetic_v<U>
+		constexpr inline void Add(const U num) noexcept(NoExcept)
+		{
+			if constexpr (NoExcept)
+			{
+				assert(CanAdd(num));
+			}
+			else
+			{
+				if (!CanAdd(num))
+				{
+					throw std::invalid_argument("Value parameter is out of range.");
+					return;
+				}
+			}
+
+			m_CurrentSize += num;
+		}
+
+		template<typename U> requires std::is_arithmetic_v<U>
+		[[nodiscard]] constexpr inline bool CanAdd(const U num) const noexcept
+		{
+			return ((m_CurrentSize + num >= MinSize) && (m_CurrentSize + num <= m_MaxSize));
+		}
+
+		[[nodiscard]] constexpr inline SizeType GetAvailable() const noexcept
+		{
+			return (m_CurrentSize < m_MaxSize) ? (m_MaxSize - m_CurrentSize) : SizeType{ 0 };
+		}
+
+		template<typename U> requires std::is_arithmetic_v<U>
+		constexpr inline void Subtract(const U num) noexcept(NoExcept)
+		{
+			if constexpr (NoExcept)
+			{
+				assert(CanSubtract(num));
+			}
+			else
+			{
+				if (!CanSubtract(num))
+				{
+					throw std::invalid_argument("Value parameter is out of range.");
+					return;
+				}
+			}
+
+			m_CurrentSize -= num;
+		}
+
+		template<typename U> requires std::is_arithmetic_v<U>
+		[[nodiscard]] constexpr inline bool CanSubtract(const U num) const noexcept
+		{
+			// Subtracting is allowed above the maximum so that the
+			// current size can come back down after the maximum was lowered
+			return ((m_CurrentSize - num >= MinSize) && (m_CurrentSize - num <= std::max(m_MaxSize, m_CurrentSize)));
+		}
+
+		[[nodiscard]] constexpr inline SizeType GetCurrent() const noexcept { return m_CurrentSize; }
+		[[nodiscard]] constexpr inline SizeType GetMinimum() const noexcept { return MinSize; }
+		[[nodiscard]] constexpr inline SizeType GetMaximum() const noexcept { return m_MaxSize; }
+
+	private:
+		static constexpr SizeType MinSize{ std::numeric_limits<T>::min() };
+
+	private:
+		SizeType m_CurrentSize{ MinSize };
+		SizeType m_MaxSize{ std::numeric_limits<T>::max() };
+	};
 }
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include <openssl/buffer.h>
 
 #include <combaseapi.h>
+#include <bit>
 
 namespace QuantumGate::Implementation::Util
 {
@@ -476,6 +477,75 @@ namespace QuantumGate::Implementation::Util
 		return numthreadsperpool;
 	}
 
+	std::optional<ThreadAffinity> GetThreadPoolAffinity(const bool enabled, const bool separate_workloads,
+														const ThreadPoolWorkload workload, const Size threadpool_index) noexcept
+	{
+		if (!enabled) return std::nullopt;
+
+		ULONG highest_node{ 0 };
+		if (!GetNumaHighestNodeNumber(&highest_node)) return std::nullopt;
+
+		// Get the processors of each NUMA node; a system
+		// without NUMA has a single node with all processors
+		std::array<std::pair<UInt16, GROUP_AFFINITY>, 64> nodes{};
+		Size num_nodes{ 0 };
+
+		for (ULONG node = 0; node <= highest_node && num_nodes < nodes.size(); ++node)
+		{
+			GROUP_AFFINITY node_affinity{};
+			if (GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &node_affinity) && node_affinity.Mask != 0)
+			{
+				nodes[num_nodes++] = { static_cast<UInt16>(node), node_affinity };
+			}
+		}
+
+		if (num_nodes == 0) return std::nullopt;
+
+		// Thread pools get spread over the nodes
+		const auto& [node, node_affinity] = nodes[threadpool_index % num_nodes];
+
+		ThreadAffinity affinity{
+			.Node = node,
+			.Group = node_affinity.Group,
+			.Mask = static_cast<UInt64>(node_affinity.Mask)
+		};
+
+		if (separate_workloads)
+		{
+			// A quarter of the processors of the node (at least one) is for
+			// cryptographic work and the rest for I/O so that the one doesn't
+			// take processor time (and caches) away from the other
+			const auto num_procs = std::popcount(affinity.Mask);
+			if (num_procs > 1)
+			{
+				const auto num_crypto_procs = std::max(num_procs / 4, 1);
+
+				auto io_mask = affinity.Mask;
+				UInt64 crypto_mask{ 0 };
+
+				for (auto x = 0; x < num_crypto_procs; ++x)
+				{
+					const auto bit = UInt64{ 1 } << (63 - std::countl_zero(io_mask));
+					crypto_mask |= bit;
+					io_mask &= ~bit;
+				}
+
+				affinity.Mask = (workload == ThreadPoolWorkload::Crypto) ? crypto_mask : io_mask;
+			}
+		}
+
+		return affinity;
+	}
+
+	Export bool SetCurrentThreadAffinity(const ThreadAffinity& affinity) noexcept
+	{
+		GROUP_AFFINITY group_affinity{};
+		group_affinity.Group = affinity.Group;
+		group_affinity.Mask = static_cast<KAFFINITY>(affinity.Mask);
+
+		return (SetThreadGroupAffinity(GetCurrentThread(), &group_affinity, nullptr) != 0);
+	}
+
 	Export Int64 GetPseudoRandomNumber() noexcept
 	{
 		return Random::GetPseudoRandomNumber();
@@ -491,6 +561,11 @@ namespace QuantumGate::Implementation::Util
 		return Random::GetPseudoRandomBytes(count);
 	}
 
+	Export void GetPseudoRandomBytes(Byte* buffer, const Size count) noexcept
+	{
+		Random::GetPseudoRandomBytes(buffer, count);
+	}
+
 	Export String GetSystemErrorString(const int code) noexcept
 	{
 		const auto error = std::error_code(code, std::system_category());
@@ -120,9 +120,23 @@ namespace QuantumGate::Implementation::Util
 	Size GetNumThreadPools(const Size min_threadpools, const Size max_threadpools, const Size min_req_threadpools) noexcept;
 	Size GetNumThreadsPerPool(const Size min_threads_per_pool, const Size max_threads_per_pool, const Size min_req_thread_per_pool) noexcept;
 
+	enum class ThreadPoolWorkload { IO, Crypto };
+
+	struct ThreadAffinity final
+	{
+		UInt16 Node{ 0 };
+		UInt16 Group{ 0 };
+		UInt64 Mask{ 0 };
+	};
+
+	std::optional<ThreadAffinity> GetThreadPoolAffinity(const bool enabled, const bool separate_workloads,
+														const ThreadPoolWorkload workload, const Size threadpool_index) noexcept;
+	Export bool SetCurrentThreadAffinity(const ThreadAffinity& affinity) noexcept;
+
 	Export Int64 GetPseudoRandomNumber() noexcept;
 	Export Int64 GetPseudoRandomNumber(const Int64 min, const Int64 max) noexcept;
 	Export Buffer GetPseudoRandomBytes(const Size count);
+	Export void GetPseudoRandomBytes(Byte* buffer, const Size count) noexcept;
 
 	Export String GetSystemErrorString(const int code) noexcept;
 
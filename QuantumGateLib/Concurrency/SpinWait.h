@@ -0,0 +1,35 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+#include <chrono>
+
+namespace QuantumGate::Implementation::Concurrency
+{
+	// Repeatedly calls the function until it returns true or the spin budget
+	// is used up; returns true if the function returned true. Meant for worker
+	// threads that poll for work for a short while before going to sleep, to
+	// avoid the (timer resolution dependent) latency of waking up again.
+	template<typename F>
+	[[nodiscard]] bool SpinWait(const std::chrono::nanoseconds budget, F&& function) noexcept(noexcept(function()))
+	{
+		const auto end = std::chrono::steady_clock::now() + budget;
+
+		while (true)
+		{
+			if (function()) return true;
+
+			// Checking the time is relatively expensive
+			// so only do it every so many spins
+			for (int spin_count = 0; spin_count < 16; ++spin_count)
+			{
+				_mm_pause();
+			}
+
+			if (std::chrono::steady_clock::now() >= end) break;
+		}
+
+		return false;
+	}
+}
\ No newline at end of file
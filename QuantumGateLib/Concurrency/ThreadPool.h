@@ -10,12 +10,38 @@
 #include "..\Common\Util.h"
 
 #include <thread>
+#include <mutex>
+#include <concepts>
 
 namespace QuantumGate::Implementation::Concurrency
 {
 	struct NoThreadPoolData final {};
 	struct NoThreadData final {};
 
+	// Moving average of the time that work waits in a queue before a worker thread
+	// gets to it; thread pool data that makes it available through a GetQueueLatency()
+	// member function allows the thread pool to grow when work waits too long
+	class QueueLatency final
+	{
+	public:
+		inline void Record(const std::chrono::nanoseconds latency) noexcept
+		{
+			// New samples get a weight of 1/8
+			const auto avg = m_Latency.load(std::memory_order_relaxed);
+			m_Latency.store(avg + ((latency.count() - avg) / 8), std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] inline std::chrono::nanoseconds Get() const noexcept
+		{
+			return std::chrono::nanoseconds(m_Latency.load(std::memory_order_relaxed));
+		}
+
+		inline void Reset() noexcept { m_Latency.store(0, std::memory_order_relaxed); }
+
+	private:
+		std::atomic<Int64> m_Latency{ 0 };
+	};
+
 	template<typename ThPData = NoThreadPoolData, typename ThData = NoThreadData>
 	class ThreadPool final
 	{
@@ -26,6 +52,12 @@ namespace QuantumGate::Implementation::Concurrency
 		template<typename U>
 		static constexpr bool has_thread_data = !std::is_same_v<std::remove_cv_t<std::decay_t<U>>, NoThreadData>;
 
+		template<typename U>
+		static constexpr bool has_queue_latency = requires(const U& data)
+		{
+			{ data.GetQueueLatency() } -> std::convertible_to<std::chrono::nanoseconds>;
+		};
+
 		template<bool thpdata = has_threadpool_data<ThPData>, bool thdata = has_thread_data<ThData>>
 		struct thread_callback
 		{
@@ -103,6 +135,26 @@ namespace QuantumGate::Implementation::Concurrency
 		using ThreadWaitCallbackType = typename thread_wait_callback<>::type;
 		using ThreadWaitInterruptCallbackType = typename thread_wait_interrupt_callback<>::type;
 
+		// Elastic thread pools keep only MinThreads of their threads running; the other
+		// threads get started one by one when work waits in the queue for longer than
+		// MaxQueueLatency on average, and they get retired again when they were (nearly)
+		// idle for IdleRetireDuration
+		struct ElasticSettings final
+		{
+			Size MinThreads{ 1 };
+			std::chrono::nanoseconds MaxQueueLatency{ std::chrono::milliseconds(20) };
+			std::chrono::nanoseconds GrowInterval{ std::chrono::milliseconds(100) };
+			std::chrono::nanoseconds IdleRetireDuration{ std::chrono::seconds(60) };
+		};
+
+		struct Metrics final
+		{
+			Size NumThreads{ 0 };
+			Size NumRunningThreads{ 0 };
+			std::chrono::nanoseconds QueueLatency{ 0 };
+			double Utilization{ 0.0 };
+		};
+
 	private:
 		struct ThreadCtrl final
 		{
@@ -122,6 +174,8 @@ namespace QuantumGate::Implementation::Concurrency
 			ThreadCallbackType ThreadCallback{ nullptr };
 			ThreadWaitCallbackType ThreadWaitCallback{ nullptr };
 			ThreadWaitInterruptCallbackType ThreadWaitInterruptCallback{ nullptr };
+			bool Elastic{ false };
+			std::atomic_bool Retired{ false };
 		};
 
 		using ThreadList = Containers::List<ThreadCtrl>;
@@ -197,6 +251,10 @@ namespace QuantumGate::Implementation::Concurrency
 
 		[[nodiscard]] inline std::pair<bool, std::optional<ThreadType>> RemoveThread(ThreadType&& thread) noexcept
 		{
+			// Elastic thread pools start and retire threads on their own
+			// and their threads may not get removed while running
+			assert(!(IsRunning() && m_Elastic.has_value()));
+
 			if (thread.IsRunning())
 			{
 				StopThread(*(thread.m_ThreadIterator));
@@ -293,14 +351,34 @@ namespace QuantumGate::Implementation::Concurrency
 
 			auto error{ false };
 
-			// Start all threads
+			m_BusyTime = 0;
+			m_IdleTime = 0;
+
+			Size num{ 0 };
+
+			// Start all threads; for elastic thread pools only
+			// the minimum number and the others when needed
 			for (auto& threadctrl : m_Threads)
 			{
-				if (!StartThread(threadctrl)) error = true;
+				threadctrl.Elastic = (m_Elastic.has_value() && num >= m_Elastic->MinThreads);
+				threadctrl.Retired = false;
+
+				if (!threadctrl.Elastic)
+				{
+					if (!StartThread(threadctrl)) error = true;
+				}
+
+				++num;
 			}
 
 			if (error && !HasRunningThreads()) return false;
 
+			{
+				std::scoped_lock lock(m_ElasticMutex);
+				m_ElasticRunning = m_Elastic.has_value();
+				m_LastGrowSteadyTime = Util::GetCurrentSteadyTime();
+			}
+
 			m_Running = true;
 
 			return true;
@@ -312,6 +390,12 @@ namespace QuantumGate::Implementation::Concurrency
 
 			m_Running = false;
 
+			{
+				// Once this is set no more elastic threads get started
+				std::scoped_lock lock(m_ElasticMutex);
+				m_ElasticRunning = false;
+			}
+
 			// Set the shutdown event to notify threads
 			// that we're shutting down
 			for (auto& threadctrl : m_Threads)
@@ -326,6 +410,44 @@ namespace QuantumGate::Implementation::Concurrency
 			}
 		}
 
+		// Processors that the threads get pinned to when they start;
+		// has to get set before the thread pool is started
+		inline void SetAffinity(const std::optional<Util::ThreadAffinity>& affinity) noexcept
+		{
+			assert(!IsRunning());
+
+			m_Affinity = affinity;
+		}
+
+		// Makes the thread pool elastic; has to get set before the thread pool is
+		// started and requires thread pool data that keeps track of queue latency
+		template<typename U = ThPData, typename = std::enable_if_t<has_queue_latency<U>>>
+		inline void SetElastic(const ElasticSettings& settings) noexcept
+		{
+			assert(!IsRunning());
+			assert(settings.MinThreads > 0);
+
+			m_Elastic = settings;
+		}
+
+		[[nodiscard]] Metrics GetMetrics() const noexcept
+		{
+			Metrics metrics;
+			metrics.NumThreads = m_Threads.size();
+			metrics.NumRunningThreads = m_NumRunningThreads.load(std::memory_order_relaxed);
+
+			if constexpr (has_queue_latency<ThPData>)
+			{
+				metrics.QueueLatency = m_Data.GetQueueLatency();
+			}
+
+			const auto busy = static_cast<double>(m_BusyTime.load(std::memory_order_relaxed));
+			const auto idle = static_cast<double>(m_IdleTime.load(std::memory_order_relaxed));
+			if (busy + idle > 0.0) metrics.Utilization = busy / (busy + idle);
+
+			return metrics;
+		}
+
 		template<typename U = ThPData, typename = std::enable_if_t<has_threadpool_data<U>>>
 		inline ThPData& GetData() noexcept { return m_Data; }
 
@@ -340,6 +462,10 @@ namespace QuantumGate::Implementation::Concurrency
 		{
 			assert(thcallback);
 
+			// Elastic thread pools start and retire threads on their own
+			// and may not get threads added while running
+			assert(!(IsRunning() && m_Elastic.has_value()));
+
 			try
 			{
 				auto& threadctrl = m_Threads.emplace_back(thname, std::move(thdata), std::move(thcallback),
@@ -425,6 +551,20 @@ namespace QuantumGate::Implementation::Concurrency
 
 			Util::SetCurrentThreadName(thctrl.ThreadName);
 
+			if (thpool.m_Affinity && !Util::SetCurrentThreadAffinity(*thpool.m_Affinity))
+			{
+				LogWarn(L"Unable to set processor affinity for worker thread \"%s\"", thctrl.ThreadName.c_str());
+			}
+
+			++thpool.m_NumRunningThreads;
+
+			auto wait_begin = std::chrono::steady_clock::now();
+
+			// Time this thread was busy since the beginning of
+			// the current period; used for retiring elastic threads
+			auto period_begin = wait_begin;
+			std::chrono::nanoseconds period_busy{ 0 };
+
 			while (true)
 			{
 				try
@@ -450,6 +590,8 @@ namespace QuantumGate::Implementation::Concurrency
 					// If the shutdown event is set exit the loop
 					if (thctrl.ShutdownEvent.IsSet()) break;
 
+					const auto busy_begin = std::chrono::steady_clock::now();
+
 					// Execute thread function
 					if constexpr (has_threadpool_data<ThPData> && has_thread_data<ThData>)
 					{
@@ -464,6 +606,34 @@ namespace QuantumGate::Implementation::Concurrency
 						thctrl.ThreadCallback(thctrl.ThreadData, thctrl.ShutdownEvent);
 					}
 					else thctrl.ThreadCallback(thctrl.ShutdownEvent);
+
+					const auto busy_end = std::chrono::steady_clock::now();
+					const auto busy = busy_end - busy_begin;
+					const auto idle = busy_begin - wait_begin;
+
+					thpool.m_BusyTime.fetch_add(busy.count(), std::memory_order_relaxed);
+					thpool.m_IdleTime.fetch_add(idle.count(), std::memory_order_relaxed);
+
+					wait_begin = busy_end;
+
+					if (thpool.m_Elastic.has_value())
+					{
+						if (thctrl.Elastic)
+						{
+							period_busy += busy;
+
+							if (busy_end - period_begin >= thpool.m_Elastic->IdleRetireDuration)
+							{
+								// Nearly idle means busy for less than 5% of the time
+								if (period_busy < thpool.m_Elastic->IdleRetireDuration / 20 && thpool.RetireThread(thctrl)) break;
+
+								period_begin = busy_end;
+								period_busy = std::chrono::nanoseconds(0);
+							}
+						}
+
+						thpool.GrowIfNeeded(idle);
+					}
 				}
 				catch (const std::exception& e)
 				{
@@ -477,12 +647,77 @@ namespace QuantumGate::Implementation::Concurrency
 				}
 			}
 
+			--thpool.m_NumRunningThreads;
+
 			LogDbg(L"Worker thread \"%s\" (%u) exiting", thctrl.ThreadName.c_str(), std::this_thread::get_id());
 		}
 
+		[[nodiscard]] bool RetireThread(ThreadCtrl& threadctrl) noexcept
+		{
+			assert(threadctrl.Elastic);
+
+			std::unique_lock lock(m_ElasticMutex, std::try_to_lock);
+			if (!lock.owns_lock() || !m_ElasticRunning) return false;
+
+			LogDbg(L"Retiring idle worker thread \"%s\" (%u)", threadctrl.ThreadName.c_str(), std::this_thread::get_id());
+
+			// The thread exits after this and gets joined
+			// when it's started again or at shutdown
+			threadctrl.Retired = true;
+
+			return true;
+		}
+
+		void GrowIfNeeded(const std::chrono::nanoseconds idle) noexcept
+		{
+			if constexpr (has_queue_latency<ThPData>)
+			{
+				// The queue latency is of the most recent work; a thread that had to wait
+				// for work means none is waiting anymore, so a high value is out of date
+				if (idle > m_Elastic->MaxQueueLatency || m_Data.GetQueueLatency() <= m_Elastic->MaxQueueLatency) return;
+
+				std::unique_lock lock(m_ElasticMutex, std::try_to_lock);
+				if (!lock.owns_lock() || !m_ElasticRunning) return;
+
+				// Start at most one thread per interval so that the
+				// effect of the new thread on the latency can show
+				const auto now = Util::GetCurrentSteadyTime();
+				if (now - m_LastGrowSteadyTime < m_Elastic->GrowInterval) return;
+
+				for (auto& threadctrl : m_Threads)
+				{
+					if (threadctrl.Elastic && (!threadctrl.Thread.joinable() || threadctrl.Retired))
+					{
+						// A retired thread has already exited
+						// or is about to and gets joined first
+						if (threadctrl.Thread.joinable()) threadctrl.Thread.join();
+
+						threadctrl.Retired = false;
+
+						LogDbg(L"Starting worker thread \"%s\" (queue latency %lldus)", threadctrl.ThreadName.c_str(),
+							   std::chrono::duration_cast<std::chrono::microseconds>(m_Data.GetQueueLatency()).count());
+
+						if (StartThread(threadctrl)) m_LastGrowSteadyTime = now;
+
+						break;
+					}
+				}
+			}
+		}
+
 	private:
 		[[no_unique_address]] ThPData m_Data;
 		bool m_Running{ false };
+		std::optional<Util::ThreadAffinity> m_Affinity;
 		ThreadList m_Threads;
+
+		std::optional<ElasticSettings> m_Elastic;
+		std::mutex m_ElasticMutex;
+		bool m_ElasticRunning{ false };
+		SteadyTime m_LastGrowSteadyTime;
+
+		std::atomic<Size> m_NumRunningThreads{ 0 };
+		std::atomic<Int64> m_BusyTime{ 0 };
+		std::atomic<Int64> m_IdleTime{ 0 };
 	};
 }
@@ -47,6 +47,19 @@ namespace QuantumGate::Implementation::Core::Access
 		return result;
 	}
 
+	Result<Vector<IPFilterID>> Manager::AddIPFilters(const Vector<String>& ip_cidrs,
+													 const IPFilterType type) noexcept
+	{
+		auto result = m_IPFilters.WithUniqueLock()->AddFilters(ip_cidrs, type);
+		if (result.Succeeded())
+		{
+			// Only one notification for the entire list
+			m_AccessUpdateCallbacks.WithUniqueLock()();
+		}
+
+		return result;
+	}
+
 	Result<> Manager::RemoveIPFilter(const IPFilterID filterid, const IPFilterType type) noexcept
 	{
 		auto result = m_IPFilters.WithUniqueLock()->RemoveFilter(filterid, type);
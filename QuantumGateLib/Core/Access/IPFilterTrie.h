@@ -0,0 +1,314 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+#include "..\..\Network\BinaryIPAddress.h"
+#include "..\..\Common\Endian.h"
+
+#include <bit>
+
+namespace QuantumGate::Implementation::Core::Access
+{
+	// Path-compressed binary (Patricia) trie of CIDR prefixes with separate roots for IPv4
+	// and IPv6. Lookups walk at most one node per distinct prefix length on the path of the
+	// address, so they're O(prefix length) regardless of the number of prefixes stored.
+	// Nodes live in a single vector and refer to each other by index so that bulk loads
+	// can reserve memory in one go.
+	class IPFilterTrie final
+	{
+		using Index = UInt32;
+		static constexpr Index InvalidIndex{ std::numeric_limits<Index>::max() };
+		static constexpr UInt8 MaxPrefixLength{ 128 };
+
+		// Address bits in host byte order; the first bit of the address
+		// is the most significant bit of High. IPv4 addresses only use the
+		// upper 32 bits of High.
+		struct Key final
+		{
+			UInt64 High{ 0 };
+			UInt64 Low{ 0 };
+		};
+
+		struct Node final
+		{
+			Key Prefix;
+			UInt8 Length{ 0 };
+			UInt32 Count{ 0 }; // Number of filters with exactly this prefix
+			std::array<Index, 2> Children{ InvalidIndex, InvalidIndex };
+		};
+
+	public:
+		using Family = Network::BinaryIPAddress::Family;
+
+		IPFilterTrie() noexcept = default;
+		IPFilterTrie(const IPFilterTrie&) = delete;
+		IPFilterTrie(IPFilterTrie&&) noexcept = default;
+		~IPFilterTrie() = default;
+		IPFilterTrie& operator=(const IPFilterTrie&) = delete;
+		IPFilterTrie& operator=(IPFilterTrie&&) noexcept = default;
+
+		void Reserve(const Size num_prefixes)
+		{
+			// A trie with N prefixes has at most N - 1 branch nodes
+			m_Nodes.reserve(m_Nodes.size() + (num_prefixes * 2));
+			m_FreeNodes.reserve(m_Nodes.capacity());
+		}
+
+		void Insert(const Network::BinaryIPAddress& address, const UInt8 prefix_length)
+		{
+			assert(prefix_length <= GetMaxPrefixLength(address.AddressFamily));
+
+			const auto prefix = GetMasked(MakeKey(address), prefix_length);
+
+			auto& root = GetRoot(address.AddressFamily);
+			auto parent = InvalidIndex;
+			UInt8 side{ 0 };
+			auto idx = root;
+
+			while (idx != InvalidIndex)
+			{
+				const auto node_length = m_Nodes[idx].Length;
+				const auto cpl = GetCommonPrefixLength(m_Nodes[idx].Prefix, prefix,
+													   std::min(node_length, prefix_length));
+				if (cpl < node_length)
+				{
+					// The new prefix either is shorter than the prefix of this node
+					// or diverges from it; in both cases a node goes in between
+					const auto node_bit = GetBit(m_Nodes[idx].Prefix, cpl);
+
+					if (cpl == prefix_length)
+					{
+						const auto nidx = AllocateNode(prefix, prefix_length, 1);
+						m_Nodes[nidx].Children[node_bit] = idx;
+						SetLink(root, parent, side, nidx);
+					}
+					else
+					{
+						const auto bidx = AllocateNode(GetMasked(prefix, cpl), cpl, 0);
+						const auto lidx = AllocateNode(prefix, prefix_length, 1);
+						m_Nodes[bidx].Children[node_bit] = idx;
+						m_Nodes[bidx].Children[node_bit ^ 1] = lidx;
+						SetLink(root, parent, side, bidx);
+					}
+
+					return;
+				}
+
+				if (node_length == prefix_length)
+				{
+					++m_Nodes[idx].Count;
+					return;
+				}
+
+				parent = idx;
+				side = GetBit(prefix, node_length);
+				idx = m_Nodes[idx].Children[side];
+			}
+
+			SetLink(root, parent, side, AllocateNode(prefix, prefix_length, 1));
+		}
+
+		bool Remove(const Network::BinaryIPAddress& address, const UInt8 prefix_length) noexcept
+		{
+			const auto prefix = GetMasked(MakeKey(address), prefix_length);
+
+			auto& root = GetRoot(address.AddressFamily);
+			auto grandparent = InvalidIndex;
+			auto parent = InvalidIndex;
+			UInt8 grandparent_side{ 0 };
+			UInt8 parent_side{ 0 };
+			auto idx = root;
+
+			while (idx != InvalidIndex)
+			{
+				auto& node = m_Nodes[idx];
+
+				if (node.Length > prefix_length ||
+					GetCommonPrefixLength(node.Prefix, prefix, node.Length) < node.Length)
+				{
+					return false;
+				}
+
+				if (node.Length == prefix_length)
+				{
+					if (node.Count == 0) return false;
+
+					if (--node.Count == 0)
+					{
+						// Removing the node may leave its parent as a branch
+						// node with only one child, which then also goes
+						Prune(root, idx, parent, parent_side);
+
+						if (parent != InvalidIndex)
+						{
+							Prune(root, parent, grandparent, grandparent_side);
+						}
+					}
+
+					return true;
+				}
+
+				grandparent = parent;
+				grandparent_side = parent_side;
+				parent = idx;
+				parent_side = GetBit(prefix, node.Length);
+				idx = node.Children[parent_side];
+			}
+
+			return false;
+		}
+
+		[[nodiscard]] bool Contains(const Network::BinaryIPAddress& address) const noexcept
+		{
+			const auto key = MakeKey(address);
+
+			auto idx = GetRoot(address.AddressFamily);
+			while (idx != InvalidIndex)
+			{
+				const auto& node = m_Nodes[idx];
+
+				if (GetCommonPrefixLength(node.Prefix, key, node.Length) < node.Length) return false;
+
+				// The first prefix we encounter on the path already
+				// covers the address; no need to look for longer ones
+				if (node.Count > 0) return true;
+
+				if (node.Length == MaxPrefixLength) break;
+
+				idx = node.Children[GetBit(key, node.Length)];
+			}
+
+			return false;
+		}
+
+		void Clear() noexcept
+		{
+			m_Nodes.clear();
+			m_FreeNodes.clear();
+			m_Roots = { InvalidIndex, InvalidIndex };
+		}
+
+		[[nodiscard]] inline bool IsEmpty() const noexcept
+		{
+			return (m_Roots[0] == InvalidIndex && m_Roots[1] == InvalidIndex);
+		}
+
+		[[nodiscard]] static constexpr UInt8 GetMaxPrefixLength(const Family af) noexcept
+		{
+			return static_cast<UInt8>(Network::BinaryIPAddress::GetNumAddressBytes(af) * 8);
+		}
+
+	private:
+		[[nodiscard]] inline Index& GetRoot(const Family af) noexcept
+		{
+			return m_Roots[af == Family::IPv4 ? 0 : 1];
+		}
+
+		[[nodiscard]] inline Index GetRoot(const Family af) const noexcept
+		{
+			return m_Roots[af == Family::IPv4 ? 0 : 1];
+		}
+
+		[[nodiscard]] Index AllocateNode(const Key& prefix, const UInt8 length, const UInt32 count)
+		{
+			Index idx{ InvalidIndex };
+
+			if (!m_FreeNodes.empty())
+			{
+				idx = m_FreeNodes.back();
+				m_FreeNodes.pop_back();
+				m_Nodes[idx] = Node{ prefix, length, count };
+			}
+			else
+			{
+				if (m_Nodes.size() >= InvalidIndex) throw std::length_error("Too many nodes in IP filter trie.");
+
+				// Keep room in the free list for every node so that
+				// freeing nodes later on never has to allocate
+				if (m_FreeNodes.capacity() <= m_Nodes.size())
+				{
+					m_FreeNodes.reserve(std::max(Size{ 16 }, m_Nodes.size() * 2));
+				}
+
+				idx = static_cast<Index>(m_Nodes.size());
+				m_Nodes.emplace_back(Node{ prefix, length, count });
+			}
+
+			return idx;
+		}
+
+		void FreeNode(const Index idx) noexcept
+		{
+			// Capacity for the free list was reserved when
+			// the node was allocated, so this doesn't throw
+			m_Nodes[idx].Children = { InvalidIndex, InvalidIndex };
+			m_FreeNodes.push_back(idx);
+		}
+
+		inline void SetLink(Index& root, const Index parent, const UInt8 side, const Index idx) noexcept
+		{
+			if (parent == InvalidIndex) root = idx;
+			else m_Nodes[parent].Children[side] = idx;
+		}
+
+		void Prune(Index& root, const Index idx, const Index parent, const UInt8 side) noexcept
+		{
+			const auto& node = m_Nodes[idx];
+			if (node.Count > 0) return;
+
+			const auto left = node.Children[0];
+			const auto right = node.Children[1];
+
+			// Branch nodes with two children stay
+			if (left != InvalidIndex && right != InvalidIndex) return;
+
+			SetLink(root, parent, side, (left != InvalidIndex) ? left : right);
+			FreeNode(idx);
+		}
+
+		[[nodiscard]] static inline Key MakeKey(const Network::BinaryIPAddress& address) noexcept
+		{
+			// Binary IP addresses are stored in network byte order
+			return Key{ Endian::FromNetworkByteOrder(address.UInt64s[0]),
+				Endian::FromNetworkByteOrder(address.UInt64s[1]) };
+		}
+
+		[[nodiscard]] static constexpr Key GetMasked(const Key& key, const UInt8 length) noexcept
+		{
+			if (length == 0) return Key{};
+			else if (length <= 64) return Key{ key.High & (~UInt64{ 0 } << (64 - length)), 0 };
+			else return Key{ key.High, key.Low & (~UInt64{ 0 } << (128 - length)) };
+		}
+
+		[[nodiscard]] static constexpr UInt8 GetBit(const Key& key, const UInt8 pos) noexcept
+		{
+			assert(pos < MaxPrefixLength);
+
+			if (pos < 64) return static_cast<UInt8>((key.High >> (63 - pos)) & 1);
+			else return static_cast<UInt8>((key.Low >> (127 - pos)) & 1);
+		}
+
+		[[nodiscard]] static constexpr UInt8 GetCommonPrefixLength(const Key& key1, const Key& key2,
+																   const UInt8 max_length) noexcept
+		{
+			UInt8 length{ MaxPrefixLength };
+
+			if (const auto diff = key1.High ^ key2.High; diff != 0)
+			{
+				length = static_cast<UInt8>(std::countl_zero(diff));
+			}
+			else if (const auto diff2 = key1.Low ^ key2.Low; diff2 != 0)
+			{
+				length = static_cast<UInt8>(64 + std::countl_zero(diff2));
+			}
+
+			return std::min(length, max_length);
+		}
+
+	private:
+		Vector<Node> m_Nodes;
+		Vector<Index> m_FreeNodes;
+		std::array<Index, 2> m_Roots{ InvalidIndex, InvalidIndex };
+	};
+}
\ No newline at end of file
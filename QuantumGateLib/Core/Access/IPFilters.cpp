@@ -7,7 +7,7 @@
 #include "..\..\Common\Endian.h"
 #include "..\..\Network\Socket.h"
 
-#include <regex>
+#include <bit>
 
 namespace QuantumGate::Implementation::Core::Access
 {
@@ -18,25 +18,17 @@ namespace QuantumGate::Implementation::Core::Access
 		{
 			case IPFilterType::Allowed:
 			case IPFilterType::Blocked:
-				try
-				{
-					// CIDR address notation, "address/leading bits"
-					// e.g. 127.0.0.1/8, 192.168.0.0/16, fc00::/7 etc.
-					// Below regex just splits the CIDR notation into an address and
-					// number of leading bits; the IPAddress class will validate them
-					std::wregex r(LR"r(^\s*(.*)(\/\d+)\s*$)r");
-					std::wcmatch m;
-					if (std::regex_search(ip_cidr, m, r))
-					{
-						return AddFilter(m[1].str().c_str(), m[2].str().c_str(), type);
-					}
-				}
-				catch (...)
+			{
+				IPAddress ip, mask;
+
+				const auto rcode = ParseCIDR(ip_cidr, ip, mask);
+				if (rcode == ResultCode::Succeeded)
 				{
-					LogErr(L"Could not add IP filter: an exception was thrown");
-					return ResultCode::Failed;
+					return AddFilterImpl(ip, mask, type);
 				}
-				break;
+
+				return rcode;
+			}
 			default:
 				assert(false);
 				break;
@@ -91,6 +83,141 @@ namespace QuantumGate::Implementation::Core::Access
 		return ResultCode::InvalidArgument;
 	}
 
+	Result<Vector<IPFilterID>> IPFilters::AddFilters(const Vector<String>& ip_cidrs,
+													 const IPFilterType type) noexcept
+	{
+		auto fltmap = GetFilterMap(type);
+		auto flttrie = GetFilterTrie(type);
+		if (fltmap == nullptr || flttrie == nullptr) return ResultCode::InvalidArgument;
+
+		Vector<IPFilterID> added_ids;
+
+		try
+		{
+			// All entries get parsed before adding any of them so that
+			// an invalid entry in the list leaves the filters unchanged
+			Vector<IPFilterImpl> ipfilters;
+			ipfilters.reserve(ip_cidrs.size());
+
+			for (const auto& ip_cidr : ip_cidrs)
+			{
+				auto& ipfilter = ipfilters.emplace_back();
+
+				const auto rcode = ParseCIDR(ip_cidr.c_str(), ipfilter.Address, ipfilter.Mask);
+				if (rcode != ResultCode::Succeeded) return rcode;
+
+				ipfilter.Type = type;
+				ipfilter.PrefixLength = GetPrefixLength(ipfilter.Mask);
+				ipfilter.ID = GetFilterID(ipfilter.Address, ipfilter.Mask);
+			}
+
+			Vector<IPFilterID> ids;
+			ids.reserve(ipfilters.size());
+			added_ids.reserve(ipfilters.size());
+
+			fltmap->reserve(fltmap->size() + ipfilters.size());
+			flttrie->Reserve(ipfilters.size());
+
+			for (const auto& ipfilter : ipfilters)
+			{
+				ids.emplace_back(ipfilter.ID);
+
+				// Filters that already exist or that occur more than once
+				// in the list are only added once; their ID gets returned
+				// for every occurrence
+				if (fltmap->emplace(ipfilter.ID, ipfilter).second)
+				{
+					try
+					{
+						flttrie->Insert(ipfilter.Address.GetBinary(), ipfilter.PrefixLength);
+					}
+					catch (...)
+					{
+						// Not in the trie, so it only gets removed from the map;
+						// the ID is only recorded for undoing once fully added
+						fltmap->erase(ipfilter.ID);
+						throw;
+					}
+
+					added_ids.emplace_back(ipfilter.ID);
+				}
+			}
+
+			return ids;
+		}
+		catch (...)
+		{
+			LogErr(L"Could not add IP filters: an exception was thrown");
+
+			// Undo what was already added
+			for (const auto id : added_ids)
+			{
+				DiscardReturnValue(RemoveFilter(id, type));
+			}
+		}
+
+		return ResultCode::Failed;
+	}
+
+	ResultCode IPFilters::ParseCIDR(const WChar* ip_cidr, IPAddress& ip, IPAddress& mask) noexcept
+	{
+		try
+		{
+			// CIDR address notation, "address/leading bits"
+			// e.g. 127.0.0.1/8, 192.168.0.0/16, fc00::/7 etc.
+			// The notation gets split by hand into an address and number
+			// of leading bits since this is also used for large bulk loads
+			StringView cidr{ ip_cidr };
+
+			constexpr StringView whitespace{ L" \t\r\n" };
+
+			const auto first = cidr.find_first_not_of(whitespace);
+			if (first != StringView::npos)
+			{
+				cidr = cidr.substr(first, cidr.find_last_not_of(whitespace) - first + 1);
+			}
+
+			const auto pos = cidr.rfind(L'/');
+			if (pos != StringView::npos && pos + 1 < cidr.size() &&
+				std::all_of(cidr.begin() + pos + 1, cidr.end(), [](const WChar c) { return (c >= L'0' && c <= L'9'); }))
+			{
+				const String ip_str{ cidr.substr(0, pos) };
+
+				if (IPAddress::TryParse(ip_str, ip))
+				{
+					UInt bits{ 0 };
+					for (auto it = cidr.begin() + pos + 1; it != cidr.end() && bits <= 128; ++it)
+					{
+						bits = (bits * 10) + static_cast<UInt>(*it - L'0');
+					}
+
+					if (bits <= 128 && IPAddress::CreateMask(ip.GetFamily(), static_cast<UInt8>(bits), mask))
+					{
+						return ResultCode::Succeeded;
+					}
+					else
+					{
+						LogErr(L"Could not add IP filter: Invalid IP address mask %s", String(cidr.substr(pos)).c_str());
+						return ResultCode::AddressMaskInvalid;
+					}
+				}
+				else
+				{
+					LogErr(L"Could not add IP filter: Unrecognized IP address %s", ip_str.c_str());
+					return ResultCode::AddressInvalid;
+				}
+			}
+			else LogErr(L"Could not add IP filter: Invalid CIDR notation %s", ip_cidr);
+		}
+		catch (...)
+		{
+			LogErr(L"Could not add IP filter: an exception was thrown");
+			return ResultCode::Failed;
+		}
+
+		return ResultCode::InvalidArgument;
+	}
+
 	Result<IPFilterID> IPFilters::AddFilterImpl(const IPAddress& ip, const IPAddress& mask,
 												const IPFilterType type) noexcept
 	{
@@ -98,34 +225,39 @@ namespace QuantumGate::Implementation::Core::Access
 		{
 			if (ip.GetFamily() == mask.GetFamily())
 			{
+				// Filters are indexed by prefix so the mask
+				// should consist of contiguous leading bits
+				if (!mask.IsMask())
+				{
+					LogErr(L"Could not add IP filter: Invalid IP address mask %s", mask.GetString().c_str());
+					return ResultCode::AddressMaskInvalid;
+				}
+
 				IPFilterImpl ipfilter;
 				ipfilter.Type = type;
 				ipfilter.Address = ip;
 				ipfilter.Mask = mask;
+				ipfilter.PrefixLength = GetPrefixLength(mask);
 				ipfilter.ID = GetFilterID(ipfilter.Address, ipfilter.Mask);
 
 				if (!HasFilter(ipfilter.ID, type))
 				{
-					const auto range = BinaryIPAddress::GetAddressRange(ipfilter.Address.GetBinary(),
-																		ipfilter.Mask.GetBinary());
-					if (range.has_value())
+					auto fltmap = GetFilterMap(type);
+					auto flttrie = GetFilterTrie(type);
+
+					flttrie->Insert(ipfilter.Address.GetBinary(), ipfilter.PrefixLength);
+
+					try
 					{
-						ipfilter.StartAddress = range->first;
-						ipfilter.EndAddress = range->second;
-
-						switch (ipfilter.Type)
-						{
-							case IPFilterType::Allowed:
-								m_IPAllowFilters[ipfilter.ID] = ipfilter;
-								break;
-							case IPFilterType::Blocked:
-								m_IPBlockFilters[ipfilter.ID] = ipfilter;
-								break;
-						}
-
-						return ipfilter.ID;
+						(*fltmap)[ipfilter.ID] = ipfilter;
 					}
-					else LogErr(L"Could not add IP filter: failed to get IP range");
+					catch (...)
+					{
+						flttrie->Remove(ipfilter.Address.GetBinary(), ipfilter.PrefixLength);
+						throw;
+					}
+
+					return ipfilter.ID;
 				}
 				else LogErr(L"Could not add IP filter: filter already exists");
 			}
@@ -140,22 +272,15 @@ namespace QuantumGate::Implementation::Core::Access
 	{
 		try
 		{
-			IPFilterMap* fltmap{ nullptr };
+			auto fltmap = GetFilterMap(type);
+			auto flttrie = GetFilterTrie(type);
+			if (fltmap == nullptr || flttrie == nullptr) return ResultCode::InvalidArgument;
 
-			switch (type)
+			if (const auto it = fltmap->find(filterid); it != fltmap->end())
 			{
-				case IPFilterType::Allowed:
-					fltmap = &m_IPAllowFilters;
-					break;
-				case IPFilterType::Blocked:
-					fltmap = &m_IPBlockFilters;
-					break;
-				default:
-					return ResultCode::InvalidArgument;
-			}
+				flttrie->Remove(it->second.Address.GetBinary(), it->second.PrefixLength);
+				fltmap->erase(it);
 
-			if (fltmap->erase(filterid) != 0)
-			{
 				return ResultCode::Succeeded;
 			}
 			else LogErr(L"Could not remove IP filter: filter does not exist");
@@ -169,6 +294,8 @@ namespace QuantumGate::Implementation::Core::Access
 	{
 		m_IPAllowFilters.clear();
 		m_IPBlockFilters.clear();
+		m_IPAllowTrie.Clear();
+		m_IPBlockTrie.Clear();
 	}
 
 	bool IPFilters::HasFilter(const IPFilterID filterid, const IPFilterType type) const noexcept
@@ -216,26 +343,40 @@ namespace QuantumGate::Implementation::Core::Access
 		return ResultCode::Failed;
 	}
 
-	bool IPFilters::IsIPInFilterMap(const IPAddress& address, const IPFilterMap& filtermap) const noexcept
+	IPFilterMap* IPFilters::GetFilterMap(const IPFilterType type) noexcept
 	{
-		for (const auto& fltpair : filtermap)
+		switch (type)
 		{
-			const auto& filter = fltpair.second;
+			case IPFilterType::Allowed:
+				return &m_IPAllowFilters;
+			case IPFilterType::Blocked:
+				return &m_IPBlockFilters;
+			default:
+				break;
+		}
 
-			if (filter.Address.GetFamily() == address.GetFamily())
-			{
-				const auto[success, inrange] = BinaryIPAddress::IsInAddressRange(address.GetBinary(),
-																				 filter.StartAddress, filter.EndAddress);
-				if (success && inrange)
-				{
-					// If the IP address was within the filter range of at least one filter
-					// we can stop looking immediately
-					return true;
-				}
-			}
+		return nullptr;
+	}
+
+	IPFilterTrie* IPFilters::GetFilterTrie(const IPFilterType type) noexcept
+	{
+		switch (type)
+		{
+			case IPFilterType::Allowed:
+				return &m_IPAllowTrie;
+			case IPFilterType::Blocked:
+				return &m_IPBlockTrie;
+			default:
+				break;
 		}
 
-		return false;
+		return nullptr;
+	}
+
+	UInt8 IPFilters::GetPrefixLength(const IPAddress& mask) noexcept
+	{
+		const auto& bin_mask = mask.GetBinary();
+		return static_cast<UInt8>(std::popcount(bin_mask.UInt64s[0]) + std::popcount(bin_mask.UInt64s[1]));
 	}
 
 	const IPFilterID IPFilters::GetFilterID(const IPAddress& ip, const IPAddress& mask) const noexcept
@@ -264,7 +405,7 @@ namespace QuantumGate::Implementation::Core::Access
 		// ranges.
 
 		// If the IP address is not in the allowed filter ranges we can return true immediately
-		if (!IsIPInFilterMap(ipaddr, m_IPAllowFilters))
+		if (!m_IPAllowTrie.Contains(ipaddr.GetBinary()))
 		{
 			return false;
 		}
@@ -272,7 +413,7 @@ namespace QuantumGate::Implementation::Core::Access
 		{
 			// If the IP address is in the allowed filter ranges check if it's also in the blocked
 			// filter ranges, in which case it was explicitly blocked
-			if (IsIPInFilterMap(ipaddr, m_IPBlockFilters))
+			if (m_IPBlockTrie.Contains(ipaddr.GetBinary()))
 			{
 				return false;
 			}
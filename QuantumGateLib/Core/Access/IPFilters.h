@@ -7,6 +7,7 @@
 #include "..\..\Common\Containers.h"
 #include "..\..\Network\IPAddress.h"
 #include "..\..\Concurrency\ThreadSafe.h"
+#include "IPFilterTrie.h"
 
 namespace QuantumGate::Implementation::Core::Access
 {
@@ -18,8 +19,7 @@ namespace QuantumGate::Implementation::Core::Access
 		IPFilterType Type{ IPFilterType::Blocked };
 		IPAddress Address;
 		IPAddress Mask;
-		Network::BinaryIPAddress StartAddress; // Network byte order (big endian)
-		Network::BinaryIPAddress EndAddress; // Network byte order (big endian)
+		UInt8 PrefixLength{ 0 };
 	};
 
 	using IPFilterMap = Containers::UnorderedMap<IPFilterID, IPFilterImpl>;
@@ -42,6 +42,8 @@ namespace QuantumGate::Implementation::Core::Access
 									 const IPFilterType type) noexcept;
 		Result<IPFilterID> AddFilter(const IPAddress& ip, const IPAddress& mask,
 									 const IPFilterType type) noexcept;
+		Result<Vector<IPFilterID>> AddFilters(const Vector<String>& ip_cidrs,
+											  const IPFilterType type) noexcept;
 
 		Result<> RemoveFilter(const IPFilterID filterid, const IPFilterType type) noexcept;
 
@@ -58,13 +60,21 @@ namespace QuantumGate::Implementation::Core::Access
 		Result<IPFilterID> AddFilterImpl(const IPAddress& ip, const IPAddress& mask,
 										 const IPFilterType type) noexcept;
 
-		[[nodiscard]] bool IsIPInFilterMap(const IPAddress& address, const IPFilterMap& filtermap) const noexcept;
+		[[nodiscard]] static ResultCode ParseCIDR(const WChar* ip_cidr, IPAddress& ip, IPAddress& mask) noexcept;
+
+		[[nodiscard]] IPFilterMap* GetFilterMap(const IPFilterType type) noexcept;
+		[[nodiscard]] IPFilterTrie* GetFilterTrie(const IPFilterType type) noexcept;
+		[[nodiscard]] static UInt8 GetPrefixLength(const IPAddress& mask) noexcept;
 
 		const IPFilterID GetFilterID(const IPAddress& ip, const IPAddress& mask) const noexcept;
 
 	private:
 		IPFilterMap m_IPAllowFilters;
 		IPFilterMap m_IPBlockFilters;
+
+		// Prefix indexes of the above filters used for lookups
+		IPFilterTrie m_IPAllowTrie;
+		IPFilterTrie m_IPBlockTrie;
 	};
 
 	using IPFilters_ThS = Concurrency::ThreadSafe<IPFilters, std::shared_mutex>;
@@ -88,6 +88,14 @@ namespace QuantumGate::Implementation::Core::Extender
 		return m_Local.load()->SendTo(GetUUID(), m_Running, m_Ready, peer, std::move(buffer), params, std::move(callback));
 	}
 
+	Result<Size> Extender::SendMessageToPeers(const Vector<PeerLUID>& pluids, Buffer&& buffer,
+											  const SendParameters& params) const noexcept
+	{
+		assert(IsRunning());
+
+		return m_Local.load()->SendToPeers(GetUUID(), m_Running, m_Ready, pluids, std::move(buffer), params);
+	}
+
 	Result<API::Peer> Extender::GetPeer(const PeerLUID pluid) const noexcept
 	{
 		assert(IsRunning());
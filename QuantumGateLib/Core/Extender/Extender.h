@@ -60,6 +60,9 @@ namespace QuantumGate::Implementation::Core::Extender
 		Result<> SendMessageTo(API::Peer& peer, Buffer&& buffer,
 							   const SendParameters& params, SendCallback&& callback) const noexcept;
 
+		Result<Size> SendMessageToPeers(const Vector<PeerLUID>& pluids, Buffer&& buffer,
+										const SendParameters& params) const noexcept;
+
 		inline static Size GetMaximumMessageDataSize() noexcept { return Message::MaxMessageDataSize; }
 
 		Result<API::Peer> GetPeer(const PeerLUID pluid) const noexcept;
@@ -6,6 +6,8 @@
 #include "ExtenderManager.h"
 #include "..\Peer\Peer.h"
 
+using namespace std::literals;
+
 namespace QuantumGate::Implementation::Core::Extender
 {
 	Control::Control(const Manager& mgr, const std::shared_ptr<QuantumGate::API::Extender>& extender,
@@ -57,16 +59,17 @@ namespace QuantumGate::Implementation::Core::Extender
 
 		const auto numthreadpools = Util::GetNumThreadPools(settings.Local.Concurrency.Extender.MinThreadPools,
 															settings.Local.Concurrency.Extender.MaxThreadPools, 1u);
-		const auto numthreadsperpool = Util::GetNumThreadsPerPool(settings.Local.Concurrency.Extender.ThreadsPerPool,
-																  settings.Local.Concurrency.Extender.ThreadsPerPool, 1u);
+		const auto numthreadsperpool = Util::GetNumThreadsPerPool(settings.Local.Concurrency.Extender.MinThreadsPerPool,
+																  settings.Local.Concurrency.Extender.MaxThreadsPerPool, 1u);
+		const auto minthreadsperpool = std::clamp(settings.Local.Concurrency.Extender.MinThreadsPerPool,
+												  Size{ 1 }, numthreadsperpool);
 
 		// Must have at least one thread pool, and at least one thread per pool 
 		assert(numthreadpools > 0 && numthreadsperpool > 0);
 
-		LogSys(L"Creating %zu extender %s with %zu worker %s %s",
+		LogSys(L"Creating %zu extender %s with %zu to %zu worker threads %s",
 			   numthreadpools, numthreadpools > 1 ? L"threadpools" : L"threadpool",
-			   numthreadsperpool, numthreadsperpool > 1 ? L"threads" : L"thread",
-			   numthreadpools > 1 ? L"each" : L"");
+			   minthreadsperpool, numthreadsperpool, numthreadpools > 1 ? L"each" : L"");
 
 		auto error = false;
 
@@ -90,6 +93,21 @@ namespace QuantumGate::Implementation::Core::Extender
 					}
 				}
 
+				if (minthreadsperpool < numthreadsperpool)
+				{
+					// Threads above the minimum only run when there's enough work
+					thpool->SetElastic({
+						.MinThreads = minthreadsperpool,
+						.MaxQueueLatency = settings.Local.Concurrency.ElasticThreadPools.MaxQueueLatency,
+						.GrowInterval = settings.Local.Concurrency.ElasticThreadPools.GrowInterval,
+						.IdleRetireDuration = settings.Local.Concurrency.ElasticThreadPools.IdleRetireDuration
+					});
+				}
+
+				thpool->SetAffinity(Util::GetThreadPoolAffinity(settings.Local.Concurrency.Affinity.Enabled,
+																settings.Local.Concurrency.Affinity.SeparateIOAndCrypto,
+																Util::ThreadPoolWorkload::IO, i));
+
 				if (!error && thpool->Startup())
 				{
 					data->ThreadPools[i] = std::move(thpool);
@@ -116,14 +134,36 @@ namespace QuantumGate::Implementation::Core::Extender
 			thpool.second->Shutdown();
 			thpool.second->Clear();
 			thpool.second->GetData().Queue.Clear();
+			thpool.second->GetData().QueueLatency.Reset();
 		}
 
 		ResetState(*data);
 	}
 
+	void Control::GetThreadPoolStatistics(Vector<ExtenderThreadPoolStatistics>& stats) const
+	{
+		auto data = m_Data.WithSharedLock();
+		if (data->Extender == nullptr) return;
+
+		for (const auto& thpool : data->ThreadPools)
+		{
+			const auto metrics = thpool.second->GetMetrics();
+
+			auto& thp_stats = stats.emplace_back();
+			thp_stats.ExtenderUUID = data->Extender->GetUUID();
+			thp_stats.NumThreads = metrics.NumThreads;
+			thp_stats.NumRunningThreads = metrics.NumRunningThreads;
+			thp_stats.NumPeers = thpool.second->GetData().PeerCount;
+			thp_stats.QueueLatency = std::chrono::duration_cast<std::chrono::microseconds>(metrics.QueueLatency);
+			thp_stats.Utilization = metrics.Utilization;
+		}
+	}
+
 	void Control::WorkerThreadWait(ThreadPoolData& thpdata, const Concurrency::Event& shutdown_event)
 	{
-		thpdata.Queue.Wait(shutdown_event);
+		// Waiting with a timeout lets idle worker threads of
+		// elastic thread pools notice that they can get retired
+		thpdata.Queue.Wait(1s, shutdown_event);
 	}
 
 	void Control::WorkerThreadWaitInterrupt(ThreadPoolData& thpdata)
@@ -154,6 +194,9 @@ namespace QuantumGate::Implementation::Core::Extender
 				Core::Peer::Event event;
 				peerctrl->WithUniqueLock([&](Peer& peer)
 				{
+					// Time spent in the queue, taken on the first pass
+					if (num == 0) thpdata.QueueLatency.Record(Util::GetCurrentSteadyTime() - peer.QueuedSteadyTime);
+
 					if (!peer.EventQueue.empty())
 					{
 						event = std::move(peer.EventQueue.front());
@@ -209,6 +252,7 @@ namespace QuantumGate::Implementation::Core::Extender
 				if (!peer.EventQueue.empty() ||
 					(!peer.MessageQueue.empty() && peer.Status == Peer::Status::Connected))
 				{
+					peer.QueuedSteadyTime = Util::GetCurrentSteadyTime();
 					thpdata.Queue.Push(peerctrl);
 				}
 				else peer.IsInQueue = false;
@@ -296,6 +340,7 @@ namespace QuantumGate::Implementation::Core::Extender
 
 				if (!peer.IsInQueue)
 				{
+					peer.QueuedSteadyTime = Util::GetCurrentSteadyTime();
 					data->ThreadPools[thpoolkey]->GetData().Queue.Push(peerctrl,
 																	   [&]() noexcept { peer.IsInQueue = true; });
 				}
@@ -46,6 +46,7 @@ namespace QuantumGate::Implementation::Core::Extender
 			Containers::Queue<Core::Peer::Event> MessageQueue;
 
 			bool IsInQueue{ false };
+			SteadyTime QueuedSteadyTime;
 			const ThreadPoolKey ThreadPoolKey{ 0 };
 			std::atomic<Size>& ThreadPoolPeerCount;
 		};
@@ -62,11 +63,14 @@ namespace QuantumGate::Implementation::Core::Extender
 			Extender* const ExtenderPointer{ nullptr };
 
 			Queue_ThS Queue;
+			Concurrency::QueueLatency QueueLatency;
 			std::atomic<Size> PeerCount{ 0 };
 
 			ThreadPoolData(const Manager& mgr, Extender* extender_ptr) noexcept :
 				ExtenderManager(mgr), ExtenderPointer(extender_ptr)
 			{}
+
+			[[nodiscard]] inline std::chrono::nanoseconds GetQueueLatency() const noexcept { return QueueLatency.Get(); }
 		};
 
 		using ThreadPool = Concurrency::ThreadPool<ThreadPoolData>;
@@ -142,6 +146,8 @@ namespace QuantumGate::Implementation::Core::Extender
 		[[nodiscard]] bool StartupExtenderThreadPools() noexcept;
 		void ShutdownExtenderThreadPools() noexcept;
 
+		void GetThreadPoolStatistics(Vector<ExtenderThreadPoolStatistics>& stats) const;
+
 	private:
 		void PreStartupExtenderThreadPools(Data& data) noexcept;
 		void ResetState(Data& data) noexcept;
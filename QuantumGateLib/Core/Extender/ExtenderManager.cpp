@@ -586,6 +586,27 @@ namespace QuantumGate::Implementation::Core::Extender
 		return retval;
 	}
 
+	Result<Vector<ExtenderThreadPoolStatistics>> Manager::GetThreadPoolStatistics() const noexcept
+	{
+		try
+		{
+			Vector<ExtenderThreadPoolStatistics> stats;
+
+			m_Extenders.WithSharedLock([&](const ExtenderMap& extenders)
+			{
+				for (const auto& it : extenders)
+				{
+					it.second->GetThreadPoolStatistics(stats);
+				}
+			});
+
+			return stats;
+		}
+		catch (...) {}
+
+		return ResultCode::Failed;
+	}
+
 	const Settings& Manager::GetSettings() const noexcept
 	{
 		return m_Settings.GetCache();
@@ -596,7 +617,8 @@ namespace QuantumGate::Implementation::Core::Extender
 		assert(event.GetType() == Peer::Event::Type::Connected ||
 			   event.GetType() == Peer::Event::Type::Suspended ||
 			   event.GetType() == Peer::Event::Type::Resumed ||
-			   event.GetType() == Peer::Event::Type::Disconnected);
+			   event.GetType() == Peer::Event::Type::Disconnected ||
+			   event.GetType() == Peer::Event::Type::SendBufferAvailable);
 
 		m_Extenders.WithSharedLock([&](const ExtenderMap& extenders) noexcept
 		{
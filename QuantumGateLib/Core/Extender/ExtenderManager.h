@@ -58,6 +58,8 @@ namespace QuantumGate::Implementation::Core::Extender
 
 		const ActiveExtenderUUIDs& GetActiveExtenderUUIDs() const noexcept;
 
+		Result<Vector<ExtenderThreadPoolStatistics>> GetThreadPoolStatistics() const noexcept;
+
 		inline ExtenderUpdateCallbacks_ThS& GetExtenderUpdateCallbacks() noexcept { return m_ExtenderUpdateCallbacks; }
 
 	private:
@@ -11,12 +11,22 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 {
 	struct KeyQueue final
 	{
-		KeyQueue(const Algorithm::Asymmetric alg) noexcept : Algorithm(alg) {}
+		KeyQueue(const Algorithm::Asymmetric alg, const Size target_size, const SteadyTime time) noexcept :
+			Algorithm(alg), TargetSize(target_size), DemandWindowStart(time)
+		{}
 
 		Algorithm::Asymmetric Algorithm{ Algorithm::Asymmetric::Unknown };
 		Containers::Queue<Crypto::AsymmetricKeyData> Queue;
 		Size NumPendingEvents{ 0 };
 		bool Active{ true };
+
+		Size TargetSize{ 0 };										// Number of keys to keep pregenerated; adapts to demand
+		Size NumRequestsInWindow{ 0 };								// Number of keys requested since DemandWindowStart
+		SteadyTime DemandWindowStart;
+		double RequestRate{ 0.0 };									// Moving average of keys requested per second
+		std::chrono::microseconds GenerationTime{ 0 };				// Moving average of the time it takes to generate a key
+		UInt64 NumHits{ 0 };										// Number of requests for which a pregenerated key was available
+		UInt64 NumMisses{ 0 };										// Number of requests for which no pregenerated key was available
 	};
 
 	using KeyQueue_ThS = Concurrency::ThreadSafe<KeyQueue, Concurrency::SpinMutex>;
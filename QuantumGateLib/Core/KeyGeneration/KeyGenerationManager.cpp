@@ -56,6 +56,16 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 
 		ShutdownThreadPool();
 
+		if (const auto result = GetStatistics(); result.Succeeded())
+		{
+			for (const auto& stats : *result)
+			{
+				LogDbg(L"Keymanager statistics for algorithm %s: %llu hits, %llu misses, %zu/%zu keys, %.2lf requests/s, %lldus generation time",
+					   Crypto::GetAlgorithmName(stats.Algorithm), stats.NumHits, stats.NumMisses, stats.NumPreGeneratedKeys,
+					   stats.TargetNumPreGeneratedKeys, stats.RequestRate, stats.GenerationTime.count());
+			}
+		}
+
 		ResetState();
 
 		LogSys(L"Keymanager shut down");
@@ -91,6 +101,8 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 						   algs2.begin(), algs2.end(),
 						   std::back_inserter(dstalgs));
 
+			const auto now = Util::GetCurrentSteadyTime();
+
 			m_KeyQueues.WithUniqueLock([&](KeyQueueMap& queues)
 			{
 				for (const auto alg : dstalgs)
@@ -98,7 +110,7 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 					LogDbg(L"Keymanager adding key queue for algorithm %s", Crypto::GetAlgorithmName(alg));
 
 					[[maybe_unused]] const auto [it, inserted] =
-						queues.insert({ alg, std::make_unique<KeyQueue_ThS>(alg) });
+						queues.insert({ alg, std::make_unique<KeyQueue_ThS>(alg, settings.Local.NumPreGeneratedKeysPerAlgorithm, now) });
 
 					assert(inserted);
 					if (!inserted)
@@ -125,6 +137,48 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 		m_KeyQueues.WithUniqueLock()->clear();
 	}
 
+	void Manager::UpdateTargetSize(KeyQueue& key_queue, const Size min_size, const Size max_size,
+								   const SteadyTime current_steadytime) noexcept
+	{
+		const auto elapsed = current_steadytime - key_queue.DemandWindowStart;
+		if (elapsed >= DemandSampleInterval)
+		{
+			const auto seconds = std::chrono::duration<double>(elapsed).count();
+			const auto rate = static_cast<double>(key_queue.NumRequestsInWindow) / seconds;
+
+			if (rate > key_queue.RequestRate)
+			{
+				// Follow increases in demand right away so that bursts
+				// don't drain the queue before it has grown
+				key_queue.RequestRate = rate;
+			}
+			else
+			{
+				// Decrease slowly; the weight of the sample depends on the length of the
+				// window so that the average doesn't depend on how often it gets updated
+				const auto alpha = 1.0 - std::exp(-seconds / std::chrono::duration<double>(DemandTimeConstant).count());
+				key_queue.RequestRate += alpha * (rate - key_queue.RequestRate);
+			}
+
+			key_queue.NumRequestsInWindow = 0;
+			key_queue.DemandWindowStart = current_steadytime;
+		}
+
+		// Number of keys that get requested while a new key is being generated
+		const auto demand = key_queue.RequestRate *
+			std::chrono::duration<double>(key_queue.GenerationTime).count() * DemandHeadroomFactor;
+
+		const auto target_size = std::clamp(static_cast<Size>(std::min(std::ceil(demand), static_cast<double>(max_size))),
+											min_size, max_size);
+		if (target_size != key_queue.TargetSize)
+		{
+			LogDbg(L"Keymanager changing number of pregenerated keys for algorithm %s from %zu to %zu (%.2lf requests/s)",
+				   Crypto::GetAlgorithmName(key_queue.Algorithm), key_queue.TargetSize, target_size, key_queue.RequestRate);
+
+			key_queue.TargetSize = target_size;
+		}
+	}
+
 	bool Manager::StartupThreadPool() noexcept
 	{
 		const auto& settings = GetSettings();
@@ -169,6 +223,10 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 			}
 		}
 
+		m_ThreadPool.SetAffinity(Util::GetThreadPoolAffinity(settings.Local.Concurrency.Affinity.Enabled,
+															 settings.Local.Concurrency.Affinity.SeparateIOAndCrypto,
+															 Util::ThreadPoolWorkload::Crypto, 0));
+
 		if (!error && m_ThreadPool.Startup())
 		{
 			return true;
@@ -196,6 +254,8 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 			{
 				it->second->WithUniqueLock([&](KeyQueue& key_queue)
 				{
+					++key_queue.NumRequestsInWindow;
+
 					if (!key_queue.Queue.empty())
 					{
 						// Get the first keypair and
@@ -203,10 +263,13 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 						keydata = std::move(key_queue.Queue.front());
 						key_queue.Queue.pop();
 
-						// Set event to generate more keys and
-						// fill the queue again
-						m_ThreadPool.GetData().PrimaryThreadEvent.Set();
+						++key_queue.NumHits;
 					}
+					else ++key_queue.NumMisses;
+
+					// Set event to generate more keys and fill the
+					// queue again, growing it if demand went up
+					m_ThreadPool.GetData().PrimaryThreadEvent.Set();
 				});
 			}
 		});
@@ -214,9 +277,79 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 		return keydata;
 	}
 
+	void Manager::ReturnAsymmetricKeys(Crypto::AsymmetricKeyData&& keydata) noexcept
+	{
+		if (!IsRunning()) return;
+
+		m_KeyQueues.WithSharedLock([&](const KeyQueueMap& key_queues)
+		{
+			if (const auto it = key_queues.find(keydata.GetAlgorithm()); it != key_queues.end())
+			{
+				it->second->WithUniqueLock([&](KeyQueue& key_queue)
+				{
+					DiscardReturnValue(ReturnToQueue(key_queue, std::move(keydata)));
+				});
+			}
+		});
+	}
+
+	bool Manager::ReturnToQueue(KeyQueue& key_queue, Crypto::AsymmetricKeyData&& keydata) noexcept
+	{
+		if (keydata.GetAlgorithm() != key_queue.Algorithm ||
+			keydata.LocalPrivateKey.IsEmpty() || keydata.LocalPublicKey.IsEmpty() ||
+			key_queue.Queue.size() >= key_queue.TargetSize)
+		{
+			return false;
+		}
+
+		try
+		{
+			key_queue.Queue.emplace(std::move(keydata));
+			return true;
+		}
+		catch (...) {}
+
+		return false;
+	}
+
+	Result<Vector<KeyGenerationStatistics>> Manager::GetStatistics() const noexcept
+	{
+		try
+		{
+			Vector<KeyGenerationStatistics> stats;
+
+			m_KeyQueues.WithSharedLock([&](const KeyQueueMap& queues)
+			{
+				stats.reserve(queues.size());
+
+				for (const auto& it : queues)
+				{
+					it.second->WithUniqueLock([&](const KeyQueue& key_queue)
+					{
+						auto& alg_stats = stats.emplace_back();
+						alg_stats.Algorithm = key_queue.Algorithm;
+						alg_stats.NumPreGeneratedKeys = key_queue.Queue.size();
+						alg_stats.TargetNumPreGeneratedKeys = key_queue.TargetSize;
+						alg_stats.NumHits = key_queue.NumHits;
+						alg_stats.NumMisses = key_queue.NumMisses;
+						alg_stats.RequestRate = key_queue.RequestRate;
+						alg_stats.GenerationTime = key_queue.GenerationTime;
+					});
+				}
+			});
+
+			return stats;
+		}
+		catch (...) {}
+
+		return ResultCode::Failed;
+	}
+
 	void Manager::PrimaryThreadWait(ThreadPoolData& thpdata, const Concurrency::Event& shutdown_event)
 	{
-		thpdata.PrimaryThreadEvent.Wait(shutdown_event);
+		// Wakes up periodically so that the number of pregenerated
+		// keys also adapts when demand goes down
+		thpdata.PrimaryThreadEvent.Wait(DemandSampleInterval, shutdown_event);
 	}
 
 	void Manager::PrimaryThreadWaitInterrupt(ThreadPoolData& thpdata)
@@ -227,6 +360,11 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 	void Manager::PrimaryThreadProcessor(ThreadPoolData& thpdata, const Concurrency::Event& shutdown_event)
 	{
 		auto has_inactive = false;
+		const auto now = Util::GetCurrentSteadyTime();
+
+		const auto& settings = GetSettings();
+		const auto min_size = settings.Local.NumPreGeneratedKeysPerAlgorithm;
+		const auto max_size = std::max(min_size, settings.Local.MaxPreGeneratedKeysPerAlgorithm);
 
 		m_KeyQueues.WithSharedLock([&](const KeyQueueMap& queues)
 		{
@@ -240,23 +378,26 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 				auto active = false;
 				Size queue_size{ 0 };
 				Size num_pending_events{ 0 };
+				Size target_size{ 0 };
 
 				it->second->WithUniqueLock([&](KeyQueue& key_queue)
 				{
 					active = key_queue.Active;
+					if (active) UpdateTargetSize(key_queue, min_size, max_size, now);
+
 					queue_size = key_queue.Queue.size();
 					num_pending_events = key_queue.NumPendingEvents;
+					target_size = key_queue.TargetSize;
 				});
 
 				if (active)
 				{
 					Size numkeys{ 0 };
 					const Size pending{ queue_size + num_pending_events };
-					const Size numpregen{ GetSettings().Local.NumPreGeneratedKeysPerAlgorithm };
 
-					if (pending < numpregen)
+					if (pending < target_size)
 					{
-						numkeys = numpregen - pending;
+						numkeys = target_size - pending;
 					}
 
 					if (numkeys > 0)
@@ -341,9 +482,20 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 
 				Crypto::AsymmetricKeyData keydata(alg);
 
+				const auto begin = Util::GetCurrentSteadyTime();
+
 				if (Crypto::GenerateAsymmetricKeys(keydata))
 				{
-					event.GetQueue()->WithUniqueLock()->Queue.emplace(std::move(keydata));
+					const auto gentime = std::chrono::duration_cast<std::chrono::microseconds>(Util::GetCurrentSteadyTime() - begin);
+
+					event.GetQueue()->WithUniqueLock([&](KeyQueue& key_queue)
+					{
+						key_queue.Queue.emplace(std::move(keydata));
+
+						// Moving average over roughly the last four keys
+						if (key_queue.GenerationTime.count() == 0) key_queue.GenerationTime = gentime;
+						else key_queue.GenerationTime += (gentime - key_queue.GenerationTime) / 4;
+					});
 				}
 				else
 				{
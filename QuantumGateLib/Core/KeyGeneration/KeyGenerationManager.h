@@ -25,6 +25,17 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 
 		using ThreadPool = Concurrency::ThreadPool<ThreadPoolData>;
 
+		// How often the demand for keys gets sampled
+		static constexpr std::chrono::milliseconds DemandSampleInterval{ 1000 };
+
+		// Time constant of the moving average of the demand for keys; shorter
+		// makes the number of pregenerated keys follow bursts more closely
+		static constexpr std::chrono::milliseconds DemandTimeConstant{ 10000 };
+
+		// The number of pregenerated keys covers this many times the number
+		// of keys that get requested while generating a key
+		static constexpr double DemandHeadroomFactor{ 2.0 };
+
 	public:
 		Manager(const Settings_CThS& settings) noexcept;
 		Manager(const Manager&) = delete;
@@ -42,6 +53,21 @@ namespace QuantumGate::Implementation::Core::KeyGeneration
 
 		std::optional<Crypto::AsymmetricKeyData> GetAsymmetricKeys(const Algorithm::Asymmetric alg) noexcept;
 
+		// Puts keys that were obtained but never used back in the queue
+		// so that they're available again for other peers
+		void ReturnAsymmetricKeys(Crypto::AsymmetricKeyData&& keydata) noexcept;
+
+		Result<Vector<KeyGenerationStatistics>> GetStatistics() const noexcept;
+
+		// Updates the demand for keys and the number of keys to keep pregenerated,
+		// which stays between min_size and max_size
+		static void UpdateTargetSize(KeyQueue& key_queue, const Size min_size, const Size max_size,
+									 const SteadyTime current_steadytime) noexcept;
+
+		// Adds returned keys to the queue unless it already has the target number
+		// of keys; returns false when the keys weren't taken and can be discarded
+		[[nodiscard]] static bool ReturnToQueue(KeyQueue& key_queue, Crypto::AsymmetricKeyData&& keydata) noexcept;
+
 	private:
 		void PreStartup() noexcept;
 		void ResetState() noexcept;
@@ -0,0 +1,26 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+#include "..\Network\IPAddress.h"
+
+namespace QuantumGate::Implementation::Core
+{
+	class ListenerShards final
+	{
+	public:
+		ListenerShards() = delete;
+
+		// Data from and connections with the same IP address always go to the same
+		// shard so that state such as connection cookies stays with the shard that created it
+		[[nodiscard]] static inline Size GetIndex(const IPAddress& address, const Size num_shards) noexcept
+		{
+			assert(num_shards > 0);
+
+			if (num_shards <= 1) return 0;
+
+			return (address.GetHash() % num_shards);
+		}
+	};
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Local.h"
 #include "..\Version.h"
 #include "..\Common\ScopeGuard.h"
+#include "Peer\PeerMessageRateLimits.h"
 
 using namespace std::literals;
 
@@ -93,6 +94,46 @@ namespace QuantumGate::Implementation::Core
 			return false;
 		}
 
+		if (params.MaxPreGeneratedKeysPerAlgorithm.has_value() &&
+			*params.MaxPreGeneratedKeysPerAlgorithm < params.NumPreGeneratedKeysPerAlgorithm)
+		{
+			LogErr(L"The maximum number of pregenerated keys per algorithm specified in the initialization parameters is smaller than the initial number of pregenerated keys per algorithm");
+			return false;
+		}
+
+		if (params.PeerBuffers.ExtenderCommunicationSend > Peer::MessageRateLimits::MaximumSize ||
+			params.PeerBuffers.ExtenderCommunicationReceive > Peer::MessageRateLimits::MaximumSize ||
+			params.PeerBuffers.RelayDataSend > Peer::MessageRateLimits::MaximumSize ||
+			params.PeerBuffers.RelayDataReceive > Peer::MessageRateLimits::MaximumSize ||
+			params.PeerBuffers.NoiseSend > Peer::MessageRateLimits::MaximumSize ||
+			params.PeerBuffers.AutoTune.MaxSize > Peer::MessageRateLimits::MaximumSize)
+		{
+			LogErr(L"Invalid buffer size specified in peer buffer parameters; the maximum is %zu bytes",
+				   Peer::MessageRateLimits::MaximumSize);
+			return false;
+		}
+
+		if (params.PeerBuffers.SendBufferAvailableThreshold > 100)
+		{
+			LogErr(L"Invalid send buffer available threshold specified in peer buffer parameters");
+			return false;
+		}
+
+		if (params.PeerBuffers.AutoTune.Enable &&
+			(params.PeerBuffers.AutoTune.TargetDelay <= std::chrono::milliseconds(0) ||
+			 params.PeerBuffers.AutoTune.MaxSize < params.PeerBuffers.ExtenderCommunicationSend ||
+			 params.PeerBuffers.AutoTune.MaxSize < params.PeerBuffers.RelayDataSend))
+		{
+			LogErr(L"Invalid automatic sizing parameters specified in peer buffer parameters");
+			return false;
+		}
+
+		if (params.Listeners.TCP.NumShards == 0 || params.Listeners.UDP.NumShards == 0)
+		{
+			LogErr(L"Invalid number of shards specified in listener parameters");
+			return false;
+		}
+
 		if (params.Relays.IPv4ExcludedNetworksCIDRLeadingBits > 32 ||
 			params.Relays.IPv6ExcludedNetworksCIDRLeadingBits > 128)
 		{
@@ -269,9 +310,11 @@ namespace QuantumGate::Implementation::Core
 				settings.Local.Listeners.TCP.Ports = Util::SetToVector(params.Listeners.TCP.Ports);
 				settings.Local.Listeners.TCP.NATTraversal = params.Listeners.TCP.NATTraversal;
 				settings.Local.Listeners.TCP.UseConditionalAcceptFunction = params.Listeners.TCP.UseConditionalAcceptFunction;
+				settings.Local.Listeners.TCP.NumShards = params.Listeners.TCP.NumShards;
 				
 				settings.Local.Listeners.UDP.Ports = Util::SetToVector(params.Listeners.UDP.Ports);
 				settings.Local.Listeners.UDP.NATTraversal = params.Listeners.UDP.NATTraversal;
+				settings.Local.Listeners.UDP.NumShards = params.Listeners.UDP.NumShards;
 				
 				settings.Local.Listeners.BTH.Ports = Util::SetToVector(params.Listeners.BTH.Ports);
 				settings.Local.Listeners.BTH.RequireAuthentication = params.Listeners.BTH.RequireAuthentication;
@@ -290,6 +333,21 @@ namespace QuantumGate::Implementation::Core
 				}
 				
 				settings.Local.NumPreGeneratedKeysPerAlgorithm = params.NumPreGeneratedKeysPerAlgorithm;
+				settings.Local.MaxPreGeneratedKeysPerAlgorithm =
+					params.MaxPreGeneratedKeysPerAlgorithm.value_or(std::max(Size{ 20 }, params.NumPreGeneratedKeysPerAlgorithm));
+
+				settings.Local.PeerBuffers.ExtenderCommunicationSend = params.PeerBuffers.ExtenderCommunicationSend;
+				settings.Local.PeerBuffers.ExtenderCommunicationReceive = params.PeerBuffers.ExtenderCommunicationReceive;
+				settings.Local.PeerBuffers.RelayDataSend = params.PeerBuffers.RelayDataSend;
+				settings.Local.PeerBuffers.RelayDataReceive = params.PeerBuffers.RelayDataReceive;
+				settings.Local.PeerBuffers.NoiseSend = params.PeerBuffers.NoiseSend;
+				settings.Local.PeerBuffers.SendBufferAvailableThreshold = params.PeerBuffers.SendBufferAvailableThreshold;
+				settings.Local.PeerBuffers.AutoTune.Enabled = params.PeerBuffers.AutoTune.Enable;
+				settings.Local.PeerBuffers.AutoTune.TargetDelay = params.PeerBuffers.AutoTune.TargetDelay;
+				settings.Local.PeerBuffers.AutoTune.MaxSize = params.PeerBuffers.AutoTune.MaxSize;
+
+				settings.Local.Concurrency.BusyPoll.Enabled = params.BusyPoll.Enable;
+				settings.Local.Concurrency.BusyPoll.SpinBudget = params.BusyPoll.SpinBudget;
 				
 				settings.Relay.IPv4ExcludedNetworksCIDRLeadingBits = params.Relays.IPv4ExcludedNetworksCIDRLeadingBits;
 				settings.Relay.IPv6ExcludedNetworksCIDRLeadingBits = params.Relays.IPv6ExcludedNetworksCIDRLeadingBits;
@@ -320,6 +378,12 @@ namespace QuantumGate::Implementation::Core
 			LogWarn(L"QuantumGate is configured to not require peer authentication");
 		}
 
+		if (m_Settings.GetCache().Local.Concurrency.BusyPoll.Enabled)
+		{
+			LogSys(L"Busy polling is enabled (spin budget %jdus)",
+				   m_Settings.GetCache().Local.Concurrency.BusyPoll.SpinBudget.count());
+		}
+
 		if (!StartupThreadPool())
 		{
 			return ResultCode::Failed;
@@ -1332,6 +1396,14 @@ namespace QuantumGate::Implementation::Core
 		return ResultCode::NotRunning;
 	}
 
+	Result<Size> Local::SendToPeers(const ExtenderUUID& uuid, const std::atomic_bool& running, const std::atomic_bool& ready,
+									const Vector<PeerLUID>& pluids, Buffer&& buffer, const SendParameters& params) noexcept
+	{
+		if (IsRunning()) return m_PeerManager.SendToPeers(uuid, running, ready, pluids, std::move(buffer), params);
+
+		return ResultCode::NotRunning;
+	}
+
 	Result<> Local::SetSecurityLevel(const SecurityLevel level,
 									 const std::optional<SecurityParameters>& params, const bool silent) noexcept
 	{
@@ -1709,6 +1781,20 @@ namespace QuantumGate::Implementation::Core
 		settings.UDP.MaxDecoyMessageInterval = 1000ms;
 	}
 
+	Result<Vector<KeyGenerationStatistics>> Local::GetKeyGenerationStatistics() const noexcept
+	{
+		if (IsRunning()) return m_KeyGenerationManager.GetStatistics();
+
+		return ResultCode::NotRunning;
+	}
+
+	Result<Vector<ExtenderThreadPoolStatistics>> Local::GetExtenderThreadPoolStatistics() const noexcept
+	{
+		if (IsRunning()) return m_ExtenderManager.GetThreadPoolStatistics();
+
+		return ResultCode::NotRunning;
+	}
+
 	void Local::FreeUnusedMemory() noexcept
 	{
 		LogDbg(L"Freeing unused memory...");
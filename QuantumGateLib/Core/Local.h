@@ -106,6 +106,9 @@ namespace QuantumGate::Implementation::Core
 		[[nodiscard]] SecurityParameters GetSecurityParameters() const noexcept;
 		void SetDefaultSecuritySettings(Settings& settings) noexcept;
 
+		Result<Vector<KeyGenerationStatistics>> GetKeyGenerationStatistics() const noexcept;
+		Result<Vector<ExtenderThreadPoolStatistics>> GetExtenderThreadPoolStatistics() const noexcept;
+
 		void FreeUnusedMemory() noexcept;
 
 	private:
@@ -138,6 +141,8 @@ namespace QuantumGate::Implementation::Core
 						const PeerLUID id, Buffer&& buffer, const SendParameters& params, SendCallback&& callback) noexcept;
 		Result<> SendTo(const ExtenderUUID& uuid, const std::atomic_bool& running, const std::atomic_bool& ready,
 						API::Peer& peer, Buffer&& buffer, const SendParameters& params, SendCallback&& callback) noexcept;
+		Result<Size> SendToPeers(const ExtenderUUID& uuid, const std::atomic_bool& running, const std::atomic_bool& ready,
+								 const Vector<PeerLUID>& pluids, Buffer&& buffer, const SendParameters& params) noexcept;
 
 		Result<> DisconnectFromImpl(API::Peer& peer) noexcept;
 
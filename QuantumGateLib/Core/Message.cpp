@@ -93,8 +93,10 @@ namespace QuantumGate::Implementation::Core
 		return false;
 	}
 
-	bool Message::Header::Write(Buffer& buffer) const noexcept
+	bool Message::Header::Write(HeaderBuffer& buffer) const noexcept
 	{
+		static_assert(GetMaxSize() <= HeaderBuffer::GetInlineSize(), "Header should fit in inline buffer storage");
+
 		// First 4 bytes are a combination of message size and type
 		// stored in little endian format:
 		// 0bDDDDDDDD'DDDSSSSS'SSSSSSSS'SSSSSSSS
@@ -108,7 +110,7 @@ namespace QuantumGate::Implementation::Core
 
 		Dbg(L"MsgHdr first 4 bytes: 0b%s", Util::ToBinaryString(data).data());
 
-		Memory::BufferWriter wrt(buffer, true);
+		Memory::SmallBufferWriter<HeaderBuffer::GetInlineSize()> wrt(buffer, true);
 
 		if (m_MessageType == MessageType::ExtenderCommunication)
 		{
@@ -132,6 +134,19 @@ namespace QuantumGate::Implementation::Core
 		Initialize(std::move(msgopt));
 	}
 
+	Message::Message(const std::shared_ptr<const SharedMessage>& smsg) noexcept : Message()
+	{
+		assert(smsg != nullptr);
+
+		if (smsg != nullptr && smsg->IsValid())
+		{
+			m_Header = smsg->GetMessage().m_Header;
+			m_UseCompression = smsg->GetMessage().m_UseCompression;
+			m_SharedMessage = smsg;
+			m_Valid = true;
+		}
+	}
+
 	void Message::Initialize(MessageOptions&& msgopt) noexcept
 	{
 		m_UseCompression = msgopt.UseCompression;
@@ -153,6 +168,8 @@ namespace QuantumGate::Implementation::Core
 	{
 		assert(IsValid());
 
+		if (m_SharedMessage != nullptr) return m_SharedMessage->GetMessage().GetMessageData();
+
 		return m_MessageData;
 	}
 
@@ -160,6 +177,9 @@ namespace QuantumGate::Implementation::Core
 	{
 		assert(IsValid());
 
+		// Shared message data can't be moved
+		assert(m_SharedMessage == nullptr);
+
 		return std::move(m_MessageData);
 	}
 
@@ -222,8 +242,11 @@ namespace QuantumGate::Implementation::Core
 		return success;
 	}
 
-	bool Message::Write(Buffer& buffer, const Crypto::SymmetricKeyData& symkey) noexcept
+	bool Message::Write(Memory::PacketBuffer& buffer, const Crypto::SymmetricKeyData& symkey) const noexcept
 	{
+		if (m_SharedMessage != nullptr) return m_SharedMessage->Write(buffer, symkey);
+
+		const auto start_size = buffer.GetSize();
 		const bool hasmsgdata = !m_MessageData.IsEmpty();
 		Buffer tmpdata;
 
@@ -265,13 +288,16 @@ namespace QuantumGate::Implementation::Core
 			}
 		}
 
-		// Add message header
-		if (!msghdr.Write(buffer)) return false;
+		Header::HeaderBuffer hdrbuf;
+		if (!msghdr.Write(hdrbuf)) return false;
 
-		// Add message data if any
-		if (hasmsgdata)
+		try
 		{
-			try
+			// Add message header
+			buffer += hdrbuf;
+
+			// Add message data if any
+			if (hasmsgdata)
 			{
 				if (msghdr.IsCompressed())
 				{
@@ -279,14 +305,19 @@ namespace QuantumGate::Implementation::Core
 				}
 				else buffer += m_MessageData;
 			}
-			catch (...) { return false; }
+		}
+		catch (...)
+		{
+			buffer.RemoveLast(buffer.GetSize() - start_size);
+			return false;
 		}
 
-		if (buffer.GetSize() > MessageTransport::MaxMessageDataSize)
+		if (const auto msg_size = buffer.GetSize() - start_size; msg_size > MessageTransport::MaxMessageDataSize)
 		{
 			LogErr(L"Size of message data is too large: %u bytes (Max. is %u bytes)",
-				   buffer.GetSize(), MessageTransport::MaxMessageDataSize);
+				   msg_size, MessageTransport::MaxMessageDataSize);
 
+			buffer.RemoveLast(msg_size);
 			return false;
 		}
 
@@ -346,6 +377,38 @@ namespace QuantumGate::Implementation::Core
 		m_Valid = true;
 	}
 
+	bool SharedMessage::Write(Memory::PacketBuffer& buffer, const Crypto::SymmetricKeyData& symkey) const noexcept
+	{
+		auto success = false;
+
+		m_EncodedData.WithUniqueLock([&](EncodedDataList& encoded_data) noexcept
+		{
+			const auto ca = symkey.CompressionAlgorithm;
+
+			try
+			{
+				auto it = std::find_if(encoded_data.begin(), encoded_data.end(),
+									   [&](const auto& data) noexcept { return (data.first == ca); });
+				if (it == encoded_data.end())
+				{
+					// First time for this compression algorithm; other peers
+					// using the same algorithm will reuse the result
+					Memory::PacketBuffer encbuf;
+					if (!m_Message.Write(encbuf, symkey)) return;
+
+					it = encoded_data.emplace(encoded_data.end(), ca, encbuf.MoveToBuffer());
+				}
+
+				// Note the copy
+				buffer += it->second;
+				success = true;
+			}
+			catch (...) {}
+		});
+
+		return success;
+	}
+
 	BufferView Message::GetFromBuffer(BufferView& srcbuf) noexcept
 	{
 		// Check if buffer has enough data for message header
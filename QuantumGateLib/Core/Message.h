@@ -6,6 +6,7 @@
 #include "MessageTypes.h"
 #include "MessageTransport.h"
 #include "..\Memory\BufferIO.h"
+#include "..\Concurrency\ThreadSafe.h"
 
 namespace QuantumGate::Implementation::Core
 {
@@ -47,11 +48,16 @@ namespace QuantumGate::Implementation::Core
 		MessageFragmentType Fragment{ MessageFragmentType::Complete };
 	};
 
+	class SharedMessage;
+
 	class Message final
 	{
 		class Header final
 		{
 		public:
+			// Headers are small enough to get written without memory allocation
+			using HeaderBuffer = Memory::SmallBuffer32;
+
 			Header() noexcept {}
 			Header(const Header&) noexcept = default;
 			Header(Header&&) noexcept = default;
@@ -76,7 +82,7 @@ namespace QuantumGate::Implementation::Core
 			Size GetSize() noexcept;
 
 			[[nodiscard]] bool Read(const BufferView& buffer) noexcept;
-			[[nodiscard]] bool Write(Buffer& buffer) const noexcept;
+			[[nodiscard]] bool Write(HeaderBuffer& buffer) const noexcept;
 
 			[[nodiscard]] inline bool IsCompressed() const noexcept
 			{
@@ -123,6 +129,7 @@ namespace QuantumGate::Implementation::Core
 	public:
 		Message() noexcept;
 		Message(MessageOptions&& msgopt) noexcept;
+		Message(const std::shared_ptr<const SharedMessage>& smsg) noexcept;
 		Message(const Message&) = delete;
 		Message(Message&&) noexcept = default;
 		~Message() = default;
@@ -138,7 +145,9 @@ namespace QuantumGate::Implementation::Core
 		Buffer&& MoveMessageData() noexcept;
 
 		[[nodiscard]] bool Read(BufferView buffer, const Crypto::SymmetricKeyData& symkey) noexcept;
-		[[nodiscard]] bool Write(Buffer& buffer, const Crypto::SymmetricKeyData& symkey) noexcept;
+
+		// Appends the encoded message to the buffer
+		[[nodiscard]] bool Write(Memory::PacketBuffer& buffer, const Crypto::SymmetricKeyData& symkey) const noexcept;
 
 		static BufferView GetFromBuffer(BufferView& srcbuf) noexcept;
 
@@ -161,6 +170,39 @@ namespace QuantumGate::Implementation::Core
 		Buffer m_MessageData;
 
 		bool m_UseCompression{ true };
+
+		// When set the message data is shared with
+		// messages for other peers (see SharedMessage)
+		std::shared_ptr<const SharedMessage> m_SharedMessage;
+	};
+
+	// A message that gets sent to multiple peers, such as when broadcasting; the
+	// message data is stored only once and referenced by the messages in the send
+	// queues of the peers. The message gets encoded (and compressed) one time for
+	// each compression algorithm in use by the peers and the result gets reused,
+	// so that the remaining work for each peer is encryption
+	class SharedMessage final
+	{
+		using EncodedDataList = Vector<std::pair<Algorithm::Compression, Buffer>>;
+		using EncodedDataList_ThS = Concurrency::ThreadSafe<EncodedDataList, std::mutex>;
+
+	public:
+		SharedMessage(MessageOptions&& msgopt) noexcept : m_Message(std::move(msgopt)) {}
+		SharedMessage(const SharedMessage&) = delete;
+		SharedMessage(SharedMessage&&) = delete;
+		~SharedMessage() = default;
+		SharedMessage& operator=(const SharedMessage&) = delete;
+		SharedMessage& operator=(SharedMessage&&) = delete;
+
+		[[nodiscard]] inline bool IsValid() const noexcept { return m_Message.IsValid(); }
+
+		inline const Message& GetMessage() const noexcept { return m_Message; }
+
+		[[nodiscard]] bool Write(Memory::PacketBuffer& buffer, const Crypto::SymmetricKeyData& symkey) const noexcept;
+
+	private:
+		Message m_Message;
+		mutable EncodedDataList_ThS m_EncodedData;
 	};
 
 	using RelayMessageID = UInt16;
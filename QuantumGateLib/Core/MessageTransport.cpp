@@ -49,13 +49,15 @@ namespace QuantumGate::Implementation::Core
 		return false;
 	}
 
-	bool MessageTransport::OHeader::Write(Buffer& buffer) const noexcept
+	bool MessageTransport::OHeader::Write(HeaderBuffer& buffer) const noexcept
 	{
+		static_assert(GetSize() <= HeaderBuffer::GetInlineSize(), "Header should fit in inline buffer storage");
+
 		const auto size = ObfuscateMessageDataSize(m_MessageDataSizeSettings, m_MessageRandomBits, m_MessageDataSize);
 
 		const BufferView hmac(m_MessageHMAC);
 
-		Memory::BufferWriter wrt(buffer, true);
+		Memory::SmallBufferWriter<HeaderBuffer::GetInlineSize()> wrt(buffer, true);
 		return wrt.WriteWithPreallocation(size, m_MessageNonceSeed, hmac);
 	}
 
@@ -127,21 +129,28 @@ namespace QuantumGate::Implementation::Core
 		return false;
 	}
 
-	bool MessageTransport::IHeader::Write(Buffer& buffer) const noexcept
+	bool MessageTransport::IHeader::Write(HeaderBuffer& buffer) const noexcept
 	{
 		try
 		{
-			Buffer rnddata;
-			if (m_RandomDataSize > 0)
+			Memory::SmallBufferWriter<HeaderBuffer::GetInlineSize()> wrt(buffer, true);
+			wrt.Preallocate(GetSize() + m_RandomDataSize);
+
+			if (wrt.Write(m_MessageCounter, m_MessageTime, m_NextRandomDataPrefixLength, m_RandomDataSize))
 			{
-				rnddata = Random::GetPseudoRandomBytes(m_RandomDataSize);
+				// Random data gets generated directly into the buffer
+				if (m_RandomDataSize > 0)
+				{
+					const auto offset = buffer.GetSize();
+					buffer.Resize(offset + m_RandomDataSize);
 
-				Dbg(L"MsgTIHdr Random data: %d bytes - %s", rnddata.GetSize(), Util::ToBase64(rnddata)->c_str());
-			}
+					Random::GetPseudoRandomBytes(buffer.GetBytes() + offset, m_RandomDataSize);
 
-			Memory::BufferWriter wrt(buffer, true);
-			return wrt.WriteWithPreallocation(m_MessageCounter, m_MessageTime, m_NextRandomDataPrefixLength,
-											  m_RandomDataSize, rnddata);
+					Dbg(L"MsgTIHdr Random data: %d bytes", m_RandomDataSize);
+				}
+
+				return true;
+			}
 		}
 		catch (...) {}
 
@@ -189,7 +198,7 @@ namespace QuantumGate::Implementation::Core
 		Validate();
 	}
 
-	void MessageTransport::SetMessageData(Buffer&& buffer) noexcept
+	void MessageTransport::SetMessageData(Memory::PacketBuffer&& buffer) noexcept
 	{
 		if (!buffer.IsEmpty())
 		{
@@ -224,7 +233,7 @@ namespace QuantumGate::Implementation::Core
 		}
 	}
 
-	const Buffer& MessageTransport::GetMessageData() const noexcept
+	const Memory::PacketBuffer& MessageTransport::GetMessageData() const noexcept
 	{
 		return m_MessageData;
 	}
@@ -294,13 +303,15 @@ namespace QuantumGate::Implementation::Core
 								// Get message inner header from buffer
 								if (m_IHeader.Read(decrbuf))
 								{
+									Memory::PacketBuffer msgdata(std::move(decrbuf));
+
 									// Remove inner message header and random padding data (if any) from buffer
-									decrbuf.RemoveFirst(IHeader::GetSize() + m_IHeader.GetRandomDataSize());
+									msgdata.RemoveFirst(IHeader::GetSize() + m_IHeader.GetRandomDataSize());
 
 									// Rest of message is message data
-									if (!decrbuf.IsEmpty())
+									if (!msgdata.IsEmpty())
 									{
-										m_MessageData = std::move(decrbuf);
+										m_MessageData = std::move(msgdata);
 									}
 
 									success = true;
@@ -330,54 +341,56 @@ namespace QuantumGate::Implementation::Core
 		return std::make_pair(success, retry);
 	}
 
-	bool MessageTransport::Write(Buffer& buffer, Crypto::SymmetricKeyData& symkey, const BufferView& nonce) noexcept
+	bool MessageTransport::Write(Memory::PacketBuffer& buffer, Crypto::SymmetricKeyData& symkey, const BufferView& nonce) noexcept
 	{
 		assert(!nonce.IsEmpty());
 
 		try
 		{
-			Buffer msgdatabuf;
+			// The message data gets moved into the output buffer and all headers
+			// get added in front of it, so that the message data doesn't get copied
+			auto msgbuffer = std::move(m_MessageData);
 
 			// Add inner message header
-			if (!m_IHeader.Write(msgdatabuf)) return false;
-
-			// Add message data if any
-			if (!m_MessageData.IsEmpty())
 			{
-				msgdatabuf += m_MessageData;
+				IHeader::HeaderBuffer ihdrbuf;
+				if (!m_IHeader.Write(ihdrbuf)) return false;
+
+				msgbuffer.Prepend(ihdrbuf);
 			}
 
-			if (msgdatabuf.GetSize() > (MessageTransport::IHeader::GetSize() + MessageTransport::MaxMessageAndRandomDataSize))
+			if (msgbuffer.GetSize() > (MessageTransport::IHeader::GetSize() + MessageTransport::MaxMessageAndRandomDataSize))
 			{
 				LogErr(L"Size of MessageTransport data combined with random data is too large: %u bytes (Max. is %u bytes)",
-					   msgdatabuf.GetSize(), MessageTransport::MaxMessageAndRandomDataSize);
+					   msgbuffer.GetSize(), MessageTransport::MaxMessageAndRandomDataSize);
 
 				return false;
 			}
 
 			auto msgohdr = m_OHeader;
-			Buffer encrdata;
 
-			// Encrypt message
-			if (Crypto::Encrypt(msgdatabuf, encrdata, symkey, nonce))
+			// Encrypt message in place; the tag goes in front of the encrypted data
+			const auto tag = msgbuffer.Prepend(Crypto::SymmetricKeyData::TagSize);
+			const BufferSpan encrdata(msgbuffer.GetBytes() + tag.GetSize(), msgbuffer.GetSize() - tag.GetSize());
+
+			if (Crypto::Encrypt(encrdata, tag, symkey, nonce))
 			{
-				msgohdr.SetMessageDataSize(encrdata.GetSize());
+				msgohdr.SetMessageDataSize(msgbuffer.GetSize());
 
 				// Calculate HMAC for the encrypted message
-				if (Crypto::HMAC(encrdata, msgohdr.GetHMACBuffer(), symkey.AuthKey, Algorithm::Hash::BLAKE2S256))
+				if (Crypto::HMAC(msgbuffer, msgohdr.GetHMACBuffer(), symkey.AuthKey, Algorithm::Hash::BLAKE2S256))
 				{
 					assert(msgohdr.GetHMACBuffer().GetSize() == OHeader::HMACBuffer::GetMaxSize());
 
 					Dbg(L"MessageTransport hash: %s", Util::ToBase64(msgohdr.GetHMACBuffer())->c_str());
 
-					auto& msgbuffer = msgdatabuf;
-					msgbuffer.Clear();
+					OHeader::HeaderBuffer ohdrbuf;
 
-					// First get the outer message header into the output buffer, then
-					// add inner message header and message data to the output buffer
-					if (msgohdr.Write(msgbuffer))
+					// Add the outer message header in front of the encrypted inner
+					// message header and message data
+					if (msgohdr.Write(ohdrbuf))
 					{
-						msgbuffer += encrdata;
+						msgbuffer.Prepend(ohdrbuf);
 
 						Dbg(L"Send buffer: %d bytes - %s", msgbuffer.GetSize(), Util::ToBase64(msgbuffer)->c_str());
 
@@ -385,11 +398,11 @@ namespace QuantumGate::Implementation::Core
 						{
 							if (m_RandomDataPrefixLength > 0)
 							{
-								buffer.Preallocate(m_RandomDataPrefixLength + msgbuffer.GetSize());
-								buffer += Random::GetPseudoRandomBytes(m_RandomDataPrefixLength);
-								buffer += msgbuffer;
+								auto prefix = msgbuffer.Prepend(m_RandomDataPrefixLength);
+								Random::GetPseudoRandomBytes(prefix.GetBytes(), prefix.GetSize());
 							}
-							else buffer = std::move(msgbuffer);
+
+							buffer = std::move(msgbuffer);
 
 							Dbg(L"Send buffer plus random data prefix: %d bytes - %s",
 								buffer.GetSize(), Util::ToBase64(buffer)->c_str());
@@ -410,6 +423,12 @@ namespace QuantumGate::Implementation::Core
 		return false;
 	}
 
+	Size MessageTransport::GetHeadroomSize(const Settings& settings) noexcept
+	{
+		return settings.Message.MaxRandomDataPrefixSize + OHeader::GetSize() + Crypto::SymmetricKeyData::TagSize +
+			IHeader::GetSize() + settings.Message.MaxInternalRandomDataSize;
+	}
+
 	MessageTransportCheck MessageTransport::Peek(const UInt16 rndp_len, const DataSizeSettings mds_settings,
 												 const Buffer& srcbuf) noexcept
 	{
@@ -5,6 +5,8 @@
 
 #include "..\Crypto\Crypto.h"
 #include "..\Memory\StackBuffer.h"
+#include "..\Memory\SmallBuffer.h"
+#include "..\Memory\PacketBuffer.h"
 
 namespace QuantumGate::Implementation::Core
 {
@@ -30,6 +32,7 @@ namespace QuantumGate::Implementation::Core
 
 		public:
 			using HMACBuffer = Memory::StackBuffer<MessageHMACSize>;
+			using HeaderBuffer = Memory::SmallBuffer64;
 
 			OHeader(const DataSizeSettings mds_settings) noexcept :
 				m_MessageDataSizeSettings(mds_settings)
@@ -44,7 +47,7 @@ namespace QuantumGate::Implementation::Core
 			void Initialize() noexcept;
 
 			[[nodiscard]] bool Read(const BufferView& buffer) noexcept;
-			[[nodiscard]] bool Write(Buffer& buffer) const noexcept;
+			[[nodiscard]] bool Write(HeaderBuffer& buffer) const noexcept;
 
 			static constexpr Size GetSize() noexcept
 			{
@@ -74,6 +77,10 @@ namespace QuantumGate::Implementation::Core
 		class IHeader final
 		{
 		public:
+			// Has room for the header plus the random data with default
+			// settings; more random data spills to allocated memory
+			using HeaderBuffer = Memory::SmallBuffer128;
+
 			IHeader() noexcept {}
 			IHeader(const IHeader&) noexcept = default;
 			IHeader(IHeader&&) noexcept = default;
@@ -84,7 +91,7 @@ namespace QuantumGate::Implementation::Core
 			void Initialize() noexcept;
 
 			[[nodiscard]] bool Read(const BufferView& buffer) noexcept;
-			[[nodiscard]] bool Write(Buffer& buffer) const noexcept;
+			[[nodiscard]] bool Write(HeaderBuffer& buffer) const noexcept;
 
 			static constexpr Size GetSize() noexcept
 			{
@@ -127,8 +134,8 @@ namespace QuantumGate::Implementation::Core
 		inline void SetMessageNonceSeed(UInt32 seed) noexcept { m_OHeader.SetMessageNonceSeed(seed); }
 		inline UInt32 GetMessageNonceSeed() const noexcept { return m_OHeader.GetMessageNonceSeed(); }
 
-		void SetMessageData(Buffer&& buffer) noexcept;
-		const Buffer& GetMessageData() const noexcept;
+		void SetMessageData(Memory::PacketBuffer&& buffer) noexcept;
+		const Memory::PacketBuffer& GetMessageData() const noexcept;
 
 		inline void SetCurrentRandomDataPrefixLength(const UInt16 len) noexcept { m_RandomDataPrefixLength = len; }
 		inline void SetNextRandomDataPrefixLength(const UInt16 len) noexcept { m_IHeader.SetRandomDataPrefixLength(len); }
@@ -139,7 +146,11 @@ namespace QuantumGate::Implementation::Core
 		[[nodiscard]] std::pair<bool, bool> Read(BufferView buffer, Crypto::SymmetricKeyData& symkey,
 												 const BufferView& nonce) noexcept;
 
-		[[nodiscard]] bool Write(Buffer& buffer, Crypto::SymmetricKeyData& symkey, const BufferView& nonce) noexcept;
+		[[nodiscard]] bool Write(Memory::PacketBuffer& buffer, Crypto::SymmetricKeyData& symkey, const BufferView& nonce) noexcept;
+
+		// Returns the headroom message data should have so that
+		// all headers can get added in front of it without copying
+		[[nodiscard]] static Size GetHeadroomSize(const Settings& settings) noexcept;
 
 		static MessageTransportCheck Peek(const UInt16 rndp_len, const DataSizeSettings mds_settings,
 										  const Buffer& srcbuf) noexcept;
@@ -172,7 +183,7 @@ namespace QuantumGate::Implementation::Core
 
 		OHeader m_OHeader;
 		IHeader m_IHeader;
-		Buffer m_MessageData;
+		Memory::PacketBuffer m_MessageData;
 		UInt16 m_RandomDataPrefixLength{ 0 };
 	};
 }
@@ -52,6 +52,8 @@ namespace QuantumGate::Implementation::Core::Peer
 			DisableSend();
 		}
 
+		InitializeBufferSizes(GetSettings());
+
 		auto& shared_secret = GetGlobalSharedSecret();
 
 		// If we have a global shared secret
@@ -121,6 +123,49 @@ namespace QuantumGate::Implementation::Core::Peer
 		else SetFlag(Flags::SendDisabled, false);
 	}
 
+	void Peer::InitializeBufferSizes(const Settings& settings) noexcept
+	{
+		const auto& buffers = settings.Local.PeerBuffers;
+
+		m_RateLimits.SetMaximum<MessageRateLimits::Type::ExtenderCommunicationSend>(buffers.ExtenderCommunicationSend);
+		m_RateLimits.SetMaximum<MessageRateLimits::Type::ExtenderCommunicationReceive>(buffers.ExtenderCommunicationReceive);
+		m_RateLimits.SetMaximum<MessageRateLimits::Type::RelayDataSend>(buffers.RelayDataSend);
+		m_RateLimits.SetMaximum<MessageRateLimits::Type::RelayDataReceive>(buffers.RelayDataReceive);
+		m_RateLimits.SetMaximum<MessageRateLimits::Type::NoiseSend>(buffers.NoiseSend);
+	}
+
+	void Peer::AutoTuneSendBufferSizes(const Settings& settings, const SteadyTime current_steadytime) noexcept
+	{
+		const auto& buffers = settings.Local.PeerBuffers;
+
+		const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(current_steadytime -
+																					 m_SendRateSteadyTime);
+		if (duration < buffers.AutoTune.Interval) return;
+
+		const auto bytes_sent = GetBytesSent();
+
+		if (m_SendRateSteadyTime != SteadyTime{} && duration.count() > 0)
+		{
+			// Size the send buffers so that they can hold the amount of data that
+			// gets sent at the measured rate within the target delay; when a buffer
+			// was the bottleneck the measured rate goes up after the buffer grows,
+			// so the size keeps increasing until the connection itself is the limit
+			const auto rate = static_cast<double>(bytes_sent - m_SendRateBytes) / static_cast<double>(duration.count());
+			const auto size = static_cast<Size>(rate * static_cast<double>(buffers.AutoTune.TargetDelay.count()));
+
+			const auto get_size = [&](const Size min_size) noexcept
+			{
+				return std::min(std::max(size, min_size), std::max(buffers.AutoTune.MaxSize, min_size));
+			};
+
+			m_RateLimits.SetMaximum<MessageRateLimits::Type::ExtenderCommunicationSend>(get_size(buffers.ExtenderCommunicationSend));
+			m_RateLimits.SetMaximum<MessageRateLimits::Type::RelayDataSend>(get_size(buffers.RelayDataSend));
+		}
+
+		m_SendRateSteadyTime = current_steadytime;
+		m_SendRateBytes = bytes_sent;
+	}
+
 	std::chrono::milliseconds Peer::GetHandshakeDelayPerMessage() const noexcept
 	{
 		return std::chrono::milliseconds(GetSettings().Local.MaxHandshakeDelay.count() / NumHandshakeDelayMessages);
@@ -274,6 +319,15 @@ namespace QuantumGate::Implementation::Core::Peer
 				EnableSend();
 			}
 
+			if (status == Status::Ready)
+			{
+				const auto& settings = GetSettings();
+				if (settings.Local.PeerBuffers.AutoTune.Enabled)
+				{
+					AutoTuneSendBufferSizes(settings, current_steadytime);
+				}
+			}
+
 			if (noise_enabled && m_NoiseQueue.IsEmpty())
 			{
 				// Queue more noise
@@ -477,6 +531,8 @@ namespace QuantumGate::Implementation::Core::Peer
 
 	void Peer::ReleaseKeyExchange() noexcept
 	{
+		if (m_KeyExchange != nullptr) m_KeyExchange->ReturnPrefetchedAsymmetricKeys();
+
 		m_KeyExchange.reset();
 
 		// After the key exchange has finished we end up
@@ -569,6 +625,15 @@ namespace QuantumGate::Implementation::Core::Peer
 
 	bool Peer::OnStatusChange(const Status old_status, const Status new_status) noexcept
 	{
+		// Incoming connections count against the maximum number of
+		// concurrent handshakes until they're ready or gone
+		if (IsFlagSet(Flags::InboundHandshakeAdmitted) &&
+			(new_status == Status::Ready || new_status == Status::Disconnected))
+		{
+			SetFlag(Flags::InboundHandshakeAdmitted, false);
+			m_PeerManager.OnInboundHandshakeEnd();
+		}
+
 		switch (new_status)
 		{
 			case Status::MetaExchange:
@@ -671,6 +736,10 @@ namespace QuantumGate::Implementation::Core::Peer
 			{
 				m_NoiseQueue.Suspend();
 
+				// Extenders that were waiting for send buffer space
+				// will try sending again after the peer resumes
+				m_SendQueues.ClearSendBufferFullExtenders();
+
 				if (!m_KeyUpdate.Suspend())
 				{
 					LogErr(L"Unable to suspend key update for peer %s", GetPeerName().c_str());
@@ -713,6 +782,13 @@ namespace QuantumGate::Implementation::Core::Peer
 					});
 				}
 
+				m_SendQueues.ClearSendBufferFullExtenders();
+
+				// Pregenerated keys that were set aside for a key update
+				// that won't happen anymore can be used by other peers
+				m_KeyUpdate.ReturnPrefetchedKeys();
+				if (m_KeyExchange != nullptr) m_KeyExchange->ReturnPrefetchedAsymmetricKeys();
+
 				if (old_status == Status::Ready || old_status == Status::Suspended)
 				{
 					// Notify extenders of disconnected peer
@@ -979,7 +1055,13 @@ namespace QuantumGate::Implementation::Core::Peer
 		// If the send buffer is empty get more messages from the send queues
 
 		Size num{ 0 };
-		Buffer sndbuf;
+		Memory::PacketBuffer sndbuf;
+
+		// Messages get written into a buffer with room for the message transport
+		// headers in front, so that they don't have to get copied again when
+		// the headers are added; partially sent data gets removed from the front
+		// of the send buffer without copying as well
+		const auto headroom = MessageTransport::GetHeadroomSize(settings);
 
 		while (m_SendQueues.HaveMessages())
 		{
@@ -995,7 +1077,10 @@ namespace QuantumGate::Implementation::Core::Peer
 				return false;
 			}
 
-			Buffer msgbuf;
+			Memory::PacketBuffer msgbuf;
+
+			try { msgbuf.Reserve(headroom, 0); }
+			catch (...) { return false; }
 
 			const auto& [success, nummsg] = m_SendQueues.GetMessages(msgbuf, *symkey, IsFlagSet(Flags::ConcatenateMessages));
 			if (!success) return false;
@@ -15,6 +15,7 @@
 #include "PeerNoiseQueue.h"
 #include "PeerSendQueues.h"
 #include "PeerReceiveQueues.h"
+#include "PeerThreadPoolBalance.h"
 
 #include <bitset>
 
@@ -38,17 +39,20 @@ namespace QuantumGate::Implementation::Core::Peer
 			ConcatenateMessages,
 			HandshakeStartDelay,
 			SendDisabled,
-			NeedsExtenderUpdate
+			NeedsExtenderUpdate,
+			InboundHandshakeAdmitted,
+			HandshakeProcessingScheduled
 		};
 
-		class EventBuffer final : public Buffer
+		template<typename B>
+		class EventBuffer final : public B
 		{
 		public:
 			inline void SetEvent() noexcept { m_EventState = true; }
 			inline void ResetEvent() noexcept { m_EventState = false; }
 			[[nodiscard]] inline bool IsEventSet() const noexcept { return m_EventState; }
 
-			using Buffer::operator=;
+			using B::operator=;
 
 		private:
 			bool m_EventState{ false };
@@ -189,7 +193,17 @@ namespace QuantumGate::Implementation::Core::Peer
 		void AddDisconnectCallback(DisconnectCallback&& function) noexcept { m_DisconnectCallbacks.Add(std::move(function)); }
 
 		[[nodiscard]] inline UInt64 GetThreadPoolKey() const noexcept { return m_ThreadPoolKey; }
-		inline void SetThreadPoolKey(const UInt64 key) noexcept { m_ThreadPoolKey = key; }
+		[[nodiscard]] inline SteadyTime GetThreadPoolSteadyTime() const noexcept { return m_ThreadPoolSteadyTime; }
+
+		inline void SetThreadPoolKey(const UInt64 key, const SteadyTime current_steadytime) noexcept
+		{
+			m_ThreadPoolKey = key;
+			m_ThreadPoolSteadyTime = current_steadytime;
+		}
+
+		inline void AddThreadPoolLoad(const std::chrono::nanoseconds busy_time) noexcept { m_ThreadPoolLoad.BusyTime += busy_time; }
+
+		[[nodiscard]] inline ThreadPoolLoad ResetThreadPoolLoad() noexcept { return std::exchange(m_ThreadPoolLoad, ThreadPoolLoad{}); }
 
 		[[nodiscard]] inline bool ShouldDisconnect() const noexcept { return (m_DisconnectCondition != DisconnectCondition::None); }
 		[[nodiscard]] inline DisconnectCondition GetDisconnectCondition() const noexcept { return m_DisconnectCondition; }
@@ -213,6 +227,12 @@ namespace QuantumGate::Implementation::Core::Peer
 		inline void SetNeedsExtenderUpdate() noexcept { SetFlag(Flags::NeedsExtenderUpdate, true); }
 		[[nodiscard]] inline bool NeedsExtenderUpdate() const noexcept { return IsFlagSet(Flags::NeedsExtenderUpdate); }
 
+		inline void SetInboundHandshakeAdmitted(const bool admitted) noexcept { SetFlag(Flags::InboundHandshakeAdmitted, admitted); }
+		[[nodiscard]] inline bool IsInboundHandshakeAdmitted() const noexcept { return IsFlagSet(Flags::InboundHandshakeAdmitted); }
+
+		inline void SetHandshakeProcessingScheduled(const bool scheduled) noexcept { SetFlag(Flags::HandshakeProcessingScheduled, scheduled); }
+		[[nodiscard]] inline bool IsHandshakeProcessingScheduled() const noexcept { return IsFlagSet(Flags::HandshakeProcessingScheduled); }
+
 		void ScheduleCallback(Callback<void()>&& callback) noexcept;
 
 		void OnUnhandledExtenderMessage(const ExtenderUUID& extuuid, const API::Extender::PeerEvent::Result& result) noexcept;
@@ -230,6 +250,9 @@ namespace QuantumGate::Implementation::Core::Peer
 
 		[[nodiscard]] bool OnStatusChange(const Status old_status, const Status new_status) noexcept;
 
+		void InitializeBufferSizes(const Settings& settings) noexcept;
+		void AutoTuneSendBufferSizes(const Settings& settings, const SteadyTime current_steadytime) noexcept;
+
 		[[nodiscard]] bool SendFromNoiseQueue(const Settings& settings) noexcept;
 
 		void EnableSend() noexcept;
@@ -303,17 +326,21 @@ namespace QuantumGate::Implementation::Core::Peer
 		UInt16 m_NextPeerRandomDataPrefixLength{ 0 };
 
 		UInt64 m_ThreadPoolKey{ 0 };
+		SteadyTime m_ThreadPoolSteadyTime;
+		ThreadPoolLoad m_ThreadPoolLoad;
 
 		DisconnectCondition m_DisconnectCondition{ DisconnectCondition::None };
 
 		ExtenderUUIDs m_PeerExtenderUUIDs;
 
 		MessageRateLimits m_RateLimits;
+		SteadyTime m_SendRateSteadyTime;
+		Size m_SendRateBytes{ 0 };
 		PeerReceiveQueues m_ReceiveQueues{ *this };
 		PeerSendQueues m_SendQueues{ *this };
 
-		EventBuffer m_ReceiveBuffer;
-		EventBuffer m_SendBuffer;
+		EventBuffer<Buffer> m_ReceiveBuffer;
+		EventBuffer<Memory::PacketBuffer> m_SendBuffer;
 		std::optional<MessageDetails> m_MessageFragments;
 
 		NoiseQueue m_NoiseQueue;
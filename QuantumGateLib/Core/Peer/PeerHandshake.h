@@ -0,0 +1,69 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+#include "PeerData.h"
+#include "PeerTypes.h"
+
+namespace QuantumGate::Implementation::Core::Peer
+{
+	// Handshakes that are further along, and those that we initiated, get
+	// processed first so that a flood of new incoming connections can't keep
+	// handshakes that were already admitted from completing
+	struct HandshakeTask final
+	{
+		PeerSharedPointer Peer;
+		bool Outbound{ false };
+		Status Status{ Status::Unknown };
+		UInt64 Sequence{ 0 };
+
+		// Returns true if task1 should be processed after task2
+		[[nodiscard]] static bool Compare(const HandshakeTask& task1, const HandshakeTask& task2) noexcept
+		{
+			if (task1.Outbound != task2.Outbound) return task2.Outbound;
+			if (task1.Status != task2.Status) return (task1.Status < task2.Status);
+			return (task1.Sequence > task2.Sequence);
+		}
+	};
+
+	// Counts the incoming connections that are busy with their handshake
+	// so that new ones can be turned away when there are too many
+	class HandshakeAdmission final
+	{
+	public:
+		HandshakeAdmission() noexcept = default;
+		HandshakeAdmission(const HandshakeAdmission&) = delete;
+		HandshakeAdmission(HandshakeAdmission&&) = delete;
+		~HandshakeAdmission() = default;
+		HandshakeAdmission& operator=(const HandshakeAdmission&) = delete;
+		HandshakeAdmission& operator=(HandshakeAdmission&&) = delete;
+
+		[[nodiscard]] inline bool CanAdmit(const Size max_num) const noexcept { return (m_NumInProgress < max_num); }
+
+		[[nodiscard]] inline bool TryAdmit(const Size max_num) noexcept
+		{
+			if (m_NumInProgress.fetch_add(1) >= max_num)
+			{
+				--m_NumInProgress;
+				return false;
+			}
+
+			return true;
+		}
+
+		inline void Release() noexcept
+		{
+			assert(m_NumInProgress > 0);
+
+			--m_NumInProgress;
+		}
+
+		[[nodiscard]] inline Size GetNumInProgress() const noexcept { return m_NumInProgress; }
+
+		inline void Reset() noexcept { m_NumInProgress = 0; }
+
+	private:
+		std::atomic<Size> m_NumInProgress{ 0 };
+	};
+}
\ No newline at end of file
@@ -22,7 +22,8 @@ namespace QuantumGate::Implementation::Core::Peer
 		[[nodiscard]] inline bool GeneratePrimaryAsymmetricKeys(const Algorithms& algorithms,
 																const Crypto::AsymmetricKeyOwner type) noexcept
 		{
-			return GenerateAsymmetricKeys(m_PrimaryAsymmetricKeys, algorithms.PrimaryAsymmetric, type);
+			return GenerateAsymmetricKeys(m_PrimaryAsymmetricKeys, m_PrefetchedPrimaryAsymmetricKeys,
+										  algorithms.PrimaryAsymmetric, type);
 		}
 
 		inline void SetPeerPrimaryHandshakeData(ProtectedBuffer&& buffer) noexcept
@@ -57,7 +58,30 @@ namespace QuantumGate::Implementation::Core::Peer
 		[[nodiscard]] bool GenerateSecondaryAsymmetricKeys(const Algorithms& algorithms,
 														   const Crypto::AsymmetricKeyOwner owner) noexcept
 		{
-			return GenerateAsymmetricKeys(m_SecondaryAsymmetricKeys, algorithms.SecondaryAsymmetric, owner);
+			return GenerateAsymmetricKeys(m_SecondaryAsymmetricKeys, m_PrefetchedSecondaryAsymmetricKeys,
+										  algorithms.SecondaryAsymmetric, owner);
+		}
+
+		// Keys that were obtained ahead of time (see KeyUpdate) get used
+		// instead of getting keys from the key manager or generating them
+		inline void SetPrefetchedAsymmetricKeys(std::optional<Crypto::AsymmetricKeyData>&& primary,
+												std::optional<Crypto::AsymmetricKeyData>&& secondary) noexcept
+		{
+			m_PrefetchedPrimaryAsymmetricKeys = std::move(primary);
+			m_PrefetchedSecondaryAsymmetricKeys = std::move(secondary);
+		}
+
+		// Gives prefetched keys that didn't get used back to the key manager
+		void ReturnPrefetchedAsymmetricKeys() noexcept
+		{
+			for (auto keys : { &m_PrefetchedPrimaryAsymmetricKeys, &m_PrefetchedSecondaryAsymmetricKeys })
+			{
+				if (keys->has_value())
+				{
+					m_KeyManager.ReturnAsymmetricKeys(std::move(**keys));
+					keys->reset();
+				}
+			}
 		}
 
 		inline void SetPeerSecondaryHandshakeData(ProtectedBuffer&& buffer) noexcept
@@ -225,6 +249,7 @@ namespace QuantumGate::Implementation::Core::Peer
 
 	private:
 		[[nodiscard]] inline bool GenerateAsymmetricKeys(std::shared_ptr<Crypto::AsymmetricKeyData>& keydata,
+														 std::optional<Crypto::AsymmetricKeyData>& prefetched_keys,
 														 const Algorithm::Asymmetric aa,
 														 const Crypto::AsymmetricKeyOwner owner) noexcept
 		{
@@ -246,7 +271,16 @@ namespace QuantumGate::Implementation::Core::Peer
 				return true;
 			}
 
-			// First check if we have a pre-generated keypair available
+			// Use the prefetched keypair if we have one
+			if (prefetched_keys && prefetched_keys->GetAlgorithm() == aa)
+			{
+				*keydata = std::move(*prefetched_keys);
+				prefetched_keys.reset();
+				keydata->SetOwner(owner);
+				return true;
+			}
+
+			// Otherwise check if we have a pre-generated keypair available
 			auto keys = m_KeyManager.GetAsymmetricKeys(aa);
 			if (keys)
 			{
@@ -291,6 +325,9 @@ namespace QuantumGate::Implementation::Core::Peer
 		std::shared_ptr<Crypto::AsymmetricKeyData> m_PrimaryAsymmetricKeys;
 		std::shared_ptr<Crypto::AsymmetricKeyData> m_SecondaryAsymmetricKeys;
 
+		std::optional<Crypto::AsymmetricKeyData> m_PrefetchedPrimaryAsymmetricKeys;
+		std::optional<Crypto::AsymmetricKeyData> m_PrefetchedSecondaryAsymmetricKeys;
+
 		std::shared_ptr<SymmetricKeyPair> m_PrimarySymmetricKeyPair;
 		std::shared_ptr<SymmetricKeyPair> m_SecondarySymmetricKeyPair;
 	};
@@ -147,6 +147,76 @@ namespace QuantumGate::Implementation::Core::Peer
 		return false;
 	}
 
+	bool KeyUpdate::ShouldPrefetchKeys(const SteadyTime current_steadytime) const noexcept
+	{
+		// Only the inbound peer knows when the next update will begin; the outbound
+		// peer waits for the update to get initiated and, with key encapsulation,
+		// doesn't need asymmetric keys of its own
+		if (GetStatus() == Status::UpdateWait && !m_KeysPrefetched &&
+			m_Peer.GetConnectionType() == PeerConnectionType::Inbound &&
+			m_Peer.GetStatus() == Core::Peer::Status::Ready &&
+			current_steadytime - m_PrefetchSteadyTime > PrefetchRetryInterval)
+		{
+			return IsWithinPrefetchWindow(current_steadytime, m_UpdateSteadyTime + m_UpdateInterval);
+		}
+
+		return false;
+	}
+
+	void KeyUpdate::PrefetchKeys(const SteadyTime current_steadytime) noexcept
+	{
+		m_PrefetchSteadyTime = current_steadytime;
+
+		const auto algorithms = m_Peer.GetAlgorithms();
+		auto& keymgr = m_Peer.GetKeyGenerationManager();
+
+		if (!m_PrefetchedPrimaryAsymmetricKeys.has_value())
+		{
+			m_PrefetchedPrimaryAsymmetricKeys = keymgr.GetAsymmetricKeys(algorithms.PrimaryAsymmetric);
+		}
+
+		if (!m_PrefetchedSecondaryAsymmetricKeys.has_value())
+		{
+			m_PrefetchedSecondaryAsymmetricKeys = keymgr.GetAsymmetricKeys(algorithms.SecondaryAsymmetric);
+		}
+
+		m_KeysPrefetched = (m_PrefetchedPrimaryAsymmetricKeys.has_value() &&
+							m_PrefetchedSecondaryAsymmetricKeys.has_value());
+
+		if (!m_KeysPrefetched)
+		{
+			LogDbg(L"No pregenerated keys available yet for next key update for peer %s; will try again",
+				   m_Peer.GetPeerName().c_str());
+		}
+	}
+
+	void KeyUpdate::ReturnPrefetchedKeys() noexcept
+	{
+		auto& keymgr = m_Peer.GetKeyGenerationManager();
+
+		for (auto keys : { &m_PrefetchedPrimaryAsymmetricKeys, &m_PrefetchedSecondaryAsymmetricKeys })
+		{
+			if (keys->has_value())
+			{
+				keymgr.ReturnAsymmetricKeys(std::move(**keys));
+				keys->reset();
+			}
+		}
+
+		m_KeysPrefetched = false;
+	}
+
+	void KeyUpdate::UsePrefetchedKeys() noexcept
+	{
+		// Any keys that weren't prefetched in time will get
+		// obtained or generated during the key exchange instead
+		m_Peer.GetKeyExchange().SetPrefetchedAsymmetricKeys(std::move(m_PrefetchedPrimaryAsymmetricKeys),
+															std::move(m_PrefetchedSecondaryAsymmetricKeys));
+		m_PrefetchedPrimaryAsymmetricKeys.reset();
+		m_PrefetchedSecondaryAsymmetricKeys.reset();
+		m_KeysPrefetched = false;
+	}
+
 	bool KeyUpdate::BeginKeyUpdate() noexcept
 	{
 		// Should not already be updating
@@ -154,6 +224,8 @@ namespace QuantumGate::Implementation::Core::Peer
 
 		if (m_Peer.InitializeKeyExchange())
 		{
+			UsePrefetchedKeys();
+
 			if (m_Peer.GetMessageProcessor().SendBeginPrimaryKeyUpdateExchange())
 			{
 				return SetStatus(KeyUpdate::Status::PrimaryExchange);
@@ -178,6 +250,10 @@ namespace QuantumGate::Implementation::Core::Peer
 
 		LogDbg(L"Suspending key update for peer %s", m_Peer.GetPeerName().c_str());
 
+		// No need to hold on to keys while suspended; they'll
+		// get prefetched again after resuming if there's time
+		ReturnPrefetchedKeys();
+
 		return SetStatus(Status::Suspended);
 	}
 
@@ -209,6 +285,10 @@ namespace QuantumGate::Implementation::Core::Peer
 			LogErr(L"Key update for peer %s timed out; will disconnect", m_Peer.GetPeerName().c_str());
 			return false;
 		}
+		else if (ShouldPrefetchKeys(current_steadytime))
+		{
+			PrefetchKeys(current_steadytime);
+		}
 
 		return true;
 	}
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "PeerMessageProcessor.h"
+#include "..\..\Crypto\KeyData.h"
 
 namespace QuantumGate::Implementation::Core::Peer
 {
@@ -11,6 +12,15 @@ namespace QuantumGate::Implementation::Core::Peer
 
 	class KeyUpdate final
 	{
+		// Asymmetric keys for the next update get prefetched from the pregenerated keys
+		// this long before the update is scheduled to begin, so that the key update itself
+		// doesn't have to wait for keys to get generated; kept short so that peers don't
+		// hold on to keys that new handshakes could use
+		static constexpr std::chrono::seconds PrefetchWindow{ 10 };
+
+		// How often to try again when no pregenerated keys were available
+		static constexpr std::chrono::seconds PrefetchRetryInterval{ 1 };
+
 	public:
 		enum class Status
 		{
@@ -31,7 +41,8 @@ namespace QuantumGate::Implementation::Core::Peer
 			// No events while suspended
 			if (GetStatus() == Status::Suspended) return false;
 
-			return ShouldUpdate(current_steadytime) || UpdateTimedOut(current_steadytime);
+			return ShouldUpdate(current_steadytime) || UpdateTimedOut(current_steadytime) ||
+				ShouldPrefetchKeys(current_steadytime);
 		}
 
 		[[nodiscard]] bool ProcessEvents(const SteadyTime current_steadytime) noexcept;
@@ -40,6 +51,14 @@ namespace QuantumGate::Implementation::Core::Peer
 		[[nodiscard]] bool  Suspend() noexcept;
 		[[nodiscard]] bool  Resume() noexcept;
 
+		void ReturnPrefetchedKeys() noexcept;
+
+		[[nodiscard]] static inline bool IsWithinPrefetchWindow(const SteadyTime current_steadytime,
+																const SteadyTime update_steadytime) noexcept
+		{
+			return (current_steadytime >= update_steadytime - PrefetchWindow);
+		}
+
 	private:
 		[[nodiscard]] bool SetStatus(const Status status) noexcept;
 		inline Status GetStatus() const noexcept { return m_Status; }
@@ -50,6 +69,10 @@ namespace QuantumGate::Implementation::Core::Peer
 		[[nodiscard]] bool UpdateTimedOut(const SteadyTime current_steadytime) const noexcept;
 		[[nodiscard]] bool ShouldUpdate(const SteadyTime current_steadytime) noexcept;
 
+		[[nodiscard]] bool ShouldPrefetchKeys(const SteadyTime current_steadytime) const noexcept;
+		void PrefetchKeys(const SteadyTime current_steadytime) noexcept;
+		void UsePrefetchedKeys() noexcept;
+
 	private:
 		Peer& m_Peer;
 		Status m_Status{ Status::Unknown };
@@ -57,5 +80,10 @@ namespace QuantumGate::Implementation::Core::Peer
 		std::chrono::seconds m_UpdateInterval{ 0 };
 		Status m_ResumeStatus{ Status::Unknown };
 		std::chrono::seconds m_ResumeUpdateIntervalDelta{ 0 };
+
+		bool m_KeysPrefetched{ false };
+		SteadyTime m_PrefetchSteadyTime;
+		std::optional<Crypto::AsymmetricKeyData> m_PrefetchedPrimaryAsymmetricKeys;
+		std::optional<Crypto::AsymmetricKeyData> m_PrefetchedSecondaryAsymmetricKeys;
 	};
 }
\ No newline at end of file
@@ -94,12 +94,10 @@ namespace QuantumGate::Implementation::Core::Peer
 			return true;
 		}
 
-		std::pair<std::shared_ptr<Crypto::SymmetricKeyData>, Buffer> GetEncryptionKeyAndNonce(const UInt32 nonce_seed,
-																							  const PeerConnectionType pctype,
-																							  const bool autogenkey_allowed) const noexcept
+		std::pair<std::shared_ptr<Crypto::SymmetricKeyData>, Crypto::SymmetricNonce> GetEncryptionKeyAndNonce(const UInt32 nonce_seed,
+																											  const PeerConnectionType pctype,
+																											  const bool autogenkey_allowed) const noexcept
 		{
-			auto error = false;
-
 			// Get the most recent key that's enabled;
 			// the most recent keys are in front
 			for (std::size_t x = 0; x < m_SymmetricKeyPairs.size(); ++x)
@@ -107,32 +105,26 @@ namespace QuantumGate::Implementation::Core::Peer
 				if (m_SymmetricKeyPairs[x]->UseForEncryption &&
 					!m_SymmetricKeyPairs[x]->IsExpired())
 				{
-					Buffer nonce;
-					if (GetNonce(nonce_seed, nonce, m_SymmetricKeyPairs[x]->EncryptionKey->HashAlgorithm))
-					{
-						return std::make_pair(m_SymmetricKeyPairs[x]->EncryptionKey, std::move(nonce));
-					}
-					else error = true;
-
-					break;
+					const auto& symkey = m_SymmetricKeyPairs[x]->EncryptionKey;
+					return std::make_pair(symkey, Crypto::GetSymmetricNonce(*symkey, nonce_seed));
 				}
 			}
 
 			// If we found no enabled keys we use
 			// the autogen key if allowed
-			if (!error && autogenkey_allowed)
+			if (autogenkey_allowed)
 			{
 				return GetAutoGenKeyAndNonce(nonce_seed, pctype, true);
 			}
 
 			// Should return nullptr for symmetric key to indicate failure
-			return std::make_pair(nullptr, Buffer());
+			return std::make_pair(nullptr, Crypto::SymmetricNonce());
 		}
 
-		std::pair<std::shared_ptr<Crypto::SymmetricKeyData>, Buffer> GetDecryptionKeyAndNonce(const UInt32 keynum,
-																							  const UInt32 nonce_seed,
-																							  const PeerConnectionType pctype,
-																							  const bool autogenkey_allowed) const noexcept
+		std::pair<std::shared_ptr<Crypto::SymmetricKeyData>, Crypto::SymmetricNonce> GetDecryptionKeyAndNonce(const UInt32 keynum,
+																											  const UInt32 nonce_seed,
+																											  const PeerConnectionType pctype,
+																											  const bool autogenkey_allowed) const noexcept
 		{
 			// If we have a symmetric key use it otherwise we'll generate one
 			// if allowed (an autogen key)
@@ -143,11 +135,8 @@ namespace QuantumGate::Implementation::Core::Peer
 				if (m_SymmetricKeyPairs[keynum]->UseForDecryption &&
 					!m_SymmetricKeyPairs[keynum]->IsExpired())
 				{
-					Buffer nonce;
-					if (GetNonce(nonce_seed, nonce, m_SymmetricKeyPairs[keynum]->DecryptionKey->HashAlgorithm))
-					{
-						return std::make_pair(m_SymmetricKeyPairs[keynum]->DecryptionKey, std::move(nonce));
-					}
+					const auto& symkey = m_SymmetricKeyPairs[keynum]->DecryptionKey;
+					return std::make_pair(symkey, Crypto::GetSymmetricNonce(*symkey, nonce_seed));
 				}
 			}
 			else if (keynum == numkeys && autogenkey_allowed)
@@ -157,7 +146,7 @@ namespace QuantumGate::Implementation::Core::Peer
 			}
 
 			// Should return nullptr for symmetric key to indicate failure
-			return std::make_pair(nullptr, Buffer());
+			return std::make_pair(nullptr, Crypto::SymmetricNonce());
 		}
 
 		[[nodiscard]] bool HasNumBytesProcessedExceededForLatestKeyPair(const Size max_num) const noexcept
@@ -248,9 +237,9 @@ namespace QuantumGate::Implementation::Core::Peer
 		}
 
 	private:
-		static std::pair<std::shared_ptr<Crypto::SymmetricKeyData>, Buffer> GetAutoGenKeyAndNonce(const UInt32 nonce_seed,
-																								  const PeerConnectionType pctype,
-																								  bool enc) noexcept
+		static std::pair<std::shared_ptr<Crypto::SymmetricKeyData>, Crypto::SymmetricNonce> GetAutoGenKeyAndNonce(const UInt32 nonce_seed,
+																												  const PeerConnectionType pctype,
+																												  bool enc) noexcept
 		{
 			try
 			{
@@ -262,14 +251,13 @@ namespace QuantumGate::Implementation::Core::Peer
 				auto tempkey2 = std::make_shared<Crypto::SymmetricKeyData>(Crypto::SymmetricKeyType::AutoGen,
 																		   alg.Hash, alg.Symmetric,
 																		   alg.Compression);
-				Buffer nonce;
-				if (GetNonce(nonce_seed, nonce, alg.Hash))
+				ProtectedBuffer seed_hash;
+				if (GetAutoGenSecret(nonce_seed, seed_hash, alg.Hash))
 				{
-					// Generate symmetric keys by using the nonce as a "secret"; this is not secure
-					// but it only serves the purpose of obfuscating the message data to make it
+					// Generate symmetric keys by using the hashed nonce seed as a "secret"; this is not
+					// secure but it only serves the purpose of obfuscating the message data to make it
 					// look random for traffic analyzers until we get a better key to work with
-					ProtectedBuffer pbuf(nonce.GetBytes(), nonce.GetSize());
-					if (Crypto::GenerateSymmetricKeys(pbuf, *tempkey1, *tempkey2))
+					if (Crypto::GenerateSymmetricKeys(seed_hash, *tempkey1, *tempkey2))
 					{
 						std::shared_ptr<Crypto::SymmetricKeyData> symkey;
 
@@ -284,7 +272,9 @@ namespace QuantumGate::Implementation::Core::Peer
 							else symkey = std::move(tempkey1);
 						}
 
-						return make_pair(std::move(symkey), std::move(nonce));
+						auto nonce = Crypto::GetSymmetricNonce(*symkey, nonce_seed);
+
+						return std::make_pair(std::move(symkey), std::move(nonce));
 					}
 				}
 			}
@@ -293,19 +283,19 @@ namespace QuantumGate::Implementation::Core::Peer
 			LogErr(L"Could not generate autogen symmetric key");
 
 			// Should return nullptr for symmetric key to indicate failure
-			return std::make_pair(nullptr, Buffer());
+			return std::make_pair(nullptr, Crypto::SymmetricNonce());
 		}
 
-		[[nodiscard]] static bool GetNonce(const UInt32 nonce_seed, Buffer& nonce, const Algorithm::Hash ha) noexcept
+		[[nodiscard]] static bool GetAutoGenSecret(const UInt32 nonce_seed, ProtectedBuffer& secret, const Algorithm::Hash ha) noexcept
 		{
 			const BufferView seedb(reinterpret_cast<const Byte*>(&nonce_seed), sizeof(UInt32));
-			if (Crypto::Hash(seedb, nonce, ha))
+			if (Crypto::Hash(seedb, secret, ha))
 			{
-				Dbg(L"Nonce: %u bytes - %s", nonce.GetSize(), Util::ToBase64(nonce)->c_str());
+				Dbg(L"Autogen secret: %u bytes - %s", secret.GetSize(), Util::ToBase64(secret)->c_str());
 				return true;
 			}
 
-			LogErr(L"Could not generate nonce");
+			LogErr(L"Could not generate autogen secret");
 
 			return false;
 		}
@@ -5,6 +5,7 @@
 #include "PeerManager.h"
 #include "..\..\Common\Random.h"
 #include "..\..\Common\ScopeGuard.h"
+#include "..\..\Concurrency\SpinWait.h"
 #include "..\..\Memory\BufferReader.h"
 #include "..\..\Memory\BufferWriter.h"
 #include "..\..\API\Access.h"
@@ -172,6 +173,13 @@ namespace QuantumGate::Implementation::Core::Peer
 					}
 				}
 
+				const auto affinity = Util::GetThreadPoolAffinity(settings.Local.Concurrency.Affinity.Enabled,
+																  settings.Local.Concurrency.Affinity.SeparateIOAndCrypto,
+																  Util::ThreadPoolWorkload::IO, i);
+				if (affinity.has_value()) thpool->GetData().NumaNode = affinity->Node;
+
+				thpool->SetAffinity(affinity);
+
 				if (!error && thpool->Startup())
 				{
 					m_ThreadPools[i] = std::move(thpool);
@@ -187,11 +195,17 @@ namespace QuantumGate::Implementation::Core::Peer
 			if (error) break;
 		}
 
+		if (!error) error = !StartupHandshakeThreadPool();
+
 		return !error;
 	}
 
 	void Manager::ShutdownThreadPools() noexcept
 	{
+		// Handshake threads go first since they
+		// process peers from the other threadpools
+		ShutdownHandshakeThreadPool();
+
 		for (const auto& thpool : m_ThreadPools)
 		{
 			thpool.second->Shutdown();
@@ -225,6 +239,55 @@ namespace QuantumGate::Implementation::Core::Peer
 		ResetState();
 	}
 
+	bool Manager::StartupHandshakeThreadPool() noexcept
+	{
+		const auto& settings = GetSettings();
+
+		const auto numthreads = Util::GetNumThreadsPerPool(settings.Local.Concurrency.HandshakeManager.MinThreads,
+														   settings.Local.Concurrency.HandshakeManager.MaxThreads, 1u);
+
+		LogSys(L"Creating peer handshake threadpool with %zu worker %s",
+			   numthreads, numthreads > 1 ? L"threads" : L"thread");
+
+		for (Size x = 0; x < numthreads; ++x)
+		{
+			if (!m_HandshakeThreadPool.AddThread(L"QuantumGate Peers Handshake Thread",
+												 MakeCallback(this, &Manager::HandshakeThreadProcessor),
+												 MakeCallback(this, &Manager::HandshakeThreadWait),
+												 MakeCallback(this, &Manager::HandshakeThreadWaitInterrupt)))
+			{
+				LogErr(L"Couldn't add a peer handshake thread");
+				return false;
+			}
+		}
+
+		m_HandshakeThreadPool.SetAffinity(Util::GetThreadPoolAffinity(settings.Local.Concurrency.Affinity.Enabled,
+																	  settings.Local.Concurrency.Affinity.SeparateIOAndCrypto,
+																	  Util::ThreadPoolWorkload::Crypto, 1));
+
+		if (!m_HandshakeThreadPool.Startup())
+		{
+			LogErr(L"Couldn't start the peer handshake threadpool");
+			return false;
+		}
+
+		return true;
+	}
+
+	void Manager::ShutdownHandshakeThreadPool() noexcept
+	{
+		m_HandshakeThreadPool.Shutdown();
+		m_HandshakeThreadPool.Clear();
+
+		// Releases the peers that were still waiting
+		m_HandshakeThreadPool.GetData().TaskQueue.WithUniqueLock([](HandshakeTaskQueueData& queue_data) noexcept
+		{
+			queue_data.Queue = HandshakeTaskQueue{ &HandshakeTask::Compare };
+		});
+
+		m_HandshakeThreadPool.GetData().WorkEvent.Reset();
+	}
+
 	void Manager::PreStartupThreadPools() noexcept
 	{
 		ResetState();
@@ -235,6 +298,8 @@ namespace QuantumGate::Implementation::Core::Peer
 		m_LookupMaps.WithUniqueLock()->Clear();
 		m_AllPeers.WithUniqueLock()->clear();
 		m_ThreadPools.clear();
+		m_LastRebalanceSteadyTime = Util::GetCurrentSteadyTime();
+		m_InboundHandshakes.Reset();
 	}
 
 	bool Manager::AddCallbacks() noexcept
@@ -284,6 +349,16 @@ namespace QuantumGate::Implementation::Core::Peer
 
 	void Manager::PrimaryThreadWait(ThreadPoolData& thpdata, const Concurrency::Event& shutdown_event)
 	{
+		const auto& busy_poll = GetSettings().Local.Concurrency.BusyPoll;
+		if (busy_poll.Enabled)
+		{
+			// Spin for a while looking for work before going to sleep
+			if (Concurrency::SpinWait(busy_poll.SpinBudget, [&]() noexcept
+			{
+				return (thpdata.WaitForWorkEvent(0ms).HadEvent || shutdown_event.IsSet());
+			})) return;
+		}
+
 		const auto result = thpdata.WaitForWorkEvent(1ms);
 		if (!result.Waited)
 		{
@@ -315,9 +390,20 @@ namespace QuantumGate::Implementation::Core::Peer
 				{
 					if (peer.CheckStatus(noise_enabled, current_steadytime, max_connect_duration, max_handshake_duration))
 					{
-						if (peer.HasPendingEvents(current_steadytime))
+						// Peers in handshake get processed on the handshake threads so that
+						// the asymmetric crypto doesn't hold up data for established peers
+						if (!peer.IsHandshakeProcessingScheduled() && peer.HasPendingEvents(current_steadytime))
 						{
-							DiscardReturnValue(peer.ProcessEvents(current_steadytime));
+							if (!peer.IsInHandshake() || !ScheduleHandshakeProcessing(peerths, peer))
+							{
+								DiscardReturnValue(peer.ProcessEvents(current_steadytime));
+
+								const auto busy_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+									Util::GetCurrentSteadyTime() - current_steadytime);
+
+								peer.AddThreadPoolLoad(busy_time);
+								thpdata.AddLoad(busy_time);
+							}
 						}
 					}
 
@@ -343,6 +429,8 @@ namespace QuantumGate::Implementation::Core::Peer
 
 			remove_list->clear();
 		}
+
+		if (!shutdown_event.IsSet()) RebalanceThreadPools();
 	}
 
 	void Manager::WorkerThreadWait(ThreadPoolData& thpdata, const Concurrency::Event& shutdown_event)
@@ -382,8 +470,16 @@ namespace QuantumGate::Implementation::Core::Peer
 						}
 					});
 				},
-				[](Tasks::PeerCallback& ptask)
+				[&](Tasks::PeerCallback& ptask)
 				{
+					const auto start_steadytime = Util::GetCurrentSteadyTime();
+
+					const auto sg = MakeScopeGuard([&]() noexcept
+					{
+						thpdata.AddLoad(std::chrono::duration_cast<std::chrono::nanoseconds>(
+							Util::GetCurrentSteadyTime() - start_steadytime));
+					});
+
 					try
 					{
 						ptask.Callback();
@@ -401,6 +497,85 @@ namespace QuantumGate::Implementation::Core::Peer
 		}
 	}
 
+	void Manager::HandshakeThreadWait(HandshakeThreadPoolData& thpdata, const Concurrency::Event& shutdown_event)
+	{
+		thpdata.WorkEvent.Wait(shutdown_event);
+	}
+
+	void Manager::HandshakeThreadWaitInterrupt(HandshakeThreadPoolData& thpdata)
+	{
+		thpdata.WorkEvent.InterruptWait();
+	}
+
+	void Manager::HandshakeThreadProcessor(HandshakeThreadPoolData& thpdata, const Concurrency::Event& shutdown_event)
+	{
+		std::optional<HandshakeTask> task;
+
+		thpdata.TaskQueue.WithUniqueLock([&](HandshakeTaskQueueData& queue_data) noexcept
+		{
+			if (!queue_data.Queue.empty())
+			{
+				task = queue_data.Queue.top();
+				queue_data.Queue.pop();
+			}
+
+			if (queue_data.Queue.empty()) thpdata.WorkEvent.Reset();
+		});
+
+		if (!task.has_value()) return;
+
+		task->Peer->WithUniqueLock([&](Peer& peer)
+		{
+			peer.SetHandshakeProcessingScheduled(false);
+
+			// The peer may have been disconnected or gotten past the handshake
+			// while waiting in the queue; in the latter case the peer threads
+			// will pick it up again
+			if (!peer.ShouldDisconnect() && peer.IsInHandshake())
+			{
+				DiscardReturnValue(peer.ProcessEvents(Util::GetCurrentSteadyTime()));
+			}
+		});
+	}
+
+	bool Manager::ScheduleHandshakeProcessing(const PeerSharedPointer& peerths, Peer& peer) noexcept
+	{
+		try
+		{
+			auto& thpdata = m_HandshakeThreadPool.GetData();
+
+			thpdata.TaskQueue.WithUniqueLock([&](HandshakeTaskQueueData& queue_data)
+			{
+				queue_data.Queue.push(HandshakeTask{
+					.Peer = peerths,
+					.Outbound = (peer.GetConnectionType() == PeerConnectionType::Outbound),
+					.Status = peer.GetStatus(),
+					.Sequence = queue_data.NextSequence++
+				});
+			});
+
+			peer.SetHandshakeProcessingScheduled(true);
+
+			thpdata.WorkEvent.Set();
+
+			return true;
+		}
+		catch (...) {}
+
+		// Caller processes the peer itself instead
+		return false;
+	}
+
+	bool Manager::CanAcceptInboundHandshake() const noexcept
+	{
+		return m_InboundHandshakes.CanAdmit(GetSettings().Local.Concurrency.HandshakeManager.MaxInboundHandshakes);
+	}
+
+	void Manager::OnInboundHandshakeEnd() noexcept
+	{
+		m_InboundHandshakes.Release();
+	}
+
 	PeerSharedPointer Manager::Get(const PeerLUID pluid) const noexcept
 	{
 		PeerSharedPointer rval{ nullptr };
@@ -554,6 +729,128 @@ namespace QuantumGate::Implementation::Core::Peer
 		thpool->GetData().TaskQueue.Push(Tasks::PeerCallback{ std::move(callback) });
 	}
 
+	void Manager::RebalanceThreadPools() noexcept
+	{
+		if (m_ThreadPools.size() < 2) return;
+
+		const auto current_steadytime = Util::GetCurrentSteadyTime();
+
+		auto last_steadytime = m_LastRebalanceSteadyTime.load();
+		if (current_steadytime - last_steadytime < ThreadPoolBalance::Interval) return;
+
+		// Only one of the primary threads gets to do the rebalancing
+		if (!m_LastRebalanceSteadyTime.compare_exchange_strong(last_steadytime, current_steadytime)) return;
+
+		const auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(current_steadytime - last_steadytime);
+
+		std::optional<ThreadPoolBalance::Move> move;
+
+		try
+		{
+			Vector<ThreadPoolBalance::ThreadPool> thpools;
+			thpools.reserve(m_ThreadPools.size());
+
+			for (const auto& thpool : m_ThreadPools)
+			{
+				thpools.emplace_back(ThreadPoolBalance::ThreadPool{
+					.Key = thpool.first,
+					.Node = thpool.second->GetData().NumaNode,
+					.Load = thpool.second->GetData().ResetLoad()
+				});
+			}
+
+			move = ThreadPoolBalance::SelectThreadPools(thpools, interval);
+		}
+		catch (...) {}
+
+		PeerSharedPointer move_peerths;
+		PeerLUID move_pluid{ 0 };
+		ThreadPoolLoad move_load;
+
+		// The load of the peers gets reset for the next interval
+		for (const auto& thpool : m_ThreadPools)
+		{
+			const auto check_peers = (move.has_value() && thpool.first == move->From.Key);
+
+			thpool.second->GetData().PeerMap.WithSharedLock([&](const PeerMap& peers)
+			{
+				for (const auto& it : peers)
+				{
+					it.second->WithUniqueLock([&](Peer& peer) noexcept
+					{
+						const auto load = peer.ResetThreadPoolLoad();
+
+						if (check_peers && peer.IsReady() && !peer.ShouldDisconnect() &&
+							!peer.IsHandshakeProcessingScheduled() &&
+							ThreadPoolBalance::IsBetterPeer(*move, load,
+															current_steadytime - peer.GetThreadPoolSteadyTime(),
+															move_load))
+						{
+							move_peerths = it.second;
+							move_pluid = it.first;
+							move_load = load;
+						}
+					});
+				}
+			});
+		}
+
+		if (move_peerths == nullptr) return;
+
+		if (MovePeer(move_peerths, move_pluid, move->From.Key, move->To.Key))
+		{
+			LogDbg(L"Moved peer LUID %llu (busy %jdus) from peers threadpool %llu (busy %jdus) "
+				   L"to threadpool %llu (busy %jdus)", move_pluid,
+				   std::chrono::duration_cast<std::chrono::microseconds>(move_load.BusyTime).count(),
+				   move->From.Key, std::chrono::duration_cast<std::chrono::microseconds>(move->From.Load.BusyTime).count(),
+				   move->To.Key, std::chrono::duration_cast<std::chrono::microseconds>(move->To.Load.BusyTime).count());
+		}
+	}
+
+	bool Manager::MovePeer(const PeerSharedPointer& peerths, const PeerLUID pluid,
+						   const UInt64 from_key, const UInt64 to_key) noexcept
+	{
+		auto& from_thpdata = m_ThreadPools[from_key]->GetData();
+		auto& to_thpdata = m_ThreadPools[to_key]->GetData();
+
+		// The peer gets added to the new threadpool first so that it's
+		// in the right place if it gets removed right after being moved
+		try
+		{
+			if (!to_thpdata.PeerMap.WithUniqueLock()->insert({ pluid, peerths }).second) return false;
+		}
+		catch (...) { return false; }
+
+		auto moved = false;
+
+		peerths->WithUniqueLock([&](Peer& peer) noexcept
+		{
+			const auto current_steadytime = Util::GetCurrentSteadyTime();
+
+			// Peers only get moved during a quiet moment, when there's no
+			// work pending for them on the threadpool they're leaving
+			if (peer.GetThreadPoolKey() != from_key || !peer.IsReady() || peer.ShouldDisconnect() ||
+				peer.IsHandshakeProcessingScheduled() || peer.HasPendingEvents(current_steadytime) ||
+				!from_thpdata.TaskQueue.IsEmpty())
+			{
+				return;
+			}
+
+			if (!to_thpdata.AddWorkEvent(peer)) return;
+
+			from_thpdata.RemoveWorkEvent(peer);
+
+			peer.SetThreadPoolKey(to_key, current_steadytime);
+
+			moved = true;
+		});
+
+		if (moved) from_thpdata.PeerMap.WithUniqueLock()->erase(pluid);
+		else to_thpdata.PeerMap.WithUniqueLock()->erase(pluid);
+
+		return moved;
+	}
+
 	bool Manager::Add(PeerSharedPointer& peerths) noexcept
 	{
 		auto success = false;
@@ -610,7 +907,7 @@ namespace QuantumGate::Implementation::Core::Peer
 			assert(thpit != m_ThreadPools.end());
 
 			// Add peer to the threadpool
-			peer.SetThreadPoolKey(thpit->first);
+			peer.SetThreadPoolKey(thpit->first, Util::GetCurrentSteadyTime());
 
 			PeerMap::iterator pit;
 
@@ -755,7 +1052,36 @@ namespace QuantumGate::Implementation::Core::Peer
 
 	bool Manager::Accept(PeerSharedPointer& peerths) noexcept
 	{
-		return Add(peerths);
+		// Admission control; when too many incoming connections are still
+		// busy with their handshake new ones get turned away early, before
+		// any expensive cryptographic work is done for them
+		const auto max_handshakes = GetSettings().Local.Concurrency.HandshakeManager.MaxInboundHandshakes;
+		if (!m_InboundHandshakes.TryAdmit(max_handshakes))
+		{
+			LogWarn(L"Not accepting connection; the maximum number of incoming handshakes in progress (%zu) has been reached",
+					max_handshakes);
+			return false;
+		}
+
+		// Gets counted down again when the handshake completes or the peer disconnects;
+		// set before adding since the peer can get processed as soon as it's added
+		peerths->WithUniqueLock()->SetInboundHandshakeAdmitted(true);
+
+		if (!Add(peerths))
+		{
+			// Only count down if that didn't already happen
+			// because the peer disconnected in the meantime
+			auto peer = peerths->WithUniqueLock();
+			if (peer->IsInboundHandshakeAdmitted())
+			{
+				peer->SetInboundHandshakeAdmitted(false);
+				m_InboundHandshakes.Release();
+			}
+
+			return false;
+		}
+
+		return true;
 	}
 
 	Result<std::pair<PeerLUID, bool>> Manager::ConnectTo(ConnectParameters&& params, ConnectCallback&& function) noexcept
@@ -1158,6 +1484,20 @@ namespace QuantumGate::Implementation::Core::Peer
 
 	Result<> Manager::Broadcast(const MessageType msgtype, const Buffer& buffer, BroadcastCallback&& callback)
 	{
+		// Messages that fit in one message get copied and encoded only once
+		// for all peers; larger ones need to get sent in fragments to each peer
+		std::shared_ptr<const SharedMessage> smsg;
+		if (buffer.GetSize() <= Message::MaxMessageDataSize)
+		{
+			try
+			{
+				// Note the copy
+				smsg = std::make_shared<const SharedMessage>(MessageOptions(msgtype, Buffer(buffer)));
+				if (!smsg->IsValid()) return ResultCode::Failed;
+			}
+			catch (...) { return ResultCode::OutOfMemory; }
+		}
+
 		m_AllPeers.WithSharedLock([&](const PeerMap& peers)
 		{
 			for (const auto& it : peers)
@@ -1168,9 +1508,20 @@ namespace QuantumGate::Implementation::Core::Peer
 
 					if (peer.IsReady())
 					{
-						// Note the copy
-						auto bbuffer = buffer;
-						if (peer.Send(msgtype, std::move(bbuffer)).Failed())
+						const auto result = std::invoke([&]()
+						{
+							if (smsg != nullptr) return peer.Send(Message(smsg));
+
+							try
+							{
+								// Note the copy
+								auto bbuffer = buffer;
+								return peer.Send(msgtype, std::move(bbuffer));
+							}
+							catch (...) { return Result<>(ResultCode::OutOfMemory); }
+						});
+
+						if (result.Failed())
 						{
 							broadcast_result = BroadcastResult::SendFailure;
 						}
@@ -1268,6 +1619,53 @@ namespace QuantumGate::Implementation::Core::Peer
 
 	Result<> Manager::SendTo(const ExtenderUUID& extuuid, const std::atomic_bool& running, const std::atomic_bool& ready,
 							 Peer& peer, Buffer&& buffer, const SendParameters& params, SendCallback&& callback) noexcept
+	{
+		if (const auto result = CanSendTo(extuuid, running, ready, peer); result.Failed()) return result;
+
+		return peer.Send(Message(MessageOptions(MessageType::ExtenderCommunication,
+												extuuid, std::move(buffer), params.Compress)),
+						 params.Priority, params.Delay, std::move(callback));
+	}
+
+	Result<Size> Manager::SendToPeers(const ExtenderUUID& extuuid, const std::atomic_bool& running, const std::atomic_bool& ready,
+									  const Vector<PeerLUID>& pluids, Buffer&& buffer, const SendParameters& params) noexcept
+	{
+		// Fragmenting isn't supported
+		if (buffer.GetSize() > Message::MaxMessageDataSize) return ResultCode::InvalidArgument;
+
+		std::shared_ptr<const SharedMessage> smsg;
+
+		try
+		{
+			smsg = std::make_shared<const SharedMessage>(MessageOptions(MessageType::ExtenderCommunication,
+																		 extuuid, std::move(buffer), params.Compress));
+			if (!smsg->IsValid()) return ResultCode::Failed;
+		}
+		catch (...) { return ResultCode::OutOfMemory; }
+
+		// The message data gets stored and encoded only once and all peers
+		// reference it; peers that can't receive the message are skipped
+		Size num{ 0 };
+
+		for (const auto pluid : pluids)
+		{
+			if (auto peerths = Get(pluid); peerths != nullptr)
+			{
+				auto peer = peerths->WithUniqueLock();
+
+				if (CanSendTo(extuuid, running, ready, *peer).Succeeded() &&
+					peer->Send(Message(smsg), params.Priority, params.Delay).Succeeded())
+				{
+					++num;
+				}
+			}
+		}
+
+		return num;
+	}
+
+	Result<> Manager::CanSendTo(const ExtenderUUID& extuuid, const std::atomic_bool& running, const std::atomic_bool& ready,
+								Peer& peer) const noexcept
 	{
 		// Only if peer status is ready (handshake succeeded, etc.)
 		if (peer.IsReady())
@@ -1279,12 +1677,7 @@ namespace QuantumGate::Implementation::Core::Peer
 				if (running)
 				{
 					// If extender is ready
-					if (ready)
-					{
-						return peer.Send(Message(MessageOptions(MessageType::ExtenderCommunication,
-																extuuid, std::move(buffer), params.Compress)),
-										 params.Priority, params.Delay, std::move(callback));
-					}
+					if (ready) return ResultCode::Succeeded;
 					else return ResultCode::FailedRetry;
 				}
 				else return ResultCode::NotRunning;
@@ -9,10 +9,13 @@
 #include "..\..\Concurrency\Queue.h"
 #include "..\..\Concurrency\ThreadPool.h"
 #include "..\..\Concurrency\EventGroup.h"
+#include "..\..\Concurrency\ConditionEvent.h"
 #include "..\KeyGeneration\KeyGenerationManager.h"
 #include "..\Relay\RelayManager.h"
 #include "..\UDP\UDPConnectionManager.h"
 #include "PeerLookupMaps.h"
+#include "PeerHandshake.h"
+#include "PeerThreadPoolBalance.h"
 
 namespace QuantumGate::Implementation::Core::Peer
 {
@@ -42,11 +45,27 @@ namespace QuantumGate::Implementation::Core::Peer
 		public:
 			PeerMap_ThS PeerMap;
 			ThreadPoolTaskQueue_ThS TaskQueue;
+			UInt16 NumaNode{ 0 };		// Of the processors the threads are pinned to, if any
 
 		private:
 			Concurrency::EventGroup WorkEvents;
 
+			// Work done by the threads since the last rebalance
+			std::atomic<UInt64> BusyTime{ 0 };
+
 		public:
+			inline void AddLoad(const std::chrono::nanoseconds busy_time) noexcept
+			{
+				BusyTime.fetch_add(static_cast<UInt64>(busy_time.count()), std::memory_order_relaxed);
+			}
+
+			[[nodiscard]] inline ThreadPoolLoad ResetLoad() noexcept
+			{
+				return ThreadPoolLoad{
+					.BusyTime = std::chrono::nanoseconds(BusyTime.exchange(0, std::memory_order_relaxed))
+				};
+			}
+
 			[[nodiscard]] inline bool InitializeWorkEvents() noexcept { return WorkEvents.Initialize(); }
 			inline void DeinitializeWorkEvents() noexcept { WorkEvents.Deinitialize(); }
 			inline void ClearWorkEvents() noexcept { WorkEvents.RemoveAllEvents(); }
@@ -58,6 +77,25 @@ namespace QuantumGate::Implementation::Core::Peer
 		using ThreadPool = Concurrency::ThreadPool<ThreadPoolData>;
 		using ThreadPoolMap = Containers::UnorderedMap<UInt64, std::unique_ptr<ThreadPool>>;
 
+		using HandshakeTaskQueue = Containers::PriorityQueue<HandshakeTask, Vector<HandshakeTask>,
+															  decltype(&HandshakeTask::Compare)>;
+
+		struct HandshakeTaskQueueData final
+		{
+			HandshakeTaskQueue Queue{ &HandshakeTask::Compare };
+			UInt64 NextSequence{ 0 };
+		};
+
+		using HandshakeTaskQueue_ThS = Concurrency::ThreadSafe<HandshakeTaskQueueData, std::mutex>;
+
+		struct HandshakeThreadPoolData final
+		{
+			HandshakeTaskQueue_ThS TaskQueue;
+			Concurrency::ConditionEvent WorkEvent;
+		};
+
+		using HandshakeThreadPool = Concurrency::ThreadPool<HandshakeThreadPoolData>;
+
 	public:
 		Manager() = delete;
 		Manager(const Settings_CThS& settings, LocalEnvironment_ThS& environment, UDP::Connection::Manager& udpmgr,
@@ -111,8 +149,14 @@ namespace QuantumGate::Implementation::Core::Peer
 		Result<> SendTo(const ExtenderUUID& extuuid, const std::atomic_bool& running, const std::atomic_bool& ready,
 						API::Peer& api_peer, Buffer&& buffer, const SendParameters& params, SendCallback&& callback) noexcept;
 
+		Result<Size> SendToPeers(const ExtenderUUID& extuuid, const std::atomic_bool& running, const std::atomic_bool& ready,
+								 const Vector<PeerLUID>& pluids, Buffer&& buffer, const SendParameters& params) noexcept;
+
 		Result<> Broadcast(const MessageType msgtype, const Buffer& buffer, BroadcastCallback&& callback);
 
+		[[nodiscard]] bool CanAcceptInboundHandshake() const noexcept;
+		[[nodiscard]] inline Size GetNumInboundHandshakesInProgress() const noexcept { return m_InboundHandshakes.GetNumInProgress(); }
+
 		const Vector<Address>* GetLocalAddresses() const noexcept;
 
 	private:
@@ -121,6 +165,8 @@ namespace QuantumGate::Implementation::Core::Peer
 
 		bool StartupThreadPools() noexcept;
 		void ShutdownThreadPools() noexcept;
+		bool StartupHandshakeThreadPool() noexcept;
+		void ShutdownHandshakeThreadPool() noexcept;
 		bool AddCallbacks() noexcept;
 		void RemoveCallbacks() noexcept;
 
@@ -164,6 +210,9 @@ namespace QuantumGate::Implementation::Core::Peer
 		Result<> SendTo(const ExtenderUUID& extuuid, const std::atomic_bool& running, const std::atomic_bool& ready,
 						Peer& peer, Buffer&& buffer, const SendParameters& params, SendCallback&& callback) noexcept;
 
+		Result<> CanSendTo(const ExtenderUUID& extuuid, const std::atomic_bool& running, const std::atomic_bool& ready,
+						   Peer& peer) const noexcept;
+
 		bool BroadcastExtenderUpdate();
 
 		void OnAccessUpdate() noexcept;
@@ -172,6 +221,13 @@ namespace QuantumGate::Implementation::Core::Peer
 
 		void SchedulePeerCallback(const UInt64 threadpool_key, Callback<void()>&& callback) noexcept;
 
+		void RebalanceThreadPools() noexcept;
+		[[nodiscard]] bool MovePeer(const PeerSharedPointer& peerths, const PeerLUID pluid,
+									const UInt64 from_key, const UInt64 to_key) noexcept;
+
+		[[nodiscard]] bool ScheduleHandshakeProcessing(const PeerSharedPointer& peerths, Peer& peer) noexcept;
+		void OnInboundHandshakeEnd() noexcept;
+
 		void AddReportedPublicEndpoint(const Endpoint& pub_endpoint, const Endpoint& rep_peer,
 									   const PeerConnectionType rep_con_type, const bool trusted) noexcept;
 
@@ -184,6 +240,10 @@ namespace QuantumGate::Implementation::Core::Peer
 		void WorkerThreadWaitInterrupt(ThreadPoolData& thpdata);
 		void WorkerThreadProcessor(ThreadPoolData& thpdata, const Concurrency::Event& shutdown_event);
 
+		void HandshakeThreadWait(HandshakeThreadPoolData& thpdata, const Concurrency::Event& shutdown_event);
+		void HandshakeThreadWaitInterrupt(HandshakeThreadPoolData& thpdata);
+		void HandshakeThreadProcessor(HandshakeThreadPoolData& thpdata, const Concurrency::Event& shutdown_event);
+
 	private:
 		std::atomic_bool m_Running{ false };
 		const Settings_CThS& m_Settings;
@@ -196,6 +256,9 @@ namespace QuantumGate::Implementation::Core::Peer
 		LookupMaps_ThS m_LookupMaps;
 		PeerMap_ThS m_AllPeers;
 		ThreadPoolMap m_ThreadPools;
+		std::atomic<SteadyTime> m_LastRebalanceSteadyTime;
+		HandshakeThreadPool m_HandshakeThreadPool;
+		HandshakeAdmission m_InboundHandshakes;
 
 		Relay::Manager m_RelayManager{ *this };
 
@@ -131,6 +131,19 @@ namespace QuantumGate::Implementation::Core::Peer
 		return MessageProcessor::Result{ .Handled = false, .Success = false };
 	}
 
+	bool MessageProcessor::IsPeerProtocolVersionSupported(const UInt8 major, const UInt8 minor) const noexcept
+	{
+		// Peers with another protocol version may derive keys and
+		// nonces differently and wouldn't be able to communicate
+		const auto local_version = m_Peer.GetLocalProtocolVersion();
+		if (major == local_version.first && minor == local_version.second) return true;
+
+		LogErr(L"Peer %s uses protocol version %u.%u which is incompatible with the local protocol version %u.%u",
+			   m_Peer.GetPeerName().c_str(), major, minor, local_version.first, local_version.second);
+
+		return false;
+	}
+
 	MessageProcessor::Result MessageProcessor::ProcessMessageMetaExchange(const MessageDetails&& msg) const noexcept
 	{
 		MessageProcessor::Result result;
@@ -159,34 +172,37 @@ namespace QuantumGate::Implementation::Core::Peer
 				{
 					m_Peer.SetPeerProtocolVersion(std::make_pair(v1, v2));
 
-					const auto& algorithms = m_Peer.GetSupportedAlgorithms();
+					if (IsPeerProtocolVersionSupported(v1, v2))
+					{
+						const auto& algorithms = m_Peer.GetSupportedAlgorithms();
 
-					const auto ha = Crypto::ChooseAlgorithm(algorithms.Hash, phal);
-					const auto paa = Crypto::ChooseAlgorithm(algorithms.PrimaryAsymmetric, ppaal);
-					const auto saa = Crypto::ChooseAlgorithm(algorithms.SecondaryAsymmetric, psaal);
-					const auto sa = Crypto::ChooseAlgorithm(algorithms.Symmetric, psal);
-					const auto ca = Crypto::ChooseAlgorithm(algorithms.Compression, pcal);
+						const auto ha = Crypto::ChooseAlgorithm(algorithms.Hash, phal);
+						const auto paa = Crypto::ChooseAlgorithm(algorithms.PrimaryAsymmetric, ppaal);
+						const auto saa = Crypto::ChooseAlgorithm(algorithms.SecondaryAsymmetric, psaal);
+						const auto sa = Crypto::ChooseAlgorithm(algorithms.Symmetric, psal);
+						const auto ca = Crypto::ChooseAlgorithm(algorithms.Compression, pcal);
 
-					Dbg(L"Chosen algorithms - Hash: %s, Primary Asymmetric: %s, Secondary Asymmetric: %s, Symmetric: %s, Compression: %s",
-						Crypto::GetAlgorithmName(ha), Crypto::GetAlgorithmName(paa), Crypto::GetAlgorithmName(saa),
-						Crypto::GetAlgorithmName(sa), Crypto::GetAlgorithmName(ca));
+						Dbg(L"Chosen algorithms - Hash: %s, Primary Asymmetric: %s, Secondary Asymmetric: %s, Symmetric: %s, Compression: %s",
+							Crypto::GetAlgorithmName(ha), Crypto::GetAlgorithmName(paa), Crypto::GetAlgorithmName(saa),
+							Crypto::GetAlgorithmName(sa), Crypto::GetAlgorithmName(ca));
 
-					if (m_Peer.SetAlgorithms(ha, paa, saa, sa, ca))
-					{
-						BufferWriter wrt(true);
-						if (wrt.WriteWithPreallocation(m_Peer.GetLocalProtocolVersion().first,
-													   m_Peer.GetLocalProtocolVersion().second, ha, paa, saa, sa, ca))
+						if (m_Peer.SetAlgorithms(ha, paa, saa, sa, ca))
 						{
-							if (m_Peer.SendWithRandomDelay(MessageType::EndMetaExchange, wrt.MoveWrittenBytes(),
-														   m_Peer.GetHandshakeDelayPerMessage()))
+							BufferWriter wrt(true);
+							if (wrt.WriteWithPreallocation(m_Peer.GetLocalProtocolVersion().first,
+														   m_Peer.GetLocalProtocolVersion().second, ha, paa, saa, sa, ca))
 							{
-								result.Success = m_Peer.SetStatus(Status::PrimaryKeyExchange);
+								if (m_Peer.SendWithRandomDelay(MessageType::EndMetaExchange, wrt.MoveWrittenBytes(),
+															   m_Peer.GetHandshakeDelayPerMessage()))
+								{
+									result.Success = m_Peer.SetStatus(Status::PrimaryKeyExchange);
+								}
+								else LogDbg(L"Couldn't send EndMetaExchange message to peer %s", m_Peer.GetPeerName().c_str());
 							}
-							else LogDbg(L"Couldn't send EndMetaExchange message to peer %s", m_Peer.GetPeerName().c_str());
+							else LogDbg(L"Couldn't prepare EndMetaExchange message for peer %s", m_Peer.GetPeerName().c_str());
 						}
-						else LogDbg(L"Couldn't prepare EndMetaExchange message for peer %s", m_Peer.GetPeerName().c_str());
+						else LogDbg(L"Couldn't set algorithms for peer %s", m_Peer.GetPeerName().c_str());
 					}
-					else LogDbg(L"Couldn't set algorithms for peer %s", m_Peer.GetPeerName().c_str());
 				}
 				else LogDbg(L"Invalid BeginMetaExchange message from peer %s; couldn't read message data",
 							m_Peer.GetPeerName().c_str());
@@ -215,18 +231,21 @@ namespace QuantumGate::Implementation::Core::Peer
 				{
 					m_Peer.SetPeerProtocolVersion(std::make_pair(v1, v2));
 
-					Dbg(L"Chosen algorithms - Hash: %s, Primary Asymmetric: %s, Secondary Asymmetric: %s, Symmetric: %s, Compression: %s",
-						Crypto::GetAlgorithmName(ha), Crypto::GetAlgorithmName(paa), Crypto::GetAlgorithmName(saa),
-						Crypto::GetAlgorithmName(sa), Crypto::GetAlgorithmName(ca));
-
-					if (m_Peer.SetAlgorithms(ha, paa, saa, sa, ca))
+					if (IsPeerProtocolVersionSupported(v1, v2))
 					{
-						if (SendBeginPrimaryKeyExchange())
+						Dbg(L"Chosen algorithms - Hash: %s, Primary Asymmetric: %s, Secondary Asymmetric: %s, Symmetric: %s, Compression: %s",
+							Crypto::GetAlgorithmName(ha), Crypto::GetAlgorithmName(paa), Crypto::GetAlgorithmName(saa),
+							Crypto::GetAlgorithmName(sa), Crypto::GetAlgorithmName(ca));
+
+						if (m_Peer.SetAlgorithms(ha, paa, saa, sa, ca))
 						{
-							result.Success = m_Peer.SetStatus(Status::PrimaryKeyExchange);
+							if (SendBeginPrimaryKeyExchange())
+							{
+								result.Success = m_Peer.SetStatus(Status::PrimaryKeyExchange);
+							}
 						}
+						else LogDbg(L"Couldn't set encryption algorithms for peer %s", m_Peer.GetPeerName().c_str());
 					}
-					else LogDbg(L"Couldn't set encryption algorithms for peer %s", m_Peer.GetPeerName().c_str());
 				}
 				else LogDbg(L"Invalid EndMetaExchange message from peer %s; couldn't read message data",
 							m_Peer.GetPeerName().c_str());
@@ -45,6 +45,8 @@ namespace QuantumGate::Implementation::Core::Peer
 		[[nodiscard]] bool SendBeginKeyExchange(const MessageType type) const noexcept;
 		[[nodiscard]] bool SendBeginPrimaryKeyUpdateExchange() const noexcept;
 
+		[[nodiscard]] bool IsPeerProtocolVersionSupported(const UInt8 major, const UInt8 minor) const noexcept;
+
 		[[nodiscard]] Result ProcessMessageMetaExchange(const MessageDetails&& msg) const noexcept;
 		[[nodiscard]] Result ProcessMessagePrimaryKeyExchange(MessageDetails&& msg) const noexcept;
 		[[nodiscard]] Result ProcessMessageSecondaryKeyExchange(MessageDetails&& msg) const noexcept;
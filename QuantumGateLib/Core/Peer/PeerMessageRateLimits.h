@@ -13,13 +13,13 @@ namespace QuantumGate::Implementation::Core::Peer
 		// Rate limits should be large enough to hold at least one full size message
 		// and can be larger to buffer more data at the cost of using more memory
 		// per peer connection, and the increased risk of out of memory attacks
-		using ExtenderCommunicationSendRateLimit = RateLimit<Size, 0, Message::MaxMessageDataSize>;
-		using ExtenderCommunicationReceiveRateLimit = RateLimit<Size, 0, Message::MaxMessageDataSize>;
+		using ExtenderCommunicationSendRateLimit = DynamicRateLimit<Size>;
+		using ExtenderCommunicationReceiveRateLimit = DynamicRateLimit<Size>;
 
-		using NoiseSendRateLimit = RateLimit<Size, 0, Message::MaxMessageDataSize>;
+		using NoiseSendRateLimit = DynamicRateLimit<Size>;
 		
-		using RelayDataSendRateLimit = RateLimit<Size, 0, Message::MaxMessageDataSize>;
-		using RelayDataReceiveRateLimit = RateLimit<Size, 0, Message::MaxMessageDataSize>;
+		using RelayDataSendRateLimit = DynamicRateLimit<Size>;
+		using RelayDataReceiveRateLimit = DynamicRateLimit<Size>;
 
 	public:
 		struct Type final
@@ -158,11 +158,77 @@ namespace QuantumGate::Implementation::Core::Peer
 			}
 		}
 
+		template<typename T>
+		constexpr inline void SetMaximum(const Size num) noexcept
+		{
+			// Never smaller than one full size message and never
+			// larger than what the limits are able to keep track of
+			const auto max_size = std::clamp(num, MinimumSize, MaximumSize);
+
+			if constexpr (std::is_same_v<T, Type::ExtenderCommunicationSend>)
+			{
+				m_ExtenderCommunicationSend.SetMaximum(max_size);
+			}
+			else if constexpr (std::is_same_v<T, Type::ExtenderCommunicationReceive>)
+			{
+				m_ExtenderCommunicationReceive.SetMaximum(max_size);
+			}
+			else if constexpr (std::is_same_v<T, Type::NoiseSend>)
+			{
+				m_NoiseSend.SetMaximum(max_size);
+			}
+			else if constexpr (std::is_same_v<T, Type::RelayDataSend>)
+			{
+				m_RelayDataSend.SetMaximum(max_size);
+			}
+			else if constexpr (std::is_same_v<T, Type::RelayDataReceive>)
+			{
+				m_RelayDataReceive.SetMaximum(max_size);
+			}
+			else
+			{
+				static_assert(AlwaysFalse<T>, "Unsupported type.");
+			}
+		}
+
+		template<typename T>
+		[[nodiscard]] constexpr inline Size GetMaximum() const noexcept
+		{
+			if constexpr (std::is_same_v<T, Type::ExtenderCommunicationSend>)
+			{
+				return m_ExtenderCommunicationSend.GetMaximum();
+			}
+			else if constexpr (std::is_same_v<T, Type::ExtenderCommunicationReceive>)
+			{
+				return m_ExtenderCommunicationReceive.GetMaximum();
+			}
+			else if constexpr (std::is_same_v<T, Type::NoiseSend>)
+			{
+				return m_NoiseSend.GetMaximum();
+			}
+			else if constexpr (std::is_same_v<T, Type::RelayDataSend>)
+			{
+				return m_RelayDataSend.GetMaximum();
+			}
+			else if constexpr (std::is_same_v<T, Type::RelayDataReceive>)
+			{
+				return m_RelayDataReceive.GetMaximum();
+			}
+			else
+			{
+				static_assert(AlwaysFalse<T>, "Unsupported type.");
+			}
+		}
+
+	public:
+		static constexpr Size MinimumSize{ Message::MaxMessageDataSize };
+		static constexpr Size MaximumSize{ 1'073'741'824 };
+
 	private:
-		ExtenderCommunicationSendRateLimit m_ExtenderCommunicationSend;
-		ExtenderCommunicationReceiveRateLimit m_ExtenderCommunicationReceive;
-		NoiseSendRateLimit m_NoiseSend;
-		RelayDataSendRateLimit m_RelayDataSend;
-		RelayDataReceiveRateLimit m_RelayDataReceive;
+		ExtenderCommunicationSendRateLimit m_ExtenderCommunicationSend{ MinimumSize };
+		ExtenderCommunicationReceiveRateLimit m_ExtenderCommunicationReceive{ MinimumSize };
+		NoiseSendRateLimit m_NoiseSend{ MinimumSize };
+		RelayDataSendRateLimit m_RelayDataSend{ MinimumSize };
+		RelayDataReceiveRateLimit m_RelayDataReceive{ MinimumSize };
 	};
 }
\ No newline at end of file
@@ -31,6 +31,13 @@ namespace QuantumGate::Implementation::Core::Peer
 
 		if (!m_Peer.GetMessageRateLimits().CanAdd<T>(msg_size))
 		{
+			if constexpr (std::is_same_v<T, MessageRateLimits::Type::ExtenderCommunicationSend>)
+			{
+				// Remember the extender so that it can be notified
+				// when there's room in the send buffer again
+				OnSendBufferFull(msg.GetExtenderUUID());
+			}
+
 			return ResultCode::PeerSendBufferFull;
 		}
 
@@ -89,6 +96,7 @@ namespace QuantumGate::Implementation::Core::Peer
 		{
 			case MessageType::ExtenderCommunication:
 				m_Peer.GetMessageRateLimits().Subtract<MessageRateLimits::Type::ExtenderCommunicationSend>(data_size);
+				CheckSendBufferAvailable();
 				break;
 			case MessageType::Noise:
 				m_Peer.GetMessageRateLimits().Subtract<MessageRateLimits::Type::NoiseSend>(data_size);
@@ -103,7 +111,7 @@ namespace QuantumGate::Implementation::Core::Peer
 		if (send_callback) m_Peer.ScheduleCallback(std::move(send_callback));
 	}
 
-	std::pair<bool, Size> PeerSendQueues::GetMessages(Buffer& buffer, const Crypto::SymmetricKeyData& symkey,
+	std::pair<bool, Size> PeerSendQueues::GetMessages(Memory::PacketBuffer& buffer, const Crypto::SymmetricKeyData& symkey,
 													  const bool concatenate) noexcept
 	{
 		// Expedited queue messages always go first
@@ -116,8 +124,6 @@ namespace QuantumGate::Implementation::Core::Peer
 		auto stop = false;
 		Size num{ 0 };
 
-		Buffer tempbuf;
-
 		// We keep filling the message transport buffer as much as possible
 		// for efficiency when allowed; note that priority is given to
 		// normal messages and delayed messages (noise etc.) get sent when
@@ -127,17 +133,13 @@ namespace QuantumGate::Implementation::Core::Peer
 		while (!m_NormalQueue.empty())
 		{
 			auto& msg = m_NormalQueue.front();
-			if (msg.Message.Write(tempbuf, symkey))
+			const auto prev_size = buffer.GetSize();
+
+			// Messages get written directly into the message transport buffer
+			if (msg.Message.Write(buffer, symkey))
 			{
-				if (buffer.GetSize() + tempbuf.GetSize() <= MessageTransport::MaxMessageDataSize)
+				if (buffer.GetSize() <= MessageTransport::MaxMessageDataSize)
 				{
-					try { buffer += tempbuf; }
-					catch (...)
-					{
-						success = false;
-						break;
-					}
-
 					RemoveMessage(m_NormalQueue);
 
 					++num;
@@ -152,7 +154,9 @@ namespace QuantumGate::Implementation::Core::Peer
 				}
 				else
 				{
-					// Message buffer is full
+					// Message buffer is full; message
+					// will get sent in the next transport
+					buffer.RemoveLast(buffer.GetSize() - prev_size);
 					stop = true;
 					break;
 				}
@@ -172,17 +176,12 @@ namespace QuantumGate::Implementation::Core::Peer
 				auto& dmsg = m_DelayedQueue.front();
 				if (dmsg.IsTime())
 				{
-					if (dmsg.Message.Write(tempbuf, symkey))
+					const auto prev_size = buffer.GetSize();
+
+					if (dmsg.Message.Write(buffer, symkey))
 					{
-						if (buffer.GetSize() + tempbuf.GetSize() <= MessageTransport::MaxMessageDataSize)
+						if (buffer.GetSize() <= MessageTransport::MaxMessageDataSize)
 						{
-							try { buffer += tempbuf; }
-							catch (...)
-							{
-								success = false;
-								break;
-							}
-
 							RemoveMessage(m_DelayedQueue);
 
 							++num;
@@ -197,6 +196,7 @@ namespace QuantumGate::Implementation::Core::Peer
 						else
 						{
 							// Message buffer is full
+							buffer.RemoveLast(buffer.GetSize() - prev_size);
 							break;
 						}
 					}
@@ -227,7 +227,7 @@ namespace QuantumGate::Implementation::Core::Peer
 		return std::make_pair(success, num);
 	}
 
-	std::pair<bool, Size> PeerSendQueues::GetExpeditedMessages(Buffer& buffer,
+	std::pair<bool, Size> PeerSendQueues::GetExpeditedMessages(Memory::PacketBuffer& buffer,
 															   const Crypto::SymmetricKeyData& symkey) noexcept
 	{
 		assert(!m_ExpeditedQueue.empty());
@@ -256,6 +256,49 @@ namespace QuantumGate::Implementation::Core::Peer
 		return std::make_pair(success, num);
 	}
 
+	void PeerSendQueues::OnSendBufferFull(const ExtenderUUID& extuuid) noexcept
+	{
+		try
+		{
+			if (std::find(m_SendBufferFullExtenders.begin(), m_SendBufferFullExtenders.end(),
+						  extuuid) == m_SendBufferFullExtenders.end())
+			{
+				m_SendBufferFullExtenders.emplace_back(extuuid);
+			}
+		}
+		catch (...)
+		{
+			// Extender won't get notified; it will
+			// have to retry sending on its own
+		}
+	}
+
+	void PeerSendQueues::CheckSendBufferAvailable() noexcept
+	{
+		if (m_SendBufferFullExtenders.empty()) return;
+
+		// Extenders only get peer events while the peer is ready; they
+		// may already have processed a disconnect event and removed the peer
+		if (!m_Peer.IsReady())
+		{
+			m_SendBufferFullExtenders.clear();
+			return;
+		}
+
+		const auto& rate_limits = m_Peer.GetMessageRateLimits();
+		const auto max_size = rate_limits.GetMaximum<MessageRateLimits::Type::ExtenderCommunicationSend>();
+		const auto available = rate_limits.GetAvailable<MessageRateLimits::Type::ExtenderCommunicationSend>();
+		const auto threshold = static_cast<double>(m_Peer.GetSettings().Local.PeerBuffers.SendBufferAvailableThreshold) / 100.0;
+
+		// Only notify once enough room became available so that extenders don't
+		// get woken up for every message that leaves the send buffer
+		if (static_cast<double>(available) >= static_cast<double>(max_size) * threshold)
+		{
+			m_Peer.ProcessEvent(m_SendBufferFullExtenders, Event::Type::SendBufferAvailable);
+			m_SendBufferFullExtenders.clear();
+		}
+	}
+
 	Size PeerSendQueues::GetAvailableExtenderCommunicationBufferSize() const noexcept
 	{
 		return m_Peer.GetMessageRateLimits().GetAvailable<MessageRateLimits::Type::ExtenderCommunicationSend>();
@@ -53,9 +53,11 @@ namespace QuantumGate::Implementation::Core::Peer
 		Result<> AddMessage(Message&& msg, const SendParameters::PriorityOption priority,
 							const std::chrono::milliseconds delay, SendCallback&& callback) noexcept;
 
-		[[nodiscard]] std::pair<bool, Size> GetMessages(Buffer& buffer, const Crypto::SymmetricKeyData& symkey,
+		[[nodiscard]] std::pair<bool, Size> GetMessages(Memory::PacketBuffer& buffer, const Crypto::SymmetricKeyData& symkey,
 														const bool concatenate) noexcept;
 
+		inline void ClearSendBufferFullExtenders() noexcept { m_SendBufferFullExtenders.clear(); }
+
 		[[nodiscard]] Size GetAvailableExtenderCommunicationBufferSize() const noexcept;
 		[[nodiscard]] Size GetAvailableRelayDataBufferSize() const noexcept;
 		[[nodiscard]] Size GetAvailableNoiseBufferSize() const noexcept;
@@ -68,13 +70,17 @@ namespace QuantumGate::Implementation::Core::Peer
 		template<typename T>
 		void RemoveMessage(T& queue) noexcept;
 
-		[[nodiscard]] std::pair<bool, Size> GetExpeditedMessages(Buffer& buffer,
+		[[nodiscard]] std::pair<bool, Size> GetExpeditedMessages(Memory::PacketBuffer& buffer,
 																 const Crypto::SymmetricKeyData& symkey) noexcept;
 
+		void OnSendBufferFull(const ExtenderUUID& extuuid) noexcept;
+		void CheckSendBufferAvailable() noexcept;
+
 	private:
 		Peer& m_Peer;
 		MessageQueue m_NormalQueue;
 		MessageQueue m_ExpeditedQueue;
 		DelayedMessageQueue m_DelayedQueue;
+		Vector<ExtenderUUID> m_SendBufferFullExtenders;
 	};
 }
\ No newline at end of file
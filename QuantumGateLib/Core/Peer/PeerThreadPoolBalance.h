@@ -0,0 +1,115 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+namespace QuantumGate::Implementation::Core::Peer
+{
+	// Work done for a peer (or for all peers of a threadpool) by the
+	// threadpool, used for spreading the load among the threadpools
+	struct ThreadPoolLoad final
+	{
+		std::chrono::nanoseconds BusyTime{ 0 };
+	};
+
+	// Peers stay with a threadpool for as long as they're connected unless the load
+	// gets unevenly spread among the threadpools; peers then get moved from the
+	// busiest threadpool to the idlest one. To prevent peers from getting moved back
+	// and forth the difference in load has to be large enough, and peers that were
+	// recently added or moved don't get moved. Peers also stay on the NUMA node of
+	// their threadpool so that they keep the processors and caches of that node.
+	class ThreadPoolBalance final
+	{
+	public:
+		static constexpr std::chrono::seconds Interval{ 10 };
+		static constexpr std::chrono::seconds PeerMinDuration{ 60 };
+		static constexpr double MinBusyShare{ 0.05 };		// Of the interval the busiest threadpool should be busy
+		static constexpr double MinLoadRatio{ 1.5 };		// Of the load of the busiest to the idlest threadpool
+
+		struct ThreadPool final
+		{
+			UInt64 Key{ 0 };
+			UInt16 Node{ 0 };
+			ThreadPoolLoad Load;
+		};
+
+		struct Move final
+		{
+			ThreadPool From;
+			ThreadPool To;
+			std::chrono::nanoseconds MaxPeerBusyTime{ 0 };
+		};
+
+		ThreadPoolBalance() = delete;
+
+		// Returns the threadpools on the same node to move a peer between, and the
+		// most load that peer may have, or nothing if the load is spread well enough
+		[[nodiscard]] static std::optional<Move> SelectThreadPools(const Vector<ThreadPool>& thpools,
+																   const std::chrono::nanoseconds interval) noexcept
+		{
+			std::optional<Move> move;
+
+			for (auto it = thpools.begin(); it != thpools.end(); ++it)
+			{
+				// Every node only once
+				if (std::any_of(thpools.begin(), it, [&](const auto& thpool) { return (thpool.Node == it->Node); }))
+				{
+					continue;
+				}
+
+				const auto node_move = SelectThreadPools(thpools, it->Node, interval);
+				if (node_move && (!move || node_move->MaxPeerBusyTime > move->MaxPeerBusyTime))
+				{
+					move = node_move;
+				}
+			}
+
+			return move;
+		}
+
+		// Returns true if a peer with the given load, that has been with its threadpool
+		// for the given duration, should be moved rather than the current candidate
+		[[nodiscard]] static bool IsBetterPeer(const Move& move, const ThreadPoolLoad& load,
+											   const std::chrono::nanoseconds duration,
+											   const ThreadPoolLoad& candidate_load) noexcept
+		{
+			return (load.BusyTime <= move.MaxPeerBusyTime && load.BusyTime > candidate_load.BusyTime &&
+					duration >= PeerMinDuration);
+		}
+
+	private:
+		[[nodiscard]] static std::optional<Move> SelectThreadPools(const Vector<ThreadPool>& thpools, const UInt16 node,
+																   const std::chrono::nanoseconds interval) noexcept
+		{
+			const ThreadPool* busiest{ nullptr };
+			const ThreadPool* idlest{ nullptr };
+
+			for (const auto& thpool : thpools)
+			{
+				if (thpool.Node != node) continue;
+
+				if (busiest == nullptr || thpool.Load.BusyTime > busiest->Load.BusyTime) busiest = &thpool;
+				if (idlest == nullptr || thpool.Load.BusyTime < idlest->Load.BusyTime) idlest = &thpool;
+			}
+
+			if (busiest == nullptr || busiest == idlest) return std::nullopt;
+
+			const auto busy_time = static_cast<double>(busiest->Load.BusyTime.count());
+			const auto idle_time = static_cast<double>(idlest->Load.BusyTime.count());
+
+			if (busy_time < static_cast<double>(interval.count()) * MinBusyShare ||
+				busy_time < idle_time * MinLoadRatio)
+			{
+				return std::nullopt;
+			}
+
+			// Moving a peer with more than half the difference in load
+			// would make the idlest threadpool busier than the busiest
+			return Move{
+				.From = *busiest,
+				.To = *idlest,
+				.MaxPeerBusyTime = (busiest->Load.BusyTime - idlest->Load.BusyTime) / 2
+			};
+		}
+	};
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "RelayManager.h"
 #include "..\Peer\PeerManager.h"
+#include "..\..\Concurrency\SpinWait.h"
 
 using namespace std::literals;
 
@@ -145,6 +146,10 @@ namespace QuantumGate::Implementation::Core::Relay
 			}
 		}
 
+		m_ThreadPool.SetAffinity(Util::GetThreadPoolAffinity(settings.Local.Concurrency.Affinity.Enabled,
+															 settings.Local.Concurrency.Affinity.SeparateIOAndCrypto,
+															 Util::ThreadPoolWorkload::IO, 1));
+
 		if (!error && m_ThreadPool.Startup())
 		{
 			return true;
@@ -611,6 +616,16 @@ namespace QuantumGate::Implementation::Core::Relay
 
 	void Manager::PrimaryThreadWait(ThreadPoolData& thpdata, ThreadData& thdata, const Concurrency::Event& shutdown_event)
 	{
+		const auto& busy_poll = GetSettings().Local.Concurrency.BusyPoll;
+		if (busy_poll.Enabled)
+		{
+			// Spin for a while looking for work before going to sleep
+			if (Concurrency::SpinWait(busy_poll.SpinBudget, [&]() noexcept
+			{
+				return (thpdata.WorkEvents.Wait(0ms).HadEvent || shutdown_event.IsSet());
+			})) return;
+		}
+
 		const auto result = thpdata.WorkEvents.Wait(1ms);
 		if (!result.Waited)
 		{
@@ -26,6 +26,7 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		const auto& listener_ports = settings.Local.Listeners.TCP.Ports;
 		const auto nat_traversal = settings.Local.Listeners.TCP.NATTraversal;
 		const auto cond_accept = settings.Local.Listeners.TCP.UseConditionalAcceptFunction;
+		const auto num_shards = settings.Local.Listeners.TCP.NumShards;
 
 		// Should have at least one port
 		if (listener_ports.empty())
@@ -34,6 +35,11 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 			return false;
 		}
 
+		if (cond_accept != UseConditionalAcceptFunction(cond_accept, num_shards))
+		{
+			LogWarn(L"TCP listenermanager is not using the conditional accept function because there is more than one shard per port; access checks will be done on the shard threads after accepting connections");
+		}
+
 		const std::array<IPAddress::Family, 2> afs{ IPAddress::Family::IPv4, IPAddress::Family::IPv6 };
 
 		for (const auto& af : afs)
@@ -58,18 +64,23 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 
 			if (address.has_value())
 			{
-				DiscardReturnValue(AddListenerThreads(*address, listener_ports, cond_accept, nat_traversal));
+				DiscardReturnValue(AddListenerThreads(*address, listener_ports, cond_accept, nat_traversal, num_shards));
 			}
 		}
 
-		if (m_ThreadPool.Startup())
+		if (m_ShardThreadPool.Startup())
 		{
-			m_Running = true;
-			m_ListeningOnAnyAddresses = true;
+			if (m_ThreadPool.Startup())
+			{
+				m_Running = true;
+				m_ListeningOnAnyAddresses = true;
 
-			LogSys(L"TCP listenermanager startup successful");
+				LogSys(L"TCP listenermanager startup successful");
+			}
+			else m_ShardThreadPool.Shutdown();
 		}
-		else LogErr(L"TCP listenermanager startup failed");
+
+		if (!m_Running) LogErr(L"TCP listenermanager startup failed");
 
 		return m_Running;
 	}
@@ -87,6 +98,7 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		const auto& listener_ports = settings.Local.Listeners.TCP.Ports;
 		const auto nat_traversal = settings.Local.Listeners.TCP.NATTraversal;
 		const auto cond_accept = settings.Local.Listeners.TCP.UseConditionalAcceptFunction;
+		const auto num_shards = settings.Local.Listeners.TCP.NumShards;
 
 		// Should have at least one port
 		if (listener_ports.empty())
@@ -95,6 +107,11 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 			return false;
 		}
 
+		if (cond_accept != UseConditionalAcceptFunction(cond_accept, num_shards))
+		{
+			LogWarn(L"TCP listenermanager is not using the conditional accept function because there is more than one shard per port; access checks will be done on the shard threads after accepting connections");
+		}
+
 		// Create a listening socket for each interface that's online
 		for (const auto& ifs : interfaces)
 		{
@@ -106,28 +123,36 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 					if (address.GetFamily() == IPAddress::Family::IPv4 ||
 						address.GetFamily() == IPAddress::Family::IPv6)
 					{
-						DiscardReturnValue(AddListenerThreads(address, listener_ports, cond_accept, nat_traversal));
+						DiscardReturnValue(AddListenerThreads(address, listener_ports, cond_accept,
+															  nat_traversal, num_shards));
 					}
 					else assert(false);
 				}
 			}
 		}
 
-		if (m_ThreadPool.Startup())
+		if (m_ShardThreadPool.Startup())
 		{
-			m_Running = true;
-			m_ListeningOnAnyAddresses = false;
+			if (m_ThreadPool.Startup())
+			{
+				m_Running = true;
+				m_ListeningOnAnyAddresses = false;
 
-			LogSys(L"TCP listenermanager startup successful");
+				LogSys(L"TCP listenermanager startup successful");
+			}
+			else m_ShardThreadPool.Shutdown();
 		}
-		else LogErr(L"TCP listenermanager startup failed");
+
+		if (!m_Running) LogErr(L"TCP listenermanager startup failed");
 
 		return m_Running;
 	}
 
 	bool Manager::AddListenerThreads(const IPAddress& address, const Vector<UInt16> ports,
-									 const bool cond_accept, const bool nat_traversal) noexcept
+									 const bool cond_accept, const bool nat_traversal, const Size num_shards) noexcept
 	{
+		assert(num_shards > 0);
+
 		// Separate listener for every port
 		for (const auto port : ports)
 		{
@@ -138,10 +163,25 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 				// Create and start the listenersocket
 				ThreadData ltd;
 				ltd.Socket = Network::Socket(endpoint.GetIPAddress().GetFamily(), Network::Socket::Type::Stream, Network::IP::Protocol::TCP);
-				ltd.UseConditionalAcceptFunction = cond_accept;
+				ltd.UseConditionalAcceptFunction = UseConditionalAcceptFunction(cond_accept, num_shards);
+
+				for (Size x = 0; x < num_shards; ++x)
+				{
+					ltd.Shards.emplace_back(std::make_shared<Shard>());
+				}
 				
 				if (ltd.Socket.Listen(endpoint, true, nat_traversal))
 				{
+					const auto shards = ltd.Shards;
+
+					// With only one shard the listener thread handles accepted
+					// connections itself, otherwise every shard gets a thread of its own
+					if (num_shards > 1 && !AddShardThreads(endpoint, shards, ltd.UseConditionalAcceptFunction))
+					{
+						LogErr(L"Could not add listener shard threads for endpoint %s", endpoint.GetString().c_str());
+						continue;
+					}
+
 					if (m_ThreadPool.AddThread(L"QuantumGate Listener Thread " + endpoint.GetString(),
 											   std::move(ltd), MakeCallback(this, &Manager::WorkerThreadProcessor)))
 					{
@@ -149,6 +189,8 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 					}
 					else
 					{
+						RemoveShardThreads(shards);
+
 						LogErr(L"Could not add listener thread for endpoint %s", endpoint.GetString().c_str());
 					}
 				}
@@ -164,10 +206,45 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		return true;
 	}
 
+	bool Manager::AddShardThreads(const IPEndpoint& endpoint, const Vector<std::shared_ptr<Shard>>& shards,
+								  const bool cond_accept) noexcept
+	{
+		for (const auto& shard : shards)
+		{
+			if (!m_ShardThreadPool.AddThread(L"QuantumGate Listener Shard Thread " + endpoint.GetString(),
+											 ShardThreadData{ .Shard = shard, .UseConditionalAcceptFunction = cond_accept },
+											 MakeCallback(this, &Manager::ShardWorkerThreadProcessor),
+											 MakeCallback(this, &Manager::ShardWorkerThreadWait),
+											 MakeCallback(this, &Manager::ShardWorkerThreadWaitInterrupt)))
+			{
+				RemoveShardThreads(shards);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Manager::RemoveShardThreads(const Vector<std::shared_ptr<Shard>>& shards) noexcept
+	{
+		auto thread = m_ShardThreadPool.GetFirstThread();
+
+		while (thread.has_value())
+		{
+			if (std::find(shards.begin(), shards.end(), thread->GetData().Shard) != shards.end())
+			{
+				thread = m_ShardThreadPool.RemoveThread(std::move(*thread)).second;
+			}
+			else thread = m_ShardThreadPool.GetNextThread(*thread);
+		}
+	}
+
 	std::optional<Manager::ThreadPool::ThreadType> Manager::RemoveListenerThread(Manager::ThreadPool::ThreadType&& thread) noexcept
 	{
 		const Endpoint endpoint = thread.GetData().Socket.GetLocalEndpoint();
 
+		RemoveShardThreads(thread.GetData().Shards);
+
 		const auto& [success, next_thread] = m_ThreadPool.RemoveThread(std::move(thread));
 		if (success)
 		{
@@ -194,6 +271,7 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		const auto& listener_ports = settings.Local.Listeners.TCP.Ports;
 		const auto nat_traversal = settings.Local.Listeners.TCP.NATTraversal;
 		const auto cond_accept = settings.Local.Listeners.TCP.UseConditionalAcceptFunction;
+		const auto num_shards = settings.Local.Listeners.TCP.NumShards;
 
 		// Check for interfaces/IP addresses that were added for which
 		// there are no listeners; we add listeners for those
@@ -222,7 +300,8 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 
 						if (!found)
 						{
-							DiscardReturnValue(AddListenerThreads(address, listener_ports, cond_accept, nat_traversal));
+							DiscardReturnValue(AddListenerThreads(address, listener_ports, cond_accept,
+																  nat_traversal, num_shards));
 						}
 					}
 				}
@@ -273,6 +352,7 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		LogSys(L"TCP listenermanager shutting down...");
 
 		m_ThreadPool.Shutdown();
+		m_ShardThreadPool.Shutdown();
 
 		ResetState();
 
@@ -288,6 +368,7 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 	{
 		m_ListeningOnAnyAddresses = false;
 		m_ThreadPool.Clear();
+		m_ShardThreadPool.Clear();
 	}
 
 	void Manager::WorkerThreadProcessor(ThreadPoolData& thpdata, ThreadData& thdata, const Concurrency::Event& shutdown_event)
@@ -303,7 +384,7 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 					LogInfo(L"Accepting new connection on endpoint %s",
 							thdata.Socket.GetLocalEndpoint().GetString().c_str());
 
-					AcceptConnection(thdata.Socket, thdata.UseConditionalAcceptFunction);
+					AcceptConnection(thdata.Socket, thdata.UseConditionalAcceptFunction, thdata.Shards);
 				}
 				else if (thdata.Socket.GetIOStatus().HasException())
 				{
@@ -322,49 +403,123 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		}
 	}
 
-	void Manager::AcceptConnection(Network::Socket& listener_socket, const bool cond_accept) noexcept
+	void Manager::ShardWorkerThreadWait(ThreadPoolData& thpdata, ShardThreadData& thdata, const Concurrency::Event& shutdown_event)
+	{
+		thdata.Shard->AcceptQueue.Wait(shutdown_event);
+	}
+
+	void Manager::ShardWorkerThreadWaitInterrupt(ThreadPoolData& thpdata, ShardThreadData& thdata)
+	{
+		thdata.Shard->AcceptQueue.InterruptWait();
+	}
+
+	void Manager::ShardWorkerThreadProcessor(ThreadPoolData& thpdata, ShardThreadData& thdata, const Concurrency::Event& shutdown_event)
+	{
+		Peer::PeerSharedPointer peerths{ nullptr };
+
+		thdata.Shard->AcceptQueue.PopFrontIf([&](auto& fpeerths) noexcept -> bool
+		{
+			peerths = std::move(fpeerths);
+			return true;
+		});
+
+		if (peerths != nullptr)
+		{
+			ProcessAcceptedConnection(peerths, thdata.UseConditionalAcceptFunction);
+		}
+	}
+
+	bool Manager::UseConditionalAcceptFunction(const bool cond_accept, const Size num_shards) noexcept
+	{
+		// The conditional accept function runs on the listener thread; with more than one
+		// shard the access checks are done on the shard threads instead, otherwise they
+		// would all still be done by the one listener thread
+		return (cond_accept && num_shards <= 1);
+	}
+
+	void Manager::AcceptConnection(Network::Socket& listener_socket, const bool cond_accept,
+								   const Vector<std::shared_ptr<Shard>>& shards) noexcept
 	{
 		auto peerths = m_PeerManager.CreateTCP(listener_socket.GetAddressFamily(), PeerConnectionType::Inbound, std::nullopt);
 		if (peerths != nullptr)
 		{
+			auto accepted{ false };
+			Size shard_index{ 0 };
+
 			peerths->WithUniqueLock([&](Peer::Peer& peer)
 			{
 				if (cond_accept)
 				{
-					if (!listener_socket.Accept(peer.GetSocket<TCP::Socket>(), true,
-												&Manager::AcceptConditionFunction, this))
-					{
-						// Couldn't accept for some reason
-						return;
-					}
+					accepted = listener_socket.Accept(peer.GetSocket<TCP::Socket>(), true,
+													  &Manager::AcceptConditionFunction, this);
 				}
 				else
 				{
-					if (listener_socket.Accept(peer.GetSocket<TCP::Socket>(), false, nullptr, nullptr))
-					{
-						// Check if the IP address is allowed
-						if (!CanAcceptConnection(peer.GetPeerEndpoint()))
-						{
-							peer.Close();
-							LogWarn(L"Incoming connection from peer %s was rejected; IP address is not allowed by access configuration",
-									peer.GetPeerName().c_str());
+					accepted = listener_socket.Accept(peer.GetSocket<TCP::Socket>(), false, nullptr, nullptr);
+				}
 
-							return;
-						}
-					}
+				if (accepted)
+				{
+					shard_index = ListenerShards::GetIndex(peer.GetPeerEndpoint().GetIPEndpoint().GetIPAddress(),
+														   shards.size());
 				}
+			});
+
+			// Couldn't accept for some reason
+			if (!accepted) return;
+
+			if (shards.size() == 1)
+			{
+				ProcessAcceptedConnection(peerths, cond_accept);
+				return;
+			}
 
-				if (m_PeerManager.Accept(peerths))
+			auto& shard = *shards[shard_index];
+
+			try
+			{
+				if (shard.AcceptQueue.GetSize() < MaxShardQueueSize)
 				{
-					LogInfo(L"Connection accepted from peer %s", peer.GetPeerName().c_str());
+					shard.AcceptQueue.Push(peerths);
+					return;
 				}
-				else
+			}
+			catch (...) {}
+
+			auto peer = peerths->WithUniqueLock();
+			peer->Close();
+			LogWarn(L"Incoming connection from peer %s was rejected; listener shard queue is full",
+					peer->GetPeerName().c_str());
+		}
+	}
+
+	void Manager::ProcessAcceptedConnection(Peer::PeerSharedPointer& peerths, const bool cond_accept) noexcept
+	{
+		peerths->WithUniqueLock([&](Peer::Peer& peer)
+		{
+			if (!cond_accept)
+			{
+				// Check if the IP address is allowed
+				if (!CanAcceptConnection(peer.GetPeerEndpoint()))
 				{
 					peer.Close();
-					LogErr(L"Could not accept connection from peer %s", peer.GetPeerName().c_str());
+					LogWarn(L"Incoming connection from peer %s was rejected; IP address is not allowed by access configuration",
+							peer.GetPeerName().c_str());
+
+					return;
 				}
-			});
-		}
+			}
+
+			if (m_PeerManager.Accept(peerths))
+			{
+				LogInfo(L"Connection accepted from peer %s", peer.GetPeerName().c_str());
+			}
+			else
+			{
+				peer.Close();
+				LogErr(L"Could not accept connection from peer %s", peer.GetPeerName().c_str());
+			}
+		});
 	}
 
 	bool Manager::CanAcceptConnection(const Address& ipaddr) const noexcept
@@ -4,13 +4,22 @@
 #pragma once
 
 #include "..\..\Concurrency\ThreadPool.h"
+#include "..\..\Concurrency\Queue.h"
 #include "..\Peer\PeerManager.h"
 #include "..\Access\AccessManager.h"
+#include "..\ListenerShards.h"
 
 namespace QuantumGate::Implementation::Core::TCP::Listener
 {
 	class Manager final
 	{
+		using AcceptQueue_ThS = Concurrency::Queue<Peer::PeerSharedPointer>;
+
+		struct Shard final
+		{
+			AcceptQueue_ThS AcceptQueue;
+		};
+
 		struct ThreadData final
 		{
 			ThreadData() noexcept = default;
@@ -27,12 +36,22 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 
 			Network::Socket Socket;
 			bool UseConditionalAcceptFunction{ true };
+			Vector<std::shared_ptr<Shard>> Shards;
+		};
+
+		struct ShardThreadData final
+		{
+			std::shared_ptr<Shard> Shard;
+			bool UseConditionalAcceptFunction{ true };
 		};
 
 		struct ThreadPoolData final
 		{};
 
 		using ThreadPool = Concurrency::ThreadPool<ThreadPoolData, ThreadData>;
+		using ShardThreadPool = Concurrency::ThreadPool<ThreadPoolData, ShardThreadData>;
+
+		static constexpr Size MaxShardQueueSize{ 1024 };
 
 	public:
 		Manager() = delete;
@@ -49,7 +68,8 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		[[nodiscard]] inline bool IsRunning() const noexcept { return m_Running; }
 
 		[[nodiscard]] bool AddListenerThreads(const IPAddress& address, const Vector<UInt16> ports,
-											  const bool cond_accept, const bool nat_traversal) noexcept;
+											  const bool cond_accept, const bool nat_traversal,
+											  const Size num_shards) noexcept;
 		std::optional<ThreadPool::ThreadType> RemoveListenerThread(ThreadPool::ThreadType&& thread) noexcept;
 		[[nodiscard]] bool Update(const Vector<API::Local::Environment::EthernetInterface>& interfaces) noexcept;
 
@@ -57,9 +77,21 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		void PreStartup() noexcept;
 		void ResetState() noexcept;
 
+		[[nodiscard]] bool AddShardThreads(const IPEndpoint& endpoint, const Vector<std::shared_ptr<Shard>>& shards,
+										   const bool cond_accept) noexcept;
+		void RemoveShardThreads(const Vector<std::shared_ptr<Shard>>& shards) noexcept;
+
 		void WorkerThreadProcessor(ThreadPoolData& thpdata, ThreadData& thdata, const Concurrency::Event& shutdown_event);
 
-		void AcceptConnection(Network::Socket& listener_socket, const bool cond_accept) noexcept;
+		void ShardWorkerThreadWait(ThreadPoolData& thpdata, ShardThreadData& thdata, const Concurrency::Event& shutdown_event);
+		void ShardWorkerThreadWaitInterrupt(ThreadPoolData& thpdata, ShardThreadData& thdata);
+		void ShardWorkerThreadProcessor(ThreadPoolData& thpdata, ShardThreadData& thdata, const Concurrency::Event& shutdown_event);
+
+		[[nodiscard]] static bool UseConditionalAcceptFunction(const bool cond_accept, const Size num_shards) noexcept;
+
+		void AcceptConnection(Network::Socket& listener_socket, const bool cond_accept,
+							  const Vector<std::shared_ptr<Shard>>& shards) noexcept;
+		void ProcessAcceptedConnection(Peer::PeerSharedPointer& peerths, const bool cond_accept) noexcept;
 
 		[[nodiscard]] bool CanAcceptConnection(const Address& ipaddr) const noexcept;
 
@@ -75,5 +107,6 @@ namespace QuantumGate::Implementation::Core::TCP::Listener
 		Peer::Manager& m_PeerManager;
 
 		ThreadPool m_ThreadPool;
+		ShardThreadPool m_ShardThreadPool;
 	};
 }
\ No newline at end of file
@@ -821,7 +821,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 	{
 		try
 		{
-			Buffer data;
+			Message::SendBuffer data;
 			if (msg.Write(data, m_SymmetricKeys[0]))
 			{
 				const auto now = Util::GetCurrentSteadyTime();
@@ -882,7 +882,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 	}
 
 	bool Connection::Send(const SteadyTime current_steadytime, const Message::Type msgtype,
-						  const std::optional<Message::SequenceNumber>& msgseqnum, Buffer&& msgdata,
+						  const std::optional<Message::SequenceNumber>& msgseqnum, Message::SendBuffer&& msgdata,
 						  std::shared_ptr<Listener::SendQueue_ThS>&& listener_send_queue,
 						  std::optional<IPEndpoint>&& peer_endpoint) noexcept
 	{
@@ -921,7 +921,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 		return false;
 	}
 
-	Result<Size> Connection::Send(const SteadyTime current_steadytime, const Buffer& msgdata,
+	Result<Size> Connection::Send(const SteadyTime current_steadytime, const Message::SendBuffer& msgdata,
 								  const std::shared_ptr<Listener::SendQueue_ThS>& listener_send_queue,
 								  const std::optional<IPEndpoint>& peer_endpoint) noexcept
 	{
@@ -933,7 +933,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 		{
 			try
 			{
-				listener_send_queue->WithUniqueLock()->emplace(
+				listener_send_queue->WithUniqueLock()->Push(
 					Listener::SendQueueItem{
 						.Endpoint = endpoint,
 						.Data = msgdata
@@ -33,7 +33,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 			std::optional<IPEndpoint> PeerEndpoint;
 			SteadyTime ScheduleSteadyTime;
 			std::chrono::milliseconds ScheduleMilliseconds{ 0 };
-			Buffer Data;
+			Message::SendBuffer Data;
 
 			inline bool IsTime(const SteadyTime now) const noexcept
 			{
@@ -194,10 +194,10 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 		[[nodiscard]] bool Send(Message&& msg, const std::chrono::milliseconds delay = std::chrono::milliseconds{ 0 },
 								const bool save_endpoint = false) noexcept;
 		[[nodiscard]] bool Send(const SteadyTime current_steadytime, const Message::Type msgtype,
-								const std::optional<Message::SequenceNumber>& msgseqnum, Buffer&& msgdata,
+								const std::optional<Message::SequenceNumber>& msgseqnum, Message::SendBuffer&& msgdata,
 								std::shared_ptr<Listener::SendQueue_ThS>&& listener_send_queue,
 								std::optional<IPEndpoint>&& peer_endpoint) noexcept;
-		[[nodiscard]] Result<Size> Send(const SteadyTime current_steadytime, const Buffer& msgdata,
+		[[nodiscard]] Result<Size> Send(const SteadyTime current_steadytime, const Message::SendBuffer& msgdata,
 										const std::shared_ptr<Listener::SendQueue_ThS>& listener_send_queue,
 										const std::optional<IPEndpoint>& peer_endpoint) noexcept;
 
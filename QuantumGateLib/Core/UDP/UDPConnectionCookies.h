@@ -87,9 +87,9 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 
 			CookieID cookieid{ 0 };
 
-			siphash(reinterpret_cast<const uint8_t*>(&cookieinfo), sizeof(cookieinfo),
-					reinterpret_cast<const uint8_t*>(&cookiekey.Key),
-					reinterpret_cast<uint8_t*>(&cookieid), sizeof(cookieid));
+			siphash_opt(reinterpret_cast<const uint8_t*>(&cookieinfo), sizeof(cookieinfo),
+						reinterpret_cast<const uint8_t*>(&cookiekey.Key),
+						reinterpret_cast<uint8_t*>(&cookieid), sizeof(cookieid));
 
 			return cookieid;
 		}
@@ -37,13 +37,13 @@ namespace QuantumGate::Implementation::Core::UDP
 			// Siphash requires keysize of 16
 			assert(global_sharedsecret.GetSize() >= 16);
 
-			siphash(reinterpret_cast<const uint8_t*>(local_input.GetBytes()), local_input.GetSize(),
-					reinterpret_cast<const uint8_t*>(global_sharedsecret.GetBytes()),
-					reinterpret_cast<uint8_t*>(local_output.GetBytes()), local_output.GetSize());
+			siphash_opt(reinterpret_cast<const uint8_t*>(local_input.GetBytes()), local_input.GetSize(),
+						reinterpret_cast<const uint8_t*>(global_sharedsecret.GetBytes()),
+						reinterpret_cast<uint8_t*>(local_output.GetBytes()), local_output.GetSize());
 
-			siphash(reinterpret_cast<const uint8_t*>(peer_input.GetBytes()), peer_input.GetSize(),
-					reinterpret_cast<const uint8_t*>(global_sharedsecret.GetBytes()),
-					reinterpret_cast<uint8_t*>(peer_output.GetBytes()), peer_output.GetSize());
+			siphash_opt(reinterpret_cast<const uint8_t*>(peer_input.GetBytes()), peer_input.GetSize(),
+						reinterpret_cast<const uint8_t*>(global_sharedsecret.GetBytes()),
+						reinterpret_cast<uint8_t*>(peer_output.GetBytes()), peer_output.GetSize());
 		}
 		else
 		{
@@ -51,7 +51,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 			msg.SetMessageSequenceNumber(static_cast<Message::SequenceNumber>(Random::GetPseudoRandomNumber()));
 			msg.SetMessageData(Random::GetPseudoRandomBytes(snd_size));
 
-			Buffer data;
+			Message::SendBuffer data;
 			if (msg.Write(data, m_Connection.GetSymmetricKeys()))
 			{
 				m_MTUDMessageData.emplace(
@@ -319,7 +319,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 			Message msg(Message::Type::MTUD, Message::Direction::Outgoing, UDPMessageSizes::Min);
 			msg.SetMessageAckNumber(seqnum);
 
-			Buffer data;
+			Message::SendBuffer data;
 			if (msg.Write(data, connection.GetSymmetricKeys()))
 			{
 #ifdef UDPMTUD_DEBUG
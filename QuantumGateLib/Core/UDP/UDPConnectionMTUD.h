@@ -23,7 +23,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 			Message::SequenceNumber SequenceNumber{ 0 };
 			UInt NumTries{ 0 };
 			SteadyTime TimeSent;
-			Buffer Data;
+			Message::SendBuffer Data;
 			bool Acked{ false };
 		};
 
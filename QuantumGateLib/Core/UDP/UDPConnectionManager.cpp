@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "UDPConnectionManager.h"
 #include "..\..\Crypto\Crypto.h"
+#include "..\..\Concurrency\SpinWait.h"
 
 using namespace std::literals;
 
@@ -103,6 +104,10 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 			catch (...) { error = true; }
 		}
 
+		m_ThreadPool.SetAffinity(Util::GetThreadPoolAffinity(settings.Local.Concurrency.Affinity.Enabled,
+															 settings.Local.Concurrency.Affinity.SeparateIOAndCrypto,
+															 Util::ThreadPoolWorkload::IO, 0));
+
 		if (!error && m_ThreadPool.Startup())
 		{
 			return true;
@@ -180,6 +185,16 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 
 	void Manager::WorkerThreadWait(ThreadPoolData& thpdata, ThreadData& thdata, const Concurrency::Event& shutdown_event)
 	{
+		const auto& busy_poll = GetSettings().Local.Concurrency.BusyPoll;
+		if (busy_poll.Enabled)
+		{
+			// Spin for a while looking for work before going to sleep
+			if (Concurrency::SpinWait(busy_poll.SpinBudget, [&]() noexcept
+			{
+				return (thdata.WorkEvents->Wait(0ms).HadEvent || shutdown_event.IsSet());
+			})) return;
+		}
+
 		const auto result = thdata.WorkEvents->Wait(1ms);
 		if (!result.Waited)
 		{
@@ -24,7 +24,7 @@ namespace QuantumGate::Implementation::Core::UDP::Connection
 			UInt NumTries{ 0 };
 			SteadyTime TimeSent;
 			SteadyTime TimeResent;
-			Buffer Data;
+			Message::SendBuffer Data;
 			bool Acked{ false };
 			SteadyTime TimeAcked;
 		};
@@ -0,0 +1,115 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+#include "..\..\Network\SerializedBinaryIPAddress.h"
+#include "..\..\Crypto\Crypto.h"
+#include "..\..\..\QuantumGateCryptoLib\QuantumGateCryptoLib.h"
+
+namespace QuantumGate::Implementation::Core::UDP::Listener
+{
+	// Lock-free cache of access decisions keyed by IP address. Every entry is stamped
+	// with the epoch in which the decision was made; the epoch changes whenever the
+	// cache gets invalidated and when the maximum entry age has passed, so that decisions
+	// depending on time (reputation improvement) and connection counts don't get stale.
+	class AccessCache final
+	{
+		static constexpr Size NumEntries{ 4096 };
+		static constexpr std::chrono::milliseconds MaxEntryAge{ 1000 };
+
+		static_assert((NumEntries & (NumEntries - 1)) == 0, "Number of entries should be a power of 2");
+
+		// Entry layout: tag (32 bits) | epoch (30 bits) | valid (1 bit) | allowed (1 bit)
+		static constexpr UInt64 EpochMask{ 0x3FFFFFFF };
+		static constexpr UInt64 ValidBit{ 0b10 };
+		static constexpr UInt64 AllowedBit{ 0b01 };
+
+	public:
+		using Epoch = UInt64;
+
+		AccessCache() noexcept = default;
+		AccessCache(const AccessCache&) = delete;
+		AccessCache(AccessCache&&) = delete;
+		~AccessCache() = default;
+		AccessCache& operator=(const AccessCache&) = delete;
+		AccessCache& operator=(AccessCache&&) = delete;
+
+		[[nodiscard]] bool Initialize() noexcept
+		{
+			const auto rnd1 = Crypto::GetCryptoRandomNumber();
+			const auto rnd2 = Crypto::GetCryptoRandomNumber();
+			if (rnd1 && rnd2)
+			{
+				m_Key = { *rnd1, *rnd2 };
+
+				for (auto& entry : m_Entries)
+				{
+					entry.store(0, std::memory_order_relaxed);
+				}
+
+				Invalidate();
+
+				return true;
+			}
+
+			return false;
+		}
+
+		inline void Invalidate() noexcept
+		{
+			m_UpdateCount.fetch_add(1, std::memory_order_acq_rel);
+		}
+
+		// The epoch should be retrieved before making the decision that gets
+		// stored with it, so that a concurrent update invalidates that decision
+		[[nodiscard]] inline Epoch GetEpoch(const SteadyTime current_steadytime) const noexcept
+		{
+			const auto window = static_cast<UInt64>(current_steadytime.time_since_epoch() / MaxEntryAge);
+			return ((m_UpdateCount.load(std::memory_order_acquire) * 0x9E3779B97F4A7C15ull) + window) & EpochMask;
+		}
+
+		[[nodiscard]] std::optional<bool> GetAllowed(const IPAddress& ip, const Epoch epoch) const noexcept
+		{
+			const auto hash = GetHash(ip);
+			const auto entry = m_Entries[hash & (NumEntries - 1)].load(std::memory_order_acquire);
+
+			if ((entry & ~AllowedBit) == MakeEntry(hash, epoch, false))
+			{
+				return ((entry & AllowedBit) == AllowedBit);
+			}
+
+			return std::nullopt;
+		}
+
+		void SetAllowed(const IPAddress& ip, const Epoch epoch, const bool allowed) noexcept
+		{
+			const auto hash = GetHash(ip);
+			m_Entries[hash & (NumEntries - 1)].store(MakeEntry(hash, epoch, allowed), std::memory_order_release);
+		}
+
+	private:
+		[[nodiscard]] UInt64 GetHash(const IPAddress& ip) const noexcept
+		{
+			const Network::SerializedBinaryIPAddress sip{ ip.GetBinary() }; // Gets rid of padding bytes
+
+			UInt64 hash{ 0 };
+
+			siphash_opt(reinterpret_cast<const uint8_t*>(&sip), sizeof(sip),
+						reinterpret_cast<const uint8_t*>(m_Key.data()),
+						reinterpret_cast<uint8_t*>(&hash), sizeof(hash));
+
+			return hash;
+		}
+
+		[[nodiscard]] static constexpr UInt64 MakeEntry(const UInt64 hash, const Epoch epoch, const bool allowed) noexcept
+		{
+			return (hash & 0xFFFFFFFF00000000ull) | ((epoch & EpochMask) << 2) | ValidBit | (allowed ? AllowedBit : 0);
+		}
+
+	private:
+		std::array<UInt64, 2> m_Key{ 0, 0 };
+		std::atomic<UInt64> m_UpdateCount{ 0 };
+		std::array<std::atomic<UInt64>, NumEntries> m_Entries{};
+	};
+}
\ No newline at end of file
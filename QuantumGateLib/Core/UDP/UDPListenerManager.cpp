@@ -3,6 +3,8 @@
 
 #include "pch.h"
 #include "UDPListenerManager.h"
+#include "..\..\Common\ScopeGuard.h"
+#include "..\..\Concurrency\SpinWait.h"
 
 using namespace std::literals;
 using namespace QuantumGate::Implementation::Network;
@@ -26,8 +28,8 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		const auto& settings = m_Settings.GetCache();
 		const auto& listener_ports = settings.Local.Listeners.UDP.Ports;
 		const auto nat_traversal = settings.Local.Listeners.UDP.NATTraversal;
+		const auto num_shards = settings.Local.Listeners.UDP.NumShards;
 		const auto& shared_secret = settings.Local.GlobalSharedSecret;
-		const auto cookie_expiration_interval = settings.UDP.CookieExpirationInterval;
 
 		// Should have at least one port
 		if (listener_ports.empty())
@@ -60,21 +62,29 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 
 			if (address.has_value())
 			{
-				DiscardReturnValue(AddWorkerListenerThreads(*address, listener_ports, nat_traversal, shared_secret));
+				DiscardReturnValue(AddWorkerListenerThreads(*address, listener_ports, nat_traversal,
+															num_shards, shared_secret));
 			}
 		}
 
-		auto& connection_cookies = m_ThreadPool.GetData().ConnectionCookies;
+		if (m_AccessCache.Initialize() && AddCallbacks() && m_ShardThreadPool.Startup())
+		{
+			if (m_ThreadPool.Startup())
+			{
+				m_Running = true;
+				m_ListeningOnAnyAddresses = true;
+
+				LogSys(L"UDP listenermanager startup successful");
+			}
+			else m_ShardThreadPool.Shutdown();
+		}
 
-		if (connection_cookies.WithUniqueLock()->Initialize(Util::GetCurrentSteadyTime(), cookie_expiration_interval) &&
-			m_ThreadPool.Startup())
+		if (!m_Running)
 		{
-			m_Running = true;
-			m_ListeningOnAnyAddresses = true;
+			RemoveCallbacks();
 
-			LogSys(L"UDP listenermanager startup successful");
+			LogErr(L"UDP listenermanager startup failed");
 		}
-		else LogErr(L"UDP listenermanager startup failed");
 
 		return m_Running;
 	}
@@ -91,8 +101,8 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		const auto& settings = m_Settings.GetCache();
 		const auto& listener_ports = settings.Local.Listeners.UDP.Ports;
 		const auto nat_traversal = settings.Local.Listeners.UDP.NATTraversal;
+		const auto num_shards = settings.Local.Listeners.UDP.NumShards;
 		const auto& shared_secret = settings.Local.GlobalSharedSecret;
-		const auto cookie_expiration_interval = settings.UDP.CookieExpirationInterval;
 
 		// Should have at least one port
 		if (listener_ports.empty())
@@ -112,31 +122,43 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 					if (address.GetFamily() == IPAddress::Family::IPv4 ||
 						address.GetFamily() == IPAddress::Family::IPv6)
 					{
-						DiscardReturnValue(AddWorkerListenerThreads(address, listener_ports, nat_traversal, shared_secret));
+						DiscardReturnValue(AddWorkerListenerThreads(address, listener_ports, nat_traversal,
+																	num_shards, shared_secret));
 					}
 					else assert(false);
 				}
 			}
 		}
 
-		auto& connection_cookies = m_ThreadPool.GetData().ConnectionCookies;
+		if (m_AccessCache.Initialize() && AddCallbacks() && m_ShardThreadPool.Startup())
+		{
+			if (m_ThreadPool.Startup())
+			{
+				m_Running = true;
+				m_ListeningOnAnyAddresses = false;
 
-		if (connection_cookies.WithUniqueLock()->Initialize(Util::GetCurrentSteadyTime(), cookie_expiration_interval) &&
-			m_ThreadPool.Startup())
+				LogSys(L"UDP listenermanager startup successful");
+			}
+			else m_ShardThreadPool.Shutdown();
+		}
+
+		if (!m_Running)
 		{
-			m_Running = true;
-			m_ListeningOnAnyAddresses = false;
+			RemoveCallbacks();
 
-			LogSys(L"UDP listenermanager startup successful");
+			LogErr(L"UDP listenermanager startup failed");
 		}
-		else LogErr(L"UDP listenermanager startup failed");
 
 		return m_Running;
 	}
 
 	bool Manager::AddWorkerListenerThreads(const IPAddress& address, const Vector<UInt16> ports, const bool nat_traversal,
-										   const ProtectedBuffer& shared_secret) noexcept
+										   const Size num_shards, const ProtectedBuffer& shared_secret) noexcept
 	{
+		assert(num_shards > 0);
+
+		const auto cookie_expiration_interval = m_Settings.GetCache().UDP.CookieExpirationInterval;
+
 		// Separate listener for every port
 		for (const auto port : ports)
 		{
@@ -145,12 +167,41 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 				const auto endpoint = IPEndpoint(IPEndpoint::Protocol::UDP, address, port);
 
 				// Create and start the listenersocket
-				ThreadData ltd(shared_secret);
+				ThreadData ltd;
 				ltd.Socket = Socket(endpoint.GetIPAddress().GetFamily(), Network::Socket::Type::Datagram, Network::IP::Protocol::UDP);
-				ltd.SendQueue = std::make_shared<SendQueue_ThS>();
+
+				// Every shard has its own symmetric keys, connection cookie state and send queue
+				auto cookies_initialized{ true };
+
+				for (Size x = 0; x < num_shards; ++x)
+				{
+					auto& shard = ltd.Shards.emplace_back(std::make_shared<Shard>(shared_secret));
+					if (!shard->ConnectionCookies.WithUniqueLock()->Initialize(Util::GetCurrentSteadyTime(),
+																			   cookie_expiration_interval))
+					{
+						cookies_initialized = false;
+						break;
+					}
+				}
+
+				if (!cookies_initialized)
+				{
+					LogErr(L"Could not initialize connection cookies for endpoint %s", endpoint.GetString().c_str());
+					continue;
+				}
 
 				if (ltd.Socket.Bind(endpoint, nat_traversal))
 				{
+					const auto shards = ltd.Shards;
+
+					// With only one shard the listener thread processes all incoming
+					// data itself, otherwise every shard gets a thread of its own
+					if (num_shards > 1 && !AddShardThreads(endpoint, shards))
+					{
+						LogErr(L"Could not add listener shard threads for endpoint %s", endpoint.GetString().c_str());
+						continue;
+					}
+
 					if (m_ThreadPool.AddThread(L"QuantumGate Listener Thread " + endpoint.GetString(),
 											   std::move(ltd), MakeCallback(this, &Manager::WorkerThreadProcessor)))
 					{
@@ -158,6 +209,8 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 					}
 					else
 					{
+						RemoveShardThreads(shards);
+
 						LogErr(L"Could not add listener thread for endpoint %s", endpoint.GetString().c_str());
 					}
 				}
@@ -173,10 +226,44 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		return true;
 	}
 
+	bool Manager::AddShardThreads(const IPEndpoint& endpoint, const Vector<std::shared_ptr<Shard>>& shards) noexcept
+	{
+		for (const auto& shard : shards)
+		{
+			if (!m_ShardThreadPool.AddThread(L"QuantumGate Listener Shard Thread " + endpoint.GetString(),
+											 ShardThreadData{ .LocalEndpoint = endpoint, .Shard = shard },
+											 MakeCallback(this, &Manager::ShardWorkerThreadProcessor),
+											 MakeCallback(this, &Manager::ShardWorkerThreadWait),
+											 MakeCallback(this, &Manager::ShardWorkerThreadWaitInterrupt)))
+			{
+				RemoveShardThreads(shards);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void Manager::RemoveShardThreads(const Vector<std::shared_ptr<Shard>>& shards) noexcept
+	{
+		auto thread = m_ShardThreadPool.GetFirstThread();
+
+		while (thread.has_value())
+		{
+			if (std::find(shards.begin(), shards.end(), thread->GetData().Shard) != shards.end())
+			{
+				thread = m_ShardThreadPool.RemoveThread(std::move(*thread)).second;
+			}
+			else thread = m_ShardThreadPool.GetNextThread(*thread);
+		}
+	}
+
 	std::optional<Manager::ThreadPool::ThreadType> Manager::RemoveListenerThread(Manager::ThreadPool::ThreadType&& thread) noexcept
 	{
 		const Endpoint endpoint = thread.GetData().Socket.GetLocalEndpoint();
 
+		RemoveShardThreads(thread.GetData().Shards);
+
 		const auto& [success, next_thread] = m_ThreadPool.RemoveThread(std::move(thread));
 		if (success)
 		{
@@ -202,6 +289,7 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		const auto& settings = m_Settings.GetCache();
 		const auto& listener_ports = settings.Local.Listeners.UDP.Ports;
 		const auto nat_traversal = settings.Local.Listeners.UDP.NATTraversal;
+		const auto num_shards = settings.Local.Listeners.UDP.NumShards;
 
 		// Check for interfaces/IP addresses that were added for which
 		// there are no listeners; we add listeners for those
@@ -231,7 +319,7 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 
 						if (!found)
 						{
-							DiscardReturnValue(AddWorkerListenerThreads(address, listener_ports, nat_traversal,
+							DiscardReturnValue(AddWorkerListenerThreads(address, listener_ports, nat_traversal, num_shards,
 																		settings.Local.GlobalSharedSecret));
 						}
 					}
@@ -283,6 +371,9 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		LogSys(L"UDP listenermanager shutting down...");
 
 		m_ThreadPool.Shutdown();
+		m_ShardThreadPool.Shutdown();
+
+		RemoveCallbacks();
 
 		ResetState();
 
@@ -297,8 +388,40 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 	void Manager::ResetState() noexcept
 	{
 		m_ListeningOnAnyAddresses = false;
-		m_ThreadPool.GetData().ConnectionCookies.WithUniqueLock()->Deinitialize();
 		m_ThreadPool.Clear();
+		m_ShardThreadPool.Clear();
+	}
+
+	bool Manager::AddCallbacks() noexcept
+	{
+		auto success = true;
+
+		m_AccessManager.GetAccessUpdateCallbacks().WithUniqueLock([&](auto& callbacks) noexcept
+		{
+			m_AccessUpdateCallbackHandle = callbacks.Add(MakeCallback(this, &Manager::OnAccessUpdate));
+			if (!m_AccessUpdateCallbackHandle)
+			{
+				LogErr(L"Couldn't register 'AccessUpdateCallback' for UDP listenermanager");
+				success = false;
+			}
+		});
+
+		return success;
+	}
+
+	void Manager::RemoveCallbacks() noexcept
+	{
+		m_AccessManager.GetAccessUpdateCallbacks().WithUniqueLock([&](auto& callbacks) noexcept
+		{
+			callbacks.Remove(m_AccessUpdateCallbackHandle);
+		});
+	}
+
+	void Manager::OnAccessUpdate() noexcept
+	{
+		// Filters, limits or reputations changed; cached
+		// access decisions are no longer valid
+		m_AccessCache.Invalidate();
 	}
 
 	Manager::ReceiveBuffer& Manager::GetReceiveBuffer() const noexcept
@@ -314,9 +437,41 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		Endpoint pendpoint;
 		auto& buffer = GetReceiveBuffer();
 
+#ifdef USE_SOCKET_EVENT
+		const auto busy_poll = m_Settings.GetCache().Local.Concurrency.BusyPoll;
+
+		// Data queued for sending by connections sets the socket event
+		// so that we wake up and send it without having to wait
+		const auto set_send_event = [&](Concurrency::Event* event) noexcept
+		{
+			for (auto& shard : thdata.Shards)
+			{
+				shard->SendQueue->WithUniqueLock()->SendEvent = event;
+			}
+		};
+
+		set_send_event(&socket.GetEvent());
+
+		auto sg = MakeScopeGuard([&]() noexcept { set_send_event(nullptr); });
+#endif
+
 		while (!shutdown_event.IsSet())
 		{
-			if (socket.UpdateIOStatus(1ms))
+			auto wait_time = 1ms;
+
+#ifdef USE_SOCKET_EVENT
+			if (busy_poll.Enabled)
+			{
+				// Spin for a while looking for socket events (including
+				// queued data to send) before waiting on the socket
+				if (Concurrency::SpinWait(busy_poll.SpinBudget, [&]() noexcept
+				{
+					return (socket.GetEvent().IsSet() || shutdown_event.IsSet());
+				})) wait_time = 0ms;
+			}
+#endif
+
+			if (socket.UpdateIOStatus(wait_time))
 			{
 				if (socket.GetIOStatus().HasException())
 				{
@@ -329,76 +484,29 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 				{
 					if (socket.GetIOStatus().CanRead())
 					{
-						auto& settings = m_Settings.GetCache();
-
 						pendpoint = Endpoint();
 						auto bufspan = BufferSpan(buffer);
 
 						const auto result = socket.ReceiveFrom(pendpoint, bufspan);
 						if (result.Succeeded() && *result > 0)
 						{
-							// Check if IP is allowed through filters/limits and if it has acceptable reputation
-							if (const auto result1 =
-								m_AccessManager.GetConnectionFromAddressAllowed(pendpoint.GetIPEndpoint().GetIPAddress(),
-																				Access::CheckType::All); result1.Succeeded())
-							{
-								bufspan = bufspan.GetFirst(*result);
+							bufspan = bufspan.GetFirst(*result);
 
-								[[maybe_unused]] const auto& [success, rep_update] =
-									AcceptConnection(settings, Util::GetCurrentSteadyTime(), Util::GetCurrentSystemTime(),
-													 thdata.SendQueue, lendpoint.GetIPEndpoint(), pendpoint.GetIPEndpoint(),
-													 bufspan, thdata.SymmetricKeys);
-								if (rep_update != Access::AddressReputationUpdate::None)
-								{
-									const auto result2 = m_AccessManager.UpdateAddressReputation(pendpoint.GetIPEndpoint().GetIPAddress(), rep_update);
-									if (!result2.Succeeded())
-									{
-										LogWarn(L"UDP listenermanager couldn't update IP reputation for peer %s (%s)",
-												pendpoint.GetString().c_str(), result2.GetErrorString().c_str());
-									}
-								}
-							}
-							else
+							if (thdata.Shards.size() == 1)
 							{
-								LogWarn(L"UDP listenermanager discarding incoming data from peer %s; IP address is not allowed by access configuration",
-										pendpoint.GetString().c_str());
+								ProcessReceivedData(*thdata.Shards.front(), lendpoint.GetIPEndpoint(),
+													pendpoint.GetIPEndpoint(), bufspan);
 							}
+							else DispatchReceivedData(thdata.Shards, pendpoint.GetIPEndpoint(), bufspan);
 						}
 					}
 
 					if (socket.GetIOStatus().CanWrite())
 					{
-						auto send_queue = thdata.SendQueue->WithUniqueLock();
-						while (!send_queue->empty())
+						for (auto& shard : thdata.Shards)
 						{
-							auto remove = false;
-							const auto& item = send_queue->front();
-
-							const auto result = socket.SendTo(item.Endpoint, item.Data);
-							if (result.Succeeded())
-							{
-								// If data was actually sent, otherwise buffer may
-								// temporarily be full/unavailable
-								if (*result == item.Data.GetSize())
-								{
-									remove = true;
-								}
-								else
-								{
-									// We'll try again later
-									break;
-								}
-							}
-							else
-							{
-								LogErr(L"UDP listenermanager failed to send data to peer %s (%s)",
-									   item.Endpoint.GetString().c_str(), result.GetErrorString().c_str());
-
-								// Remove from queue (UDPConnection will retry and add back if needed)
-								remove = true;
-							}
-
-							if (remove) send_queue->pop();
+							// Stop if the socket can't take more data for now
+							if (!SendFromQueue(socket, *shard->SendQueue)) break;
 						}
 					}
 				}
@@ -412,11 +520,129 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		}
 	}
 
+	void Manager::ShardWorkerThreadWait(ThreadPoolData& thpdata, ShardThreadData& thdata, const Concurrency::Event& shutdown_event)
+	{
+		thdata.Shard->ReceiveQueue.Wait(shutdown_event);
+	}
+
+	void Manager::ShardWorkerThreadWaitInterrupt(ThreadPoolData& thpdata, ShardThreadData& thdata)
+	{
+		thdata.Shard->ReceiveQueue.InterruptWait();
+	}
+
+	void Manager::ShardWorkerThreadProcessor(ThreadPoolData& thpdata, ShardThreadData& thdata, const Concurrency::Event& shutdown_event)
+	{
+		std::optional<ShardQueueItem> item;
+
+		thdata.Shard->ReceiveQueue.PopFrontIf([&](auto& fitem) noexcept -> bool
+		{
+			item = std::move(fitem);
+			return true;
+		});
+
+		if (item.has_value())
+		{
+			auto bufspan = BufferSpan(item->Data);
+			ProcessReceivedData(*thdata.Shard, thdata.LocalEndpoint, item->PeerEndpoint, bufspan);
+		}
+	}
+
+	void Manager::DispatchReceivedData(const Vector<std::shared_ptr<Shard>>& shards, const IPEndpoint& pendpoint,
+									   const BufferSpan& buffer) noexcept
+	{
+		// Data from the same IP address always goes to the same shard so that
+		// cookies get verified by the shard that handed them out
+		auto& shard = *shards[ListenerShards::GetIndex(pendpoint.GetIPAddress(), shards.size())];
+
+		if (shard.ReceiveQueue.GetSize() >= MaxShardQueueSize)
+		{
+			LogDbg(L"UDP listenermanager discarding incoming data from peer %s; shard queue is full",
+				   pendpoint.GetString().c_str());
+			return;
+		}
+
+		try
+		{
+			shard.ReceiveQueue.Push(ShardQueueItem{ .PeerEndpoint = pendpoint, .Data = Buffer(buffer) });
+		}
+		catch (const std::exception& e)
+		{
+			LogErr(L"UDP listenermanager failed to queue incoming data from peer %s due to an exception - %s",
+				   pendpoint.GetString().c_str(), Util::ToStringW(e.what()).c_str());
+		}
+	}
+
+	void Manager::ProcessReceivedData(Shard& shard, const IPEndpoint& lendpoint, const IPEndpoint& pendpoint,
+									  BufferSpan& buffer) noexcept
+	{
+		if (IsDataFromAddressAllowed(pendpoint.GetIPAddress()))
+		{
+			const auto& settings = m_Settings.GetCache();
+
+			[[maybe_unused]] const auto& [success, rep_update] =
+				AcceptConnection(settings, Util::GetCurrentSteadyTime(), Util::GetCurrentSystemTime(),
+								 shard.SendQueue, lendpoint, pendpoint, buffer, shard.SymmetricKeys,
+								 shard.ConnectionCookies);
+			if (rep_update != Access::AddressReputationUpdate::None)
+			{
+				const auto result2 = m_AccessManager.UpdateAddressReputation(pendpoint.GetIPAddress(), rep_update);
+				if (!result2.Succeeded())
+				{
+					LogWarn(L"UDP listenermanager couldn't update IP reputation for peer %s (%s)",
+							pendpoint.GetString().c_str(), result2.GetErrorString().c_str());
+				}
+			}
+		}
+		else
+		{
+			LogDbg(L"UDP listenermanager discarding incoming data from peer %s; IP address is not allowed by access configuration",
+				   pendpoint.GetString().c_str());
+		}
+	}
+
+	bool Manager::SendFromQueue(Socket& socket, SendQueue_ThS& queue) noexcept
+	{
+		auto send_queue = queue.WithUniqueLock();
+		while (!send_queue->Items.empty())
+		{
+			auto remove = false;
+			const auto& item = send_queue->Items.front();
+
+			const auto result = socket.SendTo(item.Endpoint, item.Data);
+			if (result.Succeeded())
+			{
+				// If data was actually sent, otherwise buffer may
+				// temporarily be full/unavailable
+				if (*result == item.Data.GetSize())
+				{
+					remove = true;
+				}
+				else
+				{
+					// We'll try again later
+					return false;
+				}
+			}
+			else
+			{
+				LogErr(L"UDP listenermanager failed to send data to peer %s (%s)",
+					   item.Endpoint.GetString().c_str(), result.GetErrorString().c_str());
+
+				// Remove from queue (UDPConnection will retry and add back if needed)
+				remove = true;
+			}
+
+			if (remove) send_queue->Items.pop();
+		}
+
+		return true;
+	}
+
 	std::pair<bool, Access::AddressReputationUpdate>
 		Manager::AcceptConnection(const Settings& settings, const SteadyTime current_steadytime,
 								  const SystemTime current_systemtime, const std::shared_ptr<SendQueue_ThS>& send_queue,
 								  const IPEndpoint& lendpoint, const IPEndpoint& pendpoint, BufferSpan& buffer,
-								  const SymmetricKeys& symkeys) noexcept
+								  const SymmetricKeys& symkeys, ConnectionCookies_ThS& connection_cookies) noexcept
 	{
 		Message msg(Message::Type::Unknown, Message::Direction::Incoming);
 		if (msg.Read(buffer, symkeys) && msg.IsValid())
@@ -450,7 +676,6 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 
 					if (syn_data.Cookie.has_value())
 					{
-						auto& connection_cookies = m_ThreadPool.GetData().ConnectionCookies;
 						if (connection_cookies.WithUniqueLock()->VerifyCookie(*syn_data.Cookie, syn_data.ConnectionID,
 																			  pendpoint, Util::GetCurrentSteadyTime(),
 																			  settings.UDP.CookieExpirationInterval))
@@ -494,7 +719,8 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 							if (cookie_verified) create_connection = true;
 							else
 							{
-								SendCookie(settings, current_steadytime, send_queue, pendpoint, syn_data.ConnectionID, symkeys);
+								SendCookie(settings, current_steadytime, send_queue, pendpoint, syn_data.ConnectionID,
+										   symkeys, connection_cookies);
 							}
 							break;
 						}
@@ -521,7 +747,12 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 
 					if (create_connection)
 					{
-						if (CanAcceptConnection(pendpoint.GetIPAddress()))
+						if (!m_PeerManager.CanAcceptInboundHandshake())
+						{
+							LogWarn(L"UDP listenermanager refused connection from peer %s; too many incoming handshakes in progress",
+									pendpoint.GetString().c_str());
+						}
+						else if (CanAcceptConnection(pendpoint.GetIPAddress()))
 						{
 							auto peerths = m_PeerManager.CreateUDP(IP::AddressFamilyToNetwork(pendpoint.GetIPAddress().GetFamily()),
 																   PeerConnectionType::Inbound, syn_data.ConnectionID,
@@ -577,12 +808,12 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 
 	void Manager::SendCookie(const Settings& settings, const SteadyTime current_steadytime,
 							 const std::shared_ptr<SendQueue_ThS>& send_queue, const IPEndpoint& pendpoint,
-							 const ConnectionID connectionid, const SymmetricKeys& symkeys) noexcept
+							 const ConnectionID connectionid, const SymmetricKeys& symkeys,
+							 ConnectionCookies_ThS& connection_cookies) noexcept
 	{
 		LogDbg(L"UDP listenermanager sending cookie to peer %s for incoming connection with ID %llu",
 			   pendpoint.GetString().c_str(), connectionid);
 
-		auto& connection_cookies = m_ThreadPool.GetData().ConnectionCookies;
 		auto cookie_data = connection_cookies.WithUniqueLock()->GetCookie(connectionid, pendpoint,
 																		  Util::GetCurrentSteadyTime(),
 																		  settings.UDP.CookieExpirationInterval);
@@ -593,10 +824,10 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 				Message msg(Message::Type::Cookie, Message::Direction::Outgoing, Connection::UDPMessageSizes::Min);
 				msg.SetCookieData(std::move(*cookie_data));
 
-				Buffer data;
+				Message::SendBuffer data;
 				if (msg.Write(data, symkeys))
 				{
-					send_queue->WithUniqueLock()->emplace(
+					send_queue->WithUniqueLock()->Push(
 						SendQueueItem{
 							.Endpoint = pendpoint,
 							.Data = std::move(data)
@@ -616,6 +847,30 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		}
 	}
 
+	bool Manager::IsDataFromAddressAllowed(const IPAddress& ipaddr) noexcept
+	{
+		// Get the epoch before making the decision so that an access
+		// update in the meantime invalidates the cached decision
+		const auto epoch = m_AccessCache.GetEpoch(Util::GetCurrentSteadyTime());
+
+		if (const auto allowed = m_AccessCache.GetAllowed(ipaddr, epoch); allowed.has_value())
+		{
+			return *allowed;
+		}
+
+		// Check if IP is allowed through filters/limits and if it has acceptable reputation
+		const auto result = m_AccessManager.GetConnectionFromAddressAllowed(ipaddr, Access::CheckType::All);
+		if (result.Succeeded())
+		{
+			m_AccessCache.SetAllowed(ipaddr, epoch, *result);
+
+			return *result;
+		}
+
+		// If anything goes wrong we always deny access
+		return false;
+	}
+
 	bool Manager::CanAcceptConnection(const IPAddress& ipaddr) const noexcept
 	{
 		// Increase connection attempts for this IP; if attempts get too high
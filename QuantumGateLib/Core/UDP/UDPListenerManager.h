@@ -6,7 +6,10 @@
 #include "UDPConnectionManager.h"
 #include "UDPListenerSocket.h"
 #include "UDPConnectionCookies.h"
+#include "UDPListenerAccessCache.h"
+#include "..\ListenerShards.h"
 #include "..\..\Concurrency\ThreadPool.h"
+#include "..\..\Concurrency\Queue.h"
 #include "..\Peer\PeerManager.h"
 #include "..\Access\AccessManager.h"
 
@@ -16,12 +19,36 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 	{
 		using ReceiveBuffer = Memory::StackBuffer<Connection::UDPMessageSizes::Max>;
 
-		struct ThreadData final
+		struct ShardQueueItem final
 		{
-			ThreadData(const ProtectedBuffer& shared_secret, const bool primary = false) :
-				SymmetricKeys(PeerConnectionType::Inbound, shared_secret)
+			IPEndpoint PeerEndpoint;
+			Buffer Data;
+		};
+
+		using ShardQueue_ThS = Concurrency::Queue<ShardQueueItem>;
+
+		struct Shard final
+		{
+			Shard(const ProtectedBuffer& shared_secret) :
+				SymmetricKeys(PeerConnectionType::Inbound, shared_secret),
+				SendQueue(std::make_shared<SendQueue_ThS>())
 			{}
 
+			Shard(const Shard&) = delete;
+			Shard(Shard&&) = delete;
+			~Shard() = default;
+			Shard& operator=(const Shard&) = delete;
+			Shard& operator=(Shard&&) = delete;
+
+			SymmetricKeys SymmetricKeys;
+			ConnectionCookies_ThS ConnectionCookies;
+			std::shared_ptr<SendQueue_ThS> SendQueue;
+			ShardQueue_ThS ReceiveQueue;
+		};
+
+		struct ThreadData final
+		{
+			ThreadData() noexcept = default;
 			ThreadData(const ThreadData&) = delete;
 			ThreadData(ThreadData&&) noexcept = default;
 
@@ -33,17 +60,23 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 			ThreadData& operator=(const ThreadData&) = delete;
 			ThreadData& operator=(ThreadData&&) noexcept = default;
 
-			SymmetricKeys SymmetricKeys;
 			Socket Socket;
-			std::shared_ptr<SendQueue_ThS> SendQueue;
+			Vector<std::shared_ptr<Shard>> Shards;
 		};
 
-		struct ThreadPoolData final
+		struct ShardThreadData final
 		{
-			ConnectionCookies_ThS ConnectionCookies;
+			IPEndpoint LocalEndpoint;
+			std::shared_ptr<Shard> Shard;
 		};
 
+		struct ThreadPoolData final
+		{};
+
 		using ThreadPool = Concurrency::ThreadPool<ThreadPoolData, ThreadData>;
+		using ShardThreadPool = Concurrency::ThreadPool<ThreadPoolData, ShardThreadData>;
+
+		static constexpr Size MaxShardQueueSize{ 1024 };
 
 	public:
 		Manager() = delete;
@@ -61,7 +94,8 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		[[nodiscard]] inline bool IsRunning() const noexcept { return m_Running; }
 
 		[[nodiscard]] bool AddWorkerListenerThreads(const IPAddress& address, const Vector<UInt16> ports,
-													const bool nat_traversal, const ProtectedBuffer& shared_secret) noexcept;
+													const bool nat_traversal, const Size num_shards,
+													const ProtectedBuffer& shared_secret) noexcept;
 		std::optional<ThreadPool::ThreadType> RemoveListenerThread(ThreadPool::ThreadType&& thread) noexcept;
 		[[nodiscard]] bool Update(const Vector<API::Local::Environment::EthernetInterface>& interfaces) noexcept;
 
@@ -69,20 +103,40 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		void PreStartup() noexcept;
 		void ResetState() noexcept;
 
+		[[nodiscard]] bool AddCallbacks() noexcept;
+		void RemoveCallbacks() noexcept;
+
+		void OnAccessUpdate() noexcept;
+
 		[[nodiscard]] ReceiveBuffer& GetReceiveBuffer() const noexcept;
 
+		[[nodiscard]] bool AddShardThreads(const IPEndpoint& endpoint, const Vector<std::shared_ptr<Shard>>& shards) noexcept;
+		void RemoveShardThreads(const Vector<std::shared_ptr<Shard>>& shards) noexcept;
+
 		void WorkerThreadProcessor(ThreadPoolData& thpdata, ThreadData& thdata, const Concurrency::Event& shutdown_event);
 
+		void ShardWorkerThreadWait(ThreadPoolData& thpdata, ShardThreadData& thdata, const Concurrency::Event& shutdown_event);
+		void ShardWorkerThreadWaitInterrupt(ThreadPoolData& thpdata, ShardThreadData& thdata);
+		void ShardWorkerThreadProcessor(ThreadPoolData& thpdata, ShardThreadData& thdata, const Concurrency::Event& shutdown_event);
+
+		void DispatchReceivedData(const Vector<std::shared_ptr<Shard>>& shards, const IPEndpoint& pendpoint,
+								  const BufferSpan& buffer) noexcept;
+		void ProcessReceivedData(Shard& shard, const IPEndpoint& lendpoint, const IPEndpoint& pendpoint,
+								 BufferSpan& buffer) noexcept;
+		[[nodiscard]] bool SendFromQueue(Socket& socket, SendQueue_ThS& queue) noexcept;
+
+		[[nodiscard]] bool IsDataFromAddressAllowed(const IPAddress& ipaddr) noexcept;
 		[[nodiscard]] bool CanAcceptConnection(const IPAddress& ipaddr) const noexcept;
 		[[nodiscard]] std::pair<bool, Access::AddressReputationUpdate>
 			AcceptConnection(const Settings& settings, const SteadyTime current_steadytime,
 							 const SystemTime current_systemtime, const std::shared_ptr<SendQueue_ThS>& send_queue,
 							 const IPEndpoint& lendpoint, const IPEndpoint& pendpoint, BufferSpan& buffer,
-							 const SymmetricKeys& symkeys) noexcept;
+							 const SymmetricKeys& symkeys, ConnectionCookies_ThS& connection_cookies) noexcept;
 
 		void SendCookie(const Settings& settings, const SteadyTime current_steadytime,
 						const std::shared_ptr<SendQueue_ThS>& send_queue, const IPEndpoint& pendpoint,
-						const ConnectionID connectionid, const SymmetricKeys& symkeys) noexcept;
+						const ConnectionID connectionid, const SymmetricKeys& symkeys,
+						ConnectionCookies_ThS& connection_cookies) noexcept;
 
 	private:
 		std::atomic_bool m_Running{ false };
@@ -92,6 +146,10 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 		UDP::Connection::Manager& m_UDPConnectionManager;
 		Peer::Manager& m_PeerManager;
 
+		AccessCache m_AccessCache;
+		Access::Manager::AccessUpdateCallbackHandle m_AccessUpdateCallbackHandle;
+
 		ThreadPool m_ThreadPool;
+		ShardThreadPool m_ShardThreadPool;
 	};
 }
\ No newline at end of file
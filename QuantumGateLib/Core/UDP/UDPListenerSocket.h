@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include "UDPMessage.h"
 #include "..\..\Network\Socket.h"
 #include "..\..\Concurrency\ThreadSafe.h"
+#include "..\..\Concurrency\Event.h"
 #include "..\..\Common\Containers.h"
 
 namespace QuantumGate::Implementation::Core::UDP::Listener
@@ -17,8 +19,21 @@ namespace QuantumGate::Implementation::Core::UDP::Listener
 	struct SendQueueItem final
 	{
 		IPEndpoint Endpoint;
-		Buffer Data;
+		Message::SendBuffer Data;
 	};
 
-	using SendQueue_ThS = Concurrency::ThreadSafe<Containers::Queue<SendQueueItem>, std::shared_mutex>;
+	struct SendQueue final
+	{
+		Containers::Queue<SendQueueItem> Items;
+		Concurrency::Event* SendEvent{ nullptr };	// Event of the listener socket; set when items get added so that the listener thread wakes up to send them
+
+		void Push(SendQueueItem&& item)
+		{
+			Items.emplace(std::move(item));
+
+			if (SendEvent != nullptr) SendEvent->Set();
+		}
+	};
+
+	using SendQueue_ThS = Concurrency::ThreadSafe<SendQueue, std::shared_mutex>;
 }
\ No newline at end of file
@@ -78,7 +78,7 @@ namespace QuantumGate::Implementation::Core::UDP
 		return false;
 	}
 
-	bool Message::Header::Write(Buffer& buffer) const noexcept
+	bool Message::Header::Write(SendBuffer& buffer) const noexcept
 	{
 		assert(m_Direction == Direction::Outgoing);
 
@@ -96,7 +96,7 @@ namespace QuantumGate::Implementation::Core::UDP
 			msgtype_flags = msgtype_flags | SeqNumFlag;
 		}
 
-		Memory::BufferWriter wrt(buffer, true);
+		Memory::SmallBufferWriter<SendBuffer::GetInlineSize()> wrt(buffer, true);
 		return wrt.WriteWithPreallocation(hmac,
 										  m_MessageIV,
 										  m_MessageSequenceNumber,
@@ -344,7 +344,7 @@ namespace QuantumGate::Implementation::Core::UDP
 		return false;
 	}
 	
-	bool Message::Write(Buffer& buffer, const SymmetricKeys& symkey) noexcept
+	bool Message::Write(SendBuffer& buffer, const SymmetricKeys& symkey) noexcept
 	{
 		try
 		{
@@ -354,7 +354,7 @@ namespace QuantumGate::Implementation::Core::UDP
 				assert(IsValid());
 			});
 
-			Buffer msgbuf;
+			SendBuffer msgbuf;
 
 			// Add message header
 			if (!m_Header.Write(msgbuf)) return false;
@@ -492,7 +492,10 @@ namespace QuantumGate::Implementation::Core::UDP
 
 							Dbg(L"UDPMessageRnd: %zu bytes", rndnum);
 
-							msgbuf += Random::GetPseudoRandomBytes(rndnum);
+							const auto offset = msgbuf.GetSize();
+							msgbuf.Resize(offset + rndnum);
+
+							Random::GetPseudoRandomBytes(msgbuf.GetBytes() + offset, rndnum);
 							break;
 						}
 						default:
@@ -549,9 +552,9 @@ namespace QuantumGate::Implementation::Core::UDP
 
 		HMAC hmac{ 0 };
 
-		halfsiphash(reinterpret_cast<const uint8_t*>(data.GetBytes()), data.GetSize(),
-					reinterpret_cast<const uint8_t*>(authkey.GetBytes()),
-					reinterpret_cast<uint8_t*>(&hmac), sizeof(hmac));
+		halfsiphash_opt(reinterpret_cast<const uint8_t*>(data.GetBytes()), data.GetSize(),
+						reinterpret_cast<const uint8_t*>(authkey.GetBytes()),
+						reinterpret_cast<uint8_t*>(&hmac), sizeof(hmac));
 
 		return hmac;
 	}
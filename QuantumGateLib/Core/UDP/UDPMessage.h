@@ -42,6 +42,10 @@ namespace QuantumGate::Implementation::Core::UDP
 		using HMAC = UInt32;
 		using IV = UInt32;
 
+		// Most messages that get sent are small control messages (acks, cookies)
+		// that fit in the inline storage and don't need a memory allocation
+		using SendBuffer = Memory::SmallBuffer256;
+
 #pragma pack(push, 1) // Disable padding bytes
 		struct AckRange final
 		{
@@ -99,7 +103,7 @@ namespace QuantumGate::Implementation::Core::UDP
 			[[nodiscard]] inline SequenceNumber GetMessageAckNumber() const noexcept { assert(m_AckFlag); return m_MessageAckNumber; }
 
 			[[nodiscard]] bool Read(const BufferView& buffer) noexcept;
-			[[nodiscard]] bool Write(Buffer& buffer) const noexcept;
+			[[nodiscard]] bool Write(SendBuffer& buffer) const noexcept;
 
 			static constexpr Size GetSize() noexcept
 			{
@@ -205,7 +209,7 @@ namespace QuantumGate::Implementation::Core::UDP
 		[[nodiscard]] Buffer&& MoveMessageData() noexcept;
 
 		[[nodiscard]] bool Read(BufferSpan& buffer, const SymmetricKeys& symkey) noexcept;
-		[[nodiscard]] bool Write(Buffer& buffer, const SymmetricKeys& symkey) noexcept;
+		[[nodiscard]] bool Write(SendBuffer& buffer, const SymmetricKeys& symkey) noexcept;
 
 		static SequenceNumber GetNextSequenceNumber(const SequenceNumber current) noexcept
 		{
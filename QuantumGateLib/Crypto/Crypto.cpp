@@ -10,6 +10,7 @@
 #include "NTRUPrime.h"
 #include "NewHope.h"
 #include "..\Common\Random.h"
+#include "..\Common\Endian.h"
 #include "..\Common\ScopeGuard.h"
 #include "..\Memory\StackBuffer.h"
 #include "..\..\QuantumGateCryptoLib\QuantumGateCryptoLib.h"
@@ -243,6 +244,16 @@ namespace QuantumGate::Implementation::Crypto
 		return false;
 	}
 
+	void SetUseOptimizedAlgorithms(const bool use) noexcept
+	{
+		QGCryptoSetUseOptimized(use ? 1 : 0);
+	}
+
+	bool IsUsingAVX2() noexcept
+	{
+		return (QGCryptoUseAVX2() != 0);
+	}
+
 	bool GenerateAsymmetricKeys(AsymmetricKeyData& keydata) noexcept
 	{
 		// Should have algorithm
@@ -396,7 +407,7 @@ namespace QuantumGate::Implementation::Crypto
 		try
 		{
 			ProtectedBuffer hkdfbuf;
-			const auto outlen = (2 * key_size) + (2 * 64); // Two encryption keys and two authentication keys
+			const auto outlen = (2 * key_size) + (2 * 64) + (2 * SymmetricKeyData::NonceSize); // Two encryption keys, two authentication keys and two nonce bases
 
 			// Generate random bytes which will be divided into the four keys
 			if (HKDF(sharedsecret, hkdfbuf, outlen, key1.HashAlgorithm))
@@ -412,15 +423,30 @@ namespace QuantumGate::Implementation::Crypto
 				key2.Key = kbuf.GetFirst(key_size);
 				kbuf.RemoveFirst(key_size);
 
-				// Last 128 bytes are authentication keys
+				// Next 128 bytes are authentication keys
 				key1.AuthKey = kbuf.GetFirst(64);
 				kbuf.RemoveFirst(64);
 
 				key2.AuthKey = kbuf.GetFirst(64);
 				kbuf.RemoveFirst(64);
 
+				// Last bytes are the nonce bases
+				std::memcpy(key1.NonceBase.data(), kbuf.GetBytes(), SymmetricKeyData::NonceSize);
+				kbuf.RemoveFirst(SymmetricKeyData::NonceSize);
+
+				std::memcpy(key2.NonceBase.data(), kbuf.GetBytes(), SymmetricKeyData::NonceSize);
+				kbuf.RemoveFirst(SymmetricKeyData::NonceSize);
+
 				assert(kbuf.IsEmpty());
 
+				// Derived keys get used for many messages, so their cipher
+				// contexts get initialized with the keys ahead of time
+				if (key1.Type == SymmetricKeyType::Derived)
+				{
+					key1.CipherContext = OpenSSLSymmetric::CreateCipherContext(key1);
+					key2.CipherContext = OpenSSLSymmetric::CreateCipherContext(key2);
+				}
+
 				Dbg(L"Secret: %d bytes - %s", sharedsecret.GetSize(), Util::ToBase64(sharedsecret)->c_str());
 				Dbg(L"Enckey1: %d bytes - %s", key1.Key.GetSize(), Util::ToBase64(key1.Key)->c_str());
 				Dbg(L"Authkey1: %d bytes - %s", key1.AuthKey.GetSize(), Util::ToBase64(key1.AuthKey)->c_str());
@@ -438,6 +464,26 @@ namespace QuantumGate::Implementation::Crypto
 		return false;
 	}
 
+	SymmetricNonce GetSymmetricNonce(const SymmetricKeyData& symkeydata, const UInt32 nonce_seed) noexcept
+	{
+		// The nonce seed from the message goes into the last bytes of the nonce
+		// base of the key, so nonces are unique per key as long as the seeds are
+		// and getting one doesn't take hashing or heap allocation
+		SymmetricNonce nonce;
+		nonce += BufferView(symkeydata.NonceBase.data(), symkeydata.NonceBase.size());
+
+		const auto seed = Endian::ToNetworkByteOrder(nonce_seed);
+		const auto seedb = reinterpret_cast<const Byte*>(&seed);
+		const auto offset = SymmetricKeyData::NonceSize - sizeof(seed);
+
+		for (Size x = 0; x < sizeof(seed); ++x)
+		{
+			nonce[offset + x] ^= seedb[x];
+		}
+
+		return nonce;
+	}
+
 	std::optional<ProtectedBuffer> GetPEMPrivateKey(const AsymmetricKeyData& keydata) noexcept
 	{
 		// Must have a key already
@@ -466,6 +512,18 @@ namespace QuantumGate::Implementation::Crypto
 		return false;
 	}
 
+	bool Encrypt(BufferSpan buffer, BufferSpan tag,
+				 SymmetricKeyData& symkeydata, const BufferView& iv) noexcept
+	{
+		if (OpenSSLSymmetric::Encrypt(buffer, tag, symkeydata, iv))
+		{
+			symkeydata.NumBytesProcessed += buffer.GetSize();
+			return true;
+		}
+
+		return false;
+	}
+
 	bool Decrypt(const BufferView& encrbuf, Buffer& buffer,
 				 SymmetricKeyData& symkeydata, const BufferView& iv) noexcept
 	{
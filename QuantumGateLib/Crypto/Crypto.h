@@ -4,9 +4,12 @@
 #pragma once
 
 #include "KeyData.h"
+#include "..\Memory\StackBuffer.h"
 
 namespace QuantumGate::Implementation::Crypto
 {
+	using SymmetricNonce = Memory::StackBuffer<SymmetricKeyData::NonceSize>;
+
 	Export const WChar* GetAlgorithmName(const Algorithm::Asymmetric alg) noexcept;
 	Export const WChar* GetAlgorithmName(const Algorithm::Symmetric alg) noexcept;
 	Export const WChar* GetAlgorithmName(const Algorithm::Hash alg) noexcept;
@@ -21,8 +24,8 @@ namespace QuantumGate::Implementation::Crypto
 	template<typename T>
 	T ChooseAlgorithm(const Vector<T>& list1, Vector<T>& list2) noexcept;
 
-	[[nodiscard]] std::optional<UInt64> GetCryptoRandomNumber() noexcept;
-	[[nodiscard]] std::optional<Buffer> GetCryptoRandomBytes(const Size size) noexcept;
+	[[nodiscard]] Export std::optional<UInt64> GetCryptoRandomNumber() noexcept;
+	[[nodiscard]] Export std::optional<Buffer> GetCryptoRandomBytes(const Size size) noexcept;
 
 	template<typename T>
 	[[nodiscard]] Export bool Hash(const BufferView& buffer, T& hashbuf, const Algorithm::Hash type) noexcept;
@@ -33,20 +36,31 @@ namespace QuantumGate::Implementation::Crypto
 	[[nodiscard]] Export bool HKDF(const BufferView& secret, ProtectedBuffer& outkey, const Size outkeylen,
 								   const Algorithm::Hash type) noexcept;
 
-	[[nodiscard]] bool GenerateAsymmetricKeys(AsymmetricKeyData& keydata) noexcept;
-	[[nodiscard]] bool GenerateSharedSecret(AsymmetricKeyData& keydata) noexcept;
-	[[nodiscard]] bool GenerateSymmetricKeys(const BufferView& sharedsecret,
-											 SymmetricKeyData& key1, SymmetricKeyData& key2) noexcept;
+	// Selects between the reference and the optimized implementations
+	// of the post-quantum algorithms; the optimized ones are the default
+	Export void SetUseOptimizedAlgorithms(const bool use) noexcept;
+	[[nodiscard]] Export bool IsUsingAVX2() noexcept;
+
+	[[nodiscard]] Export bool GenerateAsymmetricKeys(AsymmetricKeyData& keydata) noexcept;
+	[[nodiscard]] Export bool GenerateSharedSecret(AsymmetricKeyData& keydata) noexcept;
+	[[nodiscard]] Export bool GenerateSymmetricKeys(const BufferView& sharedsecret,
+													SymmetricKeyData& key1, SymmetricKeyData& key2) noexcept;
+	[[nodiscard]] Export SymmetricNonce GetSymmetricNonce(const SymmetricKeyData& symkeydata, const UInt32 nonce_seed) noexcept;
 
 	[[nodiscard]] std::optional<ProtectedBuffer> GetPEMPrivateKey(AsymmetricKeyData& keydata) noexcept;
 	[[nodiscard]] std::optional<ProtectedBuffer> GetPEMPublicKey(AsymmetricKeyData& keydata) noexcept;
 
-	[[nodiscard]] bool Encrypt(const BufferView& buffer, Buffer& encrbuf,
-							   SymmetricKeyData& symkeydata, const BufferView& iv) noexcept;
+	[[nodiscard]] Export bool Encrypt(const BufferView& buffer, Buffer& encrbuf,
+									  SymmetricKeyData& symkeydata, const BufferView& iv) noexcept;
 
-	[[nodiscard]] bool Decrypt(const BufferView& encrbuf, Buffer& buffer,
+	// Encrypts the buffer in place; the authentication tag gets
+	// written to tag (of SymmetricKeyData::TagSize bytes)
+	[[nodiscard]] bool Encrypt(BufferSpan buffer, BufferSpan tag,
 							   SymmetricKeyData& symkeydata, const BufferView& iv) noexcept;
 
+	[[nodiscard]] Export bool Decrypt(const BufferView& encrbuf, Buffer& buffer,
+									  SymmetricKeyData& symkeydata, const BufferView& iv) noexcept;
+
 	[[nodiscard]] bool HashAndSign(const BufferView& msg, const Algorithm::Asymmetric alg, const BufferView& priv_key,
 								   Buffer& sig, const Algorithm::Hash type) noexcept;
 
@@ -17,7 +17,7 @@ namespace QuantumGate::Implementation::Crypto
 		Unknown, DiffieHellman, KeyEncapsulation, DigitalSigning
 	};
 
-	struct AsymmetricKeyData final
+	struct Export AsymmetricKeyData final
 	{
 		AsymmetricKeyData() = delete;
 		AsymmetricKeyData(const Algorithm::Asymmetric aa) noexcept;
@@ -51,6 +51,8 @@ namespace QuantumGate::Implementation::Crypto
 		void* Key{ nullptr };
 	};
 
+	class SymmetricCipherContext;
+
 	enum class SymmetricKeyType
 	{
 		Unknown, AutoGen, Derived
@@ -58,6 +60,10 @@ namespace QuantumGate::Implementation::Crypto
 
 	struct SymmetricKeyData final
 	{
+		// 96 bits; the default IV size for the supported symmetric algorithms
+		static constexpr Size NonceSize{ 12 };
+		static constexpr Size TagSize{ 16 };
+
 		SymmetricKeyData() = delete;
 		SymmetricKeyData(const SymmetricKeyType type, const Algorithm::Hash ha,
 						 const Algorithm::Symmetric sa, const Algorithm::Compression ca) noexcept :
@@ -70,6 +76,11 @@ namespace QuantumGate::Implementation::Crypto
 		Algorithm::Hash HashAlgorithm{ Algorithm::Hash::Unknown };
 		Algorithm::Symmetric SymmetricAlgorithm{ Algorithm::Symmetric::Unknown };
 		Algorithm::Compression CompressionAlgorithm{ Algorithm::Compression::Unknown };
+		std::array<Byte, NonceSize> NonceBase{};
 		Size NumBytesProcessed{ 0 };
+
+		// Cipher context that was initialized with the key ahead of time (see OpenSSLSymmetric);
+		// keys without one get initialized from scratch for each message
+		std::shared_ptr<const SymmetricCipherContext> CipherContext;
 	};
 }
\ No newline at end of file
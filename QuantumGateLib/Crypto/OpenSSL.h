@@ -12,6 +12,11 @@
 #include <openssl/ec.h>
 #include <openssl/pem.h>
 
+#if OPENSSL_VERSION_MAJOR >= 3
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
+
 namespace QuantumGate::Implementation::Crypto
 {
 	class OpenSSL final
@@ -30,37 +35,54 @@ namespace QuantumGate::Implementation::Crypto
 			return (RAND_bytes(reinterpret_cast<UChar*>(buffer), static_cast<int>(len)) == 1);
 		}
 
+		[[nodiscard]] static const EVP_MD* GetDigest(const Algorithm::Hash type) noexcept
+		{
+			const auto& algorithms = GetFetchedAlgorithms();
+
+			switch (type)
+			{
+				case Algorithm::Hash::SHA256:
+					return algorithms.SHA256Digest;
+				case Algorithm::Hash::SHA512:
+					return algorithms.SHA512Digest;
+				case Algorithm::Hash::BLAKE2S256:
+					return algorithms.BLAKE2S256Digest;
+				case Algorithm::Hash::BLAKE2B512:
+					return algorithms.BLAKE2B512Digest;
+				default:
+					break;
+			}
+
+			return nullptr;
+		}
+
+		[[nodiscard]] static const EVP_CIPHER* GetCipher(const Algorithm::Symmetric type) noexcept
+		{
+			const auto& algorithms = GetFetchedAlgorithms();
+
+			switch (type)
+			{
+				case Algorithm::Symmetric::AES256_GCM:
+					return algorithms.AES256GCMCipher;
+				case Algorithm::Symmetric::CHACHA20_POLY1305:
+					return algorithms.ChaCha20Poly1305Cipher;
+				default:
+					break;
+			}
+
+			return nullptr;
+		}
+
 		template<typename T>
 		[[nodiscard]] static bool Hash(const BufferView& buffer, T& hashbuf, const Algorithm::Hash type) noexcept
 		{
 			try
 			{
-				auto context = EVP_MD_CTX_create();
-				if (context != nullptr)
-				{
-					// Release context when we exit
-					const auto sg = MakeScopeGuard([&]() noexcept { EVP_MD_CTX_destroy(context); });
-
-					const EVP_MD* md = nullptr;
-
-					switch (type)
-					{
-						case Algorithm::Hash::SHA256:
-							md = EVP_sha256();
-							break;
-						case Algorithm::Hash::SHA512:
-							md = EVP_sha512();
-							break;
-						case Algorithm::Hash::BLAKE2S256:
-							md = EVP_blake2s256();
-							break;
-						case Algorithm::Hash::BLAKE2B512:
-							md = EVP_blake2b512();
-							break;
-						default:
-							return false;
-					}
+				const auto md = GetDigest(type);
+				auto context = GetThreadContexts().DigestContext;
 
+				if (md != nullptr && context != nullptr)
+				{
 					if (EVP_DigestInit_ex(context, md, nullptr))
 					{
 						// Calculate hash
@@ -91,31 +113,10 @@ namespace QuantumGate::Implementation::Crypto
 		{
 			try
 			{
-				const EVP_MD* md{ nullptr };
-
-				switch (type)
-				{
-					case Algorithm::Hash::SHA256:
-						md = EVP_sha256();
-						break;
-					case Algorithm::Hash::SHA512:
-						md = EVP_sha512();
-						break;
-					case Algorithm::Hash::BLAKE2S256:
-						md = EVP_blake2s256();
-						break;
-					case Algorithm::Hash::BLAKE2B512:
-						md = EVP_blake2b512();
-						break;
-					default:
-						return false;
-				}
-
 				std::array<Byte, EVP_MAX_MD_SIZE> digest{ Byte{ 0 } };
-				UInt dlen{ EVP_MAX_MD_SIZE };
+				Size dlen{ 0 };
 
-				if (::HMAC(md, key.GetBytes(), static_cast<int>(key.GetSize()), reinterpret_cast<const UChar*>(buffer.GetBytes()),
-						   static_cast<int>(buffer.GetSize()), reinterpret_cast<UChar*>(digest.data()), &dlen) != nullptr)
+				if (CalcHMAC(buffer, key, type, digest.data(), dlen))
 				{
 					hmac.Resize(dlen);
 					std::memcpy(hmac.GetBytes(), digest.data(), dlen);
@@ -139,25 +140,8 @@ namespace QuantumGate::Implementation::Crypto
 					// Release pctx when we exit
 					const auto sg = MakeScopeGuard([&]() noexcept { EVP_PKEY_CTX_free(pctx); });
 
-					const EVP_MD* md{ nullptr };
-
-					switch (type)
-					{
-						case Algorithm::Hash::SHA256:
-							md = EVP_sha256();
-							break;
-						case Algorithm::Hash::SHA512:
-							md = EVP_sha512();
-							break;
-						case Algorithm::Hash::BLAKE2S256:
-							md = EVP_blake2s256();
-							break;
-						case Algorithm::Hash::BLAKE2B512:
-							md = EVP_blake2b512();
-							break;
-						default:
-							return false;
-					}
+					const auto md = GetDigest(type);
+					if (md == nullptr) return false;
 
 					constexpr std::array salt{ 'q', 'g', 'k', 'e', 'y', 's', 'a', 'l', 't' };
 					constexpr std::array label{ 'q', 'g', 'k', 'e', 'y', 'l', 'a', 'b', 'e', 'l'};
@@ -358,6 +342,201 @@ namespace QuantumGate::Implementation::Crypto
 		}
 
 	private:
+		// Digest and cipher implementations get fetched one time and are reused
+		// for all operations; with OpenSSL 3 providers fetching them implicitly
+		// (as happens with EVP_sha256() etc.) on every initialization is expensive
+		struct FetchedAlgorithms final
+		{
+			FetchedAlgorithms() noexcept
+			{
+#if OPENSSL_VERSION_MAJOR >= 3
+				SHA256Digest = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+				SHA512Digest = EVP_MD_fetch(nullptr, "SHA512", nullptr);
+				BLAKE2S256Digest = EVP_MD_fetch(nullptr, "BLAKE2S-256", nullptr);
+				BLAKE2B512Digest = EVP_MD_fetch(nullptr, "BLAKE2B-512", nullptr);
+				AES256GCMCipher = EVP_CIPHER_fetch(nullptr, "AES-256-GCM", nullptr);
+				ChaCha20Poly1305Cipher = EVP_CIPHER_fetch(nullptr, "ChaCha20-Poly1305", nullptr);
+				HMACAlgorithm = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+#else
+				SHA256Digest = EVP_sha256();
+				SHA512Digest = EVP_sha512();
+				BLAKE2S256Digest = EVP_blake2s256();
+				BLAKE2B512Digest = EVP_blake2b512();
+				AES256GCMCipher = EVP_aes_256_gcm();
+				ChaCha20Poly1305Cipher = EVP_chacha20_poly1305();
+#endif
+			}
+
+			FetchedAlgorithms(const FetchedAlgorithms&) = delete;
+			FetchedAlgorithms(FetchedAlgorithms&&) = delete;
+
+			~FetchedAlgorithms()
+			{
+#if OPENSSL_VERSION_MAJOR >= 3
+				EVP_MD_free(SHA256Digest);
+				EVP_MD_free(SHA512Digest);
+				EVP_MD_free(BLAKE2S256Digest);
+				EVP_MD_free(BLAKE2B512Digest);
+				EVP_CIPHER_free(AES256GCMCipher);
+				EVP_CIPHER_free(ChaCha20Poly1305Cipher);
+				EVP_MAC_free(HMACAlgorithm);
+#endif
+			}
+
+			FetchedAlgorithms& operator=(const FetchedAlgorithms&) = delete;
+			FetchedAlgorithms& operator=(FetchedAlgorithms&&) = delete;
+
+#if OPENSSL_VERSION_MAJOR >= 3
+			EVP_MD* SHA256Digest{ nullptr };
+			EVP_MD* SHA512Digest{ nullptr };
+			EVP_MD* BLAKE2S256Digest{ nullptr };
+			EVP_MD* BLAKE2B512Digest{ nullptr };
+			EVP_CIPHER* AES256GCMCipher{ nullptr };
+			EVP_CIPHER* ChaCha20Poly1305Cipher{ nullptr };
+			EVP_MAC* HMACAlgorithm{ nullptr };
+#else
+			const EVP_MD* SHA256Digest{ nullptr };
+			const EVP_MD* SHA512Digest{ nullptr };
+			const EVP_MD* BLAKE2S256Digest{ nullptr };
+			const EVP_MD* BLAKE2B512Digest{ nullptr };
+			const EVP_CIPHER* AES256GCMCipher{ nullptr };
+			const EVP_CIPHER* ChaCha20Poly1305Cipher{ nullptr };
+#endif
+		};
+
+		// One static thread_local object per thread manages the digest
+		// and MAC contexts so that they don't have to get allocated
+		// for every operation
+		struct ThreadContexts final
+		{
+			ThreadContexts() noexcept
+			{
+				DigestContext = EVP_MD_CTX_new();
+
+#if OPENSSL_VERSION_MAJOR >= 3
+				if (const auto mac = GetFetchedAlgorithms().HMACAlgorithm; mac != nullptr)
+				{
+					MACContext = EVP_MAC_CTX_new(mac);
+				}
+#else
+				MACContext = HMAC_CTX_new();
+#endif
+			}
+
+			ThreadContexts(const ThreadContexts&) = delete;
+			ThreadContexts(ThreadContexts&&) = delete;
+
+			~ThreadContexts()
+			{
+				if (DigestContext) EVP_MD_CTX_free(DigestContext);
+
+#if OPENSSL_VERSION_MAJOR >= 3
+				if (MACContext) EVP_MAC_CTX_free(MACContext);
+#else
+				if (MACContext) HMAC_CTX_free(MACContext);
+#endif
+			}
+
+			ThreadContexts& operator=(const ThreadContexts&) = delete;
+			ThreadContexts& operator=(ThreadContexts&&) = delete;
+
+			EVP_MD_CTX* DigestContext{ nullptr };
+
+#if OPENSSL_VERSION_MAJOR >= 3
+			EVP_MAC_CTX* MACContext{ nullptr };
+
+			// Digest the MAC context was last initialized with
+			Algorithm::Hash MACDigest{ Algorithm::Hash::Unknown };
+#else
+			HMAC_CTX* MACContext{ nullptr };
+#endif
+		};
+
+		ForceInline static const FetchedAlgorithms& GetFetchedAlgorithms() noexcept
+		{
+			static const FetchedAlgorithms algorithms;
+			return algorithms;
+		}
+
+		ForceInline static ThreadContexts& GetThreadContexts() noexcept
+		{
+			static thread_local ThreadContexts contexts;
+			return contexts;
+		}
+
+		[[nodiscard]] static bool CalcHMAC(const BufferView& buffer, const BufferView& key, const Algorithm::Hash type,
+										   Byte* digest, Size& dlen) noexcept
+		{
+			auto ctx = GetThreadContexts().MACContext;
+			if (ctx == nullptr) return false;
+
+			// A null key would mean reusing the previous key
+			// with the context, so an empty key needs a pointer
+			constexpr Byte empty_key{ 0 };
+			const auto keyptr = key.IsEmpty() ? &empty_key : key.GetBytes();
+
+#if OPENSSL_VERSION_MAJOR >= 3
+			auto& mac_digest = GetThreadContexts().MACDigest;
+
+			std::array<OSSL_PARAM, 2> params{ OSSL_PARAM_construct_end(), OSSL_PARAM_construct_end() };
+
+			// The digest only needs to be set when it's different
+			// from the one the context was last initialized with
+			if (mac_digest != type)
+			{
+				const char* name{ nullptr };
+
+				switch (type)
+				{
+					case Algorithm::Hash::SHA256:
+						name = "SHA256";
+						break;
+					case Algorithm::Hash::SHA512:
+						name = "SHA512";
+						break;
+					case Algorithm::Hash::BLAKE2S256:
+						name = "BLAKE2S-256";
+						break;
+					case Algorithm::Hash::BLAKE2B512:
+						name = "BLAKE2B-512";
+						break;
+					default:
+						return false;
+				}
+
+				params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>(name), 0);
+			}
+
+			mac_digest = Algorithm::Hash::Unknown;
+
+			if (EVP_MAC_init(ctx, reinterpret_cast<const UChar*>(keyptr), key.GetSize(), params.data()) == 1)
+			{
+				mac_digest = type;
+
+				if (EVP_MAC_update(ctx, reinterpret_cast<const UChar*>(buffer.GetBytes()), buffer.GetSize()) == 1 &&
+					EVP_MAC_final(ctx, reinterpret_cast<UChar*>(digest), &dlen, EVP_MAX_MD_SIZE) == 1)
+				{
+					return true;
+				}
+			}
+#else
+			const auto md = GetDigest(type);
+			if (md == nullptr) return false;
+
+			UInt len{ 0 };
+
+			if (HMAC_Init_ex(ctx, keyptr, static_cast<int>(key.GetSize()), md, nullptr) == 1 &&
+				HMAC_Update(ctx, reinterpret_cast<const UChar*>(buffer.GetBytes()), buffer.GetSize()) == 1 &&
+				HMAC_Final(ctx, reinterpret_cast<UChar*>(digest), &len) == 1)
+			{
+				dlen = len;
+				return true;
+			}
+#endif
+
+			return false;
+		}
+
 		[[nodiscard]] static bool GenerateKeyWithParam(AsymmetricKeyData& keydata) noexcept
 		{
 			int nid{ 0 };
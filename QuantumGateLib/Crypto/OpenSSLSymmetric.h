@@ -3,20 +3,64 @@
 
 #pragma once
 
-#include <openssl/evp.h>
+#include "OpenSSL.h"
 
 namespace QuantumGate::Implementation::Crypto
 {
+	// Cipher context that has been initialized with a key (but no IV yet);
+	// contexts for encrypting/decrypting messages with the key get duplicated
+	// from it so that only the IV needs to be set for each message
+	class SymmetricCipherContext final
+	{
+	public:
+		SymmetricCipherContext() noexcept
+		{
+			static std::atomic<UInt64> next_id{ 1 };
+
+			m_ID = next_id.fetch_add(1, std::memory_order_relaxed);
+			m_Context = EVP_CIPHER_CTX_new();
+		}
+
+		SymmetricCipherContext(const SymmetricCipherContext&) = delete;
+		SymmetricCipherContext(SymmetricCipherContext&&) = delete;
+
+		~SymmetricCipherContext()
+		{
+			if (m_Context) EVP_CIPHER_CTX_free(m_Context);
+		}
+
+		SymmetricCipherContext& operator=(const SymmetricCipherContext&) = delete;
+		SymmetricCipherContext& operator=(SymmetricCipherContext&&) = delete;
+
+		// Unique for each context ever created, unlike its address
+		inline UInt64 GetID() const noexcept { return m_ID; }
+		inline EVP_CIPHER_CTX* GetContext() const noexcept { return m_Context; }
+
+	private:
+		UInt64 m_ID{ 0 };
+		EVP_CIPHER_CTX* m_Context{ nullptr };
+	};
+
 	// One static thread_local OpenSSLSymmetric object will manage
 	// resources for encryption/decryption for efficiency (not
 	// having to allocate context memory constantly)
 	class OpenSSLSymmetric final
 	{
+		struct Context final
+		{
+			EVP_CIPHER_CTX* Context{ nullptr };
+
+			// ID of the SymmetricCipherContext the context was last
+			// duplicated from, or zero if it was initialized otherwise
+			UInt64 CipherContextID{ 0 };
+		};
+
 	private:
 		OpenSSLSymmetric() noexcept
 		{
-			// One time allocation of context
-			m_Context = EVP_CIPHER_CTX_new();
+			// One time allocation of contexts
+			m_EncryptContext.Context = EVP_CIPHER_CTX_new();
+			m_DecryptContext.Context = EVP_CIPHER_CTX_new();
 		}
 
 		OpenSSLSymmetric(const OpenSSLSymmetric&) = delete;
@@ -25,103 +69,179 @@ namespace QuantumGate::Implementation::Crypto
 		~OpenSSLSymmetric()
 		{
 			// Free resources
-			if (m_Context) EVP_CIPHER_CTX_free(m_Context);
+			if (m_EncryptContext.Context) EVP_CIPHER_CTX_free(m_EncryptContext.Context);
+			if (m_DecryptContext.Context) EVP_CIPHER_CTX_free(m_DecryptContext.Context);
 		}
 
 		OpenSSLSymmetric& operator=(const OpenSSLSymmetric&) = delete;
 		OpenSSLSymmetric& operator=(OpenSSLSymmetric&&) = delete;
 
-		ForceInline static EVP_CIPHER_CTX* GetContext() noexcept
+		ForceInline static Context& GetContext(const bool encrypt) noexcept
 		{
 			// Static object for use by the current thread
 			// allocated one time for efficiency
 			static thread_local OpenSSLSymmetric openssl;
-			return openssl.m_Context;
+			return encrypt ? openssl.m_EncryptContext : openssl.m_DecryptContext;
 		}
 
-	public:
-		[[nodiscard]] static bool Encrypt(const BufferView& buffer, Buffer& encrbuf,
-										  const SymmetricKeyData& symkeydata, const BufferView& iv) noexcept
+		[[nodiscard]] static EVP_CIPHER_CTX* InitializeContext(const SymmetricKeyData& symkeydata,
+															   const BufferView& iv, const bool encrypt) noexcept
 		{
-			assert(symkeydata.Key.GetSize() >= 32); // At least 256 bits
-			assert(iv.GetSize() >= 12); // At least 96 bits
+			auto& context = GetContext(encrypt);
+
+			auto ctx = context.Context;
+			if (ctx == nullptr) return nullptr;
+
+			const auto enc = encrypt ? 1 : 0;
 
-			const EVP_CIPHER* cipher{ nullptr };
+			if (const auto& cctx = symkeydata.CipherContext;
+				cctx != nullptr && iv.GetSize() == SymmetricKeyData::NonceSize)
+			{
+				// Duplicate the context that was initialized with the key, unless
+				// that was already done for a previous message using the same key
+				if (context.CipherContextID != cctx->GetID())
+				{
+					context.CipherContextID = 0;
+
+					if (EVP_CIPHER_CTX_copy(ctx, cctx->GetContext()) != 1) return nullptr;
+
+					context.CipherContextID = cctx->GetID();
+				}
+
+				// Only the IV needs to be set
+				if (EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr,
+									  reinterpret_cast<const UChar*>(iv.GetBytes()), enc) == 1)
+				{
+					return ctx;
+				}
 
-			switch (symkeydata.SymmetricAlgorithm)
+				context.CipherContextID = 0;
+				return nullptr;
+			}
+
+			context.CipherContextID = 0;
+
+			const auto cipher = OpenSSL::GetCipher(symkeydata.SymmetricAlgorithm);
+			if (cipher == nullptr) return nullptr;
+
+			// Initialize the operation
+			if (EVP_CipherInit_ex(ctx, cipher, nullptr, nullptr, nullptr, enc) == 1)
 			{
-				case Algorithm::Symmetric::AES256_GCM:
-					cipher = EVP_aes_256_gcm();
-					break;
-				case Algorithm::Symmetric::CHACHA20_POLY1305:
-					cipher = EVP_chacha20_poly1305();
-					break;
-				default:
-					return false;
+				EVP_CIPHER_CTX_set_padding(ctx, 1);
+
+				// Set IV length (default is 12 bytes (96 bits), but AES supports larger ones)
+				if (symkeydata.SymmetricAlgorithm == Algorithm::Symmetric::AES256_GCM)
+				{
+					if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN,
+											static_cast<int>(iv.GetSize()), nullptr) != 1) return nullptr;
+				}
+
+				// Initialize key and IV
+				if (EVP_CipherInit_ex(ctx, nullptr, nullptr,
+									  reinterpret_cast<const UChar*>(symkeydata.Key.GetBytes()),
+									  reinterpret_cast<const UChar*>(iv.GetBytes()), enc) == 1)
+				{
+					return ctx;
+				}
 			}
 
-			// Docs: https://wiki.openssl.org/index.php/EVP_Authenticated_Encryption_and_Decryption
-			// https://www.openssl.org/docs/man1.1.0/crypto/EVP_chacha20_poly1305.html
+			return nullptr;
+		}
+
+	public:
+		// Creates a cipher context initialized with the key for use with
+		// nonces of SymmetricKeyData::NonceSize; worth it for keys that
+		// get used for many messages
+		[[nodiscard]] static std::shared_ptr<const SymmetricCipherContext>
+			CreateCipherContext(const SymmetricKeyData& symkeydata) noexcept
+		{
+			assert(symkeydata.Key.GetSize() >= 32); // At least 256 bits
 
 			try
 			{
-				auto ctx = GetContext();
-				assert(ctx != nullptr);
+				const auto cipher = OpenSSL::GetCipher(symkeydata.SymmetricAlgorithm);
+				if (cipher == nullptr) return nullptr;
+
+				auto cctx = std::make_shared<SymmetricCipherContext>();
+
+				auto ctx = cctx->GetContext();
+				if (ctx == nullptr) return nullptr;
 
-				// Initialize the encryption operation
-				if (EVP_EncryptInit_ex(ctx, cipher, nullptr, nullptr, nullptr) == 1)
+				// The context is initialized for encryption; the direction
+				// gets set for each message when the IV is set
+				if (EVP_CipherInit_ex(ctx, cipher, nullptr, nullptr, nullptr, 1) == 1)
 				{
 					EVP_CIPHER_CTX_set_padding(ctx, 1);
 
-					// Set IV length (default is 12 bytes (96 bits), but AES supports larger ones)
 					if (symkeydata.SymmetricAlgorithm == Algorithm::Symmetric::AES256_GCM)
 					{
 						if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN,
-												static_cast<int>(iv.GetSize()), nullptr) != 1) return false;
+												static_cast<int>(SymmetricKeyData::NonceSize), nullptr) != 1) return nullptr;
 					}
 
-					// Initialize key and IV
-					if (EVP_EncryptInit_ex(ctx, nullptr, nullptr,
-										   reinterpret_cast<const UChar*>(symkeydata.Key.GetBytes()),
-										   reinterpret_cast<const UChar*>(iv.GetBytes())) == 1)
+					// Initialize key only
+					if (EVP_CipherInit_ex(ctx, nullptr, nullptr,
+										  reinterpret_cast<const UChar*>(symkeydata.Key.GetBytes()), nullptr, 1) == 1)
 					{
-						Size encrlen{ 0 };
-						Size len{ 0 };
-						Size taglen{ 16 };
+						return cctx;
+					}
+				}
+			}
+			catch (...) {}
 
-						encrbuf.Allocate(taglen + buffer.GetSize() + EVP_CIPHER_CTX_block_size(ctx));
+			return nullptr;
+		}
 
-						// Provide the message to be encrypted, and obtain the encrypted output
-						if (EVP_EncryptUpdate(ctx, reinterpret_cast<UChar*>(encrbuf.GetBytes()) + taglen,
-											  reinterpret_cast<int*>(&len), reinterpret_cast<const UChar*>(buffer.GetBytes()),
-											  static_cast<int>(buffer.GetSize())) == 1)
-						{
-							encrlen = len;
-							len = 0;
+		[[nodiscard]] static bool Encrypt(const BufferView& buffer, Buffer& encrbuf,
+										  const SymmetricKeyData& symkeydata, const BufferView& iv) noexcept
+		{
+			assert(symkeydata.Key.GetSize() >= 32); // At least 256 bits
+			assert(iv.GetSize() >= 12); // At least 96 bits
 
-							// Finalize the encryption
-							if (EVP_EncryptFinal_ex(ctx, reinterpret_cast<UChar*>(encrbuf.GetBytes()) + taglen + encrlen,
-													reinterpret_cast<int*>(&len)) == 1)
-							{
-								encrlen += len;
+			// Docs: https://wiki.openssl.org/index.php/EVP_Authenticated_Encryption_and_Decryption
+			// https://www.openssl.org/docs/man1.1.0/crypto/EVP_chacha20_poly1305.html
+
+			try
+			{
+				// Initialize the encryption operation with key and IV
+				if (auto ctx = InitializeContext(symkeydata, iv, true); ctx != nullptr)
+				{
+					Size encrlen{ 0 };
+					Size len{ 0 };
+					Size taglen{ 16 };
+
+					encrbuf.Allocate(taglen + buffer.GetSize() + EVP_CIPHER_CTX_block_size(ctx));
+
+					// Provide the message to be encrypted, and obtain the encrypted output
+					if (EVP_EncryptUpdate(ctx, reinterpret_cast<UChar*>(encrbuf.GetBytes()) + taglen,
+										  reinterpret_cast<int*>(&len), reinterpret_cast<const UChar*>(buffer.GetBytes()),
+										  static_cast<int>(buffer.GetSize())) == 1)
+					{
+						encrlen = len;
+						len = 0;
 
-								assert(encrlen <= (encrbuf.GetSize() - taglen));
+						// Finalize the encryption
+						if (EVP_EncryptFinal_ex(ctx, reinterpret_cast<UChar*>(encrbuf.GetBytes()) + taglen + encrlen,
+												reinterpret_cast<int*>(&len)) == 1)
+						{
+							encrlen += len;
+
+							assert(encrlen <= (encrbuf.GetSize() - taglen));
 
-								// Get the tag (16 bytes (128 bits))
-								if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG,
-														static_cast<int>(taglen), encrbuf.GetBytes()) == 1)
+							// Get the tag (16 bytes (128 bits))
+							if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG,
+													static_cast<int>(taglen), encrbuf.GetBytes()) == 1)
+							{
+								DbgInvoke([&]() noexcept
 								{
-									DbgInvoke([&]() noexcept
-									{
-										const auto tag = BufferView(encrbuf).GetFirst(taglen);
+									const auto tag = BufferView(encrbuf).GetFirst(taglen);
 
-										Dbg(L"Etag: %s", Util::ToBase64(tag)->c_str());
-										Dbg(L"Encr: %s", Util::ToBase64(encrbuf)->c_str());
-									});
+									Dbg(L"Etag: %s", Util::ToBase64(tag)->c_str());
+									Dbg(L"Encr: %s", Util::ToBase64(encrbuf)->c_str());
+								});
 
-									encrbuf.Resize(taglen + encrlen);
-									return true;
-								}
+								encrbuf.Resize(taglen + encrlen);
+								return true;
 							}
 						}
 					}
@@ -132,87 +252,98 @@ namespace QuantumGate::Implementation::Crypto
 			return false;
 		}
 
-		[[nodiscard]] static bool Decrypt(const BufferView& encrbuf, Buffer& buffer,
+		[[nodiscard]] static bool Encrypt(BufferSpan buffer, BufferSpan tag,
 										  const SymmetricKeyData& symkeydata, const BufferView& iv) noexcept
 		{
 			assert(symkeydata.Key.GetSize() >= 32); // At least 256 bits
 			assert(iv.GetSize() >= 12); // At least 96 bits
+			assert(tag.GetSize() == SymmetricKeyData::TagSize);
 
-			const EVP_CIPHER* cipher{ nullptr };
-
-			switch (symkeydata.SymmetricAlgorithm)
+			try
 			{
-				case Algorithm::Symmetric::AES256_GCM:
-					cipher = EVP_aes_256_gcm();
-					break;
-				case Algorithm::Symmetric::CHACHA20_POLY1305:
-					cipher = EVP_chacha20_poly1305();
-					break;
-				default:
-					return false;
+				// Initialize the encryption operation with key and IV
+				if (auto ctx = InitializeContext(symkeydata, iv, true); ctx != nullptr)
+				{
+					// Encrypting in place only works for stream ciphers
+					// where the output is as large as the input
+					if (EVP_CIPHER_CTX_block_size(ctx) != 1) return false;
+
+					int len{ 0 };
+
+					if (EVP_EncryptUpdate(ctx, reinterpret_cast<UChar*>(buffer.GetBytes()), &len,
+										  reinterpret_cast<const UChar*>(buffer.GetBytes()),
+										  static_cast<int>(buffer.GetSize())) == 1 &&
+						static_cast<Size>(len) == buffer.GetSize())
+					{
+						int flen{ 0 };
+
+						if (EVP_EncryptFinal_ex(ctx, reinterpret_cast<UChar*>(buffer.GetBytes()) + len, &flen) == 1 &&
+							flen == 0)
+						{
+							// Get the tag (16 bytes (128 bits))
+							if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG,
+													static_cast<int>(tag.GetSize()), tag.GetBytes()) == 1)
+							{
+								return true;
+							}
+						}
+					}
+				}
 			}
+			catch (...) {}
+
+			return false;
+		}
+
+		[[nodiscard]] static bool Decrypt(const BufferView& encrbuf, Buffer& buffer,
+										  const SymmetricKeyData& symkeydata, const BufferView& iv) noexcept
+		{
+			assert(symkeydata.Key.GetSize() >= 32); // At least 256 bits
+			assert(iv.GetSize() >= 12); // At least 96 bits
 
 			// Docs: https://wiki.openssl.org/index.php/EVP_Authenticated_Encryption_and_Decryption
 			// https://www.openssl.org/docs/man1.1.0/crypto/EVP_chacha20_poly1305.html
 
 			try
 			{
-				auto ctx = GetContext();
-				assert(ctx != nullptr);
-
-				// Initialize the decryption operation
-				if (EVP_DecryptInit_ex(ctx, cipher, nullptr, nullptr, nullptr) == 1)
+				// Initialize the decryption operation with key and IV
+				if (auto ctx = InitializeContext(symkeydata, iv, false); ctx != nullptr)
 				{
-					EVP_CIPHER_CTX_set_padding(ctx, 1);
-
-					// Set IV length (default is 12 bytes (96 bits))
-					if (symkeydata.SymmetricAlgorithm == Algorithm::Symmetric::AES256_GCM)
+					buffer.Allocate(encrbuf.GetSize());
+					Size declen{ 0 };
+					Size len{ 0 };
+					const Size taglen{ 16 };
+
+					// Provide the message to be decrypted, and obtain the plaintext output
+					if (EVP_DecryptUpdate(ctx, reinterpret_cast<UChar*>(buffer.GetBytes()), reinterpret_cast<int*>(&len),
+										  reinterpret_cast<const UChar*>(encrbuf.GetBytes()) + taglen,
+										  static_cast<int>(encrbuf.GetSize() - taglen)) == 1)
 					{
-						if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_IVLEN,
-												static_cast<int>(iv.GetSize()), nullptr) != 1) return false;
-					}
+						declen = len;
 
-					// Initialize key and IV
-					if (EVP_DecryptInit_ex(ctx, nullptr, nullptr,
-										   reinterpret_cast<const UChar*>(symkeydata.Key.GetBytes()),
-										   reinterpret_cast<const UChar*>(iv.GetBytes())) == 1)
-					{
-						buffer.Allocate(encrbuf.GetSize());
-						Size declen{ 0 };
-						Size len{ 0 };
-						const Size taglen{ 16 };
-
-						// Provide the message to be decrypted, and obtain the plaintext output
-						if (EVP_DecryptUpdate(ctx, reinterpret_cast<UChar*>(buffer.GetBytes()), reinterpret_cast<int*>(&len),
-											  reinterpret_cast<const UChar*>(encrbuf.GetBytes()) + taglen,
-											  static_cast<int>(encrbuf.GetSize() - taglen)) == 1)
+						DbgInvoke([&]() noexcept
 						{
-							declen = len;
+							const auto tag = BufferView(encrbuf).GetFirst(taglen);
 
-							DbgInvoke([&]() noexcept
-							{
-								const auto tag = BufferView(encrbuf).GetFirst(taglen);
+							Dbg(L"Dtag: %s", Util::ToBase64(tag)->c_str());
+							Dbg(L"Decr: %s", Util::ToBase64(encrbuf)->c_str());
+						});
 
-								Dbg(L"Dtag: %s", Util::ToBase64(tag)->c_str());
-								Dbg(L"Decr: %s", Util::ToBase64(encrbuf)->c_str());
-							});
+						// Set expected tag value
+						if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG,
+												static_cast<int>(taglen), const_cast<Byte*>(encrbuf.GetBytes())) == 1)
+						{
+							len = 0;
 
-							// Set expected tag value
-							if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG,
-													static_cast<int>(taglen), const_cast<Byte*>(encrbuf.GetBytes())) == 1)
+							// Finalize the decryption; a positive return value indicates success,
+							// anything else is a failure - the plaintext is not trustworthy
+							const auto ret = EVP_DecryptFinal_ex(ctx, reinterpret_cast<UChar*>(buffer.GetBytes()) + declen,
+																 reinterpret_cast<int*>(&len));
+							if (ret > 0)
 							{
-								len = 0;
-
-								// Finalize the decryption; a positive return value indicates success,
-								// anything else is a failure - the plaintext is not trustworthy
-								const auto ret = EVP_DecryptFinal_ex(ctx, reinterpret_cast<UChar*>(buffer.GetBytes()) + declen,
-																	 reinterpret_cast<int*>(&len));
-								if (ret > 0)
-								{
-									declen += len;
-									buffer.Resize(declen);
-									return true;
-								}
+								declen += len;
+								buffer.Resize(declen);
+								return true;
 							}
 						}
 					}
@@ -224,6 +355,7 @@ namespace QuantumGate::Implementation::Crypto
 		}
 
 	private:
-		EVP_CIPHER_CTX* m_Context{ nullptr };
+		Context m_EncryptContext;
+		Context m_DecryptContext;
 	};
 }
\ No newline at end of file
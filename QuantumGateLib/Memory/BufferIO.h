@@ -8,6 +8,7 @@
 #undef max
 
 #include "StackBuffer.h"
+#include "SmallBuffer.h"
 #include "..\Common\Endian.h"
 #include "..\Network\SerializedBinaryIPAddress.h"
 #include "..\Network\SerializedBinaryBTHAddress.h"
@@ -150,6 +151,12 @@ namespace QuantumGate::Implementation::Memory
 			return data.GetSize();
 		}
 
+		template<Size InlineSize>
+		Size GetDataSize(const SmallBuffer<InlineSize>& data) noexcept
+		{
+			return data.GetSize();
+		}
+
 		template<typename T>
 		Size GetDataSize(const SizeWrap<T>& data) noexcept
 		{
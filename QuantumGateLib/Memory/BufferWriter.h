@@ -138,6 +138,12 @@ namespace QuantumGate::Implementation::Memory
 			return WriteBytes(data.GetBytes(), BufferIO::GetDataSize(data));
 		}
 
+		template<Size InlineSize>
+		[[nodiscard]] bool WriteImpl(const SmallBuffer<InlineSize>& data)
+		{
+			return WriteBytes(data.GetBytes(), BufferIO::GetDataSize(data));
+		}
+
 		[[nodiscard]] bool WriteEncodedSize(const Size size, const Size maxsize) noexcept
 		{
 			assert(size <= maxsize);
@@ -209,4 +215,7 @@ namespace QuantumGate::Implementation::Memory
 
 	template<Size MaxSize>
 	using StackBufferWriter = BufferWriterImpl<StackBuffer<MaxSize>>;
+
+	template<Size InlineSize>
+	using SmallBufferWriter = BufferWriterImpl<SmallBuffer<InlineSize>>;
 }
@@ -0,0 +1,189 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+#include "Buffer.h"
+
+namespace QuantumGate::Implementation::Memory
+{
+	// Buffer for building network packets; reserves room in front of (headroom)
+	// and after (tailroom) the data so that headers can be prepended and data
+	// appended without moving the existing data. Removing data from the front
+	// or the back only adjusts the boundaries of the data.
+	template<template<typename> typename A = FreeStoreAllocator>
+	class PacketBufferImpl
+	{
+	public:
+		using VectorType = std::vector<Byte, A<Byte>>;
+		using SizeType = Size;
+
+		PacketBufferImpl() noexcept {}
+
+		explicit PacketBufferImpl(const Size headroom, const Size tailroom = 0) { Reserve(headroom, tailroom); }
+
+		PacketBufferImpl(const BufferView& buffer, const Size headroom = 0, const Size tailroom = 0)
+		{
+			Reserve(headroom, buffer.GetSize() + tailroom);
+			Append(buffer);
+		}
+
+		PacketBufferImpl(BufferImpl<A>&& buffer) noexcept :
+			m_Buffer(std::move(buffer.GetVector()))
+		{}
+
+		PacketBufferImpl(const PacketBufferImpl& other) :
+			m_Buffer(other.m_Buffer), m_Offset(other.m_Offset)
+		{}
+
+		PacketBufferImpl(PacketBufferImpl&& other) noexcept :
+			m_Buffer(std::move(other.m_Buffer)), m_Offset(std::exchange(other.m_Offset, 0))
+		{}
+
+		~PacketBufferImpl() = default;
+
+		inline explicit operator bool() const noexcept { return !IsEmpty(); }
+
+		inline Byte& operator[](const Size index) { return m_Buffer[m_Offset + index]; }
+		inline const Byte& operator[](const Size index) const { return m_Buffer[m_Offset + index]; }
+
+		inline PacketBufferImpl& operator=(const PacketBufferImpl& other)
+		{
+			// Check for same object
+			if (this == &other) return *this;
+
+			m_Buffer = other.m_Buffer;
+			m_Offset = other.m_Offset;
+
+			return *this;
+		}
+
+		inline PacketBufferImpl& operator=(PacketBufferImpl&& other) noexcept
+		{
+			// Check for same object
+			if (this == &other) return *this;
+
+			m_Buffer = std::move(other.m_Buffer);
+			m_Offset = std::exchange(other.m_Offset, 0);
+
+			return *this;
+		}
+
+		inline bool operator==(const BufferView& other) const noexcept
+		{
+			return (this->operator BufferView() == other);
+		}
+
+		inline bool operator!=(const BufferView& other) const noexcept
+		{
+			return (this->operator BufferView() != other);
+		}
+
+		inline operator BufferView() const noexcept { return { GetBytes(), GetSize() }; }
+		inline operator BufferSpan() noexcept { return { GetBytes(), GetSize() }; }
+
+		inline PacketBufferImpl& operator+=(const BufferView& buffer) { Append(buffer); return *this; }
+
+		[[nodiscard]] inline Byte* GetBytes() noexcept { return m_Buffer.data() + m_Offset; }
+		[[nodiscard]] inline const Byte* GetBytes() const noexcept { return m_Buffer.data() + m_Offset; }
+
+		[[nodiscard]] inline Size GetSize() const noexcept { return m_Buffer.size() - m_Offset; }
+
+		[[nodiscard]] inline bool IsEmpty() const noexcept { return (GetSize() == 0); }
+
+		[[nodiscard]] inline Size GetHeadroom() const noexcept { return m_Offset; }
+		[[nodiscard]] inline Size GetTailroom() const noexcept { return m_Buffer.capacity() - m_Buffer.size(); }
+
+		// Makes sure there's at least the specified amount of headroom and tailroom;
+		// only when the headroom has to grow does the data get moved
+		void Reserve(const Size headroom, const Size tailroom)
+		{
+			if (headroom > m_Offset)
+			{
+				VectorType buffer;
+				buffer.reserve(headroom + GetSize() + tailroom);
+				buffer.resize(headroom, Byte{ 0 });
+				buffer.insert(buffer.end(), m_Buffer.begin() + m_Offset, m_Buffer.end());
+
+				m_Buffer = std::move(buffer);
+				m_Offset = headroom;
+			}
+			else if (tailroom > GetTailroom())
+			{
+				m_Buffer.reserve(m_Buffer.size() + tailroom);
+			}
+		}
+
+		// Adds space for size bytes in front of the data and returns it; the
+		// contents are unspecified and expected to get written by the caller
+		[[nodiscard]] BufferSpan Prepend(const Size size)
+		{
+			if (size > m_Offset) Reserve(size, GetTailroom());
+
+			m_Offset -= size;
+
+			return { GetBytes(), size };
+		}
+
+		void Prepend(const BufferView& buffer)
+		{
+			if (!buffer.IsEmpty())
+			{
+				auto span = Prepend(buffer.GetSize());
+				std::memcpy(span.GetBytes(), buffer.GetBytes(), buffer.GetSize());
+			}
+		}
+
+		// Adds size zeroed bytes after the data and returns them
+		[[nodiscard]] BufferSpan Append(const Size size)
+		{
+			m_Buffer.resize(m_Buffer.size() + size, Byte{ 0 });
+
+			return { m_Buffer.data() + m_Buffer.size() - size, size };
+		}
+
+		void Append(const BufferView& buffer)
+		{
+			if (!buffer.IsEmpty())
+			{
+				m_Buffer.insert(m_Buffer.end(), buffer.GetBytes(), buffer.GetBytes() + buffer.GetSize());
+			}
+		}
+
+		inline void RemoveFirst(const Size num) noexcept
+		{
+			assert(GetSize() >= num);
+
+			m_Offset += std::min(num, GetSize());
+		}
+
+		inline void RemoveLast(const Size num) noexcept
+		{
+			assert(GetSize() >= num);
+
+			m_Buffer.resize(m_Buffer.size() - std::min(num, GetSize()));
+		}
+
+		// Removes the data but keeps the headroom and tailroom
+		inline void Clear() noexcept { m_Buffer.resize(m_Offset); }
+
+		// Returns the data in a Buffer; the data only gets moved
+		// (not reallocated) when there's headroom in front of it
+		[[nodiscard]] BufferImpl<A> MoveToBuffer() noexcept
+		{
+			if (m_Offset > 0)
+			{
+				m_Buffer.erase(m_Buffer.begin(), m_Buffer.begin() + m_Offset);
+				m_Offset = 0;
+			}
+
+			return BufferImpl<A>(std::move(m_Buffer));
+		}
+
+	private:
+		VectorType m_Buffer;
+		Size m_Offset{ 0 };
+	};
+
+	using PacketBuffer = PacketBufferImpl<DefaultAllocator>;
+}
\ No newline at end of file
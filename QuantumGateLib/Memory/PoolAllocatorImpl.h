@@ -23,7 +23,8 @@ namespace QuantumGate::Implementation::Memory::PoolAllocator
 
 	template<> struct AllocatorConstants<ProtectedPool>
 	{
-		static constexpr const std::size_t PoolAllocationMinimumSize{ MemorySize::_1B };
+		// Smaller allocations are handled by the slabs of the ProtectedFreeStoreAllocator
+		static constexpr const std::size_t PoolAllocationMinimumSize{ ProtectedFreeStoreAllocatorBase::MaximumSlabAllocationSize };
 		static constexpr const std::size_t PoolAllocationMaximumSize{ MemorySize::_4MB };
 		static constexpr const std::size_t MaximumFreeBufferPoolSize{ MemorySize::_16MB };
 		static constexpr const std::size_t MaximumFreeBuffersPerPool{ 20 };
@@ -5,6 +5,8 @@
 
 #include "FreeStoreAllocator.h"
 
+#include <bit>
+
 namespace QuantumGate::Implementation::Memory
 {
 	class BadAllocException final : public std::exception
@@ -16,6 +18,32 @@ namespace QuantumGate::Implementation::Memory
 	class Export ProtectedFreeStoreAllocatorBase
 	{
 	public:
+		// Allocations up to this size are sub-allocated from larger locked
+		// memory regions (slabs) instead of getting their own locked pages
+		static constexpr std::size_t MaximumSlabAllocationSize{ 4096 };
+
+		// Slab allocations get rounded up to the next power of 2 (size class),
+		// starting at the minimum block size
+		static constexpr std::size_t MinimumSlabBlockSize{ 16 };
+		static constexpr std::size_t NumSlabSizeClasses{ std::bit_width(MaximumSlabAllocationSize) -
+															std::bit_width(MinimumSlabBlockSize) + 1 };
+
+		static_assert(std::has_single_bit(MaximumSlabAllocationSize),
+					  "Maximum slab allocation size should be a power of 2");
+
+		[[nodiscard]] static constexpr std::size_t GetSlabSizeClass(const std::size_t len) noexcept
+		{
+			assert(len <= MaximumSlabAllocationSize);
+
+			const auto len2 = std::max(len, MinimumSlabBlockSize);
+			return std::bit_width(len2 - 1) - std::bit_width(MinimumSlabBlockSize - 1);
+		}
+
+		[[nodiscard]] static constexpr std::size_t GetSlabBlockSize(const std::size_t size_class) noexcept
+		{
+			return MinimumSlabBlockSize << size_class;
+		}
+
 		static void LogStatistics() noexcept;
 
 	protected:
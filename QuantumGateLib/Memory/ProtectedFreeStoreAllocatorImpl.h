@@ -4,8 +4,10 @@
 #include "pch.h"
 #include "ProtectedFreeStoreAllocator.h"
 #include "AllocatorStats.h"
+#include "..\Concurrency\SpinMutex.h"
 
 #include <mutex>
+#include <bit>
 
 namespace QuantumGate::Implementation::Memory
 {
@@ -56,99 +58,409 @@ namespace QuantumGate::Implementation::Memory
 		return false;
 	}
 
-	void ProtectedFreeStoreAllocatorBase::LogStatistics() noexcept
+	// Locks memory in physical memory and prevents it from being swapped to the
+	// pagefile (on disk); increases the working set size of the process if needed
+	inline bool LockMemory(void* memaddr, const std::size_t len) noexcept
 	{
-		DbgInvoke([&]()
-		{
-			std::wstring output{ L"\r\n\r\nProtectedFreeStoreAllocator allocation sizes:\r\n-----------------------------------------------\r\n" };
-			output += GetProtectedFreeStoreAllocatorStats().WithSharedLock()->GetAllSizes();
-			output += L"\r\nProtectedFreeStoreAllocator memory in use:\r\n-----------------------------------------------\r\n";
-			output += GetProtectedFreeStoreAllocatorStats().WithSharedLock()->GetMemoryInUse();
-			output += L"\r\n";
+		if (::VirtualLock(memaddr, len) != 0) return true;
 
-			SLogInfo(output);
-		});
-	}
+		auto succeeded = false;
 
-	void* ProtectedFreeStoreAllocatorBase::Allocate(const std::size_t len)
-	{
-		auto memaddr = ::VirtualAlloc(NULL, len, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-		if (memaddr != NULL)
+		// If the failure was caused by a low quota
+		// we try to increase it if possible
+		if (::GetLastError() == ERROR_WORKING_SET_QUOTA)
 		{
-			// Lock in physical memory and prevent from being swapped to pagefile (on disk)
-			if (::VirtualLock(memaddr, len) == 0)
+			std::unique_lock<std::mutex> lock(GetProtectedFreeStoreAllocatorMutex());
+
+			// Previous lock may have caused a delay while other threads
+			// increased the working set size; so try again before
+			// proceeding to increase the working set size
+			if (::VirtualLock(memaddr, len) != 0)
+			{
+				succeeded = true;
+			}
+			else if (::GetLastError() == ERROR_WORKING_SET_QUOTA)
 			{
-				auto succeeded = false;
+				auto retry = 0u;
 
-				// If the failure was caused by a low quota
-				// we try to increase it if possible
-				if (::GetLastError() == ERROR_WORKING_SET_QUOTA)
-				{
-					GetProtectedFreeStoreAllocatorMutex().lock();
+				std::size_t nmin{ 0 };
+				std::size_t nmax{ 0 };
 
-					// Previous lock may have caused a delay while other threads
-					// increased the working set size; so try again before
-					// proceeding to increase the working set size
-					if (::VirtualLock(memaddr, len) != 0)
-					{
-						succeeded = true;
-					}
-					else if (::GetLastError() == ERROR_WORKING_SET_QUOTA)
+				do
+				{
+					if (GetCurrentProcessWorkingSetSize(nmin, nmax))
 					{
-						auto retry = 0u;
+						std::size_t nmin2 = nmin * 2;
+						if (nmin + len > nmin2)
+						{
+							nmin2 = nmin + len;
+						}
 
-						std::size_t nmin{ 0 };
-						std::size_t nmax{ 0 };
+						std::size_t nmax2 = nmax;
+						if (nmax2 <= nmin2)
+						{
+							nmax2 = nmin2 * 2;
+						}
 
-						do
+						if (SetCurrentProcessWorkingSetSize(nmin2, nmax2))
 						{
-							if (GetCurrentProcessWorkingSetSize(nmin, nmax))
+							if (::VirtualLock(memaddr, len) != 0)
 							{
-								std::size_t nmin2 = nmin * 2;
-								if (nmin + len > nmin2)
-								{
-									nmin2 = nmin + len;
-								}
-
-								std::size_t nmax2 = nmax;
-								if (nmax2 <= nmin2)
-								{
-									nmax2 = nmin2 * 2;
-								}
-
-								if (SetCurrentProcessWorkingSetSize(nmin2, nmax2))
-								{
-									if (::VirtualLock(memaddr, len) != 0)
-									{
-										succeeded = true;
-										break;
-									}
-								}
-								else break;
+								succeeded = true;
+								break;
 							}
-							else break;
-
-							++retry;
 						}
-						while (retry < 3);
+						else break;
 					}
+					else break;
 
-					GetProtectedFreeStoreAllocatorMutex().unlock();
+					++retry;
 				}
+				while (retry < 3);
+			}
+		}
+
+		return succeeded;
+	}
+
+	// Sub-allocates small allocations from large locked memory regions so that
+	// they don't each need their own (locked) pages and system calls. Each region
+	// serves one size class (powers of 2 from MinimumSlabBlockSize up to the maximum
+	// slab allocation size) and is surrounded by guard pages that can't be accessed.
+	// Freed blocks get wiped by the caller before they are returned, and are kept
+	// in small per-thread caches before they go back to the shared free lists.
+	// Regions are not released; they get reused for later allocations.
+	class ProtectedSlabAllocator final
+	{
+		struct FreeBlock final
+		{
+			FreeBlock* Next{ nullptr };
+		};
+
+		struct SizeClassData final
+		{
+			FreeBlock* FreeList{ nullptr };
+			std::size_t NumFreeBlocks{ 0 };
+			std::size_t NumRegions{ 0 };
+		};
 
-				if (!succeeded)
+		using SizeClassData_ThS = Concurrency::ThreadSafe<SizeClassData, Concurrency::SpinMutex>;
+
+		// Blocks of a newly allocated region, linked together
+		struct Region final
+		{
+			FreeBlock* First{ nullptr };
+			FreeBlock* Last{ nullptr };
+			std::size_t NumBlocks{ 0 };
+		};
+
+	public:
+		static constexpr std::size_t NumSizeClasses{ ProtectedFreeStoreAllocatorBase::NumSlabSizeClasses };
+		static constexpr std::size_t RegionSize{ MemorySize::_1MB / 4 };
+		static constexpr std::size_t ThreadCacheSize{ 32 };
+
+	private:
+		class ThreadCache final
+		{
+			struct Bin final
+			{
+				std::array<void*, ThreadCacheSize> Blocks{ nullptr };
+				std::size_t NumBlocks{ 0 };
+			};
+
+		public:
+			ThreadCache() noexcept = default;
+			ThreadCache(const ThreadCache&) = delete;
+			ThreadCache(ThreadCache&&) = delete;
+
+			~ThreadCache()
+			{
+				// Return all cached blocks so that other threads can use them
+				for (std::size_t x = 0; x < NumSizeClasses; ++x)
 				{
-					::VirtualFree(memaddr, 0, MEM_RELEASE);
+					auto& bin = m_Bins[x];
+					ProtectedSlabAllocator::Get().Release(x, bin.Blocks.data(), bin.NumBlocks);
+					bin.NumBlocks = 0;
+				}
 
-					std::string error = "Memory allocation error; could not lock memory: GetLastError() returned " + std::to_string(::GetLastError());
-					throw BadAllocException(error.c_str());
+				Destroyed = true;
+			}
+
+			ThreadCache& operator=(const ThreadCache&) = delete;
+			ThreadCache& operator=(ThreadCache&&) = delete;
+
+			[[nodiscard]] void* Allocate(const std::size_t size_class)
+			{
+				auto& bin = m_Bins[size_class];
+				if (bin.NumBlocks == 0)
+				{
+					// Get a batch of blocks at once
+					bin.NumBlocks = ProtectedSlabAllocator::Get().Acquire(size_class, bin.Blocks.data(), ThreadCacheSize / 2);
+				}
+
+				return bin.Blocks[--bin.NumBlocks];
+			}
+
+			void Deallocate(const std::size_t size_class, void* p) noexcept
+			{
+				auto& bin = m_Bins[size_class];
+				if (bin.NumBlocks == ThreadCacheSize)
+				{
+					// Cache is full; return half of it
+					bin.NumBlocks -= ThreadCacheSize / 2;
+					ProtectedSlabAllocator::Get().Release(size_class, bin.Blocks.data() + bin.NumBlocks, ThreadCacheSize / 2);
 				}
+
+				bin.Blocks[bin.NumBlocks++] = p;
+			}
+
+			// Allocations can still get freed after the cache of a thread got destroyed
+			// (e.g. by other thread local objects); those go to the shared free lists
+			static thread_local bool Destroyed;
+
+		private:
+			std::array<Bin, NumSizeClasses> m_Bins;
+		};
+
+	public:
+		ProtectedSlabAllocator() noexcept
+		{
+			SYSTEM_INFO sysinfo{ 0 };
+			::GetSystemInfo(&sysinfo);
+
+			m_PageSize = sysinfo.dwPageSize;
+		}
+
+		ProtectedSlabAllocator(const ProtectedSlabAllocator&) = delete;
+		ProtectedSlabAllocator(ProtectedSlabAllocator&&) = delete;
+		~ProtectedSlabAllocator() = default;
+		ProtectedSlabAllocator& operator=(const ProtectedSlabAllocator&) = delete;
+		ProtectedSlabAllocator& operator=(ProtectedSlabAllocator&&) = delete;
+
+		[[nodiscard]] static ProtectedSlabAllocator& Get() noexcept
+		{
+			// Never destroyed because memory can still get freed
+			// during the destruction of other static objects
+			static ProtectedSlabAllocator* slab = new ProtectedSlabAllocator();
+			return *slab;
+		}
+
+		[[nodiscard]] void* Allocate(const std::size_t len)
+		{
+			const auto size_class = ProtectedFreeStoreAllocatorBase::GetSlabSizeClass(len);
+
+			void* p{ nullptr };
+
+			if (!ThreadCache::Destroyed)
+			{
+				p = GetThreadCache().Allocate(size_class);
+			}
+			else DiscardReturnValue(Acquire(size_class, &p, 1));
+
+			// Don't leave the free list link behind
+			static_cast<FreeBlock*>(p)->Next = nullptr;
+
+			return p;
+		}
+
+		void Deallocate(void* p, const std::size_t len) noexcept
+		{
+			const auto size_class = ProtectedFreeStoreAllocatorBase::GetSlabSizeClass(len);
+
+			if (!ThreadCache::Destroyed)
+			{
+				GetThreadCache().Deallocate(size_class, p);
 			}
+			else Release(size_class, &p, 1);
+		}
+
+		[[nodiscard]] std::wstring GetStatistics() const
+		{
+			std::wstring output;
+			std::size_t total{ 0 };
+
+			for (std::size_t x = 0; x < NumSizeClasses; ++x)
+			{
+				m_SizeClasses[x].WithUniqueLock([&](const SizeClassData& scd)
+				{
+					output += AllocatorStats::FormatString(L"Block size: %8zu bytes -> Regions: %4zu, Free blocks in shared list: %zu\r\n",
+														   ProtectedFreeStoreAllocatorBase::GetSlabBlockSize(x), scd.NumRegions, scd.NumFreeBlocks);
+					total += scd.NumRegions * RegionSize;
+				});
+			}
+
+			output += AllocatorStats::FormatString(L"\r\nTotal in slab regions: %zu bytes\r\n", total);
+
+			return output;
+		}
+
+	private:
+		[[nodiscard]] static ThreadCache& GetThreadCache() noexcept
+		{
+			static thread_local ThreadCache cache;
+			return cache;
+		}
+
+		// Gets up to num blocks (but at least one) from the shared free list
+		[[nodiscard]] std::size_t Acquire(const std::size_t size_class, void** blocks, const std::size_t num)
+		{
+			auto count = m_SizeClasses[size_class].WithUniqueLock([&](SizeClassData& scd)
+			{
+				return TakeBlocks(scd, blocks, num);
+			});
+
+			if (count == 0)
+			{
+				// Allocating and locking a new region involves system calls that
+				// can take a while, so that happens without holding the lock; the
+				// blocks of the region get added to the free list afterwards
+				const auto region = AllocateRegion(size_class);
+
+				m_SizeClasses[size_class].WithUniqueLock([&](SizeClassData& scd)
+				{
+					region.Last->Next = scd.FreeList;
+					scd.FreeList = region.First;
+					scd.NumFreeBlocks += region.NumBlocks;
+					++scd.NumRegions;
+
+					count = TakeBlocks(scd, blocks, num);
+				});
+			}
+
+			return count;
+		}
+
+		[[nodiscard]] static std::size_t TakeBlocks(SizeClassData& scd, void** blocks, const std::size_t num) noexcept
+		{
+			std::size_t count{ 0 };
+
+			while (count < num && scd.FreeList != nullptr)
+			{
+				blocks[count++] = scd.FreeList;
+				scd.FreeList = scd.FreeList->Next;
+			}
+
+			scd.NumFreeBlocks -= count;
+
+			return count;
+		}
+
+		void Release(const std::size_t size_class, void* const* blocks, const std::size_t num) noexcept
+		{
+			if (num == 0) return;
+
+			// Link the blocks together first so that the lock is held only briefly
+			for (std::size_t x = 0; x < num - 1; ++x)
+			{
+				static_cast<FreeBlock*>(blocks[x])->Next = static_cast<FreeBlock*>(blocks[x + 1]);
+			}
+
+			m_SizeClasses[size_class].WithUniqueLock([&](SizeClassData& scd)
+			{
+				static_cast<FreeBlock*>(blocks[num - 1])->Next = scd.FreeList;
+				scd.FreeList = static_cast<FreeBlock*>(blocks[0]);
+				scd.NumFreeBlocks += num;
+			});
+		}
+
+		[[nodiscard]] Region AllocateRegion(const std::size_t size_class)
+		{
+			auto memaddr = static_cast<Byte*>(::VirtualAlloc(NULL, RegionSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE));
+			if (memaddr == NULL)
+			{
+				std::string error = "Could not allocate memory: GetLastError() returned " + std::to_string(::GetLastError());
+				throw BadAllocException(error.c_str());
+			}
+
+			// The first and last page are guard pages that can't be
+			// accessed; the usable memory in between gets locked
+			auto usable_addr = memaddr + m_PageSize;
+			const auto usable_len = RegionSize - (2 * m_PageSize);
+
+			DWORD old_protect{ 0 };
+
+			if (::VirtualProtect(memaddr, m_PageSize, PAGE_NOACCESS, &old_protect) == 0 ||
+				::VirtualProtect(usable_addr + usable_len, m_PageSize, PAGE_NOACCESS, &old_protect) == 0 ||
+				!LockMemory(usable_addr, usable_len))
+			{
+				const auto error_code = ::GetLastError();
+
+				::VirtualFree(memaddr, 0, MEM_RELEASE);
+
+				std::string error = "Memory allocation error; could not protect or lock memory: GetLastError() returned " + std::to_string(error_code);
+				throw BadAllocException(error.c_str());
+			}
+
+			const auto block_size = ProtectedFreeStoreAllocatorBase::GetSlabBlockSize(size_class);
+			const auto num_blocks = usable_len / block_size;
+
+			Region region;
+			region.NumBlocks = num_blocks;
+
+			// Link all blocks together in address order
+			for (auto x = num_blocks; x > 0; --x)
+			{
+				auto block = reinterpret_cast<FreeBlock*>(usable_addr + ((x - 1) * block_size));
+				block->Next = region.First;
+				region.First = block;
+
+				if (region.Last == nullptr) region.Last = block;
+			}
+
+			return region;
+		}
+
+	private:
+		std::size_t m_PageSize{ 4096 };
+		std::array<SizeClassData_ThS, NumSizeClasses> m_SizeClasses;
+	};
+
+	thread_local bool ProtectedSlabAllocator::ThreadCache::Destroyed{ false };
+
+	void ProtectedFreeStoreAllocatorBase::LogStatistics() noexcept
+	{
+		DbgInvoke([&]()
+		{
+			std::wstring output{ L"\r\n\r\nProtectedFreeStoreAllocator allocation sizes:\r\n-----------------------------------------------\r\n" };
+			output += GetProtectedFreeStoreAllocatorStats().WithSharedLock()->GetAllSizes();
+			output += L"\r\nProtectedFreeStoreAllocator memory in use:\r\n-----------------------------------------------\r\n";
+			output += GetProtectedFreeStoreAllocatorStats().WithSharedLock()->GetMemoryInUse();
+			output += L"\r\nProtectedFreeStoreAllocator slabs:\r\n-----------------------------------------------\r\n";
+			output += ProtectedSlabAllocator::Get().GetStatistics();
+			output += L"\r\n";
+
+			SLogInfo(output);
+		});
+	}
+
+	void* ProtectedFreeStoreAllocatorBase::Allocate(const std::size_t len)
+	{
+		void* memaddr{ nullptr };
+
+		if (len <= MaximumSlabAllocationSize)
+		{
+			memaddr = ProtectedSlabAllocator::Get().Allocate(len);
 		}
 		else
 		{
-			std::string error = "Could not allocate memory: GetLastError() returned " + std::to_string(::GetLastError());
-			throw BadAllocException(error.c_str());
+			memaddr = ::VirtualAlloc(NULL, len, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+			if (memaddr != NULL)
+			{
+				if (!LockMemory(memaddr, len))
+				{
+					const auto error_code = ::GetLastError();
+
+					::VirtualFree(memaddr, 0, MEM_RELEASE);
+
+					std::string error = "Memory allocation error; could not lock memory: GetLastError() returned " + std::to_string(error_code);
+					throw BadAllocException(error.c_str());
+				}
+			}
+			else
+			{
+				std::string error = "Could not allocate memory: GetLastError() returned " + std::to_string(::GetLastError());
+				throw BadAllocException(error.c_str());
+			}
 		}
 
 		DbgInvoke([&]()
@@ -164,9 +476,16 @@ namespace QuantumGate::Implementation::Memory
 		// Wipe all data from used memory
 		MemClear(p, len);
 
-		// Unlock and free
-		::VirtualUnlock(p, len);
-		::VirtualFree(p, 0, MEM_RELEASE);
+		if (len <= MaximumSlabAllocationSize)
+		{
+			ProtectedSlabAllocator::Get().Deallocate(p, len);
+		}
+		else
+		{
+			// Unlock and free
+			::VirtualUnlock(p, len);
+			::VirtualFree(p, 0, MEM_RELEASE);
+		}
 
 		DbgInvoke([&]()
 		{
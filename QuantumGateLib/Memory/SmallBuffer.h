@@ -0,0 +1,262 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#pragma once
+
+#include "Buffer.h"
+
+#include <array>
+
+namespace QuantumGate::Implementation::Memory
+{
+	// Buffer with inline storage for up to InlineSize bytes; only when the data
+	// grows larger does it spill to memory from the allocator. Meant for the many
+	// small buffers (headers, control messages, acks) that are only a few dozen
+	// bytes in size and would otherwise each need a memory allocation.
+	template<Size InlineSize, template<typename> typename A = FreeStoreAllocator>
+	class SmallBufferImpl
+	{
+		static_assert(InlineSize > 0, "Inline size should be greater than zero");
+
+	public:
+		using VectorType = std::vector<Byte, A<Byte>>;
+		using StorageType = std::array<Byte, InlineSize>;
+		using SizeType = Size;
+
+		SmallBufferImpl() noexcept {}
+
+		SmallBufferImpl(const SmallBufferImpl& other) { *this = other; }
+
+		SmallBufferImpl(const BufferView& other) { *this += other; }
+
+		SmallBufferImpl(SmallBufferImpl&& other) noexcept { *this = std::move(other); }
+
+		explicit SmallBufferImpl(const Size size) { Allocate(size); }
+
+		SmallBufferImpl(const Byte* data, const Size data_size) { Add(data, data_size); }
+
+		~SmallBufferImpl() = default;
+
+		inline explicit operator bool() const noexcept { return !IsEmpty(); }
+
+		inline Byte& operator[](const Size index)
+		{
+			assert(index < GetSize());
+
+			return GetBytes()[index];
+		}
+
+		inline const Byte& operator[](const Size index) const
+		{
+			assert(index < GetSize());
+
+			return GetBytes()[index];
+		}
+
+		inline SmallBufferImpl& operator=(const SmallBufferImpl& other)
+		{
+			// Check for same object
+			if (this == &other) return *this;
+
+			if (other.IsInline() && IsInline())
+			{
+				std::memcpy(m_Inline.data(), other.m_Inline.data(), other.m_Size);
+				m_Size = other.m_Size;
+			}
+			else
+			{
+				Clear();
+				Add(other.GetBytes(), other.GetSize());
+			}
+
+			return *this;
+		}
+
+		inline SmallBufferImpl& operator=(SmallBufferImpl&& other) noexcept
+		{
+			// Check for same object
+			if (this == &other) return *this;
+
+			if (other.IsInline())
+			{
+				VectorType().swap(m_Heap);
+				std::memcpy(m_Inline.data(), other.m_Inline.data(), other.m_Size);
+				m_Size = std::exchange(other.m_Size, 0);
+				m_OnHeap = false;
+			}
+			else
+			{
+				// Spilled data only gets moved
+				m_Heap = std::move(other.m_Heap);
+				m_Size = 0;
+				m_OnHeap = std::exchange(other.m_OnHeap, false);
+				other.m_Heap.clear();
+			}
+
+			return *this;
+		}
+
+		inline SmallBufferImpl& operator=(const BufferView& buffer)
+		{
+			Allocate(buffer.GetSize());
+			if (!buffer.IsEmpty()) std::memcpy(GetBytes(), buffer.GetBytes(), buffer.GetSize());
+
+			return *this;
+		}
+
+		inline bool operator==(const SmallBufferImpl& other) const noexcept
+		{
+			return (this->operator BufferView() == other.operator BufferView());
+		}
+
+		inline bool operator==(const BufferView& other) const noexcept
+		{
+			return (this->operator BufferView() == other);
+		}
+
+		inline bool operator!=(const SmallBufferImpl& other) const noexcept
+		{
+			return !(*this == other);
+		}
+
+		inline bool operator!=(const BufferView& other) const noexcept
+		{
+			return (this->operator BufferView() != other);
+		}
+
+		inline operator BufferView() const noexcept { return { GetBytes(), GetSize() }; }
+		inline operator BufferSpan() noexcept { return { GetBytes(), GetSize() }; }
+
+		inline SmallBufferImpl& operator+=(const SmallBufferImpl& other) { Add(other.GetBytes(), other.GetSize()); return *this; }
+		inline SmallBufferImpl& operator+=(const BufferView& buffer) { Add(buffer.GetBytes(), buffer.GetSize()); return *this; }
+
+		[[nodiscard]] inline Byte* GetBytes() noexcept { return m_OnHeap ? m_Heap.data() : m_Inline.data(); }
+		[[nodiscard]] inline const Byte* GetBytes() const noexcept { return m_OnHeap ? m_Heap.data() : m_Inline.data(); }
+
+		[[nodiscard]] inline Size GetSize() const noexcept { return m_OnHeap ? m_Heap.size() : m_Size; }
+		[[nodiscard]] static constexpr Size GetInlineSize() noexcept { return InlineSize; }
+
+		[[nodiscard]] inline bool IsEmpty() const noexcept { return (GetSize() == 0); }
+
+		// Returns true if the data is in the inline storage
+		// and no memory was allocated for it
+		[[nodiscard]] inline bool IsInline() const noexcept { return !m_OnHeap; }
+
+		inline void Allocate(const Size size) { Resize(size); }
+
+		inline void Preallocate(const Size size)
+		{
+			if (m_OnHeap) m_Heap.reserve(size);
+			else if (size > InlineSize) Spill(size);
+		}
+
+		inline void Clear() noexcept
+		{
+			m_Heap.clear();
+			m_Size = 0;
+		}
+
+		inline void RemoveFirst(const Size num) noexcept
+		{
+			assert(GetSize() >= num);
+
+			const auto size = GetSize();
+			const auto rnum = std::min(num, size);
+
+			if (m_OnHeap) m_Heap.erase(m_Heap.begin(), m_Heap.begin() + rnum);
+			else
+			{
+				std::memmove(m_Inline.data(), m_Inline.data() + rnum, size - rnum);
+				m_Size -= rnum;
+			}
+		}
+
+		inline void RemoveLast(const Size num) noexcept
+		{
+			assert(GetSize() >= num);
+
+			const auto rnum = std::min(num, GetSize());
+
+			if (m_OnHeap) m_Heap.resize(m_Heap.size() - rnum);
+			else m_Size -= rnum;
+		}
+
+		inline void Resize(const Size new_size)
+		{
+			if (m_OnHeap) m_Heap.resize(new_size, Byte{ 0 });
+			else if (new_size <= InlineSize)
+			{
+				if (new_size > m_Size) std::memset(m_Inline.data() + m_Size, 0, new_size - m_Size);
+
+				m_Size = new_size;
+			}
+			else
+			{
+				Spill(new_size);
+				m_Heap.resize(new_size, Byte{ 0 });
+			}
+		}
+
+		// Returns the data in a Buffer; spilled data only gets moved
+		// while inline data needs to get copied
+		[[nodiscard]] BufferImpl<A> MoveToBuffer()
+		{
+			if (m_OnHeap)
+			{
+				m_OnHeap = false;
+				return BufferImpl<A>(std::move(m_Heap));
+			}
+
+			BufferImpl<A> buffer(m_Inline.data(), m_Size);
+			m_Size = 0;
+
+			return buffer;
+		}
+
+	private:
+		inline void Spill(const Size capacity)
+		{
+			assert(!m_OnHeap);
+
+			m_Heap.reserve(capacity);
+			m_Heap.insert(m_Heap.end(), m_Inline.data(), m_Inline.data() + m_Size);
+			m_Size = 0;
+			m_OnHeap = true;
+		}
+
+		inline void Add(const Byte* data, const Size size)
+		{
+			if (data != nullptr && size > 0)
+			{
+				if (!m_OnHeap)
+				{
+					if (m_Size + size <= InlineSize)
+					{
+						std::memcpy(m_Inline.data() + m_Size, data, size);
+						m_Size += size;
+						return;
+					}
+
+					Spill(m_Size + size);
+				}
+
+				m_Heap.insert(m_Heap.end(), data, data + size);
+			}
+		}
+
+	private:
+		StorageType m_Inline;
+		Size m_Size{ 0 };
+		bool m_OnHeap{ false };
+		VectorType m_Heap;
+	};
+
+	template<Size InlineSize>
+	using SmallBuffer = SmallBufferImpl<InlineSize, DefaultAllocator>;
+
+	using SmallBuffer32 = SmallBuffer<32>;
+	using SmallBuffer64 = SmallBuffer<64>;
+	using SmallBuffer128 = SmallBuffer<128>;
+	using SmallBuffer256 = SmallBuffer<256>;
+	using SmallBuffer512 = SmallBuffer<512>;
+}
\ No newline at end of file
@@ -71,21 +71,24 @@ namespace QuantumGate::Implementation
 		bool RequireAuthentication{ true };									// Whether authentication is required for connecting peers
 
 		LocalAlgorithms SupportedAlgorithms;								// The supported algorithms
-		Size NumPreGeneratedKeysPerAlgorithm{ 5 };							// The number of pregenerated keys per supported algorithm
+		Size NumPreGeneratedKeysPerAlgorithm{ 5 };							// The (minimum) number of pregenerated keys per supported algorithm
+		Size MaxPreGeneratedKeysPerAlgorithm{ 20 };							// The maximum number of pregenerated keys per supported algorithm
 
 		struct
 		{
 			struct
 			{
 				Vector<UInt16> Ports{ 999 };								// Which ports to listen on
-				bool UseConditionalAcceptFunction{ true };					// Whether to use the conditional accept function before accepting connections
+				bool UseConditionalAcceptFunction{ true };					// Whether to use the conditional accept function before accepting connections (not used with more than one shard; access checks then get done on the shard threads)
 				bool NATTraversal{ false };									// Whether NAT traversal is enabled
+				Size NumShards{ 1 };											// Number of shards per listener port; each shard has its own thread and incoming connections get distributed among shards by IP address
 			} TCP;
 			
 			struct
 			{
 				Vector<UInt16> Ports{ 999 };								// Which ports to listen on
 				bool NATTraversal{ false };									// Whether NAT traversal is enabled
+				Size NumShards{ 1 };											// Number of shards per listener port; each shard has its own thread, send queue and connection cookie state and incoming data gets distributed among shards by IP address
 			} UDP;
 
 			struct
@@ -119,6 +122,24 @@ namespace QuantumGate::Implementation
 			Size RequireAfterNumProcessedBytes{ 4'200'000'000 };			// Number of bytes that may be encrypted and transfered using a single symmetric key after which to require a key update
 		} KeyUpdate;
 
+		struct
+		{
+			Size ExtenderCommunicationSend{ 1'048'576 };					// Maximum number of bytes of extender messages that may be queued for sending per peer
+			Size ExtenderCommunicationReceive{ 1'048'576 };					// Maximum number of bytes of received extender messages that may be in process per peer
+			Size RelayDataSend{ 1'048'576 };								// Maximum number of bytes of relay data that may be queued for sending per peer
+			Size RelayDataReceive{ 1'048'576 };								// Maximum number of bytes of received relay data that may be in process per peer
+			Size NoiseSend{ 1'048'576 };									// Maximum number of bytes of noise messages that may be queued for sending per peer
+			UInt8 SendBufferAvailableThreshold{ 50 };						// Percentage of the extender communication send buffer that should be free again before extenders that found it full get notified
+
+			struct
+			{
+				bool Enabled{ false };										// Whether the extender communication and relay data send buffers get sized automatically based on the measured send rate
+				std::chrono::milliseconds TargetDelay{ 250 };				// Amount of time worth of data at the measured send rate that the send buffers should be able to hold
+				std::chrono::milliseconds Interval{ 1000 };					// Period of time over which the send rate is measured
+				Size MaxSize{ 67'108'864 };									// Maximum number of bytes that the automatically sized send buffers may grow to
+			} AutoTune;
+		} PeerBuffers;
+
 		struct
 		{
 			struct
@@ -146,13 +167,40 @@ namespace QuantumGate::Implementation
 				Size ThreadsPerPool{ 4 };									// Number of worker threads per pool
 			} PeerManager;
 
+			struct
+			{
+				Size MinThreads{ 1 };										// Minumum number of worker threads
+				Size MaxThreads{ 4 };										// Maximum number of worker threads
+				Size MaxInboundHandshakes{ 256 };							// Maximum number of incoming connections that may be in the process of completing a handshake at the same time; more incoming connections get rejected
+			} HandshakeManager;
+
 			struct
 			{
 				Size MinThreadPools{ 1 };									// Minimum number of thread pools
 				Size MaxThreadPools{ 4 };									// Maximum number of thread pools
-				Size ThreadsPerPool{ 4 };									// Number of worker threads per pool
+				Size MinThreadsPerPool{ 1 };								// Number of worker threads per pool that are always running
+				Size MaxThreadsPerPool{ 4 };								// Maximum number of worker threads per pool; the ones above the minimum get started when there's more work and retired when they're idle
 			} Extender;
 
+			struct
+			{
+				std::chrono::milliseconds MaxQueueLatency{ 20 };			// Elastic thread pools start another worker thread when work waits longer than this in the queue on average
+				std::chrono::milliseconds GrowInterval{ 100 };				// Minimum amount of time between starting worker threads in an elastic thread pool
+				std::chrono::seconds IdleRetireDuration{ 60 };				// Extra worker threads in elastic thread pools that were (nearly) idle for this amount of time get retired
+			} ElasticThreadPools;
+
+			struct
+			{
+				bool Enabled{ false };										// Whether the worker threads of each thread pool get pinned to the processors of a NUMA node; peers then only get moved between peer thread pools on the same node
+				bool SeparateIOAndCrypto{ true };							// Whether thread pools doing I/O and thread pools doing cryptographic work (key generation and handshakes) get pinned to separate processors
+			} Affinity;
+
+			struct
+			{
+				bool Enabled{ false };										// Whether the peer, relay and UDP worker threads spin (poll) for a while before going to sleep when there's no work; lowers latency at the cost of CPU time
+				std::chrono::microseconds SpinBudget{ 50 };					// Amount of time worker threads spin looking for work before going to sleep
+			} BusyPoll;
+
 			Size WorkerThreadsMaxBurst{ 64 };								// Maximum number of work items to process in a single burst
 		} Concurrency;
 	};
@@ -112,7 +112,7 @@ namespace QuantumGate::Implementation
 	struct ProtocolVersion final
 	{
 		static constexpr const UInt8 Major{ 0 };
-		static constexpr const UInt8 Minor{ 1 };
+		static constexpr const UInt8 Minor{ 2 };
 	};
 
 	enum class PeerConnectionType : UInt16
@@ -167,10 +167,28 @@ namespace QuantumGate
 		bool RequireAuthentication{ true };						// Whether authentication is required for connecting peers
 
 		Algorithms SupportedAlgorithms;							// The supported algorithms
-		Size NumPreGeneratedKeysPerAlgorithm{ 5 };				// The number of pregenerated keys per supported algorithm
+		Size NumPreGeneratedKeysPerAlgorithm{ 5 };				// The (minimum) number of pregenerated keys per supported algorithm
+		std::optional<Size> MaxPreGeneratedKeysPerAlgorithm;	// The maximum number of pregenerated keys per supported algorithm; between the initial number and this number the amount adapts to the demand for keys (defaults to 20, or the initial number if that's larger)
 
 		bool EnableExtenders{ false };							// Enable extenders on startup?
 
+		struct
+		{
+			Size ExtenderCommunicationSend{ 1'048'576 };		// Maximum number of bytes of extender messages that may be queued for sending per peer
+			Size ExtenderCommunicationReceive{ 1'048'576 };		// Maximum number of bytes of received extender messages that may be in process per peer
+			Size RelayDataSend{ 1'048'576 };					// Maximum number of bytes of relay data that may be queued for sending per peer
+			Size RelayDataReceive{ 1'048'576 };					// Maximum number of bytes of received relay data that may be in process per peer
+			Size NoiseSend{ 1'048'576 };						// Maximum number of bytes of noise messages that may be queued for sending per peer
+			UInt8 SendBufferAvailableThreshold{ 50 };			// Percentage of the extender communication send buffer that should be free again before extenders that found it full get notified
+
+			struct
+			{
+				bool Enable{ false };							// Whether the extender communication and relay data send buffers get sized automatically based on the measured send rate
+				std::chrono::milliseconds TargetDelay{ 250 };	// Amount of time worth of data at the measured send rate that the send buffers should be able to hold
+				Size MaxSize{ 67'108'864 };						// Maximum number of bytes that the automatically sized send buffers may grow to
+			} AutoTune;
+		} PeerBuffers;
+
 		struct
 		{
 			struct
@@ -178,7 +196,8 @@ namespace QuantumGate
 				bool Enable{ false };							// Enable listening for incoming connections on startup?
 				Set<UInt16> Ports{ 999 };						// Which TCP ports to listen on
 				bool NATTraversal{ false };						// Whether NAT traversal is enabled
-				bool UseConditionalAcceptFunction{ true };		// Whether to use the conditional accept function before accepting connections
+				bool UseConditionalAcceptFunction{ true };		// Whether to use the conditional accept function before accepting connections (not used with more than one shard; access checks then get done on the shard threads)
+				Size NumShards{ 1 };							// Number of shards (each with its own thread) per port among which incoming connections get distributed
 			} TCP;
 
 			struct
@@ -186,6 +205,7 @@ namespace QuantumGate
 				bool Enable{ false };							// Enable listening for incoming connections on startup?
 				Set<UInt16> Ports{ 999 };						// Which UDP ports to listen on
 				bool NATTraversal{ false };						// Whether NAT traversal is enabled
+				Size NumShards{ 1 };							// Number of shards (each with its own thread) per port among which incoming connections get distributed
 			} UDP;
 
 			struct
@@ -204,6 +224,12 @@ namespace QuantumGate
 			UInt8 IPv4ExcludedNetworksCIDRLeadingBits{ 16 };	// The CIDR leading bits of the IPv4 network address spaces of the source and destination endpoints to exclude from the relay link
 			UInt8 IPv6ExcludedNetworksCIDRLeadingBits{ 48 };	// The CIDR leading bits of the IPv6 network address spaces of the source and destination endpoints to exclude from the relay link
 		} Relays;
+
+		struct
+		{
+			bool Enable{ false };								// Whether worker threads spin (poll) for work for a while before going to sleep; lowers latency for request/response traffic at the cost of CPU time
+			std::chrono::microseconds SpinBudget{ 50 };			// Amount of time worker threads spin looking for work before going to sleep
+		} BusyPoll;
 	};
 
 	enum class SecurityLevel : UInt16
@@ -283,6 +309,26 @@ namespace QuantumGate
 		} Noise;
 	};
 
+	struct KeyGenerationStatistics
+	{
+		Algorithm::Asymmetric Algorithm{ Algorithm::Asymmetric::Unknown };
+		Size NumPreGeneratedKeys{ 0 };						// Number of keys currently pregenerated for the algorithm
+		Size TargetNumPreGeneratedKeys{ 0 };				// Number of keys to keep pregenerated; adapts to demand
+		UInt64 NumHits{ 0 };								// Number of requests for which a pregenerated key was available
+		UInt64 NumMisses{ 0 };								// Number of requests for which no pregenerated key was available
+		double RequestRate{ 0.0 };							// Moving average of keys requested per second
+		std::chrono::microseconds GenerationTime{ 0 };		// Moving average of the time it takes to generate a key
+	};
+
+	struct ExtenderThreadPoolStatistics
+	{
+		ExtenderUUID ExtenderUUID;
+		Size NumThreads{ 0 };								// Number of worker threads of the threadpool
+		Size NumRunningThreads{ 0 };						// Number of worker threads currently running; fewer for idle elastic threadpools
+		Size NumPeers{ 0 };									// Number of peers whose events the threadpool processes
+		std::chrono::microseconds QueueLatency{ 0 };		// Moving average of the time peers wait in the queue to get processed
+		double Utilization{ 0.0 };							// Share of the time the running worker threads were busy
+	};
 }
 
 namespace QuantumGate::API
@@ -119,6 +119,9 @@ namespace QuantumGate::AVExtender
 
 	void Extender::OnPeerEvent(PeerEvent&& event)
 	{
+		// Not used by this extender; avoid flooding the UI with these
+		if (event.GetType() == PeerEvent::Type::SendBufferAvailable) return;
+
 		String ev(L"Unknown");
 
 		if (event.GetType() == PeerEvent::Type::Connected)
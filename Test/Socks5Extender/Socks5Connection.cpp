@@ -1231,6 +1231,7 @@ namespace QuantumGate::Socks5Extender
 		assert(IsReady());
 
 		auto success = true;
+		auto buffer_full = false;
 
 		if (!m_ReceiveBuffer.IsEmpty())
 		{
@@ -1257,8 +1258,10 @@ namespace QuantumGate::Socks5Extender
 				}
 				else if (result == ResultCode::PeerSendBufferFull)
 				{
-					// Peer send buffer is currently full;
-					// we'll come back later to send the rest
+					// Peer send buffer is currently full; we'll come back
+					// to send the rest when we get notified that there's
+					// room available again
+					buffer_full = true;
 				}
 				else
 				{
@@ -1271,7 +1274,7 @@ namespace QuantumGate::Socks5Extender
 			else success = false;
 		}
 
-		if (success && !m_ReceiveBuffer.IsEmpty()) m_Extender.SetConnectionReceiveEvent();
+		if (success && !buffer_full && !m_ReceiveBuffer.IsEmpty()) m_Extender.SetConnectionReceiveEvent();
 
 		return success;
 	}
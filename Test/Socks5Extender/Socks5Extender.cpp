@@ -217,7 +217,13 @@ namespace QuantumGate::Socks5Extender
 		m_AllConnectionFDs.WithUniqueLock()->clear();
 		m_AllConnectionsSendEvent.Reset();
 		m_AllConnectionsReceiveEvent.Reset();
-		m_DNSCache.WithUniqueLock()->clear();
+		m_DNSLookupQueue.Clear();
+		m_DNSResultQueue.Clear();
+		m_DNSResolver.WithUniqueLock([](DNSResolver& resolver) noexcept
+		{
+			resolver.Cache.clear();
+			resolver.Pending.clear();
+		});
 
 		DeInitializeIPFilters();
 	}
@@ -335,12 +341,24 @@ namespace QuantumGate::Socks5Extender
 
 	bool Extender::StartupThreadPool()
 	{
-		if (m_ThreadPool.AddThread(GetName() + L" Main Worker Thread",
-								   MakeCallback(this, &Extender::MainWorkerThreadLoop),
-								   MakeCallback(this, &Extender::MainWorkerThreadWait)) &&
-			m_ThreadPool.AddThread(GetName() + L" DataRelay Worker Thread",
-								   MakeCallback(this, &Extender::DataRelayWorkerThreadLoop),
-								   MakeCallback(this, &Extender::DataRelayWorkerThreadWait)))
+		auto error = !(m_ThreadPool.AddThread(GetName() + L" Main Worker Thread",
+											  MakeCallback(this, &Extender::MainWorkerThreadLoop),
+											  MakeCallback(this, &Extender::MainWorkerThreadWait)) &&
+					   m_ThreadPool.AddThread(GetName() + L" DataRelay Worker Thread",
+											  MakeCallback(this, &Extender::DataRelayWorkerThreadLoop),
+											  MakeCallback(this, &Extender::DataRelayWorkerThreadWait)));
+
+		// Domains get resolved on separate threads so that
+		// slow lookups don't hold up the other connections
+		for (Size x = 0; x < DNSResolver::NumThreads && !error; ++x)
+		{
+			error = !m_ThreadPool.AddThread(GetName() + L" DNS Resolver Thread",
+											MakeCallback(this, &Extender::DNSResolverThreadLoop),
+											MakeCallback(this, &Extender::DNSResolverThreadWait),
+											MakeCallback(this, &Extender::DNSResolverThreadWaitInterrupt));
+		}
+
+		if (!error)
 		{
 			if (m_ThreadPool.Startup())
 			{
@@ -402,6 +420,14 @@ namespace QuantumGate::Socks5Extender
 
 				break;
 			}
+			case PeerEvent::Type::SendBufferAvailable:
+			{
+				// Connections waiting to relay data to the peer can continue
+				SetConnectionReceiveEvent();
+
+				// Not logged because it can occur very often
+				return;
+			}
 			default:
 			{
 				assert(false);
@@ -566,6 +592,16 @@ namespace QuantumGate::Socks5Extender
 
 								result.Success = true;
 							}
+							else if (CancelDNSRequests(event.GetPeerLUID(), cid) > 0)
+							{
+								// The connection was still waiting for its domain to get resolved
+								LogDbg(L"%s: received Disconnect from peer %llu for connection %llu waiting for domain lookup",
+									   GetName().c_str(), event.GetPeerLUID(), cid);
+
+								DiscardReturnValue(SendDisconnectAck(event.GetPeerLUID(), cid));
+
+								result.Success = true;
+							}
 							else
 							{
 								LogErr(L"%s: received Disconnect from peer %llu for unknown connection %llu",
@@ -633,32 +669,8 @@ namespace QuantumGate::Socks5Extender
 			LogDbg(L"%s: received ConnectDomain from peer %llu for connection %llu for domain %s",
 				   GetName().c_str(), pluid, cid, domain.c_str());
 
-			const auto ip = ResolveDomainIP(domain);
-			if (ip)
-			{
-				SLogInfo(GetName() << L": domain " << SLogFmt(FGBrightMagenta) << domain.c_str() <<
-						 SLogFmt(Default) << L" resolved to IP " << SLogFmt(FGBrightMagenta) <<
-						 ip->GetString() << SLogFmt(Default) << L" for connection " << cid);
-
-				DiscardReturnValue(MakeOutgoingConnection(pluid, cid, socks_version, *ip, port));
-			}
-			else
-			{
-				LogErr(L"%s: could not resolve IP addresses for domain %s", GetName().c_str(), domain.c_str());
-
-				// Could not resolve domain
-				switch (socks_version)
-				{
-					case SocksProtocolVersion::Socks4:
-						DiscardReturnValue(SendSocks4Reply(pluid, cid, Socks4Protocol::Replies::FailedOrRejected));
-					case SocksProtocolVersion::Socks5:
-						DiscardReturnValue(SendSocks5Reply(pluid, cid, Socks5Protocol::Replies::HostUnreachable));
-						break;
-					default:
-						assert(false);
-						break;
-				}
-			}
+			ResolveDomainIP(domain, DNSRequest{ .PeerID = pluid, .ConnectionID = cid,
+												.SocksVersion = socks_version, .Port = port });
 
 			return true;
 		}
@@ -832,6 +844,10 @@ namespace QuantumGate::Socks5Extender
 
 	void Extender::RemovePeer(const PeerLUID pluid) noexcept
 	{
+		// Connections that are still waiting for a domain to
+		// get resolved shouldn't get made anymore
+		DiscardReturnValue(CancelDNSRequests(pluid));
+
 		DisconnectFor(pluid);
 
 		const auto num = m_Peers.WithUniqueLock()->erase(pluid);
@@ -1136,6 +1152,9 @@ namespace QuantumGate::Socks5Extender
 	{
 		m_AllConnectionsSendEvent.Reset();
 
+		// Resume connections that were waiting for a domain to get resolved
+		ProcessDNSResults();
+
 		std::vector<Connection::Key> rlist;
 
 		m_AllConnections.WithSharedLock([&](const Connections& connections)
@@ -1507,46 +1526,191 @@ namespace QuantumGate::Socks5Extender
 		return false;
 	}
 
-	std::optional<IPAddress> Extender::ResolveDomainIP(const String& domain) noexcept
+	void Extender::DNSResolverThreadWait(const Concurrency::Event& shutdown_event)
 	{
+		m_DNSLookupQueue.Wait(shutdown_event);
+	}
+
+	void Extender::DNSResolverThreadWaitInterrupt()
+	{
+		m_DNSLookupQueue.InterruptWait();
+	}
+
+	void Extender::DNSResolverThreadLoop(const Concurrency::Event& shutdown_event)
+	{
+		std::optional<String> domain;
+
+		m_DNSLookupQueue.PopFrontIf([&](auto& fdomain) noexcept -> bool
+		{
+			domain = std::move(fdomain);
+			return true;
+		});
+
+		if (!domain.has_value()) return;
+
+		// The lookup may take a while and is done without holding any locks
+		const auto ip = LookupDomainIP(*domain);
+
+		try
 		{
-			auto cache = m_DNSCache.WithSharedLock();
-			if (const auto it = cache->find(domain); it != cache->end())
+			m_DNSResolver.WithUniqueLock()->AddToCache(*domain, ip, Util::GetCurrentSteadyTime());
+
+			// The requests that are waiting for this domain get picked up by the main worker thread
+			m_DNSResultQueue.Push(DNSResult{ .Domain = *domain, .IP = ip });
+
+			// Wakes up the main worker thread
+			m_AllConnectionsSendEvent.Set();
+		}
+		catch (...)
+		{
+			LogErr(L"%s: an exception was thrown while processing the lookup result for domain %s",
+				   GetName().c_str(), domain->c_str());
+		}
+	}
+
+	void Extender::ResolveDomainIP(const String& domain, const DNSRequest& request)
+	{
+		std::optional<DNSCacheEntry> cached;
+
+		m_DNSResolver.WithUniqueLock([&](DNSResolver& resolver)
+		{
+			if (const auto it = resolver.Cache.find(domain); it != resolver.Cache.end())
+			{
+				if (it->second.Expiration > Util::GetCurrentSteadyTime())
+				{
+					cached = it->second;
+					return;
+				}
+				else resolver.Cache.erase(it);
+			}
+
+			// If the domain is already being looked up the request
+			// only needs to wait for that lookup to complete
+			auto [it, inserted] = resolver.Pending.try_emplace(domain);
+			it->second.emplace_back(request);
+
+			if (inserted)
 			{
-				return it->second;
+				m_DNSLookupQueue.Push(domain);
 			}
+			else
+			{
+				LogDbg(L"%s: connection %llu is waiting for domain %s already being resolved",
+					   GetName().c_str(), request.ConnectionID, domain.c_str());
+			}
+		});
+
+		if (cached.has_value())
+		{
+			CompleteDNSRequest(domain, cached->IP, request);
 		}
+	}
+
+	std::optional<IPAddress> Extender::LookupDomainIP(const String& domain) const noexcept
+	{
+		ADDRINFOW* result{ nullptr };
 
-		auto cache = m_DNSCache.WithUniqueLock();
-		if (const auto it = cache->find(domain); it != cache->end())
+		const auto ret = GetAddrInfoW(domain.c_str(), L"", nullptr, &result);
+		if (ret == 0)
 		{
-			return it->second;
+			// Free ADDRINFO resources when we leave
+			const auto sg = MakeScopeGuard([&]() noexcept { FreeAddrInfoW(result); });
+
+			for (auto ptr = result; ptr != nullptr; ptr = ptr->ai_next)
+			{
+				if (ptr->ai_family == AF_INET || ptr->ai_family == AF_INET6)
+				{
+					return IPAddress(ptr->ai_addr);
+				}
+			}
 		}
-		else
+
+		return std::nullopt;
+	}
+
+	void Extender::ProcessDNSResults() noexcept
+	{
+		while (!m_DNSResultQueue.IsEmpty())
 		{
-			ADDRINFOW* result{ nullptr };
+			std::optional<DNSResult> result;
 
-			const auto ret = GetAddrInfoW(domain.c_str(), L"", nullptr, &result);
-			if (ret == 0)
+			m_DNSResultQueue.PopFrontIf([&](auto& fresult) noexcept -> bool
 			{
-				// Free ADDRINFO resources when we leave
-				const auto sg = MakeScopeGuard([&]() noexcept { FreeAddrInfoW(result); });
+				result = std::move(fresult);
+				return true;
+			});
 
-				for (auto ptr = result; ptr != nullptr; ptr = ptr->ai_next)
-				{
-					if (ptr->ai_family == AF_INET || ptr->ai_family == AF_INET6)
-					{
-						const auto ip = IPAddress(ptr->ai_addr);
+			if (!result.has_value()) break;
 
-						cache->insert({ domain, ip });
+			// Pick up the requests that are still waiting for this domain;
+			// requests that were cancelled in the mean time are gone
+			DNSRequests requests;
 
-						return ip;
-					}
+			m_DNSResolver.WithUniqueLock([&](DNSResolver& resolver) noexcept
+			{
+				if (const auto it = resolver.Pending.find(result->Domain); it != resolver.Pending.end())
+				{
+					requests = std::move(it->second);
+					resolver.Pending.erase(it);
+				}
+			});
+
+			for (const auto& request : requests)
+			{
+				try
+				{
+					CompleteDNSRequest(result->Domain, result->IP, request);
+				}
+				catch (...)
+				{
+					LogErr(L"%s: an exception was thrown while resuming connection %llu",
+						   GetName().c_str(), request.ConnectionID);
 				}
 			}
 		}
+	}
 
-		return std::nullopt;
+	Size Extender::CancelDNSRequests(const PeerLUID pluid, const std::optional<Connection::ID> cid) noexcept
+	{
+		const auto num = m_DNSResolver.WithUniqueLock()->CancelRequests(pluid, cid);
+		if (num > 0)
+		{
+			LogDbg(L"%s: cancelled %zu pending domain lookup(s) for peer %llu", GetName().c_str(), num, pluid);
+		}
+
+		return num;
+	}
+
+	void Extender::CompleteDNSRequest(const String& domain, const std::optional<IPAddress>& ip, const DNSRequest& request)
+	{
+		if (ip)
+		{
+			SLogInfo(GetName() << L": domain " << SLogFmt(FGBrightMagenta) << domain.c_str() <<
+					 SLogFmt(Default) << L" resolved to IP " << SLogFmt(FGBrightMagenta) <<
+					 ip->GetString() << SLogFmt(Default) << L" for connection " << request.ConnectionID);
+
+			DiscardReturnValue(MakeOutgoingConnection(request.PeerID, request.ConnectionID,
+													  request.SocksVersion, *ip, request.Port));
+		}
+		else
+		{
+			LogErr(L"%s: could not resolve IP addresses for domain %s", GetName().c_str(), domain.c_str());
+
+			// Could not resolve domain
+			switch (request.SocksVersion)
+			{
+				case SocksProtocolVersion::Socks4:
+					DiscardReturnValue(SendSocks4Reply(request.PeerID, request.ConnectionID,
+													   Socks4Protocol::Replies::FailedOrRejected));
+				case SocksProtocolVersion::Socks5:
+					DiscardReturnValue(SendSocks5Reply(request.PeerID, request.ConnectionID,
+													   Socks5Protocol::Replies::HostUnreachable));
+					break;
+				default:
+					assert(false);
+					break;
+			}
+		}
 	}
 
 	Socks4Protocol::Replies Extender::TranslateWSAErrorToSocks4(Int errorcode) const noexcept
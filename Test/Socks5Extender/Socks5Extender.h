@@ -7,6 +7,7 @@
 
 #include "QuantumGate.h"
 #include "Concurrency\Event.h"
+#include "Concurrency\Queue.h"
 #include "Concurrency\ThreadSafe.h"
 #include "Concurrency\ThreadPool.h"
 #include "Core\Access\IPFilters.h"
@@ -43,8 +44,92 @@ namespace QuantumGate::Socks5Extender
 
 	using PollFD_ThS = Concurrency::ThreadSafe<std::vector<WSAPOLLFD>, std::shared_mutex>;
 
-	using DNSCache = std::unordered_map<String, IPAddress>;
-	using DNSCache_ThS = Concurrency::ThreadSafe<DNSCache, std::shared_mutex>;
+	struct DNSCacheEntry final
+	{
+		std::optional<IPAddress> IP; // No value if the domain could not be resolved
+		SteadyTime Added;
+		SteadyTime Expiration;
+	};
+
+	using DNSCache = std::unordered_map<String, DNSCacheEntry>;
+
+	struct DNSRequest final
+	{
+		PeerLUID PeerID{ 0 };
+		Connection::ID ConnectionID{ 0 };
+		SocksProtocolVersion SocksVersion{ SocksProtocolVersion::Unknown };
+		UInt16 Port{ 0 };
+	};
+
+	using DNSRequests = std::vector<DNSRequest>;
+
+	struct DNSResult final
+	{
+		String Domain;
+		std::optional<IPAddress> IP;
+	};
+
+	struct DNSResolver final
+	{
+		// Domains that got resolved are cached for a while, and domains that could not
+		// be resolved for a shorter while so that they don't get looked up over and over
+		static constexpr std::chrono::seconds PositiveCacheTTL{ 300 };
+		static constexpr std::chrono::seconds NegativeCacheTTL{ 30 };
+		static constexpr Size MaxCacheSize{ 1024 };
+		static constexpr Size NumThreads{ 2 };
+
+		DNSCache Cache;
+
+		// Requests waiting for a domain to get resolved; each domain gets
+		// looked up only once no matter how many requests are waiting for it.
+		// Requests stay here until the result gets processed so that they
+		// can still be cancelled when the connection or peer goes away.
+		std::unordered_map<String, DNSRequests> Pending;
+
+		void AddToCache(const String& domain, const std::optional<IPAddress>& ip, const SteadyTime now)
+		{
+			if (Cache.size() >= MaxCacheSize)
+			{
+				std::erase_if(Cache, [&](const auto& it) noexcept { return (it.second.Expiration <= now); });
+
+				// If nothing expired make room by removing the oldest entry
+				if (Cache.size() >= MaxCacheSize)
+				{
+					Cache.erase(std::min_element(Cache.begin(), Cache.end(), [](const auto& a, const auto& b) noexcept
+					{
+						return (a.second.Added < b.second.Added);
+					}));
+				}
+			}
+
+			Cache[domain] = DNSCacheEntry{
+				.IP = ip,
+				.Added = now,
+				.Expiration = now + (ip.has_value() ? PositiveCacheTTL : NegativeCacheTTL)
+			};
+		}
+
+		[[nodiscard]] Size CancelRequests(const PeerLUID pluid, const std::optional<Connection::ID> cid) noexcept
+		{
+			Size num{ 0 };
+
+			// Entries with no requests left stay until the lookup
+			// completes so that the domain doesn't get looked up again
+			for (auto& it : Pending)
+			{
+				num += std::erase_if(it.second, [&](const DNSRequest& request) noexcept
+				{
+					return (request.PeerID == pluid && (!cid.has_value() || request.ConnectionID == *cid));
+				});
+			}
+
+			return num;
+		}
+	};
+
+	using DNSResolver_ThS = Concurrency::ThreadSafe<DNSResolver, std::shared_mutex>;
+	using DNSLookupQueue_ThS = Concurrency::Queue<String>;
+	using DNSResultQueue_ThS = Concurrency::Queue<DNSResult>;
 
 	struct Peer final
 	{
@@ -128,8 +213,15 @@ namespace QuantumGate::Socks5Extender
 		void MainWorkerThreadLoop(const Concurrency::Event& shutdown_event);
 		void DataRelayWorkerThreadWait(const Concurrency::Event& shutdown_event);
 		void DataRelayWorkerThreadLoop(const Concurrency::Event& shutdown_event);
+		void DNSResolverThreadWait(const Concurrency::Event& shutdown_event);
+		void DNSResolverThreadWaitInterrupt();
+		void DNSResolverThreadLoop(const Concurrency::Event& shutdown_event);
 
-		[[nodiscard]] std::optional<IPAddress> ResolveDomainIP(const String& domain) noexcept;
+		void ResolveDomainIP(const String& domain, const DNSRequest& request);
+		[[nodiscard]] std::optional<IPAddress> LookupDomainIP(const String& domain) const noexcept;
+		void ProcessDNSResults() noexcept;
+		void CompleteDNSRequest(const String& domain, const std::optional<IPAddress>& ip, const DNSRequest& request);
+		[[nodiscard]] Size CancelDNSRequests(const PeerLUID pluid, const std::optional<Connection::ID> cid = std::nullopt) noexcept;
 
 		[[nodiscard]] Socks4Protocol::Replies TranslateWSAErrorToSocks4(Int errorcode) const noexcept;
 		[[nodiscard]] Socks5Protocol::Replies TranslateWSAErrorToSocks5(Int errorcode) const noexcept;
@@ -231,7 +323,9 @@ namespace QuantumGate::Socks5Extender
 		PollFD_ThS m_AllConnectionFDs;
 		Concurrency::Event m_AllConnectionsSendEvent;
 		Concurrency::Event m_AllConnectionsReceiveEvent;
-		DNSCache_ThS m_DNSCache;
+		DNSResolver_ThS m_DNSResolver;
+		DNSLookupQueue_ThS m_DNSLookupQueue;
+		DNSResultQueue_ThS m_DNSResultQueue;
 
 		std::atomic_bool m_UseCompression{ true };
 
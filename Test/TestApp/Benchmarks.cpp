@@ -6,16 +6,36 @@
 
 #include <thread>
 #include <chrono>
+#include <random>
 
 #include "Console.h"
 #include "Common\Util.h"
 #include "Common\Callback.h"
+#include "Common\ScopeGuard.h"
 #include "Settings.h"
 #include "Concurrency\ThreadLocalCache.h"
 #include "Concurrency\RecursiveSharedMutex.h"
 #include "Concurrency\SpinMutex.h"
 #include "Concurrency\SharedSpinMutex.h"
 #include "Compression\Compression.h"
+#include "Memory\SmallBuffer.h"
+#include "Core\Access\IPFilters.h"
+#include "Crypto\Crypto.h"
+#include "..\..\QuantumGateCryptoLib\QuantumGateCryptoLib.h"
+
+#if defined(_DEBUG)
+#if !defined(_WIN64)
+#pragma comment (lib, "QuantumGateCryptoLib32D.lib")
+#else
+#pragma comment (lib, "QuantumGateCryptoLib64D.lib")
+#endif
+#else
+#if !defined(_WIN64)
+#pragma comment (lib, "QuantumGateCryptoLib32.lib")
+#else
+#pragma comment (lib, "QuantumGateCryptoLib64.lib")
+#endif
+#endif
 
 using namespace QuantumGate::Implementation;
 using namespace QuantumGate::Implementation::Concurrency;
@@ -482,4 +502,348 @@ void Benchmarks::BenchmarkMemory()
 		len *= 2;
 		if (len > 3000000) break;
 	}
+}
+
+void Benchmarks::BenchmarkIPFilters()
+{
+	CWaitCursor wait;
+
+	constexpr auto num_filters = 100'000u;
+	constexpr auto maxtr = 1'000'000u;
+
+	LogSys(L"---");
+	LogSys(L"Starting IPFilters benchmark with %u filters for %u iterations", num_filters, maxtr);
+
+	using namespace QuantumGate::Implementation::Core::Access;
+
+	std::mt19937 rng(1234);
+
+	Vector<String> ip_cidrs;
+	ip_cidrs.reserve(num_filters);
+
+	for (auto x = 0u; x < num_filters; ++x)
+	{
+		const auto ip = rng();
+		ip_cidrs.emplace_back(std::to_wstring((ip >> 24) & 0xff) + L"." + std::to_wstring((ip >> 16) & 0xff) + L"." +
+							  std::to_wstring((ip >> 8) & 0xff) + L".0/" + std::to_wstring(16 + (ip % 9)));
+	}
+
+	IPFilters ipfilters;
+
+	DoBenchmark(std::wstring(L"IPFilters adding filters"), 1u, [&]()
+	{
+		if (ipfilters.AddFilters(ip_cidrs, IPFilterType::Blocked).Failed() ||
+			ipfilters.AddFilter(L"0.0.0.0/0", IPFilterType::Allowed).Failed())
+		{
+			AfxMessageBox(L"Adding filters failed!");
+			throw;
+		}
+	});
+
+	Vector<IPAddress> ips;
+	ips.reserve(1024);
+
+	for (auto x = 0u; x < 1024u; ++x)
+	{
+		ips.emplace_back(BinaryIPAddress(static_cast<UInt32>(rng())));
+	}
+
+	Size num{ 0 };
+	Size num_allowed{ 0 };
+
+	DoBenchmark(std::wstring(L"IPFilters lookups"), maxtr, [&]()
+	{
+		if (ipfilters.GetAllowed(ips[num++ % ips.size()]).GetValue()) ++num_allowed;
+	});
+
+	LogSys(L"Number of allowed lookups: %zu", num_allowed);
+}
+
+void Benchmarks::BenchmarkCryptoRandom()
+{
+	CWaitCursor wait;
+
+	constexpr auto maxtr = 1'000'000u;
+
+	LogSys(L"---");
+	LogSys(L"Starting crypto random benchmark for %u iterations", maxtr);
+
+	UInt64 value{ 0 };
+
+	DoBenchmark(std::wstring(L"Crypto random number"), maxtr, [&]()
+	{
+		const auto num = Crypto::GetCryptoRandomNumber();
+		if (!num)
+		{
+			AfxMessageBox(L"Getting crypto random number failed!");
+			throw;
+		}
+
+		value ^= *num;
+	});
+
+	DoBenchmark(std::wstring(L"Crypto random bytes (64 bytes)"), maxtr, [&]()
+	{
+		const auto bytes = Crypto::GetCryptoRandomBytes(64);
+		if (!bytes)
+		{
+			AfxMessageBox(L"Getting crypto random bytes failed!");
+			throw;
+		}
+	});
+
+	LogSys(L"Result: %llu", value & 1);
+}
+
+void Benchmarks::BenchmarkPostQuantum()
+{
+	CWaitCursor wait;
+
+	LogSys(L"---");
+	LogSys(L"Starting post-quantum key exchange benchmark");
+
+	// Restore default when done
+	const auto sg = MakeScopeGuard([&] { Crypto::SetUseOptimizedAlgorithms(true); });
+
+	const std::vector<std::pair<Algorithm::Asymmetric, unsigned int>> algs =
+	{
+		{ Algorithm::Asymmetric::KEM_NTRUPRIME, 20u },
+		{ Algorithm::Asymmetric::KEM_NEWHOPE, 1000u },
+		{ Algorithm::Asymmetric::KEM_CLASSIC_MCELIECE, 1u }
+	};
+
+	for (const auto& [alg, maxtr] : algs)
+	{
+		for (const auto optimized : { false, true })
+		{
+			Crypto::SetUseOptimizedAlgorithms(optimized);
+
+			const auto name = std::wstring(Crypto::GetAlgorithmName(alg)) + (optimized ? L" (optimized" : L" (reference") +
+				(Crypto::IsUsingAVX2() ? L", AVX2)" : L")");
+
+			LogSys(L"Benchmarking %s for %u iterations", name.c_str(), maxtr);
+
+			Crypto::AsymmetricKeyData alice(alg);
+			alice.SetOwner(Crypto::AsymmetricKeyOwner::Alice);
+
+			DoBenchmark(name + L" key generation", maxtr, [&]()
+			{
+				alice.ReleaseKeys();
+
+				if (!Crypto::GenerateAsymmetricKeys(alice))
+				{
+					AfxMessageBox(L"Key generation failed!");
+					throw;
+				}
+			});
+
+			Crypto::AsymmetricKeyData bob(alg);
+			bob.SetOwner(Crypto::AsymmetricKeyOwner::Bob);
+			bob.PeerPublicKey = alice.LocalPublicKey;
+
+			DoBenchmark(name + L" encapsulation", maxtr, [&]()
+			{
+				if (!Crypto::GenerateSharedSecret(bob))
+				{
+					AfxMessageBox(L"Encapsulation failed!");
+					throw;
+				}
+			});
+
+			alice.EncryptedSharedSecret = bob.EncryptedSharedSecret;
+
+			DoBenchmark(name + L" decapsulation", maxtr, [&]()
+			{
+				if (!Crypto::GenerateSharedSecret(alice))
+				{
+					AfxMessageBox(L"Decapsulation failed!");
+					throw;
+				}
+			});
+
+			if (alice.SharedSecret != bob.SharedSecret)
+			{
+				AfxMessageBox(L"Shared secrets don't match!");
+			}
+		}
+	}
+}
+
+void Benchmarks::BenchmarkSipHash()
+{
+	CWaitCursor wait;
+	constexpr auto maxtr = 10000u;
+	constexpr auto num_datagrams = 64u;
+	constexpr auto datagram_size = 1200u;
+
+	LogSys(L"---");
+	LogSys(L"Starting SipHash benchmark for %u iterations of %u datagrams of %u bytes",
+		   maxtr, num_datagrams, datagram_size);
+
+	std::vector<UInt8> data(num_datagrams * datagram_size, 0x5A);
+	std::array<UInt8, 8> key{ 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	std::vector<const uint8_t*> in(num_datagrams);
+	std::vector<size_t> inlen(num_datagrams, datagram_size);
+	std::vector<const uint8_t*> k(num_datagrams, key.data());
+	std::vector<UInt32> hmacs(num_datagrams);
+	std::vector<uint8_t*> out(num_datagrams);
+
+	for (auto x = 0u; x < num_datagrams; ++x)
+	{
+		in[x] = data.data() + (x * datagram_size);
+		out[x] = reinterpret_cast<uint8_t*>(&hmacs[x]);
+	}
+
+	DoBenchmark(std::wstring(L"HalfSipHash (reference)"), maxtr, [&]()
+	{
+		for (auto x = 0u; x < num_datagrams; ++x) halfsiphash(in[x], inlen[x], k[x], out[x], 4);
+	});
+
+	DoBenchmark(std::wstring(L"HalfSipHash (optimized)"), maxtr, [&]()
+	{
+		for (auto x = 0u; x < num_datagrams; ++x) halfsiphash_opt(in[x], inlen[x], k[x], out[x], 4);
+	});
+
+	DoBenchmark(std::wstring(QGCryptoUseAVX2() ? L"HalfSipHash (multi-buffer, AVX2)" : L"HalfSipHash (multi-buffer)"), maxtr, [&]()
+	{
+		halfsiphash_multi(in.data(), inlen.data(), k.data(), out.data(), 4, num_datagrams);
+	});
+}
+
+void Benchmarks::BenchmarkPseudoRandom()
+{
+	CWaitCursor wait;
+
+	constexpr auto maxtr = 100'000u;
+	constexpr auto size = 1'000u;
+
+	LogSys(L"---");
+	LogSys(L"Starting pseudo-random benchmark for %u iterations of %u bytes", maxtr, size);
+
+	Buffer buffer(size);
+	std::mt19937_64 mt{ std::random_device{}() };
+
+	DoBenchmark(std::wstring(L"std::mt19937_64 random bytes"), maxtr, [&]()
+	{
+		for (Size x = 0; x < size; x += sizeof(UInt64))
+		{
+			const auto num = mt();
+			std::memcpy(buffer.GetBytes() + x, &num, std::min(sizeof(UInt64), size - x));
+		}
+	});
+
+	DoBenchmark(std::wstring(L"Util::GetPseudoRandomNumber random bytes"), maxtr, [&]()
+	{
+		for (Size x = 0; x < size; x += sizeof(UInt64))
+		{
+			const auto num = Util::GetPseudoRandomNumber();
+			std::memcpy(buffer.GetBytes() + x, &num, std::min(sizeof(UInt64), size - x));
+		}
+	});
+
+	DoBenchmark(std::wstring(L"Util::GetPseudoRandomBytes (new buffer)"), maxtr, [&]()
+	{
+		[[maybe_unused]] const auto bytes = Util::GetPseudoRandomBytes(size);
+	});
+
+	DoBenchmark(std::wstring(L"Util::GetPseudoRandomBytes (in place)"), maxtr, [&]()
+	{
+		Util::GetPseudoRandomBytes(buffer.GetBytes(), size);
+	});
+}
+
+void Benchmarks::BenchmarkSymmetric()
+{
+	CWaitCursor wait;
+
+	constexpr auto maxtr = 200'000u;
+
+	LogSys(L"---");
+	LogSys(L"Starting symmetric encryption benchmark for %u iterations", maxtr);
+
+	String secret{ L"password" };
+	const auto secretv = BufferView(reinterpret_cast<Byte*>(secret.data()), secret.size());
+
+	for (const auto sa : { Algorithm::Symmetric::AES256_GCM, Algorithm::Symmetric::CHACHA20_POLY1305 })
+	{
+		for (const auto size : { 64u, 256u, 1024u })
+		{
+			for (const auto type : { Crypto::SymmetricKeyType::AutoGen, Crypto::SymmetricKeyType::Derived })
+			{
+				// Autogen keys get initialized from scratch for each message
+				// while derived keys use a pre-initialized cipher context
+				Crypto::SymmetricKeyData skd(type, Algorithm::Hash::SHA256, sa, Algorithm::Compression::DEFLATE);
+				Crypto::SymmetricKeyData skd2(type, Algorithm::Hash::SHA256, sa, Algorithm::Compression::DEFLATE);
+				if (!Crypto::GenerateSymmetricKeys(secretv, skd, skd2))
+				{
+					AfxMessageBox(L"Symmetric key generation failed!");
+					throw;
+				}
+
+				const auto input = Util::GetPseudoRandomBytes(size);
+				Buffer eoutbuf, doutbuf;
+				UInt32 x{ 0 };
+
+				const auto name = std::wstring(Crypto::GetAlgorithmName(sa)) + L" " + std::to_wstring(size) +
+					L" byte messages" + (type == Crypto::SymmetricKeyType::Derived ?
+										 L" (cipher context)" : L" (full initialization)");
+
+				DoBenchmark(name, maxtr, [&]()
+				{
+					const auto nonce = Crypto::GetSymmetricNonce(skd, x++);
+
+					if (!Crypto::Encrypt(input, eoutbuf, skd, nonce) ||
+						!Crypto::Decrypt(eoutbuf, doutbuf, skd, nonce))
+					{
+						AfxMessageBox(L"Symmetric encryption failed!");
+						throw;
+					}
+				});
+			}
+		}
+	}
+}
+
+void Benchmarks::BenchmarkSmallBuffer()
+{
+	CWaitCursor wait;
+
+	constexpr auto maxtr = 100'000u;
+
+	LogSys(L"---");
+	LogSys(L"Starting SmallBuffer benchmark for %u iterations", maxtr);
+
+	using namespace QuantumGate::Implementation::Memory;
+
+	// Builds control messages (header plus a few bytes of payload)
+	// the way the message code does, with Buffer and with SmallBuffer
+	std::array<Byte, 21> header{};
+	std::array<Byte, 12> payload{};
+	UInt8 i{ 0 };
+
+	const auto run = [&]<typename B>(const WChar* name, B&&)
+	{
+		DoBenchmark(std::wstring(name), maxtr, [&]()
+		{
+			header[0] = static_cast<Byte>(i++);
+
+			B hdrbuf;
+			hdrbuf.Preallocate(header.size());
+			hdrbuf += BufferView(header.data(), header.size());
+
+			B msgbuf;
+			msgbuf += hdrbuf;
+			msgbuf += BufferView(payload.data(), payload.size());
+
+			if (msgbuf.GetSize() != header.size() + payload.size())
+			{
+				AfxMessageBox(L"Message size mismatch!");
+				throw;
+			}
+		});
+	};
+
+	run(L"Buffer", Buffer());
+	run(L"SmallBuffer", SmallBuffer64());
 }
\ No newline at end of file
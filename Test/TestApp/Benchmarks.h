@@ -25,5 +25,12 @@ public:
 	static void BenchmarkCompression();
 	static void BenchmarkConsole();
 	static void BenchmarkMemory();
+	static void BenchmarkIPFilters();
+	static void BenchmarkCryptoRandom();
+	static void BenchmarkPostQuantum();
+	static void BenchmarkSipHash();
+	static void BenchmarkPseudoRandom();
+	static void BenchmarkSymmetric();
+	static void BenchmarkSmallBuffer();
 };
 
@@ -54,6 +54,7 @@ BEGIN_MESSAGE_MAP(CTestAppDlgTestExtenderTab, CTestAppDlgTabCtrlPage)
 	ON_MESSAGE(static_cast<UINT>(TestExtender::WindowsMessage::ExtenderInit), &CTestAppDlgTestExtenderTab::OnExtenderInit)
 	ON_MESSAGE(static_cast<UINT>(TestExtender::WindowsMessage::ExtenderDeinit), &CTestAppDlgTestExtenderTab::OnExtenderDeInit)
 	ON_MESSAGE(static_cast<UINT>(TestExtender::WindowsMessage::PingResult), &CTestAppDlgTestExtenderTab::OnPingResult)
+	ON_MESSAGE(static_cast<UINT>(TestExtender::WindowsMessage::LatencyBenchmarkResult), &CTestAppDlgTestExtenderTab::OnLatencyBenchmarkResult)
 	ON_BN_CLICKED(IDC_SENDBUTTON, &CTestAppDlgTestExtenderTab::OnBnClickedSendbutton)
 	ON_BN_CLICKED(IDC_SENDCHECK, &CTestAppDlgTestExtenderTab::OnBnClickedSendcheck)
 	ON_BN_CLICKED(IDC_SENDFILE, &CTestAppDlgTestExtenderTab::OnBnClickedSendfile)
@@ -90,6 +91,8 @@ BEGIN_MESSAGE_MAP(CTestAppDlgTestExtenderTab, CTestAppDlgTabCtrlPage)
 	ON_BN_CLICKED(IDC_SEND_PRIORITY, &CTestAppDlgTestExtenderTab::OnBnClickedSendPriority)
 	ON_BN_CLICKED(IDC_START_BENCHMARK, &CTestAppDlgTestExtenderTab::OnBnClickedStartBenchmark)
 	ON_BN_CLICKED(IDC_PING, &CTestAppDlgTestExtenderTab::OnBnClickedPing)
+	ON_COMMAND(ID_BENCHMARKS_LATENCY, &CTestAppDlgTestExtenderTab::OnBenchmarksLatency)
+	ON_UPDATE_COMMAND_UI(ID_BENCHMARKS_LATENCY, &CTestAppDlgTestExtenderTab::OnUpdateBenchmarksLatency)
 END_MESSAGE_MAP()
 
 BOOL CTestAppDlgTestExtenderTab::OnInitDialog()
@@ -636,6 +639,22 @@ LRESULT CTestAppDlgTestExtenderTab::OnPingResult(WPARAM w, LPARAM l)
 	return 0;
 }
 
+LRESULT CTestAppDlgTestExtenderTab::OnLatencyBenchmarkResult(WPARAM w, LPARAM l)
+{
+	if (w == TRUE)
+	{
+		SetValue(IDC_PING_RESULT, Util::FormatString(L"%lldus avg", l));
+	}
+	else
+	{
+		SetValue(IDC_PING_RESULT, L"failed");
+	}
+
+	UpdateControls();
+
+	return 0;
+}
+
 void CTestAppDlgTestExtenderTab::UpdateSelectedPeer() noexcept
 {
 	m_SelectedPeerLUID.reset();
@@ -829,3 +848,32 @@ void CTestAppDlgTestExtenderTab::OnBnClickedPing()
 		UpdateControls();
 	}
 }
+
+void CTestAppDlgTestExtenderTab::OnBenchmarksLatency()
+{
+	// Many round trips with small messages so that the
+	// timing of the worker threads shows in the results
+	constexpr Size num_round_trips{ 1000 };
+	constexpr Size mins{ 32 };
+	const Size maxs{ m_TestExtender->GetMaxPingSize() };
+
+	const auto psize = GetSizeValue(IDC_PING_NUM_BYTES);
+	if (psize < mins || psize > maxs)
+	{
+		AfxMessageBox(Util::FormatString(L"Specify a ping size between %zu and %zu bytes.", mins, maxs).c_str());
+		return;
+	}
+
+	if (m_TestExtender->BenchmarkLatency(*m_SelectedPeerLUID, psize, num_round_trips))
+	{
+		SetValue(IDC_PING_RESULT, L"...");
+
+		UpdateControls();
+	}
+}
+
+void CTestAppDlgTestExtenderTab::OnUpdateBenchmarksLatency(CCmdUI* pCmdUI)
+{
+	pCmdUI->Enable(GetQuantumGateInstance()->IsRunning() && m_TestExtender != nullptr &&
+				   m_SelectedPeerLUID.has_value() && !m_TestExtender->IsPingActive());
+}
@@ -35,6 +35,7 @@ protected:
 	LRESULT OnExtenderInit(WPARAM w, LPARAM l);
 	LRESULT OnExtenderDeInit(WPARAM w, LPARAM l);
 	LRESULT OnPingResult(WPARAM w, LPARAM l);
+	LRESULT OnLatencyBenchmarkResult(WPARAM w, LPARAM l);
 
 	virtual BOOL OnInitDialog();
 
@@ -96,6 +97,8 @@ protected:
 	afx_msg void OnBnClickedSendPriority();
 	afx_msg void OnBnClickedStartBenchmark();
 	afx_msg void OnBnClickedPing();
+	afx_msg void OnBenchmarksLatency();
+	afx_msg void OnUpdateBenchmarksLatency(CCmdUI* pCmdUI);
 
 private:
 	std::optional<PeerLUID> m_SelectedPeerLUID;
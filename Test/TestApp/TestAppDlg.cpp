@@ -160,6 +160,8 @@ BEGIN_MESSAGE_MAP(CTestAppDlg, CDialogBase)
 	ON_COMMAND(ID_UTILS_UUIDGENERATIONANDVALIDATION, &CTestAppDlg::OnUtilsUUIDGenerationAndValidation)
 	ON_COMMAND(ID_LOCAL_ALLOWUNAUTHENTICATEDPEERS, &CTestAppDlg::OnLocalAllowUnauthenticatedPeers)
 	ON_UPDATE_COMMAND_UI(ID_LOCAL_ALLOWUNAUTHENTICATEDPEERS, &CTestAppDlg::OnUpdateLocalAllowUnauthenticatedPeers)
+	ON_COMMAND(ID_LOCAL_BUSYPOLL, &CTestAppDlg::OnLocalBusyPoll)
+	ON_UPDATE_COMMAND_UI(ID_LOCAL_BUSYPOLL, &CTestAppDlg::OnUpdateLocalBusyPoll)
 	ON_COMMAND(ID_PEERACCESSSETTINGS_ADD, &CTestAppDlg::OnPeerAccessSettingsAdd)
 	ON_COMMAND(ID_LOCAL_RELAYS_ENABLED, &CTestAppDlg::OnLocalRelaysEnabled)
 	ON_UPDATE_COMMAND_UI(ID_LOCAL_RELAYS_ENABLED, &CTestAppDlg::OnUpdateLocalRelaysEnabled)
@@ -193,6 +195,13 @@ BEGIN_MESSAGE_MAP(CTestAppDlg, CDialogBase)
 	ON_UPDATE_COMMAND_UI(ID_LOCAL_UDPLISTENERSENABLED, &CTestAppDlg::OnUpdateLocalUDPListenersEnabled)
 	ON_COMMAND(ID_LOCAL_BTHLISTENERSENABLED, &CTestAppDlg::OnLocalBTHListenersEnabled)
 	ON_UPDATE_COMMAND_UI(ID_LOCAL_BTHLISTENERSENABLED, &CTestAppDlg::OnUpdateLocalBTHListenersEnabled)
+	ON_COMMAND(ID_BENCHMARKS_IPFILTERS, &CTestAppDlg::OnBenchmarksIPFilters)
+	ON_COMMAND(ID_BENCHMARKS_CRYPTORANDOM, &CTestAppDlg::OnBenchmarksCryptoRandom)
+	ON_COMMAND(ID_BENCHMARKS_POSTQUANTUM, &CTestAppDlg::OnBenchmarksPostQuantum)
+	ON_COMMAND(ID_BENCHMARKS_SIPHASH, &CTestAppDlg::OnBenchmarksSipHash)
+	ON_COMMAND(ID_BENCHMARKS_PSEUDORANDOM, &CTestAppDlg::OnBenchmarksPseudoRandom)
+	ON_COMMAND(ID_BENCHMARKS_SYMMETRIC, &CTestAppDlg::OnBenchmarksSymmetric)
+	ON_COMMAND(ID_BENCHMARKS_SMALLBUFFER, &CTestAppDlg::OnBenchmarksSmallBuffer)
 END_MESSAGE_MAP()
 
 BOOL CTestAppDlg::OnInitDialog()
@@ -374,6 +383,11 @@ void CTestAppDlg::LoadSettings()
 					m_StartupParameters.RequireAuthentication = set["RequirePeerAuthentication"].get<bool>();
 				}
 
+				if (set.find("BusyPoll") != set.end())
+				{
+					m_StartupParameters.BusyPoll.Enable = set["BusyPoll"].get<bool>();
+				}
+
 				if (set.find("RelayIPv4ExcludedNetworksCIDRLeadingBits") != set.end())
 				{
 					m_StartupParameters.Relays.IPv4ExcludedNetworksCIDRLeadingBits = set["RelayIPv4ExcludedNetworksCIDRLeadingBits"].get<int>();
@@ -598,6 +612,7 @@ void CTestAppDlg::SaveSettings()
 			j["Settings"]["LocalBluetoothDiscoverable"] = (((CButton*)m_MainTab->GetDlgItem(IDC_BTH_DISCOV))->GetCheck() == BST_CHECKED);
 			j["Settings"]["LocalUUID"] = Util::ToStringA((LPCWSTR)luuid);
 			j["Settings"]["RequirePeerAuthentication"] = m_StartupParameters.RequireAuthentication;
+			j["Settings"]["BusyPoll"] = m_StartupParameters.BusyPoll.Enable;
 			j["Settings"]["RelayIPv4ExcludedNetworksCIDRLeadingBits"] = m_StartupParameters.Relays.IPv4ExcludedNetworksCIDRLeadingBits;
 			j["Settings"]["RelayIPv6ExcludedNetworksCIDRLeadingBits"] = m_StartupParameters.Relays.IPv6ExcludedNetworksCIDRLeadingBits;
 
@@ -1427,6 +1442,17 @@ void CTestAppDlg::OnUpdateLocalAllowUnauthenticatedPeers(CCmdUI* pCmdUI)
 	pCmdUI->Enable(!m_QuantumGate.IsRunning());
 }
 
+void CTestAppDlg::OnLocalBusyPoll()
+{
+	m_StartupParameters.BusyPoll.Enable = !m_StartupParameters.BusyPoll.Enable;
+}
+
+void CTestAppDlg::OnUpdateLocalBusyPoll(CCmdUI* pCmdUI)
+{
+	pCmdUI->SetCheck(m_StartupParameters.BusyPoll.Enable);
+	pCmdUI->Enable(!m_QuantumGate.IsRunning());
+}
+
 void CTestAppDlg::OnPeerAccessSettingsAdd()
 {
 	CPeerAccessDlg dlg;
@@ -1931,4 +1957,39 @@ void CTestAppDlg::OnLocalFreeUnusedMemory()
 void CTestAppDlg::OnBenchmarksThreadPause()
 {
 	Benchmarks::BenchmarkThreadPause();
+}
+
+void CTestAppDlg::OnBenchmarksIPFilters()
+{
+	Benchmarks::BenchmarkIPFilters();
+}
+
+void CTestAppDlg::OnBenchmarksCryptoRandom()
+{
+	Benchmarks::BenchmarkCryptoRandom();
+}
+
+void CTestAppDlg::OnBenchmarksPostQuantum()
+{
+	Benchmarks::BenchmarkPostQuantum();
+}
+
+void CTestAppDlg::OnBenchmarksSipHash()
+{
+	Benchmarks::BenchmarkSipHash();
+}
+
+void CTestAppDlg::OnBenchmarksPseudoRandom()
+{
+	Benchmarks::BenchmarkPseudoRandom();
+}
+
+void CTestAppDlg::OnBenchmarksSymmetric()
+{
+	Benchmarks::BenchmarkSymmetric();
+}
+
+void CTestAppDlg::OnBenchmarksSmallBuffer()
+{
+	Benchmarks::BenchmarkSmallBuffer();
 }
\ No newline at end of file
@@ -108,6 +108,8 @@ protected:
 	afx_msg void OnUtilsUUIDGenerationAndValidation();
 	afx_msg void OnLocalAllowUnauthenticatedPeers();
 	afx_msg void OnUpdateLocalAllowUnauthenticatedPeers(CCmdUI* pCmdUI);
+	afx_msg void OnLocalBusyPoll();
+	afx_msg void OnUpdateLocalBusyPoll(CCmdUI* pCmdUI);
 	afx_msg void OnPeerAccessSettingsAdd();
 	afx_msg void OnLocalRelaysEnabled();
 	afx_msg void OnUpdateLocalRelaysEnabled(CCmdUI* pCmdUI);
@@ -140,6 +142,13 @@ protected:
 	afx_msg void OnUpdateLocalUDPListenersEnabled(CCmdUI* pCmdUI);
 	afx_msg void OnLocalBTHListenersEnabled();
 	afx_msg void OnUpdateLocalBTHListenersEnabled(CCmdUI* pCmdUI);
+	afx_msg void OnBenchmarksIPFilters();
+	afx_msg void OnBenchmarksCryptoRandom();
+	afx_msg void OnBenchmarksPostQuantum();
+	afx_msg void OnBenchmarksSipHash();
+	afx_msg void OnBenchmarksPseudoRandom();
+	afx_msg void OnBenchmarksSymmetric();
+	afx_msg void OnBenchmarksSmallBuffer();
 
 private:
 	static inline const char* m_SettingsFilename{ "TestAppSettings.json" };
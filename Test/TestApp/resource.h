@@ -315,13 +315,22 @@
 #define ID_LOCAL_ADDRESS_REPUTATIONS    32857
 #define ID_LOCAL_BTHLISTENERSENABLED    32858
 #define ID_LOCAL_LISTENERS              32859
+#define ID_LOCAL_BUSYPOLL               32860
+#define ID_BENCHMARKS_LATENCY           32861
+#define ID_BENCHMARKS_IPFILTERS         32862
+#define ID_BENCHMARKS_CRYPTORANDOM      32863
+#define ID_BENCHMARKS_POSTQUANTUM       32864
+#define ID_BENCHMARKS_SIPHASH           32865
+#define ID_BENCHMARKS_PSEUDORANDOM      32866
+#define ID_BENCHMARKS_SYMMETRIC         32867
+#define ID_BENCHMARKS_SMALLBUFFER       32868
 
 // Next default values for new objects
 // 
 #ifdef APSTUDIO_INVOKED
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        178
-#define _APS_NEXT_COMMAND_VALUE         32860
+#define _APS_NEXT_COMMAND_VALUE         32869
 #define _APS_NEXT_CONTROL_VALUE         1094
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
@@ -12,6 +12,7 @@ extern "C"
 
 #include <cassert>
 #include <functional>
+#include <algorithm>
 
 #include <Console.h>
 #include <Common\Util.h>
@@ -24,27 +25,27 @@ using namespace std::literals;
 
 namespace TestExtender
 {
-	FileTransfer::FileTransfer(QuantumGate::Peer& peer, const FileTransferType type, const Size trfbuf_size,
-							   const bool autotrf, const bool benchmark, const Size benchmark_size) noexcept :
+	struct FileTransfer::HashContext final
+	{
+		crypto_blake2b_ctx Context;
+	};
+
+	FileTransfer::FileTransfer(QuantumGate::Peer& peer, const FileTransferType type, const Size chunk_size,
+							   const Size window_size, const bool autotrf, const bool benchmark, const Size benchmark_size) noexcept :
 		m_Peer(peer), m_Type(type), m_Auto(autotrf), m_Benchmark(benchmark), m_BenchmarkSize(benchmark_size),
-		m_TransferBuffer(trfbuf_size), m_LastActiveSteadyTime(Util::GetCurrentSteadyTime())
+		m_ChunkSize(chunk_size), m_WindowSize(window_size), m_LastActiveSteadyTime(Util::GetCurrentSteadyTime())
 	{}
 
 	FileTransfer::FileTransfer(QuantumGate::Peer& peer, const FileTransferType type, const FileTransferID id,
 							   const Size filesize, const String& filename, Buffer&& filehash,
-							   const Size trfbuf_size, const bool autotrf, const bool benchmark) noexcept :
+							   const bool autotrf, const bool benchmark) noexcept :
 		m_Peer(peer), m_Type(type), m_Auto(autotrf), m_Benchmark(benchmark), m_ID(id), m_FileHash(std::move(filehash)),
-		m_FileName(filename), m_FileSize(filesize), m_TransferBuffer(trfbuf_size),
-		m_LastActiveSteadyTime(Util::GetCurrentSteadyTime())
+		m_FileName(filename), m_FileSize(filesize), m_LastActiveSteadyTime(Util::GetCurrentSteadyTime())
 	{}
 
 	FileTransfer::~FileTransfer()
 	{
-		if (m_File != nullptr)
-		{
-			fclose(m_File);
-			m_File = nullptr;
-		}
+		CloseFile();
 
 		if (((m_Status != FileTransferStatus::Succeeded || IsAuto()) &&
 			 m_Type == FileTransferType::Incoming) && !m_FileName.empty() && !m_Benchmark)
@@ -71,34 +72,34 @@ namespace TestExtender
 		}
 		else
 		{
-			if (fopen_s(&m_File, Util::ToStringA(filename).c_str(), "rb") == 0)
+			m_File = CreateFile(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (m_File != INVALID_HANDLE_VALUE)
 			{
-				// Seek to end
-				if (fseek(m_File, 0, SEEK_END) == 0)
+				LARGE_INTEGER fsize{ 0 };
+
+				// This check needed for 32-bit systems that can't support 64-bit file sizes
+				if (GetFileSizeEx(m_File, &fsize) &&
+					static_cast<UInt64>(fsize.QuadPart) <= (std::numeric_limits<Size>::max)())
 				{
-					m_FileSize = ftell(m_File);
+					m_FileSize = static_cast<Size>(fsize.QuadPart);
 					m_FileName = filename;
 
-					if (CalcFileHash(m_FileHash))
+					if (MapFile(false))
 					{
-						// Seek to beginning
-						if (fseek(m_File, 0, SEEK_SET) == 0)
+						if (CalcFileHash(m_FileHash))
 						{
 							m_ID = Util::GetPersistentHash(*Util::ToBase64(m_FileHash));
 							m_LastActiveSteadyTime = Util::GetCurrentSteadyTime();
 
 							success = true;
 						}
-						else LogErr(L"Could not seek in file %s", filename.c_str());
 					}
+					else LogErr(L"Could not map file %s", filename.c_str());
 				}
-				else LogErr(L"Could not seek in file %s", filename.c_str());
+				else LogErr(L"Could not get size of file %s", filename.c_str());
 
-				if (!success)
-				{
-					fclose(m_File);
-					m_File = nullptr;
-				}
+				if (!success) CloseFile();
 			}
 			else LogErr(L"Could not open file %s", filename.c_str());
 		}
@@ -106,64 +107,88 @@ namespace TestExtender
 		return success;
 	}
 
-	Size FileTransfer::ReadFromFile(Byte* buffer, Size size) noexcept
+	bool FileTransfer::CanSendChunk() const noexcept
 	{
+		return (m_Status == FileTransferStatus::Transfering && !m_LastChunkSent &&
+				m_NumChunksInFlight < m_WindowSize);
+	}
+
+	// Returns the next chunk to send; the transfer only moves on to
+	// the chunk after it once SentChunk() gets called
+	BufferView FileTransfer::ReadChunk() noexcept
+	{
+		assert(CanSendChunk());
+
 		if (m_NumBytesTransferred == 0) m_TransferStartSteadyTime = Util::GetCurrentSteadyTime();
 
-		m_LastActiveSteadyTime = Util::GetCurrentSteadyTime();
+		const auto size = (std::min)(m_ChunkSize, m_FileSize - m_NumBytesTransferred);
 
-		Size numread{ 0 };
+		BufferView chunk;
 
 		if (m_Benchmark)
 		{
 			assert(size <= m_BenchmarkBuffer.GetSize());
 
-			numread = size;
-			if (numread > (m_FileSize - m_NumBytesTransferred))
-			{
-				numread = m_FileSize - m_NumBytesTransferred;
-			}
+			chunk = BufferView(m_BenchmarkBuffer).GetFirst(size);
+		}
+		else if (size > 0)
+		{
+			// Chunk comes straight from the mapping
+			chunk = BufferView(m_FileView + m_NumBytesTransferred, size);
+		}
 
-			std::memcpy(buffer, m_BenchmarkBuffer.GetBytes(), numread);
+		return chunk;
+	}
 
-			if (numread < size)
-			{
-				// Transfer end
-				TransferEndStats();
-			}
-		}
-		else
+	void FileTransfer::SentChunk(const Size size) noexcept
+	{
+		assert(size <= m_FileSize - m_NumBytesTransferred);
+
+		m_LastActiveSteadyTime = Util::GetCurrentSteadyTime();
+
+		m_NumBytesTransferred += size;
+		++m_NumChunksInFlight;
+
+		if (m_NumBytesTransferred == m_FileSize)
 		{
-			numread = fread(buffer, sizeof(Byte), size, m_File);
+			m_LastChunkSent = true;
 
-			if (numread < size)
-			{
-				if (m_NumBytesTransferred + numread != m_FileSize)
-				{
-					LogErr(L"Error reading file %s", m_FileName.c_str());
-					SetStatus(FileTransferStatus::Error);
-				}
-				else
-				{
-					// Transfer end
-					TransferEndStats();
-				}
-			}
+			// Transfer end
+			TransferEndStats();
 		}
+	}
 
-		m_NumBytesTransferred += numread;
+	void FileTransfer::AckChunk() noexcept
+	{
+		if (m_NumChunksInFlight > 0) --m_NumChunksInFlight;
 
-		return numread;
+		m_LastActiveSteadyTime = Util::GetCurrentSteadyTime();
+	}
+
+	bool FileTransfer::IsAllChunksAcked() const noexcept
+	{
+		return (m_LastChunkSent && m_NumChunksInFlight == 0);
 	}
 
 	bool FileTransfer::OpenDestinationFile(const String& filename)
 	{
 		if (!m_Benchmark)
 		{
-			if (fopen_s(&m_File, Util::ToStringA(filename).c_str(), "w+b") != 0)
+			m_File = CreateFile(filename.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+								CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (m_File == INVALID_HANDLE_VALUE) return false;
+
+			// Mapping the file also extends it to its full size
+			if (!MapFile(true))
 			{
+				LogErr(L"Could not map file %s", filename.c_str());
+
+				CloseFile();
 				return false;
 			}
+
+			m_HashContext = std::make_unique<HashContext>();
+			crypto_blake2b_init(&m_HashContext->Context);
 		}
 
 		m_FileName = filename;
@@ -172,60 +197,53 @@ namespace TestExtender
 		return true;
 	}
 
-	bool FileTransfer::WriteToFile(const Byte* buffer, const Size size) noexcept
+	bool FileTransfer::WriteChunk(const UInt64 offset, const BufferView& data) noexcept
 	{
 		if (m_NumBytesTransferred == 0) m_TransferStartSteadyTime = Util::GetCurrentSteadyTime();
 
 		m_LastActiveSteadyTime = Util::GetCurrentSteadyTime();
 
-		if (m_Benchmark)
+		// Chunks are expected in order so that they can get hashed as they come in
+		if (offset != m_NumBytesTransferred || data.GetSize() > m_FileSize - m_NumBytesTransferred)
 		{
-			m_NumBytesTransferred += size;
+			LogErr(L"File transfer error: unexpected data at offset %llu for file %s", offset, m_FileName.c_str());
 
-			if (m_NumBytesTransferred == m_FileSize)
-			{
-				// Transfer end
-				TransferEndStats();
+			SetStatus(FileTransferStatus::Error);
+			return false;
+		}
 
-				SetStatus(FileTransferStatus::Succeeded);
-			}
+		if (!m_Benchmark && !data.IsEmpty())
+		{
+			std::memcpy(m_FileView + m_NumBytesTransferred, data.GetBytes(), data.GetSize());
 
-			return true;
+			crypto_blake2b_update(&m_HashContext->Context, reinterpret_cast<const UChar*>(data.GetBytes()), data.GetSize());
 		}
-		else
+
+		m_NumBytesTransferred += data.GetSize();
+
+		if (m_NumBytesTransferred == m_FileSize)
 		{
-			const auto numwritten = fwrite(buffer, sizeof(Byte), size, m_File);
-			if (numwritten == size)
+			// Transfer end
+			TransferEndStats();
+
+			if (!m_Benchmark)
 			{
-				m_NumBytesTransferred += numwritten;
+				std::array<Byte, 64> hash{};
+				crypto_blake2b_final(&m_HashContext->Context, reinterpret_cast<UChar*>(hash.data()));
 
-				if (m_NumBytesTransferred == m_FileSize)
+				if (BufferView(hash.data(), hash.size()) != BufferView(m_FileHash))
 				{
-					// Transfer end
-					TransferEndStats();
+					LogErr(L"File transfer error: hash for file %s doesn't match", m_FileName.c_str());
 
-					Buffer hash;
-
-					if (CalcFileHash(hash) && hash == m_FileHash)
-					{
-						SetStatus(FileTransferStatus::Succeeded);
-					}
-					else
-					{
-						LogErr(L"File transfer error: hash for file %s doesn't match", m_FileName.c_str());
-
-						SetStatus(FileTransferStatus::Error);
-						return false;
-					}
+					SetStatus(FileTransferStatus::Error);
+					return false;
 				}
-
-				return true;
 			}
 
-			SetStatus(FileTransferStatus::Error);
-
-			return false;
+			SetStatus(FileTransferStatus::Succeeded);
 		}
+
+		return true;
 	}
 
 	void FileTransfer::SetStatus(const FileTransferStatus status) noexcept
@@ -257,50 +275,61 @@ namespace TestExtender
 		return L"Unknown";
 	}
 
-	bool FileTransfer::CalcFileHash(Buffer& hashbuff) noexcept
+	bool FileTransfer::MapFile(const bool write) noexcept
 	{
-		try
+		// Empty files can't be mapped (and there's nothing to map)
+		if (m_FileSize == 0) return true;
+
+		const auto size = static_cast<UInt64>(m_FileSize);
+
+		m_FileMapping = CreateFileMapping(m_File, nullptr, write ? PAGE_READWRITE : PAGE_READONLY,
+										  static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+		if (m_FileMapping != nullptr)
 		{
-			constexpr Size bufsize{ 1024 * 1000 };
-			Buffer buffer(bufsize);
-			Size bytesread{ 0 };
+			m_FileView = static_cast<Byte*>(MapViewOfFile(m_FileMapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+			if (m_FileView != nullptr) return true;
 
-			// Seek to start
-			if (fseek(m_File, 0, SEEK_SET) == 0)
-			{
-				LogInfo(L"Calculating hash for file %s", m_FileName.c_str());
+			CloseHandle(m_FileMapping);
+			m_FileMapping = nullptr;
+		}
 
-				Buffer fhash(64);
-				crypto_blake2b_ctx ctx;
-				crypto_blake2b_init(&ctx);
+		return false;
+	}
 
-				while (true)
-				{
-					const auto numread = fread(buffer.GetBytes(), sizeof(Byte), buffer.GetSize(), m_File);
+	void FileTransfer::CloseFile() noexcept
+	{
+		if (m_FileView != nullptr)
+		{
+			UnmapViewOfFile(m_FileView);
+			m_FileView = nullptr;
+		}
 
-					bytesread += static_cast<Size>(numread);
+		if (m_FileMapping != nullptr)
+		{
+			CloseHandle(m_FileMapping);
+			m_FileMapping = nullptr;
+		}
 
-					crypto_blake2b_update(&ctx, reinterpret_cast<const UChar*>(buffer.GetBytes()), numread);
+		if (m_File != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(m_File);
+			m_File = INVALID_HANDLE_VALUE;
+		}
+	}
 
-					if (numread < bufsize)
-					{
-						if (bytesread != m_FileSize)
-						{
-							LogErr(L"Error reading file %s", m_FileName.c_str());
-						}
-						else
-						{
-							crypto_blake2b_final(&ctx, reinterpret_cast<UChar*>(fhash.GetBytes()));
+	bool FileTransfer::CalcFileHash(Buffer& hashbuff) noexcept
+	{
+		try
+		{
+			LogInfo(L"Calculating hash for file %s", m_FileName.c_str());
 
-							hashbuff = std::move(fhash);
-							return true;
-						}
+			// Hashed straight from the mapping
+			Buffer fhash(64);
+			crypto_blake2b(reinterpret_cast<UChar*>(fhash.GetBytes()),
+						   reinterpret_cast<const UChar*>(m_FileView), m_FileSize);
 
-						break;
-					}
-				}
-			}
-			else LogErr(L"Could not seek in file %s", m_FileName.c_str());
+			hashbuff = std::move(fhash);
+			return true;
 		}
 		catch (...) {}
 
@@ -392,6 +421,15 @@ namespace TestExtender
 
 	void Extender::OnPeerEvent(PeerEvent&& event)
 	{
+		if (event.GetType() == PeerEvent::Type::SendBufferAvailable)
+		{
+			// Outgoing file transfers that were paused because
+			// the peer send buffer was full can continue; not passed
+			// on to the UI because it can occur very often
+			ResumeFileTransfers(event.GetPeerLUID());
+			return;
+		}
+
 		String ev(L"Unknown");
 
 		if (event.GetType() == PeerEvent::Type::Connected)
@@ -536,8 +574,7 @@ namespace TestExtender
 										{
 											auto ft = std::make_unique<FileTransfer>(peer, FileTransferType::Incoming, fid,
 																					 fsize2, fname, std::move(fhash),
-																					 GetFileTransferDataSize(), autotrf,
-																					 benchmark);
+																					 autotrf, benchmark);
 											ft->SetStatus(FileTransferStatus::NeedAccept);
 
 											const auto retval = filetransfers.insert({ fid, std::move(ft) });
@@ -642,11 +679,15 @@ namespace TestExtender
 
 								IfHasFileTransfer(event.GetPeerLUID(), ftid, [&](FileTransfer& ft)
 								{
-									auto& buffer = ft.GetTransferBuffer();
+									UInt64 offset{ 0 };
 
-									if (rdr.Read(WithSize(buffer, GetFileTransferDataSize())))
+									if (rdr.Read(offset))
 									{
-										if (ft.WriteToFile(buffer.GetBytes(), buffer.GetSize()))
+										// The rest of the message is the chunk
+										BufferView data{ *msgdata };
+										data.RemoveFirst(GetFileTransferDataHeaderSize());
+
+										if (data.GetSize() <= GetFileTransferDataSize() && ft.WriteChunk(offset, data))
 										{
 											result.Success = SendFileDataAck(ft);
 										}
@@ -671,7 +712,9 @@ namespace TestExtender
 
 								IfHasFileTransfer(event.GetPeerLUID(), ftid, [&](FileTransfer& ft)
 								{
-									if (ft.GetNumBytesTransferred() == ft.GetFileSize())
+									ft.AckChunk();
+
+									if (ft.IsAllChunksAcked())
 									{
 										ft.SetStatus(FileTransferStatus::Succeeded);
 										result.Success = true;
@@ -717,22 +760,32 @@ namespace TestExtender
 									{
 										if (time_received <= (ping.TimeSent + ping.TimeOut))
 										{
-											const auto elapsed_time =
-												std::chrono::duration_cast<std::chrono::milliseconds>(time_received - ping.TimeSent);
+											if (ping.IsLatencyBenchmark())
+											{
+												if (ContinueLatencyBenchmark(ping, time_received))
+												{
+													result.Success = true;
+													return;
+												}
+											}
+											else
+											{
+												const auto elapsed_time =
+													std::chrono::duration_cast<std::chrono::milliseconds>(time_received - ping.TimeSent);
 
-											LogInfo(L"Ping reply from peer %llu (Buffer: %zu bytes, Result: %jdms)",
-													event.GetPeerLUID(), echo_data.GetSize(), elapsed_time.count());
+												LogInfo(L"Ping reply from peer %llu (Buffer: %zu bytes, Result: %jdms)",
+														event.GetPeerLUID(), echo_data.GetSize(), elapsed_time.count());
 
-											PostMessage(m_Window, static_cast<UINT>(WindowsMessage::PingResult),
-														static_cast<WPARAM>(TRUE), static_cast<LPARAM>(elapsed_time.count()));
+												PostMessage(m_Window, static_cast<UINT>(WindowsMessage::PingResult),
+															static_cast<WPARAM>(TRUE), static_cast<LPARAM>(elapsed_time.count()));
+											}
 										}
 										else
 										{
 											LogInfo(L"Ping reply from peer %llu timed out (Buffer: %zu bytes)",
 													event.GetPeerLUID(), echo_data.GetSize());
 
-											PostMessage(m_Window, static_cast<UINT>(WindowsMessage::PingResult),
-														static_cast<WPARAM>(FALSE), 0);
+											PostMessage(m_Window, ping.GetResultMessage(), static_cast<WPARAM>(FALSE), 0);
 										}
 
 										result.Success = true;
@@ -821,8 +874,7 @@ namespace TestExtender
 						LogInfo(L"Ping reply from peer %llu timed out (Buffer: %zu bytes)",
 								ping.PeerLUID, ping.Data.GetSize());
 
-						PostMessage(extender->m_Window, static_cast<UINT>(WindowsMessage::PingResult),
-									static_cast<WPARAM>(FALSE), 0);
+						PostMessage(extender->m_Window, ping.GetResultMessage(), static_cast<WPARAM>(FALSE), 0);
 
 						ping.Reset();
 					}
@@ -980,6 +1032,81 @@ namespace TestExtender
 		return m_Ping.WithSharedLock()->Active;
 	}
 
+	bool Extender::BenchmarkLatency(const PeerLUID pluid, const Size size, const Size num) noexcept
+	{
+		assert(num > 0);
+
+		auto success = false;
+
+		m_Ping.WithUniqueLock([&](PingData& ping)
+		{
+			if (!ping.Active)
+			{
+				LogInfo(L"Starting latency benchmark with peer %llu (Buffer: %zu bytes, Round trips: %zu)", pluid, size, num);
+
+				try
+				{
+					ping.PeerLUID = pluid;
+					ping.Data = Util::GetPseudoRandomBytes(size);
+					ping.NumRoundTrips = num;
+					ping.RoundTripTimes.reserve(num);
+					ping.TimeSent = Util::GetCurrentSteadyTime();
+
+					if (SendEcho(pluid, ping.Data))
+					{
+						ping.Active = true;
+						success = true;
+					}
+				}
+				catch (...) {}
+
+				if (!success) ping.Reset();
+			}
+			else LogErr(L"Cannot benchmark latency with peer %llu; there's a ping active", pluid);
+		});
+
+		return success;
+	}
+
+	bool Extender::ContinueLatencyBenchmark(PingData& ping, const SteadyTime time_received) noexcept
+	{
+		ping.RoundTripTimes.emplace_back(time_received - ping.TimeSent);
+
+		if (ping.RoundTripTimes.size() < ping.NumRoundTrips)
+		{
+			ping.TimeSent = Util::GetCurrentSteadyTime();
+
+			if (SendEcho(ping.PeerLUID, ping.Data)) return true;
+
+			LogErr(L"Latency benchmark with peer %llu failed after %zu round trips",
+				   ping.PeerLUID, ping.RoundTripTimes.size());
+
+			PostMessage(m_Window, ping.GetResultMessage(), static_cast<WPARAM>(FALSE), 0);
+
+			return false;
+		}
+
+		auto& rtts = ping.RoundTripTimes;
+		std::sort(rtts.begin(), rtts.end());
+
+		const auto to_us = [](const std::chrono::nanoseconds ns) noexcept
+		{
+			return static_cast<double>(ns.count()) / 1000.0;
+		};
+
+		std::chrono::nanoseconds total{ 0 };
+		for (const auto rtt : rtts) total += rtt;
+
+		LogInfo(L"Latency benchmark with peer %llu finished (Buffer: %zu bytes, Round trips: %zu, Min: %.1fus, Avg: %.1fus, P50: %.1fus, P99: %.1fus, Max: %.1fus)",
+				ping.PeerLUID, ping.Data.GetSize(), rtts.size(), to_us(rtts.front()), to_us(total / rtts.size()),
+				to_us(rtts[rtts.size() / 2]), to_us(rtts[(rtts.size() * 99) / 100]), to_us(rtts.back()));
+
+		PostMessage(m_Window, ping.GetResultMessage(), static_cast<WPARAM>(TRUE),
+					static_cast<LPARAM>(std::chrono::duration_cast<std::chrono::microseconds>(total / rtts.size()).count()));
+
+		return false;
+	}
+
 	bool Extender::SendMessage(const PeerLUID pluid, const String& msg, const SendParameters::PriorityOption priority,
 							   const std::chrono::milliseconds delay) const
 	{
@@ -1014,7 +1141,8 @@ namespace TestExtender
 		if (it != peers->end())
 		{
 			auto ft = std::make_unique<FileTransfer>(it->second->Peer, FileTransferType::Outgoing,
-													 GetFileTransferDataSize(), autotrf, benchmark, benchmark_size);
+													 GetFileTransferDataSize(), m_FileTransferWindowSize,
+													 autotrf, benchmark, benchmark_size);
 
 			// Need to unlock because IfNotHasFileTransfer will
 			// lock again later
@@ -1158,34 +1286,66 @@ namespace TestExtender
 
 	Size Extender::GetFileTransferDataSize() const noexcept
 	{
-		// 15 bytes for MessageType::FileTransferData message header
-		return (GetMaximumMessageDataSize() - 15);
+		return (GetMaximumMessageDataSize() - GetFileTransferDataHeaderSize());
 	}
 
 	bool Extender::SendFileData(FileTransfer& ft)
 	{
-		auto& buffer = ft.GetTransferBuffer();
-		const auto numread = ft.ReadFromFile(buffer.GetBytes(), buffer.GetSize());
-
-		if (ft.GetStatus() != FileTransferStatus::Error)
+		// Keep sending chunks until the window is full so that there
+		// are several chunks in flight instead of waiting for each ack
+		while (ft.CanSendChunk())
 		{
-			buffer.Resize(numread);
+			const UInt64 offset = ft.GetNumBytesTransferred();
+			const auto chunk = ft.ReadChunk();
 
 			constexpr UInt16 msgtype = static_cast<UInt16>(MessageType::FileTransferData);
 
 			BufferWriter writer(true);
-			if (writer.WriteWithPreallocation(msgtype, ft.GetID(), WithSize(buffer, GetFileTransferDataSize())))
+			if (writer.WriteWithPreallocation(msgtype, ft.GetID(), offset, chunk))
 			{
-				if (SendMessageTo(ft.GetPeer(), writer.MoveWrittenBytes(),
-								  QuantumGate::SendParameters{ .Compress = m_UseCompression }).Succeeded()) return true;
+				const auto result = SendMessageTo(ft.GetPeer(), writer.MoveWrittenBytes(),
+												  QuantumGate::SendParameters{ .Compress = m_UseCompression });
+				if (result.Succeeded())
+				{
+					ft.SentChunk(chunk.GetSize());
+					continue;
+				}
+				else if (result == ResultCode::PeerSendBufferFull)
+				{
+					// The peer send buffer can't take more for now; the rest of the
+					// window gets sent on the next ack or when we get notified
+					// that there's room available again
+					return true;
+				}
 				else LogErr(L"Could not send FileTransferData message to peer");
 			}
 			else LogErr(L"Could not prepare FileTransferData message for peer");
+
+			ft.SetStatus(FileTransferStatus::Error);
+
+			return false;
 		}
 
-		ft.SetStatus(FileTransferStatus::Error);
+		return true;
+	}
 
-		return false;
+	void Extender::ResumeFileTransfers(const PeerLUID pluid)
+	{
+		m_Peers.WithSharedLock([&](auto& peers)
+		{
+			const auto it = peers.find(pluid);
+			if (it != peers.end())
+			{
+				auto filetransfers = it->second->FileTransfers.WithSharedLock();
+				for (auto& [ftid, ft] : *filetransfers)
+				{
+					if (ft->GetType() == FileTransferType::Outgoing && ft->CanSendChunk())
+					{
+						SendFileData(*ft);
+					}
+				}
+			}
+		});
 	}
 
 	bool Extender::SendFileDataAck(FileTransfer& ft) noexcept
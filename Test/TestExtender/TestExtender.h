@@ -51,20 +51,30 @@ namespace TestExtender
 
 	using FileTransferID = UInt64;
 
+	// Files are memory mapped so that chunks get sent from and written to the
+	// mapping directly. Outgoing transfers keep up to window size chunks in flight
+	// before waiting for acknowledgements, and incoming transfers hash the chunks
+	// as they get written instead of reading the entire file again at the end.
 	class FileTransfer final
 	{
+		struct HashContext;
+
 	public:
-		FileTransfer(QuantumGate::Peer& peer, const FileTransferType type, const Size trfbuf_size,
-					 const bool autotrf, const bool benchmark, const Size benchmark_size) noexcept;
+		FileTransfer(QuantumGate::Peer& peer, const FileTransferType type, const Size chunk_size,
+					 const Size window_size, const bool autotrf, const bool benchmark, const Size benchmark_size) noexcept;
 		FileTransfer(QuantumGate::Peer& peer, const FileTransferType type, const FileTransferID id,
 					 const Size filesize, const String& filename, Buffer&& filehash,
-					 const Size trfbuf_size, const bool autotrf, const bool benchmark) noexcept;
+					 const bool autotrf, const bool benchmark) noexcept;
 		~FileTransfer();
 
 		bool OpenSourceFile(const String& filename);
-		Size ReadFromFile(Byte* buffer, Size size) noexcept;
+		[[nodiscard]] bool CanSendChunk() const noexcept;
+		[[nodiscard]] BufferView ReadChunk() noexcept;
+		void SentChunk(const Size size) noexcept;
+		void AckChunk() noexcept;
+		[[nodiscard]] bool IsAllChunksAcked() const noexcept;
 		bool OpenDestinationFile(const String& filename);
-		bool WriteToFile(const Byte* buffer, const Size size) noexcept;
+		bool WriteChunk(const UInt64 offset, const BufferView& data) noexcept;
 
 		void SetStatus(const FileTransferStatus status) noexcept;
 
@@ -81,9 +91,10 @@ namespace TestExtender
 		inline Size GetFileSize() const noexcept { return m_FileSize; }
 		inline Size GetNumBytesTransferred() const noexcept { return m_NumBytesTransferred; }
 		inline Buffer* GetFileHash() noexcept { return &m_FileHash; }
-		inline Buffer& GetTransferBuffer() noexcept { return m_TransferBuffer; }
 
 	private:
+		bool MapFile(const bool write) noexcept;
+		void CloseFile() noexcept;
 		bool CalcFileHash(Buffer& hashbuff) noexcept;
 		void TransferEndStats() const noexcept;
 
@@ -98,10 +109,16 @@ namespace TestExtender
 		FileTransferID m_ID{ 0 };
 		Buffer m_FileHash;
 		String m_FileName;
-		std::FILE* m_File{ nullptr };
+		HANDLE m_File{ INVALID_HANDLE_VALUE };
+		HANDLE m_FileMapping{ nullptr };
+		Byte* m_FileView{ nullptr };
 		Size m_FileSize{ 0 };
 		Size m_NumBytesTransferred{ 0 };
-		Buffer m_TransferBuffer;
+		Size m_ChunkSize{ 0 };
+		Size m_WindowSize{ 1 };
+		Size m_NumChunksInFlight{ 0 };
+		bool m_LastChunkSent{ false };
+		std::unique_ptr<HashContext> m_HashContext;
 		SteadyTime m_TransferStartSteadyTime;
 		SteadyTime m_LastActiveSteadyTime;
 	};
@@ -132,7 +149,8 @@ namespace TestExtender
 		FileAccept = WM_USER + 2,
 		ExtenderInit = WM_USER + 3,
 		ExtenderDeinit = WM_USER + 4,
-		PingResult = WM_USER + 5
+		PingResult = WM_USER + 5,
+		LatencyBenchmarkResult = WM_USER + 6
 	};
 
 	struct Event final
@@ -149,6 +167,18 @@ namespace TestExtender
 		std::chrono::milliseconds TimeOut{ 5000 };
 		Buffer Data;
 
+		// For latency benchmarks the echo is sent again as soon
+		// as the reply comes in until all round trips are done
+		Size NumRoundTrips{ 0 };
+		Vector<std::chrono::nanoseconds> RoundTripTimes;
+
+		[[nodiscard]] inline bool IsLatencyBenchmark() const noexcept { return (NumRoundTrips > 0); }
+
+		[[nodiscard]] inline UINT GetResultMessage() const noexcept
+		{
+			return static_cast<UINT>(IsLatencyBenchmark() ? WindowsMessage::LatencyBenchmarkResult : WindowsMessage::PingResult);
+		}
+
 		void Reset()
 		{
 			Active = false;
@@ -157,6 +187,8 @@ namespace TestExtender
 			TimeOut = std::chrono::milliseconds{ 5000 };
 			Data.Clear();
 			Data.FreeUnused();
+			NumRoundTrips = 0;
+			RoundTripTimes.clear();
 		}
 	};
 
@@ -174,6 +206,8 @@ namespace TestExtender
 		inline void SetAutoFileTransferPath(const String& path) { m_AutoFileTransferPath.WithUniqueLock() = path; }
 		inline void SetUseCompression(const bool compression) noexcept { m_UseCompression = compression; }
 		inline bool IsUsingCompression() const noexcept { return m_UseCompression; }
+		inline void SetFileTransferWindowSize(const Size size) noexcept { m_FileTransferWindowSize = (std::max)(size, Size{ 1 }); }
+		inline Size GetFileTransferWindowSize() const noexcept { return m_FileTransferWindowSize; }
 
 		bool SendMessage(const PeerLUID pluid, const String& msg, const SendParameters::PriorityOption priority,
 						 const std::chrono::milliseconds delay) const;
@@ -185,6 +219,8 @@ namespace TestExtender
 		Size GetMaxPingSize() const noexcept;
 		[[nodiscard]] bool IsPingActive() const noexcept;
 
+		bool BenchmarkLatency(const PeerLUID pluid, const Size size, const Size num) noexcept;
+
 		bool SendFile(const PeerLUID pluid, const String filename, const bool autotrf,
 					  const bool benchmark, const Size benchmark_size);
 		bool AcceptFile(const PeerLUID pluid, const FileTransferID ftid, const String& filename);
@@ -211,17 +247,26 @@ namespace TestExtender
 
 		bool SendFileTransferStart(FileTransfer& ft);
 		bool SendFileTransferCancel(FileTransfer& ft) noexcept;
+		static constexpr Size GetFileTransferDataHeaderSize() noexcept
+		{
+			return sizeof(UInt16) + sizeof(FileTransferID) + sizeof(UInt64);
+		}
+
 		Size GetFileTransferDataSize() const noexcept;
 		bool SendFileData(FileTransfer& ft);
+		void ResumeFileTransfers(const PeerLUID pluid);
 		bool SendFileDataAck(FileTransfer& ft) noexcept;
 
 		bool SendEcho(const PeerLUID pluid, const BufferView ping_data) noexcept;
 		bool SendEchoReply(Peer& peer, const BufferView ping_data) noexcept;
 
+		bool ContinueLatencyBenchmark(PingData& ping, const SteadyTime time_received) noexcept;
+
 	private:
 		HWND m_Window{ nullptr };
 
 		std::atomic_bool m_UseCompression{ true };
+		std::atomic<Size> m_FileTransferWindowSize{ 8 };
 		Concurrency::Event m_ShutdownEvent;
 		std::thread m_Thread;
 		Peers_ThS m_Peers;
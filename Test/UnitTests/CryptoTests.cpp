@@ -5,6 +5,8 @@
 #include "Common\Util.h"
 #include "Crypto\Crypto.h"
 
+#include <thread>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace UnitTests
@@ -90,6 +92,103 @@ namespace UnitTests
 			}
 		}
 
+		TEST_METHOD(SymmetricNonce)
+		{
+			String secret{ L"password" };
+
+			Crypto::SymmetricKeyData skd(Crypto::SymmetricKeyType::Derived, Algorithm::Hash::BLAKE2B512,
+										 Algorithm::Symmetric::CHACHA20_POLY1305, Algorithm::Compression::DEFLATE);
+			Crypto::SymmetricKeyData skd2(Crypto::SymmetricKeyType::Derived, Algorithm::Hash::BLAKE2B512,
+										  Algorithm::Symmetric::CHACHA20_POLY1305, Algorithm::Compression::DEFLATE);
+
+			Assert::AreEqual(true,
+							 Crypto::GenerateSymmetricKeys(BufferView(reinterpret_cast<Byte*>(secret.data()),
+																	  secret.size()), skd, skd2));
+
+			// Both keys get their own nonce base
+			Assert::AreEqual(false, skd.NonceBase == skd2.NonceBase);
+			Assert::AreEqual(false, skd.NonceBase == decltype(skd.NonceBase){});
+
+			const auto nonce1 = Crypto::GetSymmetricNonce(skd, 1);
+			const auto nonce2 = Crypto::GetSymmetricNonce(skd, 2);
+			const auto nonce3 = Crypto::GetSymmetricNonce(skd2, 1);
+
+			Assert::AreEqual(true, nonce1.GetSize() == Crypto::SymmetricKeyData::NonceSize);
+
+			// Same key and seed always give the same nonce
+			Assert::AreEqual(true, nonce1 == Crypto::GetSymmetricNonce(skd, 1));
+
+			// Different seeds or keys give different nonces
+			Assert::AreEqual(false, nonce1 == nonce2);
+			Assert::AreEqual(false, nonce1 == nonce3);
+
+			// Seed 0 leaves the nonce base as is
+			Assert::AreEqual(true, BufferView(skd.NonceBase.data(), skd.NonceBase.size()) ==
+							 BufferView(Crypto::GetSymmetricNonce(skd, 0)));
+
+			// Encryption with the nonce works both ways
+			const Buffer input(reinterpret_cast<const Byte*>(secret.data()), secret.size() * sizeof(String::value_type));
+			Buffer eoutbuf, doutbuf;
+
+			Assert::AreEqual(true, Crypto::Encrypt(input, eoutbuf, skd, nonce2));
+			Assert::AreEqual(true, Crypto::Decrypt(eoutbuf, doutbuf, skd, nonce2));
+			Assert::AreEqual(true, (doutbuf == input));
+
+			// Decryption with a nonce from another seed fails
+			Assert::AreEqual(false, Crypto::Decrypt(eoutbuf, doutbuf, skd, nonce1));
+		}
+
+		TEST_METHOD(SymmetricCipherContext)
+		{
+			String secret{ L"password" };
+			const auto secretv = BufferView(reinterpret_cast<Byte*>(secret.data()), secret.size());
+
+			for (const auto sa : { Algorithm::Symmetric::AES256_GCM, Algorithm::Symmetric::CHACHA20_POLY1305 })
+			{
+				// Derived keys get a pre-initialized cipher context, autogen keys
+				// don't; generated from the same secret they have the same key
+				Crypto::SymmetricKeyData skd(Crypto::SymmetricKeyType::Derived, Algorithm::Hash::SHA256, sa,
+											 Algorithm::Compression::DEFLATE);
+				Crypto::SymmetricKeyData skd2(Crypto::SymmetricKeyType::Derived, Algorithm::Hash::SHA256, sa,
+											  Algorithm::Compression::DEFLATE);
+				Crypto::SymmetricKeyData skd_ag(Crypto::SymmetricKeyType::AutoGen, Algorithm::Hash::SHA256, sa,
+												Algorithm::Compression::DEFLATE);
+				Crypto::SymmetricKeyData skd2_ag(Crypto::SymmetricKeyType::AutoGen, Algorithm::Hash::SHA256, sa,
+												 Algorithm::Compression::DEFLATE);
+
+				Assert::AreEqual(true, Crypto::GenerateSymmetricKeys(secretv, skd, skd2));
+				Assert::AreEqual(true, Crypto::GenerateSymmetricKeys(secretv, skd_ag, skd2_ag));
+
+				Assert::AreEqual(true, skd.CipherContext != nullptr && skd2.CipherContext != nullptr);
+				Assert::AreEqual(true, skd_ag.CipherContext == nullptr && skd2_ag.CipherContext == nullptr);
+
+				for (UInt32 x = 0; x < 100; ++x)
+				{
+					// Alternate between keys so that contexts get duplicated again
+					auto& key = (x % 3 == 0) ? skd2 : skd;
+					auto& key_ag = (x % 3 == 0) ? skd2_ag : skd_ag;
+
+					const auto nonce = Crypto::GetSymmetricNonce(key, x);
+					const auto input = Util::GetPseudoRandomBytes(x * 7);
+
+					Buffer eoutbuf, eoutbuf_ag, doutbuf, doutbuf_ag;
+
+					// Both ways of initializing give the same results
+					Assert::AreEqual(true, Crypto::Encrypt(input, eoutbuf, key, nonce));
+					Assert::AreEqual(true, Crypto::Encrypt(input, eoutbuf_ag, key_ag, nonce));
+					Assert::AreEqual(true, eoutbuf == eoutbuf_ag);
+
+					Assert::AreEqual(true, Crypto::Decrypt(eoutbuf, doutbuf, key_ag, nonce));
+					Assert::AreEqual(true, Crypto::Decrypt(eoutbuf_ag, doutbuf_ag, key, nonce));
+					Assert::AreEqual(true, doutbuf == input && doutbuf_ag == input);
+
+					// A failed decryption doesn't affect the next message
+					eoutbuf[0] = eoutbuf[0] ^ Byte{ 0x01 };
+					Assert::AreEqual(false, Crypto::Decrypt(eoutbuf, doutbuf, key, nonce));
+				}
+			}
+		}
+
 		TEST_METHOD(AsymmetricAlgorithms)
 		{
 			Algorithms algs;
@@ -397,5 +496,129 @@ namespace UnitTests
 																		 buffer.size())));
 			}
 		}
+
+		TEST_METHOD(CryptoRandomBytes)
+		{
+			// Statistical tests from FIPS 140-2 on a sample of 20000 bits; the bounds are
+			// wider than the ones in FIPS 140-2 (at least 8 standard deviations from the
+			// expected values) so that good output practically never fails while broken
+			// output still does, since the test can't use a fixed seed
+			const auto test_sample = [](const Buffer& sample)
+			{
+				Assert::AreEqual(static_cast<Size>(2500), sample.GetSize());
+
+				Size ones{ 0 };
+				std::array<Size, 16> nibbles{ 0 };
+				std::array<std::array<Size, 6>, 2> runs{ 0 };
+				Size longest_run{ 0 };
+
+				auto run_bit = 2u;
+				Size run_length{ 0 };
+
+				const auto end_run = [&]()
+				{
+					if (run_length > 0)
+					{
+						++runs[run_bit][std::min(run_length, Size{ 6 }) - 1];
+						longest_run = std::max(longest_run, run_length);
+					}
+				};
+
+				for (Size x = 0; x < sample.GetSize(); ++x)
+				{
+					const auto byte = static_cast<UChar>(sample[x]);
+
+					++nibbles[byte >> 4];
+					++nibbles[byte & 0x0f];
+
+					for (auto b = 7; b >= 0; --b)
+					{
+						const auto bit = static_cast<unsigned int>((byte >> b) & 1);
+						ones += bit;
+
+						if (bit == run_bit) ++run_length;
+						else
+						{
+							end_run();
+							run_bit = bit;
+							run_length = 1;
+						}
+					}
+				}
+
+				end_run();
+
+				// Monobit test
+				Assert::AreEqual(true, ones > 9300 && ones < 10700);
+
+				// Poker test
+				double sum{ 0.0 };
+				for (const auto count : nibbles)
+				{
+					sum += static_cast<double>(count) * static_cast<double>(count);
+				}
+
+				const auto poker = ((16.0 / 5000.0) * sum) - 5000.0;
+				Assert::AreEqual(true, poker > 0.5 && poker < 100.0);
+
+				// Runs test
+				constexpr std::array<std::pair<Size, Size>, 6> run_intervals{
+					std::make_pair(2100, 2900), std::make_pair(970, 1530), std::make_pair(425, 825),
+					std::make_pair(170, 455), std::make_pair(56, 256), std::make_pair(56, 256)
+				};
+
+				for (const auto& bit_runs : runs)
+				{
+					for (Size x = 0; x < bit_runs.size(); ++x)
+					{
+						Assert::AreEqual(true, bit_runs[x] >= run_intervals[x].first &&
+										 bit_runs[x] <= run_intervals[x].second);
+					}
+				}
+
+				// Long run test
+				Assert::AreEqual(true, longest_run < 48);
+			};
+
+			// Large requests spanning multiple buffer refills; each
+			// gets tested as four separate samples
+			for (auto x = 0u; x < 3u; ++x)
+			{
+				const auto bytes = Crypto::GetCryptoRandomBytes(10000);
+				Assert::AreEqual(true, bytes.has_value());
+				Assert::AreEqual(static_cast<Size>(10000), bytes->GetSize());
+
+				for (Size offset = 0; offset < bytes->GetSize(); offset += 2500)
+				{
+					test_sample(Buffer(BufferView(*bytes).GetSub(offset, 2500)));
+				}
+			}
+
+			// Many small requests
+			{
+				Buffer sample;
+				while (sample.GetSize() < 2500)
+				{
+					const auto bytes = Crypto::GetCryptoRandomBytes(std::min(Size{ 7 }, 2500 - sample.GetSize()));
+					Assert::AreEqual(true, bytes.has_value());
+					sample += *bytes;
+				}
+
+				test_sample(sample);
+			}
+
+			// Threads have their own generator state and should get different bytes
+			{
+				std::optional<Buffer> bytes1, bytes2;
+
+				std::thread thread1([&]() { bytes1 = Crypto::GetCryptoRandomBytes(64); });
+				std::thread thread2([&]() { bytes2 = Crypto::GetCryptoRandomBytes(64); });
+				thread1.join();
+				thread2.join();
+
+				Assert::AreEqual(true, bytes1.has_value() && bytes2.has_value());
+				Assert::AreEqual(false, *bytes1 == *bytes2);
+			}
+		}
 	};
 }
\ No newline at end of file
@@ -4,8 +4,11 @@
 #include "pch.h"
 #include "Core\Access\IPFilters.h"
 
+#include <random>
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace QuantumGate::Implementation::Core::Access;
+using namespace QuantumGate::Implementation::Network;
 
 namespace UnitTests
 {
@@ -240,5 +243,151 @@ namespace UnitTests
 				Assert::AreEqual(false, ipfilters.GetAllowed(L"fe80:c11a:3a9c:ef11:e795::f000").GetValue());
 			}
 		}
+
+		TEST_METHOD(Prefixes)
+		{
+			IPFilters ipfilters;
+
+			// Masks should consist of contiguous leading bits
+			IPAddress ip, mask;
+			Assert::AreEqual(true, IPAddress::TryParse(L"192.168.0.0", ip));
+			Assert::AreEqual(true, IPAddress::TryParse(L"255.0.255.0", mask));
+			Assert::AreEqual(true,
+							 ipfilters.AddFilter(ip, mask, IPFilterType::Allowed) == ResultCode::AddressMaskInvalid);
+
+			// Host bits in the filter address don't narrow the range
+			auto result = ipfilters.AddFilter(L"10.1.2.200/16", IPFilterType::Allowed);
+			Assert::AreEqual(true, result.Succeeded());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.1.0.0").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.1.2.100").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.1.255.255").GetValue());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"10.0.255.255").GetValue());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"10.2.0.0").GetValue());
+
+			// Nested ranges
+			auto result2 = ipfilters.AddFilter(L"10.0.0.0/8", IPFilterType::Allowed);
+			Assert::AreEqual(true, result2.Succeeded());
+			auto result3 = ipfilters.AddFilter(L"10.1.2.0/24", IPFilterType::Allowed);
+			Assert::AreEqual(true, result3.Succeeded());
+
+			// Different filter with the same prefix
+			auto result4 = ipfilters.AddFilter(L"10.1.0.0/16", IPFilterType::Allowed);
+			Assert::AreEqual(true, result4.Succeeded());
+
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.0.255.255").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.200.0.1").GetValue());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"11.0.0.0").GetValue());
+
+			// The /16 range is still there after removing the wider /8 range
+			Assert::AreEqual(true, ipfilters.RemoveFilter(*result2, IPFilterType::Allowed).Succeeded());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"10.200.0.1").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.1.200.1").GetValue());
+
+			// The /16 range is still there after removing one of the filters with that prefix
+			Assert::AreEqual(true, ipfilters.RemoveFilter(*result, IPFilterType::Allowed).Succeeded());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.1.200.1").GetValue());
+
+			Assert::AreEqual(true, ipfilters.RemoveFilter(*result4, IPFilterType::Allowed).Succeeded());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"10.1.200.1").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.1.2.1").GetValue());
+
+			Assert::AreEqual(true, ipfilters.RemoveFilter(*result3, IPFilterType::Allowed).Succeeded());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"10.1.2.1").GetValue());
+
+			// Allow everything
+			Assert::AreEqual(true, ipfilters.AddFilter(L"0.0.0.0/0", IPFilterType::Allowed).Succeeded());
+			Assert::AreEqual(true, ipfilters.AddFilter(L"::/0", IPFilterType::Allowed).Succeeded());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"1.2.3.4").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"255.255.255.255").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"fe80::1").GetValue());
+
+			// Blocked ranges of both families
+			Assert::AreEqual(true, ipfilters.AddFilter(L"1.2.3.0/31", IPFilterType::Blocked).Succeeded());
+			Assert::AreEqual(true, ipfilters.AddFilter(L"fe80::/10", IPFilterType::Blocked).Succeeded());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"1.2.3.0").GetValue());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"1.2.3.1").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"1.2.3.2").GetValue());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"febf:ffff::1").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"fec0::1").GetValue());
+
+			ipfilters.Clear();
+
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"1.2.3.2").GetValue());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"fec0::1").GetValue());
+		}
+
+		TEST_METHOD(AddMultiple)
+		{
+			IPFilters ipfilters;
+
+			// Invalid entries leave the filters unchanged
+			Assert::AreEqual(true,
+							 ipfilters.AddFilters({ L"192.168.0.0/16", L"192.168.abc.1/24" },
+												  IPFilterType::Allowed) == ResultCode::AddressInvalid);
+			Assert::AreEqual(true,
+							 ipfilters.AddFilters({ L"192.168.0.0/16", L"10.0.0.0/33" },
+												  IPFilterType::Allowed) == ResultCode::AddressMaskInvalid);
+			Assert::AreEqual(true,
+							 ipfilters.AddFilters({ L"192.168.0.0/16", L"10.0.0.0" },
+												  IPFilterType::Allowed) == ResultCode::InvalidArgument);
+			Assert::AreEqual(static_cast<size_t>(0), ipfilters.GetFilters().GetValue().size());
+
+			auto result = ipfilters.AddFilters({ L"192.168.0.0/16", L" 10.0.0.0/8 ", L"fc00::/7",
+												 L"192.168.0.0/16" }, IPFilterType::Allowed);
+			Assert::AreEqual(true, result.Succeeded());
+
+			// Duplicates only get added once
+			Assert::AreEqual(static_cast<size_t>(4), result->size());
+			Assert::AreEqual(true, result->at(0) == result->at(3));
+			Assert::AreEqual(static_cast<size_t>(3), ipfilters.GetFilters().GetValue().size());
+
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"192.168.100.1").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"10.20.30.40").GetValue());
+			Assert::AreEqual(true, ipfilters.GetAllowed(L"fd00::1").GetValue());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"172.16.0.1").GetValue());
+
+			Assert::AreEqual(true, ipfilters.RemoveFilter(result->at(1), IPFilterType::Allowed).Succeeded());
+			Assert::AreEqual(false, ipfilters.GetAllowed(L"10.20.30.40").GetValue());
+		}
+
+		TEST_METHOD(ManyFilters)
+		{
+			constexpr auto num_filters = 1'000u;
+
+			std::mt19937 rng(1234);
+
+			Vector<String> ip_cidrs;
+			Vector<std::pair<UInt32, UInt32>> networks;
+			ip_cidrs.reserve(num_filters);
+			networks.reserve(num_filters);
+
+			for (auto x = 0u; x < num_filters; ++x)
+			{
+				const auto ip = static_cast<UInt32>(rng());
+				const auto prefix = 16 + (ip % 9);
+				ip_cidrs.emplace_back(std::to_wstring((ip >> 24) & 0xff) + L"." + std::to_wstring((ip >> 16) & 0xff) + L"." +
+									  std::to_wstring((ip >> 8) & 0xff) + L".0/" + std::to_wstring(prefix));
+				networks.emplace_back(ip, prefix);
+			}
+
+			IPFilters ipfilters;
+			Assert::AreEqual(true, ipfilters.AddFilters(ip_cidrs, IPFilterType::Blocked).Succeeded());
+			Assert::AreEqual(true, ipfilters.AddFilter(L"0.0.0.0/0", IPFilterType::Allowed).Succeeded());
+
+			// Lookups should give the same results as checking all filters one by one
+			for (auto x = 0u; x < 10'000u; ++x)
+			{
+				// Half of the addresses are in one of the blocked networks
+				auto ip = static_cast<UInt32>(rng());
+				if (x % 2 == 0) ip = (networks[ip % networks.size()].first & 0xffffff00) | (ip & 0xff);
+
+				const auto blocked = std::any_of(networks.begin(), networks.end(), [&](const auto& network)
+				{
+					return (((ip ^ network.first) >> (32 - network.second)) == 0);
+				});
+
+				Assert::AreEqual(!blocked, ipfilters.GetAllowed(IPAddress(BinaryIPAddress(ip))).GetValue());
+			}
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Core\KeyGeneration\KeyGenerationManager.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Core::KeyGeneration;
+using namespace std::literals;
+
+namespace UnitTests
+{
+	TEST_CLASS(KeyGenerationTests)
+	{
+	public:
+		TEST_METHOD(UpdateTargetSize)
+		{
+			constexpr Size min_size{ 5 };
+			constexpr Size max_size{ 50 };
+
+			auto now = Util::GetCurrentSteadyTime();
+
+			KeyQueue key_queue(Algorithm::Asymmetric::KEM_NTRUPRIME, min_size, now);
+			key_queue.GenerationTime = 500ms;
+
+			// Advances the time by one second during which num requests
+			// were made and updates the target size
+			const auto request = [&](const Size num)
+			{
+				key_queue.NumRequestsInWindow += num;
+				now += 1s;
+				Manager::UpdateTargetSize(key_queue, min_size, max_size, now);
+			};
+
+			// No demand
+			request(0);
+			Assert::AreEqual(true, key_queue.RequestRate == 0.0);
+			Assert::AreEqual(min_size, key_queue.TargetSize);
+
+			// Low demand stays at the minimum
+			request(2);
+			Assert::AreEqual(true, key_queue.RequestRate == 2.0);
+			Assert::AreEqual(min_size, key_queue.TargetSize);
+
+			// The rate follows increases right away; 20 requests per second
+			// for 0.5 seconds of generation time with a headroom factor of 2
+			request(20);
+			Assert::AreEqual(true, key_queue.RequestRate == 20.0);
+			Assert::AreEqual(Size{ 20 }, key_queue.TargetSize);
+
+			// Doesn't grow above the maximum
+			request(1000);
+			Assert::AreEqual(true, key_queue.RequestRate == 1000.0);
+			Assert::AreEqual(max_size, key_queue.TargetSize);
+
+			// Within a sample interval the requests keep counting
+			// and the rate and target size don't change
+			key_queue.NumRequestsInWindow += 10;
+			Manager::UpdateTargetSize(key_queue, min_size, max_size, now + 500ms);
+			Assert::AreEqual(Size{ 10 }, key_queue.NumRequestsInWindow);
+			Assert::AreEqual(true, key_queue.RequestRate == 1000.0);
+			Assert::AreEqual(max_size, key_queue.TargetSize);
+			key_queue.NumRequestsInWindow = 0;
+
+			// When demand goes away the rate decreases slowly
+			request(0);
+			Assert::AreEqual(true, key_queue.RequestRate < 1000.0 && key_queue.RequestRate > 500.0);
+			Assert::AreEqual(max_size, key_queue.TargetSize);
+
+			// and the target size shrinks back to the minimum without
+			// ever going up or leaving the bounds on the way
+			auto previous_size = key_queue.TargetSize;
+			auto shrunk = false;
+
+			for (auto x = 0; x < 300; ++x)
+			{
+				request(0);
+
+				Assert::AreEqual(true, key_queue.TargetSize <= previous_size);
+				Assert::AreEqual(true, key_queue.TargetSize >= min_size && key_queue.TargetSize <= max_size);
+
+				if (key_queue.TargetSize > min_size && key_queue.TargetSize < max_size) shrunk = true;
+
+				previous_size = key_queue.TargetSize;
+			}
+
+			Assert::AreEqual(true, shrunk);
+			Assert::AreEqual(min_size, key_queue.TargetSize);
+
+			// Bursts grow the target size again right away
+			request(30);
+			Assert::AreEqual(Size{ 30 }, key_queue.TargetSize);
+
+			// The minimum applies even without any demand
+			KeyQueue key_queue2(Algorithm::Asymmetric::KEM_NEWHOPE, 0, now);
+			Manager::UpdateTargetSize(key_queue2, min_size, max_size, now + 1s);
+			Assert::AreEqual(min_size, key_queue2.TargetSize);
+		}
+
+		TEST_METHOD(ReturnToQueue)
+		{
+			const auto make_keys = [](const Algorithm::Asymmetric alg)
+			{
+				Crypto::AsymmetricKeyData keydata(alg);
+				keydata.LocalPrivateKey.Allocate(32);
+				keydata.LocalPublicKey.Allocate(32);
+				return keydata;
+			};
+
+			KeyQueue key_queue(Algorithm::Asymmetric::KEM_NTRUPRIME, 2, Util::GetCurrentSteadyTime());
+
+			// Unused keys go back in the queue
+			Assert::AreEqual(true, Manager::ReturnToQueue(key_queue, make_keys(Algorithm::Asymmetric::KEM_NTRUPRIME)));
+			Assert::AreEqual(Size{ 1 }, key_queue.Queue.size());
+
+			// Keys for another algorithm don't
+			Assert::AreEqual(false, Manager::ReturnToQueue(key_queue, make_keys(Algorithm::Asymmetric::KEM_NEWHOPE)));
+			Assert::AreEqual(Size{ 1 }, key_queue.Queue.size());
+
+			// Neither do keys that were released
+			auto keydata = make_keys(Algorithm::Asymmetric::KEM_NTRUPRIME);
+			keydata.ReleaseKeys();
+			Assert::AreEqual(false, Manager::ReturnToQueue(key_queue, std::move(keydata)));
+			Assert::AreEqual(Size{ 1 }, key_queue.Queue.size());
+
+			Assert::AreEqual(true, Manager::ReturnToQueue(key_queue, make_keys(Algorithm::Asymmetric::KEM_NTRUPRIME)));
+			Assert::AreEqual(Size{ 2 }, key_queue.Queue.size());
+
+			// The queue doesn't grow beyond the target size
+			Assert::AreEqual(false, Manager::ReturnToQueue(key_queue, make_keys(Algorithm::Asymmetric::KEM_NTRUPRIME)));
+			Assert::AreEqual(Size{ 2 }, key_queue.Queue.size());
+
+			// Returned keys can be handed out again
+			Assert::AreEqual(true, key_queue.Queue.front().GetAlgorithm() == Algorithm::Asymmetric::KEM_NTRUPRIME);
+			Assert::AreEqual(false, key_queue.Queue.front().LocalPublicKey.IsEmpty());
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Core\ListenerShards.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Core;
+
+namespace UnitTests
+{
+	TEST_CLASS(ListenerShardsTests)
+	{
+	public:
+		TEST_METHOD(GetIndex)
+		{
+			const auto ip1 = IPAddress(L"192.168.1.10");
+			const auto ip2 = IPAddress(L"fe80::c11a:3a9c:ef10:e795");
+
+			// With one shard everything goes to the same shard
+			Assert::AreEqual(true, ListenerShards::GetIndex(ip1, 1) == 0);
+			Assert::AreEqual(true, ListenerShards::GetIndex(ip2, 1) == 0);
+
+			for (Size num_shards = 2; num_shards <= 16; ++num_shards)
+			{
+				// The same IP address always goes to the same shard
+				const auto idx1 = ListenerShards::GetIndex(ip1, num_shards);
+				Assert::AreEqual(true, idx1 < num_shards);
+				Assert::AreEqual(true, ListenerShards::GetIndex(IPAddress(L"192.168.1.10"), num_shards) == idx1);
+
+				const auto idx2 = ListenerShards::GetIndex(ip2, num_shards);
+				Assert::AreEqual(true, idx2 < num_shards);
+				Assert::AreEqual(true, ListenerShards::GetIndex(IPAddress(L"fe80::c11a:3a9c:ef10:e795"), num_shards) == idx2);
+			}
+		}
+
+		TEST_METHOD(Distribution)
+		{
+			constexpr Size num_shards{ 8 };
+			std::array<Size, num_shards> counts{ 0 };
+
+			for (UInt32 x = 0; x < 4096; ++x)
+			{
+				const auto ip = IPAddress(BinaryIPAddress(BinaryIPAddress::Family::IPv4,
+														  static_cast<Byte>(10), static_cast<Byte>(x >> 16),
+														  static_cast<Byte>(x >> 8), static_cast<Byte>(x)));
+
+				++counts[ListenerShards::GetIndex(ip, num_shards)];
+			}
+
+			// Addresses should get spread among all shards
+			for (const auto count : counts)
+			{
+				Assert::AreEqual(true, count > 256);
+				Assert::AreEqual(true, count < 768);
+			}
+		}
+	};
+}
\ No newline at end of file
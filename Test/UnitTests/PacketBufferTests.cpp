@@ -0,0 +1,118 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "..\..\QuantumGateLib\Memory\PacketBuffer.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Memory;
+
+namespace UnitTests
+{
+	TEST_CLASS(PacketBufferTests)
+	{
+	public:
+		TEST_METHOD(General)
+		{
+			const String hdr1txt = L"Header1";
+			const String hdr2txt = L"Hdr2";
+			const String datatxt = L"The payload of the packet";
+			const String trltxt = L"Trailer";
+
+			const auto hdr1 = BufferView(reinterpret_cast<const Byte*>(hdr1txt.data()), hdr1txt.size() * sizeof(String::value_type));
+			const auto hdr2 = BufferView(reinterpret_cast<const Byte*>(hdr2txt.data()), hdr2txt.size() * sizeof(String::value_type));
+			const auto data = BufferView(reinterpret_cast<const Byte*>(datatxt.data()), datatxt.size() * sizeof(String::value_type));
+			const auto trl = BufferView(reinterpret_cast<const Byte*>(trltxt.data()), trltxt.size() * sizeof(String::value_type));
+
+			// Default constructor
+			PacketBuffer pb1;
+			Assert::AreEqual(true, pb1.IsEmpty());
+			Assert::AreEqual(false, pb1.operator bool());
+			Assert::AreEqual(true, pb1.GetSize() == 0);
+			Assert::AreEqual(true, pb1.GetHeadroom() == 0);
+
+			// Headroom and tailroom
+			PacketBuffer pb2(hdr1.GetSize() + hdr2.GetSize(), data.GetSize() + trl.GetSize());
+			Assert::AreEqual(true, pb2.IsEmpty());
+			Assert::AreEqual(true, pb2.GetHeadroom() == hdr1.GetSize() + hdr2.GetSize());
+			Assert::AreEqual(true, pb2.GetTailroom() >= data.GetSize() + trl.GetSize());
+
+			// Data shouldn't move when prepending and appending within the reserved room
+			pb2 += data;
+			const auto data_ptr = pb2.GetBytes();
+			Assert::AreEqual(true, pb2 == data);
+
+			pb2.Prepend(hdr2);
+			pb2.Prepend(hdr1);
+			pb2.Append(trl);
+			Assert::AreEqual(true, pb2.GetHeadroom() == 0);
+			Assert::AreEqual(true, pb2.GetBytes() + hdr1.GetSize() + hdr2.GetSize() == data_ptr);
+			Assert::AreEqual(true, pb2.GetSize() == hdr1.GetSize() + hdr2.GetSize() + data.GetSize() + trl.GetSize());
+
+			Buffer check;
+			check += hdr1;
+			check += hdr2;
+			check += data;
+			check += trl;
+			Assert::AreEqual(true, pb2 == BufferView(check));
+
+			// Removing data from the front and back
+			pb2.RemoveFirst(hdr1.GetSize());
+			Assert::AreEqual(true, pb2.GetHeadroom() == hdr1.GetSize());
+			pb2.RemoveFirst(hdr2.GetSize());
+			pb2.RemoveLast(trl.GetSize());
+			Assert::AreEqual(true, pb2 == data);
+			Assert::AreEqual(true, pb2.GetBytes() == data_ptr);
+
+			// Prepending more than the headroom moves the data
+			pb2.Prepend(hdr1);
+			pb2.Prepend(hdr2);
+			Assert::AreEqual(true, pb2.GetSize() == hdr2.GetSize() + hdr1.GetSize() + data.GetSize());
+			Assert::AreEqual(true, BufferView(pb2).GetFirst(hdr2.GetSize()) == hdr2);
+			Assert::AreEqual(true, BufferView(pb2).GetSub(hdr2.GetSize(), hdr1.GetSize()) == hdr1);
+			Assert::AreEqual(true, BufferView(pb2).GetLast(data.GetSize()) == data);
+
+			// Prepending and appending space
+			PacketBuffer pb3(8);
+			auto span = pb3.Prepend(4);
+			Assert::AreEqual(true, span.GetSize() == 4);
+			std::memset(span.GetBytes(), 0xAA, span.GetSize());
+			auto span2 = pb3.Append(4);
+			Assert::AreEqual(true, span2.GetSize() == 4);
+			Assert::AreEqual(true, pb3.GetSize() == 8);
+			Assert::AreEqual(true, pb3[0] == Byte{ 0xAA } && pb3[3] == Byte{ 0xAA });
+			Assert::AreEqual(true, pb3[4] == Byte{ 0 } && pb3[7] == Byte{ 0 });
+
+			// Copy constructor
+			PacketBuffer pb4(pb2);
+			Assert::AreEqual(true, pb4 == BufferView(pb2));
+			Assert::AreEqual(true, pb4.GetHeadroom() == pb2.GetHeadroom());
+
+			// Move constructor
+			PacketBuffer pb5(std::move(pb4));
+			Assert::AreEqual(true, pb5 == BufferView(pb2));
+			Assert::AreEqual(true, pb4.IsEmpty());
+			Assert::AreEqual(true, pb4.GetHeadroom() == 0);
+
+			// Conversion from and to Buffer
+			pb5.RemoveFirst(hdr2.GetSize() + hdr1.GetSize());
+			auto b1 = pb5.MoveToBuffer();
+			Assert::AreEqual(true, b1 == data);
+			Assert::AreEqual(true, pb5.IsEmpty());
+
+			PacketBuffer pb6(std::move(b1));
+			Assert::AreEqual(true, pb6 == data);
+			Assert::AreEqual(true, b1.IsEmpty());
+
+			PacketBuffer pb7(data, 16, 16);
+			Assert::AreEqual(true, pb7 == data);
+			Assert::AreEqual(true, pb7.GetHeadroom() == 16);
+			Assert::AreEqual(true, pb7.GetTailroom() >= 16);
+
+			// Clear keeps the headroom
+			pb7.Clear();
+			Assert::AreEqual(true, pb7.IsEmpty());
+			Assert::AreEqual(true, pb7.GetHeadroom() == 16);
+		}
+	};
+}
\ No newline at end of file
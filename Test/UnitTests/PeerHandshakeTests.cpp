@@ -0,0 +1,156 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Core\Peer\PeerHandshake.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Core::Peer;
+
+namespace UnitTests
+{
+	TEST_CLASS(PeerHandshakeTests)
+	{
+	public:
+		TEST_METHOD(TaskCompare)
+		{
+			const auto task = [](const bool outbound, const Status status, const UInt64 sequence)
+			{
+				return HandshakeTask{ .Outbound = outbound, .Status = status, .Sequence = sequence };
+			};
+
+			// Outbound goes first regardless of status and order
+			Assert::AreEqual(true, HandshakeTask::Compare(task(false, Status::SessionInit, 0),
+														  task(true, Status::MetaExchange, 1)));
+			Assert::AreEqual(false, HandshakeTask::Compare(task(true, Status::MetaExchange, 1),
+														   task(false, Status::SessionInit, 0)));
+
+			// Then handshakes that are further along
+			Assert::AreEqual(true, HandshakeTask::Compare(task(false, Status::MetaExchange, 0),
+														  task(false, Status::Authentication, 1)));
+			Assert::AreEqual(false, HandshakeTask::Compare(task(false, Status::Authentication, 1),
+														   task(false, Status::MetaExchange, 0)));
+			Assert::AreEqual(true, HandshakeTask::Compare(task(true, Status::PrimaryKeyExchange, 0),
+														  task(true, Status::SecondaryKeyExchange, 1)));
+
+			// Then first in, first out
+			Assert::AreEqual(true, HandshakeTask::Compare(task(false, Status::MetaExchange, 1),
+														  task(false, Status::MetaExchange, 0)));
+			Assert::AreEqual(false, HandshakeTask::Compare(task(false, Status::MetaExchange, 0),
+														   task(false, Status::MetaExchange, 1)));
+
+			// Strict weak ordering; a task doesn't go before itself
+			const auto t = task(true, Status::Authentication, 5);
+			Assert::AreEqual(false, HandshakeTask::Compare(t, t));
+		}
+
+		TEST_METHOD(TaskQueueOrder)
+		{
+			Containers::PriorityQueue<HandshakeTask, Vector<HandshakeTask>,
+				decltype(&HandshakeTask::Compare)> queue{ &HandshakeTask::Compare };
+
+			UInt64 sequence{ 0 };
+			const auto push = [&](const bool outbound, const Status status)
+			{
+				queue.push(HandshakeTask{ .Outbound = outbound, .Status = status, .Sequence = sequence++ });
+			};
+
+			push(false, Status::MetaExchange);			// 0
+			push(false, Status::Authentication);		// 1
+			push(true, Status::MetaExchange);			// 2
+			push(false, Status::MetaExchange);			// 3
+			push(true, Status::SessionInit);			// 4
+			push(false, Status::Authentication);		// 5
+			push(true, Status::MetaExchange);			// 6
+
+			const std::array<UInt64, 7> expected{ 4, 2, 6, 1, 5, 0, 3 };
+
+			for (const auto seq : expected)
+			{
+				Assert::AreEqual(false, queue.empty());
+				Assert::AreEqual(seq, queue.top().Sequence);
+				queue.pop();
+			}
+
+			Assert::AreEqual(true, queue.empty());
+		}
+
+		TEST_METHOD(Admission)
+		{
+			constexpr Size max_num{ 3 };
+
+			HandshakeAdmission admission;
+			Assert::AreEqual(Size{ 0 }, admission.GetNumInProgress());
+			Assert::AreEqual(true, admission.CanAdmit(max_num));
+
+			// Admits up to the maximum
+			for (Size x = 0; x < max_num; ++x)
+			{
+				Assert::AreEqual(true, admission.TryAdmit(max_num));
+			}
+
+			Assert::AreEqual(max_num, admission.GetNumInProgress());
+			Assert::AreEqual(false, admission.CanAdmit(max_num));
+
+			// Rejects beyond the maximum without changing the count
+			Assert::AreEqual(false, admission.TryAdmit(max_num));
+			Assert::AreEqual(false, admission.TryAdmit(max_num));
+			Assert::AreEqual(max_num, admission.GetNumInProgress());
+
+			// A handshake ending (ready or disconnected) makes room for another
+			admission.Release();
+			Assert::AreEqual(max_num - 1, admission.GetNumInProgress());
+			Assert::AreEqual(true, admission.CanAdmit(max_num));
+			Assert::AreEqual(true, admission.TryAdmit(max_num));
+			Assert::AreEqual(false, admission.TryAdmit(max_num));
+
+			// A lower maximum (settings changed) applies right away
+			Assert::AreEqual(false, admission.TryAdmit(1));
+
+			for (Size x = 0; x < max_num; ++x) admission.Release();
+
+			Assert::AreEqual(Size{ 0 }, admission.GetNumInProgress());
+
+			admission.Reset();
+			Assert::AreEqual(Size{ 0 }, admission.GetNumInProgress());
+		}
+
+		TEST_METHOD(AdmissionConcurrent)
+		{
+			constexpr Size max_num{ 10 };
+			constexpr auto num_threads = 8;
+			constexpr auto num_iterations = 10'000;
+
+			HandshakeAdmission admission;
+			std::atomic<Size> num_admitted{ 0 };
+			std::atomic<Size> max_admitted{ 0 };
+
+			Vector<std::thread> threads;
+
+			for (auto x = 0; x < num_threads; ++x)
+			{
+				threads.emplace_back([&]()
+				{
+					for (auto y = 0; y < num_iterations; ++y)
+					{
+						if (admission.TryAdmit(max_num))
+						{
+							const auto num = ++num_admitted;
+							auto prev_max = max_admitted.load();
+							while (num > prev_max && !max_admitted.compare_exchange_weak(prev_max, num)) {}
+
+							--num_admitted;
+							admission.Release();
+						}
+					}
+				});
+			}
+
+			for (auto& thread : threads) thread.join();
+
+			// There were never more admitted handshakes than the maximum
+			Assert::AreEqual(Size{ 0 }, admission.GetNumInProgress());
+			Assert::AreEqual(true, max_admitted.load() > 0 && max_admitted.load() <= max_num);
+		}
+	};
+}
\ No newline at end of file
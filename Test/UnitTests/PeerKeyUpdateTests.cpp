@@ -0,0 +1,43 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Core\Peer\PeerKeyUpdate.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Core::Peer;
+using namespace std::literals;
+
+namespace UnitTests
+{
+	TEST_CLASS(PeerKeyUpdateTests)
+	{
+	public:
+		TEST_METHOD(PrefetchWindow)
+		{
+			const auto now = Util::GetCurrentSteadyTime();
+
+			// Update scheduled for 300 seconds from now (the minimum interval)
+			// up to 1200 seconds from now (the maximum interval)
+			for (const auto interval : { 300s, 750s, 1200s })
+			{
+				const auto update_time = now + interval;
+
+				// Not at 75% of the minimum interval or any time
+				// well before the update is scheduled
+				Assert::AreEqual(false, KeyUpdate::IsWithinPrefetchWindow(now, update_time));
+				Assert::AreEqual(false, KeyUpdate::IsWithinPrefetchWindow(now + 225s, update_time));
+				Assert::AreEqual(false, KeyUpdate::IsWithinPrefetchWindow(update_time - 60s, update_time));
+				Assert::AreEqual(false, KeyUpdate::IsWithinPrefetchWindow(update_time - 11s, update_time));
+
+				// Only shortly before the update
+				Assert::AreEqual(true, KeyUpdate::IsWithinPrefetchWindow(update_time - 10s, update_time));
+				Assert::AreEqual(true, KeyUpdate::IsWithinPrefetchWindow(update_time - 1s, update_time));
+
+				// and when the update is late
+				Assert::AreEqual(true, KeyUpdate::IsWithinPrefetchWindow(update_time, update_time));
+				Assert::AreEqual(true, KeyUpdate::IsWithinPrefetchWindow(update_time + 5s, update_time));
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Core\Peer\PeerThreadPoolBalance.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Core::Peer;
+using namespace std::literals;
+
+namespace UnitTests
+{
+	TEST_CLASS(PeerThreadPoolBalanceTests)
+	{
+	public:
+		TEST_METHOD(SelectThreadPools)
+		{
+			const auto thpool = [](const UInt64 key, const std::chrono::nanoseconds busy_time)
+			{
+				return ThreadPoolBalance::ThreadPool{ .Key = key, .Load = ThreadPoolLoad{ .BusyTime = busy_time } };
+			};
+
+			const std::chrono::nanoseconds interval = ThreadPoolBalance::Interval;
+
+			// Nothing to spread the load over
+			Assert::AreEqual(false, ThreadPoolBalance::SelectThreadPools({}, interval).has_value());
+			Assert::AreEqual(false, ThreadPoolBalance::SelectThreadPools({ thpool(1, 5s) }, interval).has_value());
+
+			// Busiest threadpool isn't busy enough during the interval
+			Assert::AreEqual(false, ThreadPoolBalance::SelectThreadPools({ thpool(1, 499ms), thpool(2, 0ms) },
+																		 interval).has_value());
+
+			// Difference in load is too small
+			Assert::AreEqual(false, ThreadPoolBalance::SelectThreadPools({ thpool(1, 1000ms), thpool(2, 700ms) },
+																		 interval).has_value());
+
+			// Busy enough and large enough difference in load
+			{
+				const auto move = ThreadPoolBalance::SelectThreadPools({ thpool(1, 500ms), thpool(2, 0ms) }, interval);
+				Assert::AreEqual(true, move.has_value());
+				Assert::AreEqual(true, move->From.Key == 1 && move->To.Key == 2);
+				Assert::AreEqual(true, move->MaxPeerBusyTime == 250ms);
+			}
+
+			{
+				const auto move = ThreadPoolBalance::SelectThreadPools({ thpool(1, 1000ms), thpool(2, 3000ms),
+																		 thpool(3, 2000ms) }, interval);
+				Assert::AreEqual(true, move.has_value());
+				Assert::AreEqual(true, move->From.Key == 2 && move->To.Key == 1);
+				Assert::AreEqual(true, move->MaxPeerBusyTime == 1000ms);
+			}
+
+			// Once a peer with half the difference in load has moved the
+			// threadpools are even and nothing moves back
+			Assert::AreEqual(false, ThreadPoolBalance::SelectThreadPools({ thpool(1, 2000ms), thpool(2, 2000ms) },
+																		 interval).has_value());
+
+			// Or when a peer with somewhat less load than that moved
+			Assert::AreEqual(false, ThreadPoolBalance::SelectThreadPools({ thpool(1, 1700ms), thpool(2, 2300ms) },
+																		 interval).has_value());
+		}
+
+		TEST_METHOD(SelectThreadPoolsOnNode)
+		{
+			const auto thpool = [](const UInt64 key, const UInt16 node, const std::chrono::nanoseconds busy_time)
+			{
+				return ThreadPoolBalance::ThreadPool{ .Key = key, .Node = node,
+													  .Load = ThreadPoolLoad{ .BusyTime = busy_time } };
+			};
+
+			const std::chrono::nanoseconds interval = ThreadPoolBalance::Interval;
+
+			// Peers don't get moved to another node
+			Assert::AreEqual(false, ThreadPoolBalance::SelectThreadPools({ thpool(1, 0, 3000ms), thpool(2, 1, 0ms) },
+																		 interval).has_value());
+			Assert::AreEqual(false, ThreadPoolBalance::SelectThreadPools({ thpool(1, 0, 3000ms), thpool(2, 0, 2500ms),
+																		   thpool(3, 1, 0ms), thpool(4, 1, 0ms) },
+																		 interval).has_value());
+
+			// Only between threadpools on the same node
+			{
+				const auto move = ThreadPoolBalance::SelectThreadPools({ thpool(1, 0, 3000ms), thpool(2, 1, 1000ms),
+																		 thpool(3, 0, 1500ms), thpool(4, 1, 0ms) },
+																	   interval);
+				Assert::AreEqual(true, move.has_value());
+				Assert::AreEqual(true, move->From.Key == 1 && move->To.Key == 3);
+				Assert::AreEqual(true, move->MaxPeerBusyTime == 750ms);
+			}
+
+			// On the node with the largest difference in load
+			{
+				const auto move = ThreadPoolBalance::SelectThreadPools({ thpool(1, 0, 3000ms), thpool(2, 1, 4000ms),
+																		 thpool(3, 0, 1500ms), thpool(4, 1, 0ms) },
+																	   interval);
+				Assert::AreEqual(true, move.has_value());
+				Assert::AreEqual(true, move->From.Key == 2 && move->To.Key == 4);
+				Assert::AreEqual(true, move->MaxPeerBusyTime == 2000ms);
+			}
+		}
+
+		TEST_METHOD(IsBetterPeer)
+		{
+			const auto load = [](const std::chrono::nanoseconds busy_time)
+			{
+				return ThreadPoolLoad{ .BusyTime = busy_time };
+			};
+
+			const ThreadPoolBalance::Move move{ .From = { .Key = 1 }, .To = { .Key = 2 }, .MaxPeerBusyTime = 250ms };
+			const std::chrono::nanoseconds min_duration = ThreadPoolBalance::PeerMinDuration;
+
+			// Largest load up to the maximum gets chosen
+			Assert::AreEqual(true, ThreadPoolBalance::IsBetterPeer(move, load(100ms), min_duration, load(0ms)));
+			Assert::AreEqual(true, ThreadPoolBalance::IsBetterPeer(move, load(250ms), min_duration, load(100ms)));
+			Assert::AreEqual(false, ThreadPoolBalance::IsBetterPeer(move, load(100ms), min_duration, load(200ms)));
+			Assert::AreEqual(false, ThreadPoolBalance::IsBetterPeer(move, load(100ms), min_duration, load(100ms)));
+
+			// Peers with more load than the maximum don't get moved
+			Assert::AreEqual(false, ThreadPoolBalance::IsBetterPeer(move, load(251ms), min_duration, load(0ms)));
+
+			// Peers without load don't get moved
+			Assert::AreEqual(false, ThreadPoolBalance::IsBetterPeer(move, load(0ms), min_duration, load(0ms)));
+
+			// Peers that were recently added or moved stay where they are
+			Assert::AreEqual(false, ThreadPoolBalance::IsBetterPeer(move, load(100ms), min_duration - 1ms, load(0ms)));
+			Assert::AreEqual(true, ThreadPoolBalance::IsBetterPeer(move, load(100ms), min_duration + 1ms, load(0ms)));
+		}
+	};
+}
\ No newline at end of file
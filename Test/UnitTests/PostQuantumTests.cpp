@@ -0,0 +1,243 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Common\Util.h"
+#include "Common\ScopeGuard.h"
+#include "..\..\QuantumGateCryptoLib\QuantumGateCryptoLib.h"
+
+extern "C"
+{
+#include "..\..\QuantumGateCryptoLib\NTRUPrime\sntrup857\ref\kernels.h"
+#include "..\..\QuantumGateCryptoLib\NewHope\ref\poly.h"
+#include "..\..\QuantumGateCryptoLib\NewHope\ref\ntt.h"
+}
+
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	struct KEMAlgorithm final
+	{
+		const WChar* Name{ nullptr };
+		Size PublicKeySize{ 0 };
+		Size SecretKeySize{ 0 };
+		Size CiphertextSize{ 0 };
+		Size SharedSecretSize{ 0 };
+		int (*KeyPair)(unsigned char*, unsigned char*) { nullptr };
+		int (*Encrypt)(unsigned char*, unsigned char*, const unsigned char*) { nullptr };
+		int (*Decrypt)(unsigned char*, const unsigned char*, const unsigned char*) { nullptr };
+	};
+
+	const std::vector<KEMAlgorithm> KEMAlgorithms =
+	{
+		{
+			L"NTRUPrime sntrup857",
+			crypto_kem_sntrup857_PUBLICKEYBYTES, crypto_kem_sntrup857_SECRETKEYBYTES,
+			crypto_kem_sntrup857_CIPHERTEXTBYTES, crypto_kem_sntrup857_BYTES,
+			&crypto_kem_sntrup857_keypair, &crypto_kem_sntrup857_enc, &crypto_kem_sntrup857_dec
+		},
+		{
+			L"NewHope",
+			NEWHOPE_CCAKEM_PUBLICKEYBYTES, NEWHOPE_CCAKEM_SECRETKEYBYTES,
+			NEWHOPE_CCAKEM_CIPHERTEXTBYTES, NEWHOPE_SYMBYTES,
+			&crypto_kem_newhope_keypair, &crypto_kem_newhope_enc, &crypto_kem_newhope_dec
+		},
+		{
+			L"McEliece mceliece8192128",
+			crypto_kem_mceliece8192128_PUBLICKEYBYTES, crypto_kem_mceliece8192128_SECRETKEYBYTES,
+			crypto_kem_mceliece8192128_CIPHERTEXTBYTES, crypto_kem_mceliece8192128_BYTES,
+			&crypto_kem_mceliece8192128_keypair, &crypto_kem_mceliece8192128_enc, &crypto_kem_mceliece8192128_dec
+		}
+	};
+
+	TEST_CLASS(PostQuantumTests)
+	{
+	public:
+		TEST_METHOD(OptimizedMatchesReference)
+		{
+			// Restore default when done
+			const auto sg = MakeScopeGuard([&] { QGCryptoSetUseOptimized(true); });
+
+			for (const auto& alg : KEMAlgorithms)
+			{
+				// Keys generated by one implementation should work with the other
+				// and both implementations should arrive at the same shared secret,
+				// including the implicit rejection value for a tampered ciphertext
+				for (const auto keypair_optimized : { true, false })
+				{
+					std::vector<unsigned char> pk(alg.PublicKeySize);
+					std::vector<unsigned char> sk(alg.SecretKeySize);
+					std::vector<unsigned char> ct(alg.CiphertextSize);
+					std::vector<unsigned char> ss(alg.SharedSecretSize);
+					std::vector<unsigned char> ss_ref(alg.SharedSecretSize);
+					std::vector<unsigned char> ss_opt(alg.SharedSecretSize);
+
+					QGCryptoSetUseOptimized(keypair_optimized);
+					Assert::AreEqual(0, alg.KeyPair(pk.data(), sk.data()));
+
+					QGCryptoSetUseOptimized(!keypair_optimized);
+					Assert::AreEqual(0, alg.Encrypt(ct.data(), ss.data(), pk.data()));
+
+					QGCryptoSetUseOptimized(false);
+					Assert::AreEqual(0, alg.Decrypt(ss_ref.data(), ct.data(), sk.data()));
+
+					QGCryptoSetUseOptimized(true);
+					Assert::AreEqual(0, alg.Decrypt(ss_opt.data(), ct.data(), sk.data()));
+
+					Assert::AreEqual(true, ss == ss_ref);
+					Assert::AreEqual(true, ss == ss_opt);
+
+					ct[ct.size() / 2] ^= 0x01;
+
+					QGCryptoSetUseOptimized(false);
+					DiscardReturnValue(alg.Decrypt(ss_ref.data(), ct.data(), sk.data()));
+
+					QGCryptoSetUseOptimized(true);
+					DiscardReturnValue(alg.Decrypt(ss_opt.data(), ct.data(), sk.data()));
+
+					Assert::AreEqual(false, ss == ss_ref);
+					Assert::AreEqual(true, ss_ref == ss_opt);
+				}
+			}
+		}
+
+		TEST_METHOD(NTRUPrimeKernelsMatchReference)
+		{
+			// Restore default when done
+			const auto sg = MakeScopeGuard([&] { QGCryptoSetUseOptimized(true); });
+
+			QGCryptoSetUseOptimized(true);
+			if (!QGCryptoUseAVX2())
+			{
+				Logger::WriteMessage("AVX2 is not supported on this CPU; skipping test\n");
+				return;
+			}
+
+			constexpr auto p = 857;
+			constexpr auto q12 = (5167 - 1) / 2;
+
+			using SmallPoly = std::array<Int8, p>;
+			using FqPoly = std::array<Int16, p>;
+
+			// The round trips in OptimizedMatchesReference can't catch a kernel
+			// bug that encoding and decoding share, so compare the outputs of
+			// the kernels themselves for the same inputs
+			const auto check = [](auto&& kernel, auto& out_ref, auto& out_avx2)
+			{
+				QGCryptoSetUseOptimized(false);
+				const auto ret_ref = kernel(out_ref.data());
+
+				QGCryptoSetUseOptimized(true);
+				const auto ret_avx2 = kernel(out_avx2.data());
+
+				Assert::AreEqual(ret_ref, ret_avx2);
+				Assert::AreEqual(true, out_ref == out_avx2);
+			};
+
+			std::mt19937 rng(1234);
+
+			for (auto x = 0; x < 100; ++x)
+			{
+				SmallPoly f{};
+				SmallPoly g{};
+				FqPoly fq{};
+
+				switch (x)
+				{
+					case 0:
+						// Extremes, where the intermediate sums are largest
+						f.fill(1);
+						g.fill(1);
+						fq.fill(q12);
+						break;
+					case 1:
+						f.fill(-1);
+						g.fill(1);
+						fq.fill(-q12);
+						break;
+					case 2:
+						// All zeros; not invertible
+						break;
+					default:
+						for (auto& c : f) c = static_cast<Int8>(static_cast<int>(rng() % 3) - 1);
+						for (auto& c : g) c = static_cast<Int8>(static_cast<int>(rng() % 3) - 1);
+						for (auto& c : fq) c = static_cast<Int16>(static_cast<int>(rng() % (2 * q12 + 1)) - q12);
+						break;
+				}
+
+				SmallPoly small_ref{};
+				SmallPoly small_avx2{};
+				FqPoly fq_ref{};
+				FqPoly fq_avx2{};
+
+				check([&](Int8* h) { sntrup857_ref_R3_mult(h, f.data(), g.data()); return 0; }, small_ref, small_avx2);
+				check([&](Int8* out) { return sntrup857_ref_R3_recip(out, f.data()); }, small_ref, small_avx2);
+				check([&](Int16* h) { sntrup857_ref_Rq_mult_small(h, fq.data(), g.data()); return 0; }, fq_ref, fq_avx2);
+				check([&](Int16* out) { return sntrup857_ref_Rq_recip3(out, f.data()); }, fq_ref, fq_avx2);
+			}
+		}
+
+		TEST_METHOD(NewHopeKernelsMatchReference)
+		{
+			// Restore default when done
+			const auto sg = MakeScopeGuard([&] { QGCryptoSetUseOptimized(true); });
+
+			QGCryptoSetUseOptimized(true);
+			if (!QGCryptoUseAVX2())
+			{
+				Logger::WriteMessage("AVX2 is not supported on this CPU; skipping test\n");
+				return;
+			}
+
+			// Runs the kernel on copies of the input with the reference
+			// implementation and with the AVX2 kernel and compares the outputs
+			const auto check = [](auto&& kernel, const poly& in)
+			{
+				poly out_ref = in;
+				poly out_avx2 = in;
+
+				QGCryptoSetUseOptimized(false);
+				kernel(out_ref);
+
+				QGCryptoSetUseOptimized(true);
+				kernel(out_avx2);
+
+				Assert::AreEqual(0, std::memcmp(out_ref.coeffs, out_avx2.coeffs, sizeof(out_ref.coeffs)));
+			};
+
+			std::mt19937 rng(1234);
+
+			for (auto x = 0; x < 100; ++x)
+			{
+				poly a{};
+				poly b{};
+
+				switch (x)
+				{
+					case 0:
+						for (auto& c : a.coeffs) c = NEWHOPE_Q - 1;
+						for (auto& c : b.coeffs) c = NEWHOPE_Q - 1;
+						break;
+					case 1:
+						// All zeros
+						break;
+					default:
+						for (auto& c : a.coeffs) c = static_cast<UInt16>(rng() % NEWHOPE_Q);
+						for (auto& c : b.coeffs) c = static_cast<UInt16>(rng() % NEWHOPE_Q);
+						break;
+				}
+
+				check([](poly& r) { ntt(r.coeffs, gammas_bitrev_montgomery); }, a);
+				check([](poly& r) { ntt(r.coeffs, omegas_inv_bitrev_montgomery); }, a);
+				check([&](poly& r) { mul_coefficients(r.coeffs, b.coeffs); }, a);
+				check([](poly& r) { mul_coefficients(r.coeffs, gammas_inv_montgomery); }, a);
+				check([&](poly& r) { poly_mul_pointwise(&r, &a, &b); }, a);
+				check([](poly& r) { poly_ntt(&r); }, a);
+				check([](poly& r) { poly_invntt(&r); }, a);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Memory\ProtectedFreeStoreAllocator.h"
+
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Memory;
+
+namespace UnitTests
+{
+	TEST_CLASS(ProtectedFreeStoreAllocatorTests)
+	{
+	public:
+		using Allocator = ProtectedFreeStoreAllocator<Byte>;
+		using Base = ProtectedFreeStoreAllocatorBase;
+
+		TEST_METHOD(SizeClasses)
+		{
+			// Smallest requests share the smallest size class
+			Assert::AreEqual(std::size_t{ 0 }, Base::GetSlabSizeClass(0));
+			Assert::AreEqual(std::size_t{ 0 }, Base::GetSlabSizeClass(1));
+			Assert::AreEqual(std::size_t{ 0 }, Base::GetSlabSizeClass(Base::MinimumSlabBlockSize));
+
+			// Sizes get rounded up to the next power of 2
+			Assert::AreEqual(std::size_t{ 1 }, Base::GetSlabSizeClass(17));
+			Assert::AreEqual(std::size_t{ 1 }, Base::GetSlabSizeClass(32));
+			Assert::AreEqual(std::size_t{ 2 }, Base::GetSlabSizeClass(33));
+			Assert::AreEqual(Base::NumSlabSizeClasses - 1, Base::GetSlabSizeClass(Base::MaximumSlabAllocationSize));
+
+			Assert::AreEqual(Base::MinimumSlabBlockSize, Base::GetSlabBlockSize(0));
+			Assert::AreEqual(Base::MaximumSlabAllocationSize, Base::GetSlabBlockSize(Base::NumSlabSizeClasses - 1));
+
+			// Every size fits in its block, with less than half of it unused
+			for (std::size_t len = 1; len <= Base::MaximumSlabAllocationSize; ++len)
+			{
+				const auto block_size = Base::GetSlabBlockSize(Base::GetSlabSizeClass(len));
+				Assert::AreEqual(true, block_size >= len);
+				Assert::AreEqual(true, len <= Base::MinimumSlabBlockSize || block_size < len * 2);
+			}
+
+			// Blocks of a size class are spaced by the block size
+			Allocator alloc;
+			auto p1 = alloc.allocate(100);
+			auto p2 = alloc.allocate(100);
+
+			const auto distance = static_cast<std::size_t>(std::abs(p2 - p1));
+			Assert::AreEqual(true, distance % Base::GetSlabBlockSize(Base::GetSlabSizeClass(100)) == 0);
+
+			alloc.deallocate(p1, 100);
+			alloc.deallocate(p2, 100);
+		}
+
+		TEST_METHOD(ZeroOnFree)
+		{
+			Allocator alloc;
+
+			for (const auto len : { std::size_t{ 1 }, std::size_t{ 24 }, std::size_t{ 256 },
+				 Base::MaximumSlabAllocationSize })
+			{
+				auto p = alloc.allocate(len);
+				std::memset(p, 0xAA, len);
+				alloc.deallocate(p, len);
+
+				// The block that was just freed comes back
+				// from the thread cache and should be wiped
+				auto p2 = alloc.allocate(len);
+				Assert::AreEqual(true, p == p2);
+
+				const auto block_size = Base::GetSlabBlockSize(Base::GetSlabSizeClass(len));
+				for (std::size_t x = 0; x < block_size; ++x)
+				{
+					Assert::AreEqual(true, p2[x] == Byte{ 0 });
+				}
+
+				alloc.deallocate(p2, len);
+			}
+		}
+
+		TEST_METHOD(CrossThreadFree)
+		{
+			constexpr std::size_t len{ 64 };
+			constexpr std::size_t num{ 1000 };
+
+			std::vector<Byte*> blocks;
+			auto intact = true;
+
+			std::thread thread1([&]()
+			{
+				Allocator alloc;
+
+				for (std::size_t x = 0; x < num; ++x)
+				{
+					auto p = alloc.allocate(len);
+					std::memset(p, static_cast<int>(x & 0xFF), len);
+					blocks.emplace_back(p);
+				}
+			});
+
+			thread1.join();
+
+			std::thread thread2([&]()
+			{
+				Allocator alloc;
+
+				for (std::size_t x = 0; x < num; ++x)
+				{
+					if (blocks[x][len - 1] != static_cast<Byte>(x & 0xFF)) intact = false;
+
+					alloc.deallocate(blocks[x], len);
+				}
+			});
+
+			thread2.join();
+
+			// Contents were intact when freed by the other thread
+			Assert::AreEqual(true, intact);
+
+			// Freed blocks can be used again
+			Allocator alloc;
+			std::vector<Byte*> blocks2;
+
+			for (std::size_t x = 0; x < num; ++x)
+			{
+				auto p = alloc.allocate(len);
+				Assert::AreEqual(true, p[len - 1] == Byte{ 0 });
+				std::memset(p, 0xBB, len);
+				blocks2.emplace_back(p);
+			}
+
+			for (auto p : blocks2) alloc.deallocate(p, len);
+		}
+
+		TEST_METHOD(ThreadExit)
+		{
+			// Size class that no other test uses
+			constexpr std::size_t len{ 2000 };
+			constexpr std::size_t num{ 8 };
+
+			std::vector<Byte*> blocks1;
+			std::vector<Byte*> blocks2;
+
+			const auto allocate = [&](std::vector<Byte*>& blocks, const bool free)
+			{
+				Allocator alloc;
+
+				for (std::size_t x = 0; x < num; ++x)
+				{
+					blocks.emplace_back(alloc.allocate(len));
+				}
+
+				if (free)
+				{
+					// Blocks stay in the cache of this thread
+					// until the thread exits
+					for (auto p : blocks) alloc.deallocate(p, len);
+				}
+			};
+
+			std::thread thread1([&]() { allocate(blocks1, true); });
+			thread1.join();
+
+			// After the first thread exited its blocks are available to other threads
+			std::thread thread2([&]() { allocate(blocks2, false); });
+			thread2.join();
+
+			for (auto p : blocks1)
+			{
+				Assert::AreEqual(true, std::find(blocks2.begin(), blocks2.end(), p) != blocks2.end());
+			}
+
+			// Blocks can also be freed by a thread whose cache
+			// doesn't exist anymore or by another thread
+			Allocator alloc;
+			for (auto p : blocks2) alloc.deallocate(p, len);
+		}
+
+		TEST_METHOD(LargeAllocations)
+		{
+			SYSTEM_INFO sysinfo{ 0 };
+			::GetSystemInfo(&sysinfo);
+
+			Allocator alloc;
+
+			// Requests above the largest size class get their own locked
+			// pages and don't get rounded up to a size class
+			for (const auto len : { Base::MaximumSlabAllocationSize + 1, Base::MaximumSlabAllocationSize * 2,
+				 std::size_t{ 100'000 }, std::size_t{ 1'000'000 } })
+			{
+				auto p = alloc.allocate(len);
+				Assert::AreEqual(true, p != nullptr);
+
+				// Starts on an allocation boundary of its own
+				Assert::AreEqual(true, reinterpret_cast<std::uintptr_t>(p) % sysinfo.dwAllocationGranularity == 0);
+
+				for (std::size_t x = 0; x < len; ++x)
+				{
+					Assert::AreEqual(true, p[x] == Byte{ 0 });
+				}
+
+				std::memset(p, 0xCC, len);
+				Assert::AreEqual(true, p[len - 1] == Byte{ 0xCC });
+
+				alloc.deallocate(p, len);
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Common\Util.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	TEST_CLASS(RandomTests)
+	{
+	public:
+		TEST_METHOD(PseudoRandomBytes)
+		{
+			// Sizes around the generator step size
+			for (const auto size : { 0u, 1u, 7u, 8u, 31u, 32u, 33u, 64u, 1000u, 4096u })
+			{
+				const auto bytes1 = Util::GetPseudoRandomBytes(size);
+				const auto bytes2 = Util::GetPseudoRandomBytes(size);
+				Assert::AreEqual(true, bytes1.GetSize() == size);
+				Assert::AreEqual(true, bytes2.GetSize() == size);
+
+				if (size >= 8) Assert::AreEqual(false, bytes1 == bytes2);
+			}
+
+			// Filling in place doesn't write past the end
+			{
+				std::array<Byte, 64> bytes;
+				bytes.fill(Byte{ 0xAA });
+
+				Util::GetPseudoRandomBytes(bytes.data(), 37);
+				for (auto x = 37u; x < bytes.size(); ++x)
+				{
+					Assert::AreEqual(true, bytes[x] == Byte{ 0xAA });
+				}
+			}
+
+			// All byte values should show up with roughly the same frequency
+			{
+				constexpr auto size = 1u << 20;
+				const auto bytes = Util::GetPseudoRandomBytes(size);
+
+				std::array<Size, 256> counts{ 0 };
+				for (Size x = 0; x < bytes.GetSize(); ++x)
+				{
+					++counts[static_cast<UInt8>(bytes[x])];
+				}
+
+				const auto expected = size / counts.size();
+				for (const auto count : counts)
+				{
+					Assert::AreEqual(true, count > (expected * 9) / 10 && count < (expected * 11) / 10);
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -130,6 +130,74 @@ namespace UnitTests
 			}
 		}
 
+		TEST_METHOD(DynamicMaximum)
+		{
+			DynamicRateLimit<Size> rlimit;
+			Assert::AreEqual(true, rlimit.GetCurrent() == 0);
+			Assert::AreEqual(true, rlimit.GetMinimum() == 0);
+			Assert::AreEqual(true, rlimit.GetMaximum() == std::numeric_limits<Size>::max());
+
+			DynamicRateLimit<Size> rlimit2(1000);
+			Assert::AreEqual(true, rlimit2.GetMaximum() == 1000);
+			Assert::AreEqual(true, rlimit2.GetAvailable() == 1000);
+			Assert::AreEqual(true, rlimit2.CanAdd(1000));
+			Assert::AreEqual(false, rlimit2.CanAdd(1001));
+			rlimit2.Add(800);
+			Assert::AreEqual(true, rlimit2.GetAvailable() == 200);
+
+			// Growing the maximum makes room available
+			rlimit2.SetMaximum(2000);
+			Assert::AreEqual(true, rlimit2.GetCurrent() == 800);
+			Assert::AreEqual(true, rlimit2.GetAvailable() == 1200);
+			Assert::AreEqual(true, rlimit2.CanAdd(1200));
+			Assert::AreEqual(false, rlimit2.CanAdd(1201));
+
+			// Shrinking the maximum below the current size
+			rlimit2.SetMaximum(500);
+			Assert::AreEqual(true, rlimit2.GetCurrent() == 800);
+			Assert::AreEqual(true, rlimit2.GetAvailable() == 0);
+			Assert::AreEqual(false, rlimit2.CanAdd(1));
+			Assert::AreEqual(true, rlimit2.CanSubtract(400));
+			Assert::AreEqual(false, rlimit2.CanSubtract(801));
+			rlimit2.Subtract(400);
+			Assert::AreEqual(true, rlimit2.GetCurrent() == 400);
+			Assert::AreEqual(true, rlimit2.GetAvailable() == 100);
+			Assert::AreEqual(true, rlimit2.CanAdd(100));
+			Assert::AreEqual(false, rlimit2.CanAdd(101));
+
+			// Copy keeps the maximum
+			auto rlimit3 = rlimit2;
+			Assert::AreEqual(true, rlimit3.GetMaximum() == 500);
+			Assert::AreEqual(true, rlimit3.GetCurrent() == 400);
+
+			{
+				DynamicRateLimit<Int16, false> rlimit4(100);
+				static_assert(!noexcept(rlimit4.Add(1)), "Should not be noexcept.");
+
+				Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					rlimit4.Add(101);
+				});
+
+				Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					rlimit4.SetMaximum(std::numeric_limits<Int32>::min());
+				});
+
+				// Values that don't fit don't get truncated
+				Assert::ExpectException<std::invalid_argument>([&]()
+				{
+					rlimit4.SetMaximum(Int32{ 65'636 });
+				});
+				Assert::AreEqual(true, rlimit4.GetMaximum() == 100);
+			}
+
+			{
+				DynamicRateLimit<UInt16> rlimit5(UInt64{ 65'636 });
+				Assert::AreEqual(true, rlimit5.GetMaximum() == std::numeric_limits<UInt16>::max());
+			}
+		}
+
 		TEST_METHOD(Exceptions)
 		{
 			static_assert(noexcept(RateLimit<UInt8>{}), "Default constructor should be noexcept.");
@@ -0,0 +1,214 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "..\..\QuantumGateCryptoLib\QuantumGateCryptoLib.h"
+
+#include <random>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace UnitTests
+{
+	// Reference test vectors from the SipHash repository (vectors.h); key is
+	// 00 01 02 ... 0f and input is the first N bytes of 00 01 02 ...
+	const std::array<std::array<UInt8, 8>, 16> SipHash64Vectors =
+	{{
+		{ 0x31, 0x0e, 0x0e, 0xdd, 0x47, 0xdb, 0x6f, 0x72 },
+		{ 0xfd, 0x67, 0xdc, 0x93, 0xc5, 0x39, 0xf8, 0x74 },
+		{ 0x5a, 0x4f, 0xa9, 0xd9, 0x09, 0x80, 0x6c, 0x0d },
+		{ 0x2d, 0x7e, 0xfb, 0xd7, 0x96, 0x66, 0x67, 0x85 },
+		{ 0xb7, 0x87, 0x71, 0x27, 0xe0, 0x94, 0x27, 0xcf },
+		{ 0x8d, 0xa6, 0x99, 0xcd, 0x64, 0x55, 0x76, 0x18 },
+		{ 0xce, 0xe3, 0xfe, 0x58, 0x6e, 0x46, 0xc9, 0xcb },
+		{ 0x37, 0xd1, 0x01, 0x8b, 0xf5, 0x00, 0x02, 0xab },
+		{ 0x62, 0x24, 0x93, 0x9a, 0x79, 0xf5, 0xf5, 0x93 },
+		{ 0xb0, 0xe4, 0xa9, 0x0b, 0xdf, 0x82, 0x00, 0x9e },
+		{ 0xf3, 0xb9, 0xdd, 0x94, 0xc5, 0xbb, 0x5d, 0x7a },
+		{ 0xa7, 0xad, 0x6b, 0x22, 0x46, 0x2f, 0xb3, 0xf4 },
+		{ 0xfb, 0xe5, 0x0e, 0x86, 0xbc, 0x8f, 0x1e, 0x75 },
+		{ 0x90, 0x3d, 0x84, 0xc0, 0x27, 0x56, 0xea, 0x14 },
+		{ 0xee, 0xf2, 0x7a, 0x8e, 0x90, 0xca, 0x23, 0xf7 },
+		{ 0xe5, 0x45, 0xbe, 0x49, 0x61, 0xca, 0x29, 0xa1 }
+	}};
+
+	const std::array<std::array<UInt8, 16>, 16> SipHash128Vectors =
+	{{
+		{ 0xa3, 0x81, 0x7f, 0x04, 0xba, 0x25, 0xa8, 0xe6, 0x6d, 0xf6, 0x72, 0x14, 0xc7, 0x55, 0x02, 0x93 },
+		{ 0xda, 0x87, 0xc1, 0xd8, 0x6b, 0x99, 0xaf, 0x44, 0x34, 0x76, 0x59, 0x11, 0x9b, 0x22, 0xfc, 0x45 },
+		{ 0x81, 0x77, 0x22, 0x8d, 0xa4, 0xa4, 0x5d, 0xc7, 0xfc, 0xa3, 0x8b, 0xde, 0xf6, 0x0a, 0xff, 0xe4 },
+		{ 0x9c, 0x70, 0xb6, 0x0c, 0x52, 0x67, 0xa9, 0x4e, 0x5f, 0x33, 0xb6, 0xb0, 0x29, 0x85, 0xed, 0x51 },
+		{ 0xf8, 0x81, 0x64, 0xc1, 0x2d, 0x9c, 0x8f, 0xaf, 0x7d, 0x0f, 0x6e, 0x7c, 0x7b, 0xcd, 0x55, 0x79 },
+		{ 0x13, 0x68, 0x87, 0x59, 0x80, 0x77, 0x6f, 0x88, 0x54, 0x52, 0x7a, 0x07, 0x69, 0x0e, 0x96, 0x27 },
+		{ 0x14, 0xee, 0xca, 0x33, 0x8b, 0x20, 0x86, 0x13, 0x48, 0x5e, 0xa0, 0x30, 0x8f, 0xd7, 0xa1, 0x5e },
+		{ 0xa1, 0xf1, 0xeb, 0xbe, 0xd8, 0xdb, 0xc1, 0x53, 0xc0, 0xb8, 0x4a, 0xa6, 0x1f, 0xf0, 0x82, 0x39 },
+		{ 0x3b, 0x62, 0xa9, 0xba, 0x62, 0x58, 0xf5, 0x61, 0x0f, 0x83, 0xe2, 0x64, 0xf3, 0x14, 0x97, 0xb4 },
+		{ 0x26, 0x44, 0x99, 0x06, 0x0a, 0xd9, 0xba, 0xab, 0xc4, 0x7f, 0x8b, 0x02, 0xbb, 0x6d, 0x71, 0xed },
+		{ 0x00, 0x11, 0x0d, 0xc3, 0x78, 0x14, 0x69, 0x56, 0xc9, 0x54, 0x47, 0xd3, 0xf3, 0xd0, 0xfb, 0xba },
+		{ 0x01, 0x51, 0xc5, 0x68, 0x38, 0x6b, 0x66, 0x77, 0xa2, 0xb4, 0xdc, 0x6f, 0x81, 0xe5, 0xdc, 0x18 },
+		{ 0xd6, 0x26, 0xb2, 0x66, 0x90, 0x5e, 0xf3, 0x58, 0x82, 0x63, 0x4d, 0xf6, 0x85, 0x32, 0xc1, 0x25 },
+		{ 0x98, 0x69, 0xe2, 0x47, 0xe9, 0xc0, 0x8b, 0x10, 0xd0, 0x29, 0x93, 0x4f, 0xc4, 0xb9, 0x52, 0xf7 },
+		{ 0x31, 0xfc, 0xef, 0xac, 0x66, 0xd7, 0xde, 0x9c, 0x7e, 0xc7, 0x48, 0x5f, 0xe4, 0x49, 0x49, 0x02 },
+		{ 0x54, 0x93, 0xe9, 0x99, 0x33, 0xb0, 0xa8, 0x11, 0x7e, 0x08, 0xec, 0x0f, 0x97, 0xcf, 0xc3, 0xd9 }
+	}};
+
+	const std::array<std::array<UInt8, 4>, 16> HalfSipHash32Vectors =
+	{{
+		{ 0xa9, 0x35, 0x9f, 0x5b },
+		{ 0x27, 0x47, 0x5a, 0xb8 },
+		{ 0xfa, 0x62, 0xa6, 0x03 },
+		{ 0x8a, 0xfe, 0xe7, 0x04 },
+		{ 0x2a, 0x6e, 0x46, 0x89 },
+		{ 0xc5, 0xfa, 0xb6, 0x69 },
+		{ 0x58, 0x63, 0xfc, 0x23 },
+		{ 0x8b, 0xcf, 0x63, 0xc5 },
+		{ 0xd0, 0xb8, 0x84, 0x8f },
+		{ 0xf8, 0x06, 0xe7, 0x79 },
+		{ 0x94, 0xb0, 0x79, 0x34 },
+		{ 0x08, 0x08, 0x30, 0x50 },
+		{ 0x57, 0xf0, 0x87, 0x2f },
+		{ 0x77, 0xe6, 0x63, 0xff },
+		{ 0xd6, 0xff, 0xf8, 0x7c },
+		{ 0x74, 0xfe, 0x2b, 0x97 }
+	}};
+
+	const std::array<std::array<UInt8, 8>, 16> HalfSipHash64Vectors =
+	{{
+		{ 0x21, 0x8d, 0x1f, 0x59, 0xb9, 0xb8, 0x3c, 0xc8 },
+		{ 0xbe, 0x55, 0x24, 0x12, 0xf8, 0x38, 0x73, 0x15 },
+		{ 0x06, 0x4f, 0x39, 0xef, 0x7c, 0x50, 0xeb, 0x57 },
+		{ 0xce, 0x0f, 0x1a, 0x45, 0xf7, 0x06, 0x06, 0x79 },
+		{ 0xd5, 0xe7, 0x8a, 0x17, 0x5b, 0xe5, 0x2e, 0xa1 },
+		{ 0xcb, 0x9d, 0x7c, 0x3f, 0x2f, 0x3d, 0xb5, 0x80 },
+		{ 0xce, 0x3e, 0x91, 0x35, 0x8a, 0xa2, 0xbc, 0x25 },
+		{ 0xff, 0x20, 0x27, 0x28, 0xb0, 0x7b, 0xc6, 0x84 },
+		{ 0xed, 0xfe, 0xe8, 0x20, 0xbc, 0xe4, 0x85, 0x8c },
+		{ 0x5b, 0x51, 0xcc, 0xcc, 0x13, 0x88, 0x83, 0x07 },
+		{ 0x95, 0xb0, 0x46, 0x9f, 0x06, 0xa6, 0xf2, 0xee },
+		{ 0xae, 0x26, 0x33, 0x39, 0x94, 0xdd, 0xcd, 0x48 },
+		{ 0x7b, 0xc7, 0x1f, 0x9f, 0xae, 0xf5, 0xc7, 0x99 },
+		{ 0x5a, 0x23, 0x52, 0xd7, 0x5a, 0x0c, 0x37, 0x44 },
+		{ 0x3b, 0xb1, 0xa8, 0x70, 0xea, 0xe8, 0xe6, 0x58 },
+		{ 0x21, 0x7d, 0x0b, 0xcb, 0x4e, 0x81, 0xc9, 0x02 }
+	}};
+
+	using SipHashFunction = int(*)(const uint8_t*, const size_t, const uint8_t*, uint8_t*, const size_t);
+
+	template<Size N>
+	void CheckVectors(const std::array<std::array<UInt8, N>, 16>& vectors, const SipHashFunction func)
+	{
+		std::array<UInt8, 16> key{ 0 };
+		std::array<UInt8, 16> in{ 0 };
+		for (auto x = 0u; x < 16u; ++x)
+		{
+			key[x] = static_cast<UInt8>(x);
+			in[x] = static_cast<UInt8>(x);
+		}
+
+		for (auto len = 0u; len < vectors.size(); ++len)
+		{
+			std::array<UInt8, N> out{ 0 };
+			Assert::AreEqual(0, func(in.data(), len, key.data(), out.data(), out.size()));
+			Assert::AreEqual(true, out == vectors[len]);
+		}
+	}
+
+	TEST_CLASS(SipHashTests)
+	{
+	public:
+		TEST_METHOD(ReferenceVectors)
+		{
+			for (const auto func : { &siphash, &siphash_opt })
+			{
+				CheckVectors(SipHash64Vectors, func);
+				CheckVectors(SipHash128Vectors, func);
+			}
+
+			for (const auto func : { &halfsiphash, &halfsiphash_opt })
+			{
+				CheckVectors(HalfSipHash32Vectors, func);
+				CheckVectors(HalfSipHash64Vectors, func);
+			}
+		}
+
+		TEST_METHOD(OptimizedMatchesReference)
+		{
+			std::mt19937 gen(369);
+			std::uniform_int_distribution<int> byte_dist(0, 255);
+
+			std::vector<UInt8> data(2048);
+			for (auto& b : data) b = static_cast<UInt8>(byte_dist(gen));
+
+			std::array<UInt8, 16> key{ 0 };
+			for (auto& b : key) b = static_cast<UInt8>(byte_dist(gen));
+
+			for (auto len = 0u; len < data.size(); ++len)
+			{
+				for (const auto outlen : { 8u, 16u })
+				{
+					std::array<UInt8, 16> out_ref{ 0 };
+					std::array<UInt8, 16> out_opt{ 0 };
+					Assert::AreEqual(0, siphash(data.data(), len, key.data(), out_ref.data(), outlen));
+					Assert::AreEqual(0, siphash_opt(data.data(), len, key.data(), out_opt.data(), outlen));
+					Assert::AreEqual(true, out_ref == out_opt);
+				}
+
+				for (const auto outlen : { 4u, 8u })
+				{
+					std::array<UInt8, 8> out_ref{ 0 };
+					std::array<UInt8, 8> out_opt{ 0 };
+					Assert::AreEqual(0, halfsiphash(data.data(), len, key.data(), out_ref.data(), outlen));
+					Assert::AreEqual(0, halfsiphash_opt(data.data(), len, key.data(), out_opt.data(), outlen));
+					Assert::AreEqual(true, out_ref == out_opt);
+				}
+			}
+		}
+
+		TEST_METHOD(MultiBuffer)
+		{
+			std::mt19937 gen(963);
+			std::uniform_int_distribution<int> byte_dist(0, 255);
+
+			std::vector<UInt8> data(2048);
+			for (auto& b : data) b = static_cast<UInt8>(byte_dist(gen));
+
+			// Batches of various sizes with mixed lengths, offsets and keys;
+			// sizes that aren't a multiple of 8 also exercise the scalar tail
+			for (const auto num : { 0u, 1u, 7u, 8u, 9u, 16u, 31u, 64u })
+			{
+				for (const auto outlen : { 4u, 8u })
+				{
+					std::vector<const uint8_t*> in(num);
+					std::vector<size_t> inlen(num);
+					std::vector<std::array<UInt8, 8>> keys(num);
+					std::vector<const uint8_t*> k(num);
+					std::vector<std::array<UInt8, 8>> outs(num);
+					std::vector<uint8_t*> out(num);
+
+					std::uniform_int_distribution<size_t> len_dist(0, num % 2 == 0 ? 1500 : 64);
+
+					for (auto x = 0u; x < num; ++x)
+					{
+						inlen[x] = len_dist(gen);
+						in[x] = data.data() + std::uniform_int_distribution<size_t>(0, data.size() - inlen[x])(gen);
+						for (auto& b : keys[x]) b = static_cast<UInt8>(byte_dist(gen));
+						k[x] = keys[x].data();
+						out[x] = outs[x].data();
+					}
+
+					Assert::AreEqual(0, halfsiphash_multi(in.data(), inlen.data(), k.data(), out.data(), outlen, num));
+
+					for (auto x = 0u; x < num; ++x)
+					{
+						std::array<UInt8, 8> out_ref{ 0 };
+						std::array<UInt8, 8> out_multi{ 0 };
+						std::memcpy(out_multi.data(), outs[x].data(), outlen);
+
+						Assert::AreEqual(0, halfsiphash(in[x], inlen[x], k[x], out_ref.data(), outlen));
+						Assert::AreEqual(true, out_ref == out_multi);
+					}
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "..\..\QuantumGateLib\Memory\SmallBuffer.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Memory;
+
+namespace UnitTests
+{
+	static std::size_t NumSmallBufferTestAllocations{ 0 };
+
+	// Allocator that counts the number of allocations
+	template<typename T>
+	struct CountingAllocator
+	{
+		using value_type = T;
+
+		CountingAllocator() noexcept = default;
+
+		template<typename U>
+		CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+		T* allocate(const std::size_t n)
+		{
+			++NumSmallBufferTestAllocations;
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* p, const std::size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+
+		template<typename U>
+		bool operator==(const CountingAllocator<U>&) const noexcept { return true; }
+
+		template<typename U>
+		bool operator!=(const CountingAllocator<U>&) const noexcept { return false; }
+	};
+
+	TEST_CLASS(SmallBufferTests)
+	{
+	public:
+		TEST_METHOD(General)
+		{
+			const String smalltxt = L"Small";
+			const String largetxt = L"This text is too large to fit in the inline storage of the buffer";
+
+			const auto small = BufferView(reinterpret_cast<const Byte*>(smalltxt.data()), smalltxt.size() * sizeof(String::value_type));
+			const auto large = BufferView(reinterpret_cast<const Byte*>(largetxt.data()), largetxt.size() * sizeof(String::value_type));
+
+			Assert::AreEqual(true, small.GetSize() <= SmallBuffer32::GetInlineSize());
+			Assert::AreEqual(true, large.GetSize() > SmallBuffer32::GetInlineSize());
+
+			// Default constructor
+			SmallBuffer32 sb1;
+			Assert::AreEqual(true, sb1.IsEmpty());
+			Assert::AreEqual(false, sb1.operator bool());
+			Assert::AreEqual(true, sb1.IsInline());
+			Assert::AreEqual(true, sb1.GetSize() == 0);
+
+			// Small data stays inline
+			sb1 += small;
+			Assert::AreEqual(true, sb1.IsInline());
+			Assert::AreEqual(true, sb1 == small);
+			Assert::AreEqual(true, sb1.GetBytes() != small.GetBytes());
+
+			// Up to the inline size stays inline
+			sb1.Resize(SmallBuffer32::GetInlineSize());
+			Assert::AreEqual(true, sb1.IsInline());
+			Assert::AreEqual(true, sb1.GetSize() == SmallBuffer32::GetInlineSize());
+			Assert::AreEqual(true, BufferView(sb1).GetFirst(small.GetSize()) == small);
+
+			// Added bytes are zeroed
+			for (auto x = small.GetSize(); x < sb1.GetSize(); ++x)
+			{
+				Assert::AreEqual(true, sb1[x] == Byte{ 0 });
+			}
+
+			// Growing larger spills
+			sb1 += large;
+			Assert::AreEqual(false, sb1.IsInline());
+			Assert::AreEqual(true, sb1.GetSize() == SmallBuffer32::GetInlineSize() + large.GetSize());
+			Assert::AreEqual(true, BufferView(sb1).GetFirst(small.GetSize()) == small);
+			Assert::AreEqual(true, BufferView(sb1).GetLast(large.GetSize()) == large);
+
+			// Removing data
+			sb1.RemoveFirst(SmallBuffer32::GetInlineSize());
+			Assert::AreEqual(true, sb1 == large);
+			sb1.RemoveLast(large.GetSize() - small.GetSize());
+			Assert::AreEqual(true, sb1.GetSize() == small.GetSize());
+			sb1.Clear();
+			Assert::AreEqual(true, sb1.IsEmpty());
+
+			SmallBuffer32 sb2(small);
+			sb2.RemoveFirst(2);
+			Assert::AreEqual(true, sb2.IsInline());
+			Assert::AreEqual(true, BufferView(sb2) == small.GetLast(small.GetSize() - 2));
+			sb2.RemoveLast(2);
+			Assert::AreEqual(true, BufferView(sb2) == small.GetSub(2, small.GetSize() - 4));
+
+			// Preallocation larger than the inline size spills
+			SmallBuffer32 sb3(small);
+			sb3.Preallocate(large.GetSize());
+			Assert::AreEqual(false, sb3.IsInline());
+			Assert::AreEqual(true, sb3 == small);
+
+			// Copy and move of inline data
+			{
+				SmallBuffer32 sb4(small);
+				SmallBuffer32 sb5(sb4);
+				Assert::AreEqual(true, sb5 == sb4);
+				Assert::AreEqual(true, sb5.IsInline());
+
+				SmallBuffer32 sb6(std::move(sb4));
+				Assert::AreEqual(true, sb6 == small);
+				Assert::AreEqual(true, sb6.IsInline());
+				Assert::AreEqual(true, sb4.IsEmpty());
+
+				sb5 = large;
+				sb5 = sb6;
+				Assert::AreEqual(true, sb5 == small);
+			}
+
+			// Copy and move of spilled data
+			{
+				SmallBuffer32 sb4(large);
+				Assert::AreEqual(false, sb4.IsInline());
+
+				SmallBuffer32 sb5(sb4);
+				Assert::AreEqual(true, sb5 == sb4);
+				Assert::AreEqual(true, sb5.GetBytes() != sb4.GetBytes());
+
+				// Spilled data only gets moved
+				const auto bytes = sb4.GetBytes();
+				SmallBuffer32 sb6(std::move(sb4));
+				Assert::AreEqual(true, sb6 == large);
+				Assert::AreEqual(true, sb6.GetBytes() == bytes);
+				Assert::AreEqual(true, sb4.IsEmpty());
+				Assert::AreEqual(true, sb4.IsInline());
+
+				// Moving inline data over spilled data
+				SmallBuffer32 sb7(small);
+				sb6 = std::move(sb7);
+				Assert::AreEqual(true, sb6.IsInline());
+				Assert::AreEqual(true, sb6 == small);
+			}
+
+			// Move to Buffer
+			{
+				SmallBuffer32 sb4(large);
+				const auto bytes = sb4.GetBytes();
+				auto buf1 = sb4.MoveToBuffer();
+				Assert::AreEqual(true, buf1 == large);
+				Assert::AreEqual(true, buf1.GetBytes() == bytes);
+				Assert::AreEqual(true, sb4.IsEmpty());
+
+				SmallBuffer32 sb5(small);
+				auto buf2 = sb5.MoveToBuffer();
+				Assert::AreEqual(true, buf2 == small);
+				Assert::AreEqual(true, sb5.IsEmpty());
+			}
+		}
+
+		TEST_METHOD(Allocations)
+		{
+			// Builds control messages (header plus a few bytes of payload) the way
+			// the message code does; SmallBuffer shouldn't need to allocate memory
+			constexpr auto num_messages = 100u;
+
+			std::array<Byte, 21> header{};
+			std::array<Byte, 12> payload{};
+
+			const auto run = [&]<typename B>(B&&) -> std::size_t
+			{
+				NumSmallBufferTestAllocations = 0;
+
+				for (auto i = 0u; i < num_messages; ++i)
+				{
+					header[0] = static_cast<Byte>(i);
+
+					B hdrbuf;
+					hdrbuf.Preallocate(header.size());
+					hdrbuf += BufferView(header.data(), header.size());
+
+					B msgbuf;
+					msgbuf += hdrbuf;
+					msgbuf += BufferView(payload.data(), payload.size());
+
+					Assert::AreEqual(true, msgbuf.GetSize() == header.size() + payload.size());
+					Assert::AreEqual(true, BufferView(msgbuf).GetFirst(header.size()) == BufferView(header.data(), header.size()));
+				}
+
+				return NumSmallBufferTestAllocations;
+			};
+
+			const auto num_buf = run(BufferImpl<CountingAllocator>());
+			const auto num_sbuf = run(SmallBufferImpl<64, CountingAllocator>());
+
+			Assert::AreEqual(true, num_buf >= num_messages * 2);
+			Assert::AreEqual(true, num_sbuf == 0);
+		}
+	};
+}
\ No newline at end of file
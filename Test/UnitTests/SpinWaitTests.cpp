@@ -0,0 +1,65 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Concurrency\SpinWait.h"
+#include "Concurrency\Event.h"
+
+#include <thread>
+
+using namespace std::literals;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation;
+
+namespace UnitTests
+{
+	TEST_CLASS(SpinWaitTests)
+	{
+	public:
+		TEST_METHOD(General)
+		{
+			// Returns immediately when the function returns true
+			{
+				auto num{ 0 };
+				Assert::AreEqual(true, Concurrency::SpinWait(1s, [&]() noexcept { return (++num == 1); }));
+				Assert::AreEqual(1, num);
+			}
+
+			// Keeps calling the function until it returns true
+			{
+				auto num{ 0 };
+				Assert::AreEqual(true, Concurrency::SpinWait(1s, [&]() noexcept { return (++num == 10); }));
+				Assert::AreEqual(10, num);
+			}
+
+			// Gives up when the budget is used up
+			{
+				const auto begin = std::chrono::steady_clock::now();
+				Assert::AreEqual(false, Concurrency::SpinWait(10ms, []() noexcept { return false; }));
+				Assert::AreEqual(true, std::chrono::steady_clock::now() - begin >= 10ms);
+			}
+
+			// Zero budget still calls the function once
+			{
+				auto num{ 0 };
+				Assert::AreEqual(false, Concurrency::SpinWait(0ns, [&]() noexcept { ++num; return false; }));
+				Assert::AreEqual(1, num);
+			}
+
+			// Sees an event that gets set by another thread
+			{
+				Concurrency::Event event;
+
+				auto thread = std::thread([&]()
+				{
+					std::this_thread::sleep_for(5ms);
+					event.Set();
+				});
+
+				Assert::AreEqual(true, Concurrency::SpinWait(5s, [&]() noexcept { return event.IsSet(); }));
+
+				thread.join();
+			}
+		}
+	};
+}
\ No newline at end of file
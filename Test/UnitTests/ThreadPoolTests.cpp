@@ -0,0 +1,154 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Concurrency\ThreadPool.h"
+#include "Concurrency\Queue.h"
+
+#include <thread>
+
+using namespace std::literals;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+struct ElasticTestData final
+{
+	Concurrency::Queue<SteadyTime> Queue;
+	Concurrency::QueueLatency QueueLatency;
+	std::atomic<Size> NumProcessed{ 0 };
+
+	[[nodiscard]] std::chrono::nanoseconds GetQueueLatency() const noexcept { return QueueLatency.Get(); }
+};
+
+using ElasticTestThreadPool = Concurrency::ThreadPool<ElasticTestData>;
+
+namespace UnitTests
+{
+	TEST_CLASS(ThreadPoolTests)
+	{
+	public:
+		TEST_METHOD(General)
+		{
+			Concurrency::ThreadPool<> pool;
+
+			std::atomic<Size> num{ 0 };
+
+			for (auto x = 0; x < 2; ++x)
+			{
+				Assert::AreEqual(true, pool.AddThread(L"QuantumGate Test Thread",
+													  MakeCallback([&](const Concurrency::Event&)
+				{
+					++num;
+					std::this_thread::sleep_for(1ms);
+				})));
+			}
+
+			Assert::AreEqual(true, pool.Startup());
+			Assert::AreEqual(true, pool.IsRunning());
+
+			std::this_thread::sleep_for(100ms);
+
+			const auto metrics = pool.GetMetrics();
+			Assert::AreEqual(true, metrics.NumThreads == 2);
+			Assert::AreEqual(true, metrics.NumRunningThreads == 2);
+			Assert::AreEqual(true, metrics.Utilization > 0.0 && metrics.Utilization <= 1.0);
+
+			pool.Shutdown();
+			pool.Clear();
+
+			Assert::AreEqual(false, pool.IsRunning());
+			Assert::AreEqual(true, num > 0);
+			Assert::AreEqual(true, pool.GetMetrics().NumRunningThreads == 0);
+		}
+
+		TEST_METHOD(Elastic)
+		{
+			constexpr Size max_threads{ 4 };
+
+			ElasticTestThreadPool pool;
+
+			for (Size x = 0; x < max_threads; ++x)
+			{
+				Assert::AreEqual(true, pool.AddThread(L"QuantumGate Test Thread",
+													  MakeCallback([](ElasticTestData& thpdata, const Concurrency::Event&)
+				{
+					std::optional<SteadyTime> queued;
+
+					thpdata.Queue.PopFrontIf([&](auto& time) noexcept -> bool
+					{
+						queued = time;
+						return true;
+					});
+
+					if (queued)
+					{
+						thpdata.QueueLatency.Record(Util::GetCurrentSteadyTime() - *queued);
+						std::this_thread::sleep_for(5ms);
+						++thpdata.NumProcessed;
+					}
+				}),
+													  MakeCallback([](ElasticTestData& thpdata, const Concurrency::Event& shutdown_event)
+				{
+					thpdata.Queue.Wait(10ms, shutdown_event);
+				}),
+													  MakeCallback([](ElasticTestData& thpdata)
+				{
+					thpdata.Queue.InterruptWait();
+				})));
+			}
+
+			pool.SetElastic({
+				.MinThreads = 1,
+				.MaxQueueLatency = 1ms,
+				.GrowInterval = 10ms,
+				.IdleRetireDuration = 300ms
+			});
+
+			Assert::AreEqual(true, pool.Startup());
+
+			// Only the minimum number of threads runs without work
+			std::this_thread::sleep_for(100ms);
+			Assert::AreEqual(true, pool.GetMetrics().NumThreads == max_threads);
+			Assert::AreEqual(true, pool.GetMetrics().NumRunningThreads == 1);
+
+			const auto wait_for = [&](const Size num_threads, const std::chrono::milliseconds max_wait)
+			{
+				const auto begin = Util::GetCurrentSteadyTime();
+				while (pool.GetMetrics().NumRunningThreads != num_threads &&
+					   Util::GetCurrentSteadyTime() - begin < max_wait)
+				{
+					std::this_thread::sleep_for(1ms);
+				}
+
+				return (pool.GetMetrics().NumRunningThreads == num_threads);
+			};
+
+			// Lots of work makes the queue latency go up
+			// and the thread pool should grow to the maximum
+			constexpr Size num_work{ 400 };
+			for (Size x = 0; x < num_work; ++x)
+			{
+				pool.GetData().Queue.Push(Util::GetCurrentSteadyTime());
+			}
+
+			Assert::AreEqual(true, wait_for(max_threads, 2000ms));
+			Assert::AreEqual(true, pool.GetMetrics().QueueLatency > 1ms);
+
+			// Once the work is done the extra threads should get retired
+			Assert::AreEqual(true, wait_for(1, 10000ms));
+			Assert::AreEqual(true, pool.GetData().NumProcessed == num_work);
+
+			// More work grows the thread pool again
+			for (Size x = 0; x < num_work; ++x)
+			{
+				pool.GetData().Queue.Push(Util::GetCurrentSteadyTime());
+			}
+
+			Assert::AreEqual(true, wait_for(max_threads, 2000ms));
+
+			pool.Shutdown();
+			pool.Clear();
+
+			Assert::AreEqual(true, pool.GetMetrics().NumRunningThreads == 0);
+		}
+	};
+}
\ No newline at end of file
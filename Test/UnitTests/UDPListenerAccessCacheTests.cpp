@@ -0,0 +1,100 @@
+// This file is part of the QuantumGate project. For copyright and
+// licensing information refer to the license file(s) in the project root.
+
+#include "pch.h"
+#include "Settings.h"
+#include "Common\Util.h"
+
+// Undefine conflicting macro
+#ifdef max
+#undef max
+#endif
+
+#include "Core\UDP\UDPListenerAccessCache.h"
+
+using namespace std::literals;
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace QuantumGate::Implementation::Core::UDP::Listener;
+
+namespace UnitTests
+{
+	TEST_CLASS(UDPListenerAccessCacheTests)
+	{
+	public:
+		TEST_METHOD(General)
+		{
+			auto ac = std::make_unique<AccessCache>();
+			Assert::AreEqual(true, ac->Initialize());
+
+			const auto ip1 = IPAddress(L"3.30.120.5");
+			const auto ip2 = IPAddress(L"3.30.120.6");
+			const auto ip3 = IPAddress(L"fe80::c11a:3a9c:ef10:e795");
+
+			const auto epoch = ac->GetEpoch(Util::GetCurrentSteadyTime());
+
+			// Nothing cached yet
+			Assert::AreEqual(false, ac->GetAllowed(ip1, epoch).has_value());
+			Assert::AreEqual(false, ac->GetAllowed(ip3, epoch).has_value());
+
+			ac->SetAllowed(ip1, epoch, true);
+			ac->SetAllowed(ip3, epoch, false);
+
+			const auto result1 = ac->GetAllowed(ip1, epoch);
+			Assert::AreEqual(true, result1.has_value());
+			Assert::AreEqual(true, *result1);
+
+			const auto result2 = ac->GetAllowed(ip3, epoch);
+			Assert::AreEqual(true, result2.has_value());
+			Assert::AreEqual(false, *result2);
+
+			// Different IP isn't cached
+			Assert::AreEqual(false, ac->GetAllowed(ip2, epoch).has_value());
+
+			// Decision can be changed
+			ac->SetAllowed(ip1, epoch, false);
+
+			const auto result3 = ac->GetAllowed(ip1, epoch);
+			Assert::AreEqual(true, result3.has_value());
+			Assert::AreEqual(false, *result3);
+		}
+
+		TEST_METHOD(Invalidation)
+		{
+			auto ac = std::make_unique<AccessCache>();
+			Assert::AreEqual(true, ac->Initialize());
+
+			const auto ip = IPAddress(L"192.168.1.10");
+			const auto now = Util::GetCurrentSteadyTime();
+
+			// Decision made with an epoch from before an update should not be used
+			{
+				const auto epoch = ac->GetEpoch(now);
+				ac->Invalidate();
+				ac->SetAllowed(ip, epoch, true);
+
+				Assert::AreEqual(false, ac->GetAllowed(ip, ac->GetEpoch(now)).has_value());
+			}
+
+			// Update invalidates cached decisions
+			{
+				const auto epoch = ac->GetEpoch(now);
+				ac->SetAllowed(ip, epoch, true);
+
+				Assert::AreEqual(true, ac->GetAllowed(ip, ac->GetEpoch(now)).has_value());
+
+				ac->Invalidate();
+
+				Assert::AreEqual(false, ac->GetAllowed(ip, ac->GetEpoch(now)).has_value());
+			}
+
+			// Decisions expire after some time
+			{
+				const auto epoch = ac->GetEpoch(now);
+				ac->SetAllowed(ip, epoch, false);
+
+				Assert::AreEqual(true, ac->GetAllowed(ip, ac->GetEpoch(now)).has_value());
+				Assert::AreEqual(false, ac->GetAllowed(ip, ac->GetEpoch(now + 5s)).has_value());
+			}
+		}
+	};
+}
\ No newline at end of file